@@ -0,0 +1,219 @@
+/*  
+ *  src/include/buildConfig.h -- Build configuration file.
+ *  
+ *  WARNING: DO NOT EDIT. This file is generated by configure.
+ *
+ *  Use "./configure --help" for available options.
+ */ 
+
+    #define BLD_MPR_PRODUCT 1
+    #define BLD_PRODUCT "mpr"
+    #define BLD_NAME "Multithreaded Portable Runtime"
+    #define BLD_VERSION "3.1.4"
+    #define BLD_NUMBER "1-repos"
+    #define BLD_NUMBER_ONLY "1"
+    #define BLD_MAJOR_VERSION 3
+    #define BLD_MINOR_VERSION 1
+    #define BLD_PATCH_VERSION 4
+    #define BLD_VNUM "3001004"
+    #define BLD_TYPE "DEBUG"
+    #define BLD_TUNE MPR_TUNE_BALANCED
+    #define BLD_DEFAULTS "standard"
+    #define BLD_COMPONENTS " ar cc make nm strip ranlib doxygen mpr regexp matrixssl openssl ssl"
+    #define BLD_EMBEDTHIS 0
+
+    #define BLD_COMPANY "Embedthis"
+    #define BLD_DEBUG 1
+    #define BLD_DIRS "build products obj lib bin src test all doc samples projects package releases"
+    #define BLD_CLEAN_INSTALL "0"
+    #define BLD_LICENSE "gpl"
+    #define BLD_COMMERCIAL "0"
+
+    #define BLD_HOST_SYSTEM "x86_64-pc-linux"
+    #define BLD_BUILD_SYSTEM "x86_64-pc-linux"
+    #define BLD_CROSS "0"
+
+    #define BLD_HOST_OS "LINUX"
+    #define BLD_HOST_CPU_ARCH MPR_CPU_IX64
+    #define BLD_HOST_CPU "x86_64"
+    #define BLD_HOST_CPU_UPPER "X86_64"
+    #define BLD_HOST_CPU_MODEL ""
+    #define BLD_HOST_DIST "debian"
+    #define BLD_HOST_DIST_VER "GNU/Linux"
+    #define BLD_HOST_UNIX 1
+    #define BLD_HOST_WIN 0
+
+    #define BLD_BUILD_OS "LINUX"
+    #define BLD_BUILD_CPU_ARCH MPR_CPU_IX64
+    #define BLD_BUILD_CPU "x86_64"
+    #define BLD_BUILD_CPU_UPPER "X86_64"
+    #define BLD_BUILD_CPU_MODEL ""
+    #define BLD_BUILD_UNIX 1
+    #define BLD_BUILD_WIN 0
+
+    #define BLD_ROOT_PREFIX "/"
+    #define BLD_PREFIX "/usr"
+    #define BLD_CFG_PREFIX "/usr/lib/mpr"
+    #define BLD_BIN_PREFIX "/usr/lib/mpr/3.1.4/bin"
+    #define BLD_DOC_PREFIX "/usr/lib/mpr/3.1.4/doc"
+    #define BLD_INC_PREFIX "/usr/lib/mpr/3.1.4/inc"
+    #define BLD_JEM_PREFIX "/usr/lib/mpr/jems"
+    #define BLD_LIB_PREFIX "/usr/lib/mpr/3.1.4/lib"
+    #define BLD_LOG_PREFIX "/var/log/mpr"
+    #define BLD_MAN_PREFIX "/usr/lib/mpr/3.1.4/man"
+    #define BLD_MOD_PREFIX "/usr/lib/mpr/3.1.4/modules"
+    #define BLD_PRD_PREFIX "/usr/lib/mpr"
+    #define BLD_SAM_PREFIX "/usr/lib/mpr/3.1.4/samples"
+    #define BLD_SRC_PREFIX "/usr/src/mpr-3.1.4"
+    #define BLD_VER_PREFIX "/usr/lib/mpr/3.1.4"
+    #define BLD_WEB_PREFIX "/var/www/mpr-default"
+
+    #define BLD_BUILD_LIB_DIR "/root/repo/lib"
+    #define BLD_BUILD_MOD_DIR "/root/repo/modules"
+
+    #define BLD_FEATURE_ASSERT 1
+    #define BLD_FEATURE_CMD 1
+    #define BLD_FEATURE_COMPLETE_NATIVE 1
+    #define BLD_FEATURE_COMPLETE_CROSS 0
+    #define BLD_FEATURE_DOC 1
+    #define BLD_FEATURE_DEVICE PocketPC2003
+    #define BLD_FEATURE_FLOATING_POINT 1
+    #define BLD_FEATURE_LEGACY_API 0
+    #define BLD_FEATURE_MULTITHREAD 1
+    #define BLD_FEATURE_NUM_TYPE 
+    #define BLD_FEATURE_NUM_TYPE_STRING ""
+    #define BLD_FEATURE_SAMPLES 1
+    #define BLD_FEATURE_TEST 1
+
+    #ifdef STATIC_OVERRIDE
+    #define         BLD_FEATURE_STATIC STATIC_OVERRIDE
+    #else
+    #define         BLD_FEATURE_STATIC 0
+    #endif
+
+    #define BLD_FEATURE_DECIMAL 0
+    #define BLD_FEATURE_HTTP 1
+    #define BLD_FEATURE_HTTP_CLIENT 1
+    #define BLD_FEATURE_XML 1
+
+    #define BLD_BUILD_ARCH ".a"
+    #define BLD_BUILD_EXE ""
+    #define BLD_BUILD_OBJ ".o"
+    #define BLD_BUILD_PIOBJ ".o"
+    #define BLD_BUILD_CLASS ".class"
+    #define BLD_BUILD_SHLIB ".so"
+    #define BLD_BUILD_SHOBJ ".so"
+
+    #
+
+    #define 	BUILD_NATIVE_OR_COMPLETE_CROSS 1
+    #define 	BUILD_CROSS_OR_COMPLETE_NATIVE 1
+
+    #define 	LINUX 1
+    #define 	BLD_OS "LINUX"
+    #define 	BLD_CPU_ARCH MPR_CPU_IX64
+    #define 	BLD_CPU "x86_64"
+    #define 	BLD_CPU_UPPER "X86_64"
+    #define 	BLD_CPU_MODEL ""
+    #define 	BLD_DIST "debian"
+    #define 	BLD_DIST_VER "GNU/Linux"
+    #define 	BLD_UNIX_LIKE 1
+    #define 	BLD_WIN_LIKE 0
+
+    #define 	BLD_CFLAGS ""
+    #define 	BLD_DFLAGS ""
+    #define 	BLD_IFLAGS ""
+    #define 	BLD_LDFLAGS ""
+    #define 	BLD_JFLAGS ""
+    #define 	BLD_CPPFLAGS ""
+
+    #define 	BLD_ARCH ".a"
+    #define 	BLD_EXE ""
+    #define 	BLD_CLASS ".class"
+    #define 	BLD_SHLIB ".so"
+    #define 	BLD_SHOBJ ".so"
+    #define 	BLD_LIB ".so"
+    #define 	BLD_OBJ ".o"
+    #define 	BLD_PIOBJ ".o"
+
+    #define     BLD_BIN_NAME "bin"
+    #define     BLD_LIB_NAME "lib"
+    #define     BLD_OBJ_NAME "obj"
+    #define     BLD_MOD_NAME "modules"
+    #define     BLD_INC_NAME "src/include"
+    #define 	BLD_TOOLS_DIR "${BLD_TOP}/build/bin"
+    #define 	BLD_BIN_DIR ${BLD_TOP}/bin
+    #define 	BLD_OBJ_DIR ${BLD_TOP}/obj
+    #define 	BLD_MOD_DIR ${BLD_TOP}/modules
+    #define 	BLD_JEM_DIR ${BLD_TOP}/jlocal
+    #define 	BLD_LIB_DIR ${BLD_TOP}/lib
+    #define 	BLD_INC_DIR ${BLD_TOP}/src/include
+    #define 	BLD_ABS_BIN_DIR "/root/repo/bin"
+    #define 	BLD_ABS_LIB_DIR "/root/repo/lib"
+    #define 	BLD_ABS_OBJ_DIR "/root/repo/obj"
+    #define 	BLD_ABS_MOD_DIR "/root/repo/modules"
+    #define 	BLD_ABS_JEM_DIR "/root/repo/jlocal"
+    #define 	BLD_ABS_INC_DIR "/root/repo/src/include"
+
+    #define     BLD_FEATURE_ROMFS 0
+
+    #define 	BLD_FEATURE_AR 1
+    #define 	BLD_AR "/usr/bin/ar"
+    #define 	BLD_AR_BUILTIN 0
+    #define 	BLD_AR_WITH "1"
+
+    #define 	BLD_FEATURE_CC 1
+    #define 	BLD_CC "/usr/bin/cc"
+    #define 	BLD_CC_BUILTIN 0
+    #define 	BLD_CC_WITH "1"
+    #define 	BLD_CC_CYGWIN 0
+    #define 	BLD_CC_DIAB 0
+    #define 	BLD_CC_DOUBLE_BRACES 1
+    #define 	BLD_CC_DYN_LOAD 1
+    #define 	BLD_CC_MTUNE 1
+    #define 	BLD_CC_MMU 1
+    #define 	BLD_CC_WARN_UNUSED 1
+    #define 	BLD_CC_EDITLINE 0
+    #define 	BLD_CC_STACK_PROTECTOR 1
+
+    #define 	BLD_FEATURE_MAKE 1
+    #define 	BLD_MAKE "/usr/bin/make"
+    #define 	BLD_MAKE_BUILTIN 0
+    #define 	BLD_MAKE_WITH "1"
+
+    #define 	BLD_FEATURE_NM 1
+    #define 	BLD_NM "/usr/bin/nm"
+    #define 	BLD_NM_BUILTIN 0
+    #define 	BLD_NM_WITH "1"
+
+    #define 	BLD_FEATURE_STRIP 1
+    #define 	BLD_STRIP "/usr/bin/strip"
+    #define 	BLD_STRIP_BUILTIN 0
+    #define 	BLD_STRIP_WITH "1"
+
+    #define 	BLD_FEATURE_RANLIB 1
+    #define 	BLD_RANLIB "/usr/bin/ranlib"
+    #define 	BLD_RANLIB_BUILTIN 0
+    #define 	BLD_RANLIB_WITH "1"
+
+    #define 	BLD_FEATURE_DOXYGEN 0
+
+    #define 	BLD_FEATURE_MPR 1
+    #define 	BLD_MPR "src/mpr"
+    #define 	BLD_MPR_BUILTIN 1
+    #define 	BLD_MPR_LIBS "mpr"
+    #define 	BLD_MPR_WITH "1"
+
+    #define 	BLD_FEATURE_REGEXP 1
+    #define 	BLD_REGEXP "src/regexp"
+    #define 	BLD_REGEXP_BUILTIN 1
+    #define 	BLD_REGEXP_LIBS "pcre"
+    #define 	BLD_REGEXP_WITH "1"
+
+    #define 	BLD_FEATURE_MATRIXSSL 0
+
+    #define 	BLD_FEATURE_OPENSSL 0
+
+    #define 	BLD_FEATURE_SSL 0
+
+
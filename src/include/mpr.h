@@ -49,8 +49,10 @@ struct  MprCond;
 struct  MprCmd;
 struct  MprDispatcher;
 struct  MprEvent;
+struct  MprFiber;
 struct  MprFile;
 struct  MprFileSystem;
+struct  MprFuture;
 struct  MprHeap;
 struct  MprHttp;
 struct  MprModule;
@@ -256,6 +258,15 @@ typedef void *MprCtx;
  */
 typedef struct MprString { int dummy; } MprString;
 
+/**
+    Compiled format string
+    @description Format strings used repeatedly may be compiled once into a list of literal text and conversion 
+        specs via #mprCompileFormat. Formatting with a compiled format skips parsing the format string.
+    @see mprCompileFormat, mprGetFormat, mprAsprintfFormat, mprVasprintfFormat, mprSprintfFormat, mprPutFormatToBuf
+    @ingroup MprString
+ */
+typedef struct MprFormat MprFormat;
+
 /*
    Mode values for mprDtoa
  */
@@ -280,9 +291,18 @@ typedef struct MprString { int dummy; } MprString;
          2   Return ndigits of result,
          3   Number of digits applies after the decimal point.
     @param flags Format flags
+    @remarks The shortest digits and modest digit counts are generated with the fast Grisu3 algorithm. Other modes
+        and the rare values Grisu3 cannot prove correct are converted by dtoa().
  */
 extern char *mprDtoa(MprCtx ctx, double value, int ndigits, int mode, int flags);
 
+/*
+    Internal
+ */
+#define MPR_GRISU_MAX_DIGITS        17      /* Max digits requested from mprGrisuDtoa in MPR_DTOA_N_DIGITS mode */
+#define MPR_GRISU_BUFSIZE           32      /* Buffer size for mprGrisuDtoa */
+extern int mprGrisuDtoa(double value, int mode, int ndigits, char *buf, int *period);
+
 extern int mprIsInfinite(double value);
 extern int mprIsZero(double value);
 extern int mprIsNan(double value);
@@ -380,6 +400,11 @@ extern char *mprVsprintf(char *buf, int maxSize, cchar *fmt, va_list args);
  */
 extern char *mprItoa(char *buf, int size, int64 value, int radix);
 
+/*
+ *  Internal
+ */
+extern char *mprFormatUint(char *end, uint64 value, int radix, int upper);
+
 /**
  *  Convert a string to an integer.
  *  @description This call converts the supplied string to an integer using the specified radix (base).
@@ -480,8 +505,8 @@ extern int mprStrcpyCount(char *dest, int destMax, cchar *src, int count);
  *  @description Locate the first occurrence of pattern in a string, but do not search more than the given length. 
  *  @param str Pointer to the string to search.
  *  @param pattern String pattern to search for.
- *  @param len Count of characters in the pattern to actually search for.
- *  @return Returns the number of characters in the target string.
+ *  @param len Maximum count of characters in the string to search. The pattern must lie wholly within this count.
+ *  @return Returns a pointer to the first occurrence of the pattern or null if not found.
  *  @ingroup MprString
  */
 extern char *mprStrnstr(cchar *str, cchar *pattern, int len);
@@ -581,6 +606,130 @@ extern char *mprStrTok(char *str, cchar *delim, char **last);
 extern int print(cchar *fmt, ...);
 #endif
 
+/******************************** String Builder *****************************/
+
+#define MPR_BUILDER_LOCAL   256         /* Bytes of local storage in a string builder */
+
+/**
+ *  String builder
+ *  @description MprStrBuilder builds a string from a series of appends. Builders are declared on the stack and 
+ *      initialized with #mprInitStrBuilder. Short strings are built in storage local to the builder. Longer 
+ *      strings move to an allocated block that doubles in size as required. The result is taken with 
+ *      #mprStealBuilder which hands over the allocated block without copying. A builder that is not stolen must be 
+ *      released with #mprFreeBuilder. 
+ *  \n\n
+ *  The string is always null terminated. If an append fails because the maximum size would be exceeded or memory 
+ *  can't be allocated, the builder is marked in error and #mprStealBuilder returns null.
+ *  @stability Evolving.
+ *  @see mprInitStrBuilder, mprPutStringToBuilder, mprPutBlockToBuilder, mprPutCharToBuilder, mprPutIntToBuilder,
+ *      mprPutFmtToBuilder, mprGrowBuilder, mprGetBuilderString, mprStealBuilder, mprFreeBuilder
+ *  @defgroup MprStrBuilder MprStrBuilder
+ */
+typedef struct MprStrBuilder {
+    MprCtx  ctx;                        /* Memory context for allocated storage and the result */
+    char    *buf;                       /* String storage. Local storage until the string outgrows it. */
+    int     length;                     /* Length of the string */
+    int     size;                       /* Size of buf */
+    int     maxsize;                    /* Maximum size of the string including the null. Zero for no limit. */
+    int     error;                      /* An append failed */
+    char    local[MPR_BUILDER_LOCAL];   /* Local storage for short strings */
+} MprStrBuilder;
+
+/**
+ *  Initialize a string builder
+ *  @param ctx Any memory context allocated by the MPR. The result and any allocated storage are owned by ctx.
+ *  @param sb String builder to initialize. Typically a local variable.
+ *  @param maxSize Maximum size of the string including the trailing null. Set to -1 for no limit.
+ *  @ingroup MprStrBuilder
+ */
+extern void mprInitStrBuilder(MprCtx ctx, MprStrBuilder *sb, int maxSize);
+
+/**
+ *  Grow a string builder
+ *  @description Ensure there is room to append the given number of characters and a trailing null.
+ *  @param sb String builder initialized by #mprInitStrBuilder
+ *  @param count Count of characters to make room for
+ *  @return Zero if successful, otherwise a negative MPR error code.
+ *  @ingroup MprStrBuilder
+ */
+extern int mprGrowBuilder(MprStrBuilder *sb, int count);
+
+/**
+ *  Append a string to a string builder
+ *  @param sb String builder initialized by #mprInitStrBuilder
+ *  @param str String to append. A null string is ignored.
+ *  @return Count of characters appended or a negative MPR error code.
+ *  @ingroup MprStrBuilder
+ */
+extern int mprPutStringToBuilder(MprStrBuilder *sb, cchar *str);
+
+/**
+ *  Append a block of characters to a string builder
+ *  @param sb String builder initialized by #mprInitStrBuilder
+ *  @param str Characters to append
+ *  @param len Count of characters to append
+ *  @return Count of characters appended or a negative MPR error code.
+ *  @ingroup MprStrBuilder
+ */
+extern int mprPutBlockToBuilder(MprStrBuilder *sb, cchar *str, int len);
+
+/**
+ *  Append a character to a string builder
+ *  @param sb String builder initialized by #mprInitStrBuilder
+ *  @param c Character to append
+ *  @return One if successful or a negative MPR error code.
+ *  @ingroup MprStrBuilder
+ */
+extern int mprPutCharToBuilder(MprStrBuilder *sb, int c);
+
+/**
+ *  Append an integer to a string builder
+ *  @description The integer is appended in decimal.
+ *  @param sb String builder initialized by #mprInitStrBuilder
+ *  @param value Integer to append
+ *  @return Count of characters appended or a negative MPR error code.
+ *  @ingroup MprStrBuilder
+ */
+extern int mprPutIntToBuilder(MprStrBuilder *sb, int64 value);
+
+/**
+ *  Append a formatted string to a string builder
+ *  @description The string is formatted directly into the builder storage.
+ *  @param sb String builder initialized by #mprInitStrBuilder
+ *  @param fmt Printf style format string
+ *  @param ... Variable arguments for the format string
+ *  @return Count of characters appended.
+ *  @ingroup MprStrBuilder
+ */
+extern int mprPutFmtToBuilder(MprStrBuilder *sb, cchar *fmt, ...);
+
+/**
+ *  Get the string built so far
+ *  @description The string remains owned by the builder and is only valid until the next append.
+ *  @param sb String builder initialized by #mprInitStrBuilder
+ *  @return The null terminated string.
+ *  @ingroup MprStrBuilder
+ */
+extern cchar *mprGetBuilderString(MprStrBuilder *sb);
+
+/**
+ *  Take the built string
+ *  @description Return the string as an allocated block owned by the builder memory context. Strings that have 
+ *      outgrown the local storage are returned without copying. The builder is reset to empty and may be reused.
+ *  @param sb String builder initialized by #mprInitStrBuilder
+ *  @return An allocated string or null if any append failed. The caller should free with #mprFree.
+ *  @ingroup MprStrBuilder
+ */
+extern char *mprStealBuilder(MprStrBuilder *sb);
+
+/**
+ *  Release a string builder
+ *  @description Free any storage allocated by the builder. Not required after #mprStealBuilder.
+ *  @param sb String builder initialized by #mprInitStrBuilder
+ *  @ingroup MprStrBuilder
+ */
+extern void mprFreeBuilder(MprStrBuilder *sb);
+
 /******************************** Buffer Service *****************************/
 /**
  *  Buffer refill callback function
@@ -602,13 +751,20 @@ typedef int (*MprBufProc)(struct MprBuf* bp, void *arg);
  *  \n\n
  *  For performance, the specification of MprBuf is deliberately exposed. All members of MprBuf are implicitly public.
  *  However, it is still recommended that wherever possible, you use the accessor routines provided.
+ *  \n\n
+ *  Buffers can be switched to ring mode via #mprSetBufRing. Ring buffers wrap reads and writes at the end of the 
+ *  buffer rather than moving data to the front, so the data may be in two pieces. In ring mode, mprGetBufStart and
+ *  mprGetBufEnd with mprGetBufSpace address only the first contiguous piece. Use mprGetBufVector, 
+ *  mprGetBufSpaceVector or the block get and put routines, which handle the wrap.
  *  @stability Evolving.
  *  @see MprBuf, mprCreateBuf, mprSetBufMax, mprStealBuf, mprAdjustBufStart, mprAdjustBufEnd, mprCopyBufDown,
  *      mprFlushBuf, mprGetCharFromBuf, mprGetBlockFromBuf, mprGetBufLength, mprGetBufOrigin, mprGetBufSize,
  *      mprGetBufEnd, mprGetBufSpace, mprGetGrowBuf, mprGrowBuf, mprInsertCharToBuf,
  *      mprLookAtNextCharInBuf, mprLookAtLastCharInBuf, mprPutCharToBuf, mprPutBlockToBuf, mprPutIntToBuf,
- *      mprPutStringToBuf, mprPutFmtToBuf, mprRefillBuf, mprResetBufIfEmpty, mprSetBufSize, mprGetBufRefillProc,
- *      mprSetBufRefillProc, mprFree, MprBufProc
+ *      mprPutStringToBuf, mprPutFmtToBuf, mprPutFormatToBuf, mprRefillBuf, mprResetBufIfEmpty, mprSetBufSize,
+ *      mprGetBufRefillProc, mprSetBufRefillProc, mprSetBufRing, mprGetBufVector, mprGetBufSpaceVector,
+ *      mprGetBufPoolStats, mprFree, 
+ *      MprBufProc
  *  @defgroup MprBuf MprBuf
  */
 typedef struct MprBuf {
@@ -621,8 +777,12 @@ typedef struct MprBuf {
     int             growBy;             /**< Next growth increment to use */
     MprBufProc      refillProc;         /**< Auto-refill procedure */
     void            *refillArg;         /**< Refill arg */
+    int             flags;              /**< Buffer mode flags */
 } MprBuf;
 
+#define MPR_BUF_RING        0x1         /**< Reads and writes wrap at the end of the buffer */
+#define MPR_BUF_POOLED      0x2         /**< Buffer storage is owned by the buffer pool */
+
 
 /**
  *  Create a new buffer
@@ -873,14 +1033,27 @@ extern int mprPutStringToBuf(MprBuf *buf, cchar *str);
 /**
  *  Put a formatted string to the buffer.
  *  @description Format a string and Append to the buffer at the end position and increment the end pointer.
+ *      The string is formatted directly into the free space of the buffer which is grown as required. Output that
+ *      would exceed the maximum buffer size is truncated.
  *  @param buf Buffer created via mprCreateBuf
  *  @param fmt Printf style format string
  *  @param ... Variable arguments for the format string
- *  @returns Zero if successful and otherwise a negative error code 
+ *  @returns Count of bytes written to the buffer
  *  @ingroup MprBuf
  */
 extern int mprPutFmtToBuf(MprBuf *buf, cchar *fmt, ...);
 
+/**
+ *  Put a formatted string to the buffer using a compiled format.
+ *  @description Like #mprPutFmtToBuf but formats using a format compiled by #mprCompileFormat or #mprGetFormat.
+ *  @param buf Buffer created via mprCreateBuf
+ *  @param format Compiled format
+ *  @param ... Variable arguments for the format
+ *  @returns Count of bytes written to the buffer
+ *  @ingroup MprBuf
+ */
+extern int mprPutFormatToBuf(MprBuf *buf, MprFormat *format, ...);
+
 /**
  *  Refill the buffer with data
  *  @description Refill the buffer by calling the refill procedure specified via #mprSetBufRefillProc
@@ -934,6 +1107,235 @@ extern MprBufProc mprGetBufRefillProc(MprBuf *buf);
  */
 extern void mprSetBufRefillProc(MprBuf *buf, MprBufProc fn, void *arg);
 
+/*
+ *  Vectored write array
+ */
+typedef struct MprIOVec {
+    char            *start;
+    size_t          len;
+} MprIOVec;
+
+/**
+ *  Set ring mode
+ *  @description Switch a buffer into or out of ring mode. In ring mode, data wraps at the end of the buffer instead
+ *      of being compacted to the front and one byte of the buffer is always left unused. Leaving ring mode makes
+ *      the data contiguous again.
+ *  @param buf Buffer created via mprCreateBuf
+ *  @param enable Set to true to enable ring mode
+ *  @returns Zero if successful and otherwise a negative error code 
+ *  @ingroup MprBuf
+ */
+extern int mprSetBufRing(MprBuf *buf, bool enable);
+
+/**
+ *  Get the buffer data as an I/O vector
+ *  @description Describe the buffer data without copying it. A wrapped ring buffer has two segments. Use 
+ *      mprAdjustBufStart to remove data after it has been written, for example by #mprWriteSocketVector.
+ *  @param buf Buffer created via mprCreateBuf
+ *  @param iovec Vector of at least two entries to fill
+ *  @returns Count of entries filled: 0, 1 or 2.
+ *  @ingroup MprBuf
+ */
+extern int mprGetBufVector(MprBuf *buf, MprIOVec *iovec);
+
+/**
+ *  Get the buffer free space as an I/O vector
+ *  @description Describe the free space for a scatter read. Ring buffers may have space both after the end pointer
+ *      and at the front of the buffer. Use mprAdjustBufEnd with the total count read to add the data.
+ *  @param buf Buffer created via mprCreateBuf
+ *  @param iovec Vector of at least two entries to fill
+ *  @returns Count of entries filled: 0, 1 or 2.
+ *  @ingroup MprBuf
+ */
+extern int mprGetBufSpaceVector(MprBuf *buf, MprIOVec *iovec);
+
+/**
+ *  Buffer pool statistics
+ *  @description Buffers between MPR_BUF_POOL_MIN and MPR_BUF_POOL_MAX bytes are rounded up to a power of two size
+ *      class and their storage is drawn from and returned to a process-wide pool. Each thread keeps a small cache
+ *      of free blocks in front of the pool so most requests take no lock. Free storage is limited to 
+ *      MPR_BUF_POOL_RETAIN bytes per size class in the pool and MPR_BUF_CACHE_RETAIN bytes per size class in each 
+ *      thread cache. Blocks beyond the limits are freed.
+ *  @see mprGetBufPoolStats
+ *  @ingroup MprBuf
+ */
+typedef struct MprBufPoolStats {
+    int64           hits;               /**< Storage requests satisfied from the pool or a thread cache */
+    int64           misses;             /**< Storage requests that had to allocate */
+    int64           releases;           /**< Blocks returned for reuse */
+    int64           discards;           /**< Blocks freed because the pool was at its retention limit */
+    int64           retained;           /**< Bytes of free storage currently held */
+} MprBufPoolStats;
+
+extern struct MprBufPool *mprCreateBufPool(MprCtx ctx);
+
+/**
+ *  Get buffer pool statistics
+ *  @description Return the pool hit, miss and retention statistics including those of all thread caches.
+ *  @param ctx Any memory context allocated by the MPR
+ *  @param stats Statistics structure to fill
+ *  @ingroup MprBuf
+ */
+extern void mprGetBufPoolStats(MprCtx ctx, MprBufPoolStats *stats);
+
+/**
+ *  Buffer chain segment
+ *  @description Fixed size block of chain storage. The segment data immediately follows this header.
+ *  @ingroup MprBufChain
+ */
+typedef struct MprBufSegment {
+    struct MprBufSegment *next;         /**< Next segment in the chain */
+    char            *start;             /**< Pointer to next data char */
+    char            *end;               /**< Pointer one past the last data char */
+    char            *endbuf;            /**< Pointer one past the end of the segment */
+} MprBufSegment;
+
+/**
+ *  Segmented Buffer Module
+ *  @description MprBufChain is a queue of bytes stored in a list of fixed size segments. Unlike MprBuf, appending
+ *      data never reallocates or copies existing content, so large payloads grow in constant time per segment and
+ *      need no more than one spare segment of extra memory. The content is not contiguous. Use 
+ *      #mprGetBufChainVector to export it for scatter/gather I/O or #mprGetBufChainString to flatten it.
+ *  @stability Prototype.
+ *  @see MprBufChain, mprCreateBufChain, mprPutBlockToBufChain, mprPutStringToBufChain, mprGetBlockFromBufChain,
+ *      mprPeekBufChain, mprAdjustBufChainStart, mprReserveBufChain, mprAdjustBufChainEnd, mprGetBufChainLength,
+ *      mprGetBufChainVector, mprGetBufChainString, mprFlushBufChain, mprWriteSocketChain, mprFree
+ *  @defgroup MprBufChain MprBufChain
+ */
+typedef struct MprBufChain {
+    MprBufSegment   *first;             /**< Segment holding the next data to read */
+    MprBufSegment   *last;              /**< Segment receiving appended data */
+    MprBufSegment   *spare;             /**< Consumed segment kept for reuse */
+    int             segmentSize;        /**< Data size of each segment */
+    int             length;             /**< Total data bytes in the chain */
+    int             maxsize;            /**< Max data bytes the chain may hold. -1 means no limit */
+} MprBufChain;
+
+/**
+ *  Create a buffer chain
+ *  @description Create an empty buffer chain. Storage is allocated a segment at a time as data is added. 
+ *      Use mprFree to free the chain and all its segments.
+ *  @param ctx Any memory context allocated by the MPR
+ *  @param segmentSize Size of each segment. Set to zero to use MPR_BUFSIZE.
+ *  @param maxSize Maximum number of bytes the chain can hold. Set to -1 for no limit.
+ *  @return A new buffer chain
+ *  @ingroup MprBufChain
+ */
+extern MprBufChain *mprCreateBufChain(MprCtx ctx, int segmentSize, int maxSize);
+
+/**
+ *  Put a block to a buffer chain
+ *  @description Append a block of data to the chain, adding segments as required.
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @param data Block to append
+ *  @param size Size of the block
+ *  @return Count of bytes appended. This will be less than size if the chain is full or memory can't be allocated.
+ *  @ingroup MprBufChain
+ */
+extern int mprPutBlockToBufChain(MprBufChain *chain, cchar *data, int size);
+
+/**
+ *  Put a string to a buffer chain
+ *  @description Append a string to the chain. The trailing null is not added.
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @param str String to append
+ *  @return Count of bytes appended.
+ *  @ingroup MprBufChain
+ */
+extern int mprPutStringToBufChain(MprBufChain *chain, cchar *str);
+
+/**
+ *  Get a block from a buffer chain
+ *  @description Copy data from the front of the chain and remove it from the chain.
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @param buf Destination for the data
+ *  @param size Size of the destination
+ *  @return Count of bytes copied.
+ *  @ingroup MprBufChain
+ */
+extern int mprGetBlockFromBufChain(MprBufChain *chain, char *buf, int size);
+
+/**
+ *  Peek at the start of a buffer chain
+ *  @description Copy data from the front of the chain without removing it.
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @param buf Destination for the data
+ *  @param size Size of the destination
+ *  @return Count of bytes copied.
+ *  @ingroup MprBufChain
+ */
+extern int mprPeekBufChain(MprBufChain *chain, char *buf, int size);
+
+/**
+ *  Remove data from the start of a buffer chain
+ *  @description Discard data from the front of the chain. Use this after writing data exported by 
+ *      #mprGetBufChainVector. Emptied segments are released.
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @param size Count of bytes to remove.
+ *  @ingroup MprBufChain
+ */
+extern void mprAdjustBufChainStart(MprBufChain *chain, int size);
+
+/**
+ *  Reserve space at the end of a buffer chain
+ *  @description Return contiguous free space at the end of the chain, adding a segment if the last segment is full.
+ *      This lets callers read directly into the chain without an intermediate copy. Call #mprAdjustBufChainEnd
+ *      to add the bytes written to the chain.
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @param end Set to the start of the free space
+ *  @return Count of free bytes at *end. Returns a negative MPR error code if the chain is full or memory can't
+ *      be allocated.
+ *  @ingroup MprBufChain
+ */
+extern int mprReserveBufChain(MprBufChain *chain, char **end);
+
+/**
+ *  Add reserved space to a buffer chain
+ *  @description Add bytes written into space returned by #mprReserveBufChain to the chain.
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @param size Count of bytes written. Must not exceed the space reserved.
+ *  @ingroup MprBufChain
+ */
+extern void mprAdjustBufChainEnd(MprBufChain *chain, int size);
+
+/**
+ *  Get the buffer chain length
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @return Count of data bytes in the chain
+ *  @ingroup MprBufChain
+ */
+extern int mprGetBufChainLength(MprBufChain *chain);
+
+/**
+ *  Export a buffer chain as an I/O vector
+ *  @description Describe the chain content with one vector entry per segment, suitable for #mprWriteSocketVector.
+ *      The chain is not modified.
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @param iovec Vector to fill
+ *  @param count Maximum number of entries to fill
+ *  @return Count of entries filled
+ *  @ingroup MprBufChain
+ */
+extern int mprGetBufChainVector(MprBufChain *chain, MprIOVec *iovec, int count);
+
+/**
+ *  Flatten a buffer chain into a string
+ *  @description Copy the chain content into a single null terminated block. The chain is not modified.
+ *  @param ctx Any memory context allocated by the MPR
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @return An allocated string. Caller must free.
+ *  @ingroup MprBufChain
+ */
+extern char *mprGetBufChainString(MprCtx ctx, MprBufChain *chain);
+
+/**
+ *  Flush a buffer chain
+ *  @description Discard all data in the chain.
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @ingroup MprBufChain
+ */
+extern void mprFlushBufChain(MprBufChain *chain);
+
 /******************************** Date and Time Service ***********************/
 /*
  *  Format a date according to RFC822: (Fri, 07 Jan 2003 12:12:21 PDT)
@@ -1112,7 +1514,7 @@ extern int mprGetTimeZoneOffset(MprCtx ctx, MprTime when);
  *  @stability Evolving.
  *  @see MprList, mprAddItem, mprGetItem, mprCreateList, mprClearList, mprLookupItem, mprFree, 
  *      mprGetFirstItem, mprGetListCapacity, mprGetListCount, mprGetNextItem, mprGetPrevItem, 
- *      mprRemoveItem, mprRemoveItemByIndex, mprRemoveRangeOfItems, mprAppendList, mprSortList, 
+ *      mprRemoveItem, mprRemoveItemByIndex, mprRemoveRangeOfItems, mprAppendList, mprSortList, mprParallelSortList,
  *      mprDupList, MprListCompareProc, mprFree, mprCreateKeyPair
  *  @defgroup MprList MprList
  */
@@ -1374,12 +1776,32 @@ extern int mprSetListLimits(MprList *list, int initialSize, int maxSize);
 
 /**
  *  Sort a list
- *  @description Sort a list using the sort ordering dictated by the supplied compare function.
+ *  @description Sort a list using the sort ordering dictated by the supplied compare function. The sort is stable:
+ *      items that compare equal keep their relative order.
  *  @param list List pointer returned from mprCreateList.
  *  @param compare Comparison function. If null, then a default string comparison is used.
+ *  @return Zero if successful, otherwise a negative MPR error code.
  *  @ingroup MprList
  */
-extern void mprSortList(MprList *list, MprListCompareProc compare);
+extern int mprSortList(MprList *list, MprListCompareProc compare);
+
+/**
+ *  Sort a list using the worker pool
+ *  @description Sort a list like #mprSortList but divide the work over the available CPUs. Lists shorter than 
+ *      MPR_SORT_PARALLEL_MIN are sorted by the calling thread. The sort is stable. The compare function is called
+ *      concurrently from several threads and must not modify shared state.
+ *  @param list List pointer returned from mprCreateList.
+ *  @param compare Comparison function. If null, then a default string comparison is used.
+ *  @return Zero if successful, otherwise a negative MPR error code.
+ *  @ingroup MprList
+ */
+extern int mprParallelSortList(MprList *list, MprListCompareProc compare);
+
+/*
+ *  Internal. Sort over numCpu CPUs if the list has at least minLength items. The unit tests use this to exercise 
+ *  the parallel merge on single CPU systems.
+ */
+extern int mprSortListInParallel(MprList *list, MprListCompareProc compare, int minLength, int numCpu);
 
 /**
  *  Key value pairs for use with MprList or MprHash
@@ -1401,6 +1823,219 @@ typedef struct MprKeyValue {
  */
 extern MprKeyValue *mprCreateKeyPair(MprCtx ctx, cchar *key, cchar *value);
 
+/**
+ *  Intrusive list link
+ *  @description An MprLink is embedded in each item stored on an MprLinkList. Because the links live in the items,
+ *      items can be appended and removed in constant time without searching or allocating memory. An item can be
+ *      on as many link lists as it has embedded links. Use #mprGetLinkItem to convert a link back to its item.
+ *  @stability Evolving.
+ *  @see MprLinkList, mprInitLinkList, mprAppendLink, mprPrependLink, mprRemoveLink, mprGetFirstLink,
+ *      mprGetLastLink, mprGetNextLink, mprGetPrevLink, mprGetLinkItem, mprGetLinkCount, mprIsLinked
+ *  @defgroup MprLinkList MprLinkList
+ */
+typedef struct MprLink {
+    struct MprLink  *next;              /**< Next link. Null if not on a list */
+    struct MprLink  *prev;              /**< Previous link */
+} MprLink;
+
+/**
+ *  Intrusive list head
+ *  @description The list is circular through the head link so empty lists point to themselves. Link lists are
+ *      typically embedded in their owning object and must be initialized via #mprInitLinkList before use.
+ *  @ingroup MprLinkList
+ */
+typedef struct MprLinkList {
+    MprLink         head;               /**< List head. Not an item */
+    int             length;             /**< Count of linked items */
+} MprLinkList;
+
+/**
+ *  Get the item containing a link
+ *  @param link Link pointer
+ *  @param type Type of the item containing the link
+ *  @param field Name of the link field in the item type
+ *  @return Returns a pointer to the item
+ *  @ingroup MprLinkList
+ */
+#define mprGetLinkItem(link, type, field) ((type*) (((char*) (link)) - offsetof(type, field)))
+
+/**
+ *  Get the number of items on a link list
+ *  @param list Link list
+ *  @return Returns the count of items
+ *  @ingroup MprLinkList
+ */
+#define mprGetLinkCount(list) ((list)->length)
+
+/**
+ *  Test if a link is on a list
+ *  @param link Link pointer
+ *  @return Returns true if the link is on a list
+ *  @ingroup MprLinkList
+ */
+#define mprIsLinked(link) ((link)->next != 0)
+
+/**
+ *  Initialize a link list
+ *  @param list Link list to initialize
+ *  @ingroup MprLinkList
+ */
+extern void mprInitLinkList(MprLinkList *list);
+
+/**
+ *  Append a link to the end of a list
+ *  @param list Link list
+ *  @param link Link to add. The link must not already be on a list.
+ *  @ingroup MprLinkList
+ */
+extern void mprAppendLink(MprLinkList *list, MprLink *link);
+
+/**
+ *  Prepend a link to the front of a list
+ *  @param list Link list
+ *  @param link Link to add. The link must not already be on a list.
+ *  @ingroup MprLinkList
+ */
+extern void mprPrependLink(MprLinkList *list, MprLink *link);
+
+/**
+ *  Remove a link from a list
+ *  @description Remove the link in constant time. It is safe to call this for a link that is not on the list.
+ *  @param list Link list containing the link
+ *  @param link Link to remove
+ *  @ingroup MprLinkList
+ */
+extern void mprRemoveLink(MprLinkList *list, MprLink *link);
+
+/**
+ *  Get the first link on a list
+ *  @param list Link list
+ *  @return Returns the first link or null if the list is empty
+ *  @ingroup MprLinkList
+ */
+extern MprLink *mprGetFirstLink(MprLinkList *list);
+
+/**
+ *  Get the last link on a list
+ *  @param list Link list
+ *  @return Returns the last link or null if the list is empty
+ *  @ingroup MprLinkList
+ */
+extern MprLink *mprGetLastLink(MprLinkList *list);
+
+/**
+ *  Get the next link on a list
+ *  @description To remove the current link while walking, get the next link before removing.
+ *  @param list Link list
+ *  @param link Current link
+ *  @return Returns the next link or null at the end of the list
+ *  @ingroup MprLinkList
+ */
+extern MprLink *mprGetNextLink(MprLinkList *list, MprLink *link);
+
+/**
+ *  Get the previous link on a list
+ *  @param list Link list
+ *  @param link Current link
+ *  @return Returns the previous link or null at the start of the list
+ *  @ingroup MprLinkList
+ */
+extern MprLink *mprGetPrevLink(MprLinkList *list, MprLink *link);
+
+/********************************** Queue Service *****************************/
+/**
+ *  Lock-free queues
+ *  @description MprQueue provides queues that can be shared between threads without locking. A bounded queue is a
+ *      fixed size ring that supports any number of producer and consumer threads. Use #mprEnqueue and #mprDequeue
+ *      with bounded queues. An unbounded queue supports any number of producer threads but only one consumer thread.
+ *      Items on unbounded queues embed an MprQueueLink. Use #mprEnqueueLink and #mprDequeueLink with unbounded
+ *      queues and #mprGetLinkItem to convert a dequeued link back to its item.
+ *  @stability Evolving.
+ *  @see MprQueue, MprQueueLink, mprCreateQueue, mprEnqueue, mprDequeue, mprEnqueueLink, mprDequeueLink,
+ *      mprGetQueueCount, mprFree
+ *  @defgroup MprQueue MprQueue
+ */
+typedef struct MprQueueLink {
+    struct MprQueueLink * volatile next;    /**< Next queued link */
+} MprQueueLink;
+
+/*
+ *  Bounded queue ring cell. The sequence number says whether the cell is ready to be written or read for a given lap.
+ */
+typedef struct MprQueueCell {
+    volatile int    seq;                    /**< Cell sequence number */
+    void            *data;                  /**< Queued item */
+} MprQueueCell;
+
+typedef struct MprQueue {
+    MprQueueCell    *cells;                 /**< Ring cells for bounded queues. Null if unbounded */
+    int             mask;                   /**< Ring size - 1 */
+    char            pad1[MPR_CACHE_LINE];
+    volatile int    enqueuePos;             /**< Next bounded enqueue position. Written by producers */
+    char            pad2[MPR_CACHE_LINE];
+    volatile int    dequeuePos;             /**< Next bounded dequeue position. Written by consumers */
+    char            pad3[MPR_CACHE_LINE];
+    MprQueueLink * volatile head;           /**< Most recently enqueued link. Written by producers */
+    char            pad4[MPR_CACHE_LINE];
+    MprQueueLink    *tail;                  /**< Next link to dequeue. Written by the consumer */
+    MprQueueLink    stub;                   /**< Placeholder link so the unbounded queue is never empty */
+} MprQueue;
+
+/**
+ *  Create a queue
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param size Capacity for a bounded multiple producer, multiple consumer queue. This is rounded up to a power of
+ *      two. Set to zero to create an unbounded multiple producer, single consumer queue.
+ *  @returns The queue or null if memory can't be allocated or if the size is too large for one allocation.
+ *  @ingroup MprQueue
+ */
+extern MprQueue *mprCreateQueue(MprCtx ctx, int size);
+
+/**
+ *  Add an item to a bounded queue
+ *  @param q Queue created with a non-zero size
+ *  @param item Item to add
+ *  @returns Zero if successful. Returns MPR_ERR_WONT_FIT if the queue is full.
+ *  @ingroup MprQueue
+ */
+extern int mprEnqueue(MprQueue *q, cvoid *item);
+
+/**
+ *  Remove the oldest item from a bounded queue
+ *  @param q Queue created with a non-zero size
+ *  @returns The item or null if the queue is empty
+ *  @ingroup MprQueue
+ */
+extern void *mprDequeue(MprQueue *q);
+
+/**
+ *  Add a link to an unbounded queue
+ *  @description This never blocks or fails. The link must not already be on a queue.
+ *  @param q Queue created with a zero size
+ *  @param link Link embedded in the item to add
+ *  @ingroup MprQueue
+ */
+extern void mprEnqueueLink(MprQueue *q, MprQueueLink *link);
+
+/**
+ *  Remove the oldest link from an unbounded queue
+ *  @description Only one thread may dequeue from an unbounded queue at a time.
+ *  @param q Queue created with a zero size
+ *  @returns The link or null if the queue is empty. A link that is part way through being enqueued by another
+ *      thread is not yet visible.
+ *  @ingroup MprQueue
+ */
+extern MprQueueLink *mprDequeueLink(MprQueue *q);
+
+/**
+ *  Get the number of items on a bounded queue
+ *  @description The count is a snapshot and may be stale by the time it is returned.
+ *  @param q Queue created with a non-zero size
+ *  @returns The count of queued items
+ *  @ingroup MprQueue
+ */
+extern int mprGetQueueCount(MprQueue *q);
+
 /********************************* Logging Services ***************************/
 /**
  *  Logging Services
@@ -1494,6 +2129,23 @@ extern void mprMemoryError(MprCtx ctx, cchar *fmt, ...);
  */
 extern void mprLog(MprCtx ctx, int level, cchar *fmt, ...);
 
+/**
+ *  Write a message to the diagnostic log file using a compiled format
+ *  @description Like #mprLog but formats using a format compiled by #mprCompileFormat or #mprGetFormat. Use this
+ *      for messages logged on hot paths. Keep the compiled format in a static call site cache so the format is
+ *      parsed only once:
+ *  \n\n
+ *      static MprFormat *readFormat;
+ *  \n
+ *      mprLogFormat(ctx, 5, mprGetFormat(ctx, &readFormat, "Read %d bytes"), nbytes);
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param level Logging level for this message. The level is 0-9 with zero being the most verbose.
+ *  @param format Compiled format. If null, nothing is logged.
+ *  @param ... Variable number of arguments for the format
+ *  @ingroup MprLog
+ */
+extern void mprLogFormat(MprCtx ctx, int level, MprFormat *format, ...);
+
 /**
  *  Write a raw log message to the diagnostic log file.
  *  @description Send a raw message to the MPR logging subsystem. Raw messages do not have any application prefix
@@ -1557,24 +2209,49 @@ typedef struct MprHash {
     char            *key;               /**< Hash key */
     cvoid           *data;              /**< Pointer to symbol data */
     int             bucket;             /**< Hash bucket index */
+    uint            hash;               /**< Full hash code of the key */
+    struct MprHash  *nextOrder;         /**< Next entry in insertion order (ordered tables only) */
+    struct MprHash  *prevOrder;         /**< Previous entry in insertion order (ordered tables only) */
 } MprHash;
 
 
-#define MPR_HASH_CASELESS 0x1
+#define MPR_HASH_CASELESS   0x1             /**< Keys are compared ignoring ASCII case */
+#define MPR_HASH_FLAT       0x2             /**< Open addressing table created via mprCreateFlatHash */
+#define MPR_HASH_BORROWED_KEYS  0x4         /**< Keys are stored by reference and must outlive the table */
+#define MPR_HASH_INTERNED_KEYS  0x8         /**< Keys are stored in the process-wide intern pool */
+#define MPR_HASH_ORDERED        0x10        /**< Walk entries in insertion order */
+
+struct MprHashKeys;
 
 /**
  *  Hash table control structure
+ *  @description The buckets array is a power of two in size and is resized automatically to keep the load factor
+ *      (count / hashSize) between MPR_HASH_MIN_LOAD and MPR_HASH_MAX_LOAD percent. The table never shrinks below
+ *      its initial size.
  */
 typedef struct MprHashTable {
     MprHash         **buckets;          /**< Hash collision bucket table */
     int             hashSize;           /**< Size of the buckets array */
+    int             bits;               /**< Log2 of hashSize */
+    int             minSize;            /**< Initial and minimum size of the buckets array */
     int             count;              /**< Number of symbols in the table */
     int             flags;              /**< Control flags */
+    uint            seed;               /**< Hash function seed */
+    uchar           *ctrl;              /**< Flat tables: control byte per slot */
+    MprHash         *slots;             /**< Flat tables: entry per slot */
+    int             growthLeft;         /**< Flat tables: adds possible before the table must be rebuilt */
+    int             keyBytes;           /**< Flat tables: bytes of key storage used */
+    int             keyGarbage;         /**< Flat tables: bytes of key storage held by removed entries */
+    struct MprHashKeys *keys;           /**< Flat tables: key storage blocks */
+    MprHash         *head;              /**< Ordered tables: first entry in insertion order */
+    MprHash         *tail;              /**< Ordered tables: last entry in insertion order */
 } MprHashTable;
 
 /**
  *  Add a symbol value into the hash table
  *  @description Associate an arbitrary value with a string symbol key and insert into the symbol table.
+ *      For flat tables, the add invalidates all MprHash pointers previously returned for the table. See 
+ *      #mprCreateFlatHash.
  *  @param table Symbol table returned via mprCreateSymbolTable.
  *  @param key String key of the symbole entry to delete.
  *  @param ptr Arbitrary pointer to associate with the key in the table.
@@ -1609,15 +2286,93 @@ extern MprHashTable *mprCopyHash(MprCtx ctx, MprHashTable *table);
 /**
  *  Create a hash table
  *  @description Creates a hash table that can store arbitrary objects associated with string key values.
+ *      The table grows and shrinks automatically as entries are added and removed.
  *  @param ctx Any memory context allocated by the MPR.
- *  @param hashSize Size of the hash table for the symbol table. Should be a prime number.
+ *  @param hashSize Initial size of the hash table. This is rounded up to a power of two and is also the minimum
+ *      size the table will shrink to. Set to zero for the default (MPR_DEFAULT_HASH_SIZE).
  *  @return Returns a pointer to the allocated symbol table. Caller should use mprFree to dispose of the table 
  *      when complete.
  *  @ingroup MprHash
  */
 extern MprHashTable *mprCreateHash(MprCtx ctx, int hashSize);
+
+/**
+ *  Create a flat hash table
+ *  @description Creates an open addressing hash table. Flat tables support the full MprHash API and are a drop-in
+ *      replacement for tables created via mprCreateHash. They use less memory and are faster for lookup-heavy
+ *      tables, but entries are stored in the table itself and any add may rebuild the table and move them. All 
+ *      MprHash pointers previously returned for a flat table are invalidated by any add, not just by adds that 
+ *      grow the table. This differs from chained tables where an entry stays valid until it is removed. Entries 
+ *      may be removed during a walk, but not added.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param hashSize Expected number of entries. The table grows as required.
+ *  @return Returns a pointer to the allocated symbol table. Caller should use mprFree to dispose of the table 
+ *      when complete.
+ *  @ingroup MprHash
+ */
+extern MprHashTable *mprCreateFlatHash(MprCtx ctx, int hashSize);
+
+/**
+ *  Make a hash table case insensitive
+ *  @description Keys are compared and hashed ignoring ASCII case. Existing entries are rehashed.
+ *  @param table Hash table created via mprCreateHash.
+ *  @ingroup MprHash
+ */
 extern void mprSetHashCaseless(MprHashTable *table);
 
+/**
+ *  Set the hash function seed
+ *  @description Tables that hold keys supplied by an untrusted peer should use a random seed so that an attacker
+ *      cannot precompute keys that collide into one bucket. Existing entries are rehashed. The default seed is zero.
+ *  @param table Hash table created via mprCreateHash.
+ *  @param seed Seed value. Typically obtained from mprGetRandomBytes.
+ *  @ingroup MprHash
+ */
+extern void mprSetHashSeed(MprHashTable *table, uint seed);
+
+/**
+ *  Walk a hash table in insertion order
+ *  @description After this call, mprGetFirstHash and mprGetNextHash return entries in the order they were added.
+ *      The walk costs O(count) regardless of the table size. Updating the value of an existing key does not change
+ *      its position. Must be called before any entries are added. Copies of the table are also ordered.
+ *  @param table Hash table created via mprCreateHash or mprCreateFlatHash.
+ *  @ingroup MprHash
+ */
+extern void mprSetHashOrdered(MprHashTable *table);
+
+/**
+ *  Store hash keys by reference
+ *  @description By default, tables copy each key when an entry is added. After this call, the table stores the
+ *      caller's key pointer instead. Use this for static string tables and for keys that live in a buffer that
+ *      outlives the table. Must be called before any entries are added. Copies of the table made via mprCopyHash
+ *      copy their keys.
+ *  @param table Hash table created via mprCreateHash or mprCreateFlatHash.
+ *  @ingroup MprHash
+ */
+extern void mprSetHashBorrowedKeys(MprHashTable *table);
+
+/**
+ *  Store hash keys in the intern pool
+ *  @description After this call, keys are stored via #mprIntern so repeated keys across tables share one copy.
+ *      Lookups with an interned key match by pointer without a string compare. Must be called before any
+ *      entries are added.
+ *  @param table Hash table created via mprCreateHash or mprCreateFlatHash.
+ *  @ingroup MprHash
+ */
+extern void mprSetHashInternedKeys(MprHashTable *table);
+
+/**
+ *  Intern a string
+ *  @description Return the canonical copy of a string from the process-wide intern pool, adding it if required.
+ *      Equal strings intern to the same pointer, so interned strings can be compared with ==. Interned strings
+ *      are never freed before the Mpr. This routine is thread-safe.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param str String to intern.
+ *  @return The interned copy of the string or null if memory cannot be allocated.
+ *  @ingroup MprHash
+ */
+extern cchar *mprIntern(MprCtx ctx, cchar *str);
+
 /**
  *  Return the first symbol in a symbol entry
  *  @description Prepares for walking the contents of a symbol table by returning the first entry in the symbol table.
@@ -1632,7 +2387,9 @@ extern MprHash *mprGetFirstHash(MprHashTable *table);
  *  @description Continues walking the contents of a symbol table by returning
  *      the next entry in the symbol table. A previous call to mprGetFirstSymbol
  *      or mprGetNextSymbol is required to supply the value of the \a last
- *      argument.
+ *      argument. The walk remains valid if entries are added or removed (other than \a last) during the walk and
+ *      the table is resized as a result. Entries present for the whole walk are returned exactly once. Entries
+ *      added during the walk may or may not be returned.
  *  @param table Symbol table returned via mprCreateSymbolTable.
  *  @param last Symbol table entry returned via mprGetFirstSymbol or mprGetNextSymbol.
  *  @return Pointer to the first entry in the symbol table.
@@ -1679,6 +2436,146 @@ extern MprHash *mprLookupHashEntry(MprHashTable *table, cchar *key);
  */
 extern int mprRemoveHash(MprHashTable *table, cchar *key);
 
+/**
+ *  Hash a string
+ *  @description Compute the hash used by MPR hash tables. The result is the same on all hosts so it may be used for
+ *      tables generated at build time.
+ *  @param str String to hash.
+ *  @param seed Hash seed.
+ *  @return A 32 bit hash code.
+ *  @ingroup MprHash
+ */
+extern uint mprHashString(cchar *str, uint seed);
+
+/**
+ *  Lookup a key in a perfect hash table
+ *  @description Perfect hash tables are generated at build time by the makehash utility. Each key in the
+ *      generated set maps to a unique slot with a single probe.
+ *  @param seeds Seed table generated by makehash.
+ *  @param size Number of entries in the generated table.
+ *  @param key Key to lookup.
+ *  @return The slot index for the key. Keys outside the generated set also map to a slot, so the caller must 
+ *      compare the key stored at the slot.
+ *  @ingroup MprHash
+ */
+extern int mprLookupPerfectHash(const short *seeds, int size, cchar *key);
+
+/*
+ *  Internal
+ */
+extern uint mprHashKey(MprHashTable *table, cchar *key);
+extern MprHash *mprAddFlatHash(MprHashTable *table, cchar *key, cvoid *ptr, int duplicate);
+extern MprHash *mprLookupFlatHash(MprHashTable *table, cchar *key, uint hash);
+extern int mprRemoveFlatHash(MprHashTable *table, cchar *key);
+extern MprHash *mprGetNextFlatHash(MprHashTable *table, MprHash *last);
+extern int mprRehashFlatHash(MprHashTable *table);
+extern void mprLinkHashOrder(MprHashTable *table, MprHash *sp);
+extern void mprUnlinkHashOrder(MprHashTable *table, MprHash *sp);
+
+/************************** Concurrent Hash Table Service ********************/
+/**
+ *  Concurrent hash table
+ *  @description A thread-safe hash table for caches shared by many threads. Entries are divided over a number of
+ *      stripes, each a separate MprHashTable with its own lock, so threads using different keys rarely contend.
+ *      Lookups return the value rather than the hash entry. Keys are always copied.
+ *  @see mprCreateConcurrentHash, mprAddConcurrentHash, mprLookupConcurrentHash, mprRemoveConcurrentHash,
+ *      mprCasConcurrentHash, mprWalkConcurrentHash, mprGetConcurrentHashCount
+ *  @stability Prototype.
+ *  @defgroup MprConcurrentHash MprConcurrentHash
+ */
+typedef struct MprHashStripe {
+    MprHashTable    *table;             /**< Entries for this stripe */
+#if BLD_FEATURE_MULTITHREAD
+    struct MprMutex *mutex;             /**< Stripe lock */
+#endif
+} MprHashStripe;
+
+typedef struct MprConcurrentHash {
+    MprHashStripe   *stripes;           /**< Stripe array */
+    int             stripeMask;         /**< Number of stripes less one */
+} MprConcurrentHash;
+
+/**
+ *  Callback for mprWalkConcurrentHash
+ *  @param data Data supplied to mprWalkConcurrentHash
+ *  @param key Entry key
+ *  @param value Entry value
+ *  @return True to remove the entry
+ *  @ingroup MprConcurrentHash
+ */
+typedef bool (*MprConcurrentHashProc)(void *data, cchar *key, cvoid *value);
+
+/**
+ *  Create a concurrent hash table
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param stripes Number of lock stripes. Rounded up to a power of two. Set to zero for MPR_HASH_STRIPES.
+ *  @param flags Set to MPR_HASH_CASELESS for case insensitive keys.
+ *  @return The hash table or null if memory cannot be allocated.
+ *  @ingroup MprConcurrentHash
+ */
+extern MprConcurrentHash *mprCreateConcurrentHash(MprCtx ctx, int stripes, int flags);
+
+/**
+ *  Add or update a value
+ *  @param ch Concurrent hash created via mprCreateConcurrentHash.
+ *  @param key Key string. This is copied.
+ *  @param value Value to store.
+ *  @return Zero if successful, otherwise a negative MPR error code.
+ *  @ingroup MprConcurrentHash
+ */
+extern int mprAddConcurrentHash(MprConcurrentHash *ch, cchar *key, cvoid *value);
+
+/**
+ *  Lookup a value
+ *  @param ch Concurrent hash created via mprCreateConcurrentHash.
+ *  @param key Key string.
+ *  @return The value or null if the key is not present.
+ *  @ingroup MprConcurrentHash
+ */
+extern cvoid *mprLookupConcurrentHash(MprConcurrentHash *ch, cchar *key);
+
+/**
+ *  Remove a key
+ *  @param ch Concurrent hash created via mprCreateConcurrentHash.
+ *  @param key Key string.
+ *  @return Zero if the key was removed, otherwise MPR_ERR_NOT_FOUND.
+ *  @ingroup MprConcurrentHash
+ */
+extern int mprRemoveConcurrentHash(MprConcurrentHash *ch, cchar *key);
+
+/**
+ *  Compare and swap a value
+ *  @description Atomically replace the value for a key if the current value equals \a expected. An expected value
+ *      of null matches a missing key, in which case the key is added.
+ *  @param ch Concurrent hash created via mprCreateConcurrentHash.
+ *  @param key Key string.
+ *  @param expected Value the key must currently have.
+ *  @param value New value.
+ *  @return True if the value was updated.
+ *  @ingroup MprConcurrentHash
+ */
+extern bool mprCasConcurrentHash(MprConcurrentHash *ch, cchar *key, cvoid *expected, cvoid *value);
+
+/**
+ *  Visit every entry
+ *  @description Invoke a callback for each entry. Each stripe is locked while its entries are visited so the
+ *      callback must be brief and must not call other concurrent hash routines on the same table. The callback
+ *      may return true to remove the entry, which allows expiring cache entries in one pass.
+ *  @param ch Concurrent hash created via mprCreateConcurrentHash.
+ *  @param proc Callback procedure.
+ *  @param data Data passed to the callback.
+ *  @ingroup MprConcurrentHash
+ */
+extern void mprWalkConcurrentHash(MprConcurrentHash *ch, MprConcurrentHashProc proc, void *data);
+
+/**
+ *  Return the number of entries
+ *  @param ch Concurrent hash created via mprCreateConcurrentHash.
+ *  @return The entry count. Other threads may change the table while it is being counted.
+ *  @ingroup MprConcurrentHash
+ */
+extern int mprGetConcurrentHashCount(MprConcurrentHash *ch);
+
 /********************************** File Service ******************************/
 /*
  *  Prototypes for file system switch methods
@@ -2885,6 +3782,9 @@ typedef struct MprCond {
             struct MprMutex *mutex; /**< Thread synchronization mutex */
     #endif
     volatile int triggered;         /**< Value of the condition */
+#if BLD_FEATURE_FIBERS
+    struct MprFiber *fiber;         /**< Fiber suspended waiting on the condition */
+#endif
 } MprCond;
 
 
@@ -3144,14 +4044,49 @@ extern void mprGlobalLock(MprCtx ctx);
 extern void mprGlobalUnlock(MprCtx ctx);
 
 /****************************** Thread Service ****************************/
+/**
+ *  Thread local data storage
+ */
+typedef struct MprThreadLocal {
+#if BLD_UNIX_LIKE
+    pthread_key_t   key;                /**< Data key */
+#elif BLD_WIN_LIKE
+    DWORD           key;
+#else
+    int             dummy;              /**< Prevents asserts in memory allocation */
+#endif
+} MprThreadLocal;
+
+
+/*
+ *  Thread service
+ */
+/**
+ *  CPU affinity set
+ *  @description Bit set of CPU numbers used to pin threads to a subset of the system CPUs. Sets are manipulated
+ *      via #mprInitCpuSet, #mprAddCpuToSet, #mprRemoveCpuFromSet and #mprIsCpuInSet. The bit layout matches the
+ *      native Linux cpu mask layout.
+ *  @see mprSetThreadAffinity, mprSetWorkerAffinity, mprGetNumaCpuSet
+ *  @ingroup MprThread
+ */
+typedef struct MprCpuSet {
+    ulong           bits[MPR_MAX_CPUS / (8 * sizeof(ulong))];
+} MprCpuSet;
+
 /*
  *  Thread service
  */
 typedef struct MprThreadService {
-    MprList         *threads;           /* List of all threads */
+    MprLinkList     threads;            /* List of all threads */
     struct MprThread *mainThread;       /* Main application Mpr thread id */
+    struct MprThread *eventsThread;     /* Dedicated events thread (if running) */
     MprMutex        *mutex;             /* Multi-thread sync */
+    MprThreadLocal  *threadKey;         /* Thread local key for the current MprThread */
     int             stackSize;          /* Default thread stack size */
+    MprCpuSet       eventsAffinity;     /* Affinity to apply when the events thread starts */
+    int             eventsPinned;       /* Events thread affinity has been defined */
+    int             numaNodes;          /* Count of NUMA nodes (zero until probed) */
+    MprCpuSet       *numaCpus;          /* CPU sets for each NUMA node */
 } MprThreadService;
 
 
@@ -3186,21 +4121,16 @@ typedef struct MprThread {
     int             priority;           /**< Current priority */
     int             stackSize;          /**< Only VxWorks implements */
     int             isMain;             /**< Is the main thread */
-} MprThread;
-
-
-/**
- *  Thread local data storage
- */
-typedef struct MprThreadLocal {
-#if BLD_UNIX_LIKE
-    pthread_key_t   key;                /**< Data key */
-#elif BLD_WIN_LIKE
-    DWORD           key;
-#else
-    int             dummy;              /**< Prevents asserts in memory allocation */
+    int             osTid;              /**< Kernel task ID (Linux). Used to set affinity from other threads */
+    int             pinned;             /**< Thread is pinned to the CPUs in affinity */
+    int             numaNode;           /**< NUMA node containing all the affinity CPUs. Set to -1 if none */
+    MprCpuSet       affinity;           /**< CPUs the thread may run on when pinned */
+#if BLD_FEATURE_FIBERS
+    struct MprFiber *fiber;             /**< Fiber currently running on this thread */
 #endif
-} MprThreadLocal;
+    struct MprBufCache *bufCache;       /**< Buffer storage cached by this thread */
+    MprLink         link;               /**< Thread service list linkage */
+} MprThread;
 
 
 /**
@@ -3242,62 +4172,173 @@ extern int mprStartThread(MprThread *thread);
  *  @return Returns a string name for the thread. Caller must not free.
  *  @ingroup MprThread
  */
-extern cchar *mprGetThreadName(MprThread *thread);
+extern cchar *mprGetThreadName(MprThread *thread);
+
+/**
+ *  Get the thread priroity
+ *  @description Get the current priority for the specified thread.
+ *  @param thread Thread object returned by #mprCreateThread
+ *  @returns An integer MPR thread priority between 0 and 100 inclusive.
+ *  @ingroup MprThread
+ */
+extern int mprGetThreadPriority(MprThread *thread);
+
+/**
+ *  Set the thread priroity
+ *  @description Set the current priority for the specified thread.
+ *  @param thread Thread object returned by #mprCreateThread
+ *  @param priority Priority to associate with the thread. Mpr thread priorities are are integer values between 0 
+ *      and 100 inclusive with 50 being a normal priority. The MPR maps these priorities in a linear fashion onto 
+ *      native O/S priorites. Useful constants are: 
+ *      @li MPR_LOW_PRIORITY
+ *      @li MPR_NORMAL_PRIORITY
+ *      @li MPR_HIGH_PRIORITY
+ *  @ingroup MprThread
+ */
+extern void mprSetThreadPriority(MprThread *thread, int priority);
+
+/**
+ *  Get the currently executing thread.
+ *  @description Get the thread object for the currently executing O/S thread.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @return Returns a thread object representing the current O/S thread.
+ *  @ingroup MprThread
+ */
+extern MprThread *mprGetCurrentThread(MprCtx ctx);
+
+/**
+ *  Get the O/S thread
+ *  @description Get the O/S thread ID for the currently executing thread.
+ *  @return Returns a platform specific O/S thread ID. On Unix, this is a pthread reference. On other systems it is
+ *      a thread integer value.
+ *  @ingroup MprThread
+ */
+extern MprOsThread mprGetCurrentOsThread();
+
+/**
+ *  Set the thread priroity for the current thread.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @description Set the current priority for the specified thread.
+ *  @param priority Priority to associate with the thread. Mpr thread priorities are are integer values between 0 
+ *      and 100 inclusive with 50 being a normal priority. The MPR maps these priorities in a linear fashion onto 
+ *      native O/S priorites. Useful constants are: 
+ *      @li MPR_LOW_PRIORITY
+ *      @li MPR_NORMAL_PRIORITY
+ *      @li MPR_HIGH_PRIORITY
+ *  @ingroup MprThread
+ */
+extern void mprSetCurrentThreadPriority(MprCtx ctx, int priority);
+
+/**
+ *  Clear a CPU set
+ *  @param cpus CPU set to initialize
+ *  @ingroup MprThread
+ */
+extern void mprInitCpuSet(MprCpuSet *cpus);
+
+/**
+ *  Add a CPU to a CPU set
+ *  @param cpus CPU set to modify
+ *  @param cpu CPU number. CPUs are numbered from zero.
+ *  @ingroup MprThread
+ */
+extern void mprAddCpuToSet(MprCpuSet *cpus, int cpu);
+
+/**
+ *  Remove a CPU from a CPU set
+ *  @param cpus CPU set to modify
+ *  @param cpu CPU number. CPUs are numbered from zero.
+ *  @ingroup MprThread
+ */
+extern void mprRemoveCpuFromSet(MprCpuSet *cpus, int cpu);
+
+/**
+ *  Test if a CPU is in a CPU set
+ *  @param cpus CPU set to examine
+ *  @param cpu CPU number. CPUs are numbered from zero.
+ *  @return True if the CPU is a member of the set
+ *  @ingroup MprThread
+ */
+extern bool mprIsCpuInSet(MprCpuSet *cpus, int cpu);
+
+/**
+ *  Count the CPUs in a CPU set
+ *  @param cpus CPU set to examine
+ *  @return The number of CPUs in the set
+ *  @ingroup MprThread
+ */
+extern int mprGetCpuSetCount(MprCpuSet *cpus);
+
+/**
+ *  Get the number of CPUs in the system
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @return The count of CPUs
+ *  @ingroup MprThread
+ */
+extern int mprGetCpuCount(MprCtx ctx);
 
 /**
- *  Get the thread priroity
- *  @description Get the current priority for the specified thread.
- *  @param thread Thread object returned by #mprCreateThread
- *  @returns An integer MPR thread priority between 0 and 100 inclusive.
+ *  Get the number of NUMA nodes in the system
+ *  @description The NUMA topology is probed on first use. Systems without NUMA support report one node containing
+ *      all CPUs.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @return The count of NUMA nodes. Always at least one.
  *  @ingroup MprThread
  */
-extern int mprGetThreadPriority(MprThread *thread);
+extern int mprGetNumaNodeCount(MprCtx ctx);
 
 /**
- *  Set the thread priroity
- *  @description Set the current priority for the specified thread.
- *  @param thread Thread object returned by #mprCreateThread
- *  @param priority Priority to associate with the thread. Mpr thread priorities are are integer values between 0 
- *      and 100 inclusive with 50 being a normal priority. The MPR maps these priorities in a linear fashion onto 
- *      native O/S priorites. Useful constants are: 
- *      @li MPR_LOW_PRIORITY
- *      @li MPR_NORMAL_PRIORITY
- *      @li MPR_HIGH_PRIORITY
+ *  Get the CPUs belonging to a NUMA node
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param node NUMA node number. Nodes are numbered from zero.
+ *  @param cpus CPU set to receive the node's CPUs
+ *  @return Zero if successful, otherwise MPR_ERR_BAD_ARGS if the node does not exist.
  *  @ingroup MprThread
  */
-extern void mprSetThreadPriority(MprThread *thread, int priority);
+extern int mprGetNumaCpuSet(MprCtx ctx, int node, MprCpuSet *cpus);
 
 /**
- *  Get the currently executing thread.
- *  @description Get the thread object for the currently executing O/S thread.
+ *  Get the NUMA node the current thread is pinned to
+ *  @description A thread is considered to be on a NUMA node if all the CPUs in its affinity set belong to that node.
+ *      Virtual memory mapped via #mprMapAlloc from such a thread prefers memory local to the node.
  *  @param ctx Any memory context allocated by the MPR.
- *  @return Returns a thread object representing the current O/S thread.
+ *  @return The NUMA node number or -1 if the thread is not pinned to a single node.
  *  @ingroup MprThread
  */
-extern MprThread *mprGetCurrentThread(MprCtx ctx);
+extern int mprGetCurrentNumaNode(MprCtx ctx);
 
 /**
- *  Get the O/S thread
- *  @description Get the O/S thread ID for the currently executing thread.
- *  @return Returns a platform specific O/S thread ID. On Unix, this is a pthread reference. On other systems it is
- *      a thread integer value.
+ *  Set the CPU affinity for a thread
+ *  @description Pin a thread so that it may only run on the CPUs in the given set. This may be called before or after
+ *      the thread is started. Pinning is supported on Linux and Windows. On other systems the affinity is recorded
+ *      but not applied.
+ *  @param thread Thread object returned by #mprCreateThread or #mprGetCurrentThread
+ *  @param cpus CPU set. Set to NULL to remove any prior pinning and allow the thread to run on any CPU.
+ *  @return Zero if successful, otherwise a negative MPR error code.
  *  @ingroup MprThread
  */
-extern MprOsThread mprGetCurrentOsThread();
+extern int mprSetThreadAffinity(MprThread *thread, MprCpuSet *cpus);
 
 /**
- *  Set the thread priroity for the current thread.
+ *  Set the CPU affinity for the service thread
+ *  @description The service thread is the main application thread that created the MPR. 
  *  @param ctx Any memory context allocated by the MPR.
- *  @description Set the current priority for the specified thread.
- *  @param priority Priority to associate with the thread. Mpr thread priorities are are integer values between 0 
- *      and 100 inclusive with 50 being a normal priority. The MPR maps these priorities in a linear fashion onto 
- *      native O/S priorites. Useful constants are: 
- *      @li MPR_LOW_PRIORITY
- *      @li MPR_NORMAL_PRIORITY
- *      @li MPR_HIGH_PRIORITY
+ *  @param cpus CPU set. Set to NULL to remove any prior pinning.
+ *  @return Zero if successful, otherwise a negative MPR error code.
  *  @ingroup MprThread
  */
-extern void mprSetCurrentThreadPriority(MprCtx ctx, int priority);
+extern int mprSetServiceThreadAffinity(MprCtx ctx, MprCpuSet *cpus);
+
+/**
+ *  Set the CPU affinity for the events thread
+ *  @description The events thread is the dedicated thread created by #mprStartEventsThread. If the thread is not yet
+ *      running, the affinity is applied when it starts.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param cpus CPU set. Set to NULL to remove any prior pinning.
+ *  @return Zero if successful, otherwise a negative MPR error code.
+ *  @ingroup MprThread
+ */
+extern int mprSetEventsThreadAffinity(MprCtx ctx, MprCpuSet *cpus);
 
 /*
  *  Somewhat internal APIs
@@ -3337,6 +4378,54 @@ typedef void *MprThread;
 
 extern cchar *mprGetCurrentThreadName(MprCtx ctx);
 
+/**
+ *  Apply a full memory barrier
+ *  @description Loads and stores issued before the barrier complete before any loads and stores issued after it.
+ *      This is a no-op in single-threaded builds.
+ *  @ingroup MprSynch
+ */
+extern void mprAtomicBarrier();
+
+/**
+ *  Atomic compare and swap of a pointer
+ *  @description Store \a value at \a addr if the current contents equal \a expected. The operation is a full
+ *      memory barrier.
+ *  @param addr Address of the pointer to update
+ *  @param expected Expected current value
+ *  @param value New value to store
+ *  @returns True if the value was stored
+ *  @ingroup MprSynch
+ */
+extern bool mprAtomicCas(void * volatile *addr, cvoid *expected, cvoid *value);
+
+/**
+ *  Atomic compare and swap of an integer
+ *  @param addr Address of the integer to update
+ *  @param expected Expected current value
+ *  @param value New value to store
+ *  @returns True if the value was stored
+ *  @ingroup MprSynch
+ */
+extern bool mprAtomicCasInt(volatile int *addr, int expected, int value);
+
+/**
+ *  Atomic exchange of a pointer
+ *  @param addr Address of the pointer to update
+ *  @param value New value to store
+ *  @returns The prior value
+ *  @ingroup MprSynch
+ */
+extern void *mprAtomicExchange(void * volatile *addr, cvoid *value);
+
+/**
+ *  Atomic add to an integer
+ *  @param addr Address of the integer to update
+ *  @param value Value to add. May be negative.
+ *  @returns The updated value
+ *  @ingroup MprSynch
+ */
+extern int mprAtomicAdd(volatile int *addr, int value);
+
 /********************************* Memory *************************************/
 /*
  *  Magic number to identify blocks. Only used in debug mode.
@@ -3801,6 +4890,67 @@ extern char *mprAsprintf(MprCtx ctx, int maxSize, cchar *fmt, ...);
  */
 extern char *mprVasprintf(MprCtx ctx, int maxSize, cchar *fmt, va_list arg);
 
+/**
+ *  Compile a format string
+ *  @description Parse a printf style format string into a list of literal text and conversion specs. The compiled
+ *      format may be used any number of times with #mprAsprintfFormat, #mprSprintfFormat and #mprPutFormatToBuf.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param fmt Printf style format string. The string is copied.
+ *  @return The compiled format. Free with #mprFree.
+ *  @ingroup MprString
+ */
+extern MprFormat *mprCompileFormat(MprCtx ctx, cchar *fmt);
+
+/**
+ *  Get a compiled format from a call site cache
+ *  @description Compile the format on first use and save it in the cache. The cache should be a static variable 
+ *      initialized to null at the call site. The compiled format is owned by the Mpr and is freed when the Mpr
+ *      is terminated. Freeing the format resets the cache to null so the format is compiled again if a new Mpr is
+ *      created in the same process. This call is thread-safe.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param cache Reference to the call site cache variable
+ *  @param fmt Printf style format string. This must be the same string for every call using the cache.
+ *  @return The compiled format
+ *  @ingroup MprString
+ */
+extern MprFormat *mprGetFormat(MprCtx ctx, MprFormat **cache, cchar *fmt);
+
+/**
+ *  Format a string using a compiled format
+ *  @description Like #mprAsprintf but formats using a format compiled by #mprCompileFormat.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param maxSize Maximum size to allocate for the buffer including the trailing null.
+ *  @param format Compiled format
+ *  @param ... Variable arguments for the format
+ *  @return Returns an allocated string. Caller must free.
+ *  @ingroup MprString
+ */
+extern char *mprAsprintfFormat(MprCtx ctx, int maxSize, MprFormat *format, ...);
+
+/**
+ *  Format a string using a compiled format
+ *  @description Like #mprVasprintf but formats using a format compiled by #mprCompileFormat.
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param maxSize Maximum size to allocate for the buffer including the trailing null.
+ *  @param format Compiled format
+ *  @param arg Varargs argument obtained from va_start.
+ *  @return Returns an allocated string. Caller must free.
+ *  @ingroup MprString
+ */
+extern char *mprVasprintfFormat(MprCtx ctx, int maxSize, MprFormat *format, va_list arg);
+
+/**
+ *  Format a string into a buffer using a compiled format
+ *  @description Like #mprSprintf but formats using a format compiled by #mprCompileFormat.
+ *  @param buf Pointer to the buffer.
+ *  @param maxSize Size of the buffer.
+ *  @param format Compiled format
+ *  @param ... Variable arguments for the format
+ *  @return Returns the buffer.
+ *  @ingroup MprString
+ */
+extern char *mprSprintfFormat(char *buf, int maxSize, MprFormat *format, ...);
+
 /**
  *  Append strings to an existing string and reallocate as required.
  *  @description Append a list of strings to an existing string. The list of strings is terminated by a 
@@ -3988,11 +5138,12 @@ typedef long (*MprMsgCallback)(HWND hwnd, uint msg, uint wp, long lp);
 #endif
 
 typedef struct MprWaitService {
-    MprList         *handlers;              /* List of handlers */
+    MprLinkList     handlers;               /* List of handlers */
     int             flags;                  /* State flags */
     int             maskGeneration;         /* Generation number for mask changes */
     int             lastMaskGeneration;     /* Last generation number for mask changes */
     int             rebuildMasks;           /* IO mask rebuild required */
+    int             removals;               /* Count of handlers removed. Detects list changes while unlocked */
 
 #if LINUX || MACOSX || FREEBSD
     struct pollfd   *fds;                   /* File descriptors to poll on */
@@ -4082,8 +5233,7 @@ typedef struct MprWaitHandler {
 #endif
     MprWaitService  *waitService;       /**< Wait service pointer */
     MprWaitProc     proc;               /**< Wait handler procedure */
-    struct MprWaitHandler *next;        /**< List linkage */
-    struct MprWaitHandler *prev;
+    MprLink         link;               /**< Wait service list linkage */
 } MprWaitHandler;
 
 
@@ -4303,7 +5453,7 @@ extern int mprSetMaxSocketClients(MprCtx ctx, int max);
  *      mprWriteSocket, mprWriteSocketString, mprReadSocket, mprSetSocketCallback, mprSetSocketEventMask, 
  *      mprGetSocketBlockingMode, mprIsSocketEof, mprGetSocketFd, mprGetSocketPort, mprGetSocketBlockingMode, 
  *      mprSetSocketNoDelay, mprGetSocketError, mprParseIp, mprSendFileToSocket, mprSetSocketEof, mprIsSocketSecure
- *      mprWriteSocketVector
+ *      mprWriteSocketVector, mprWriteSocketChain
  *  @defgroup MprSocket MprSocket
  */
 typedef struct MprSocket {
@@ -4335,15 +5485,6 @@ typedef struct MprSocket {
 } MprSocket;
 
 
-/*
- *  Vectored write array
- */
-typedef struct MprIOVec {
-    char            *start;
-    size_t          len;
-} MprIOVec;
-
-
 /**
  *  Flag for mprCreateSocket to use the default SSL provider
  */ 
@@ -4609,6 +5750,17 @@ extern bool mprIsSocketSecure(MprSocket *sp);
  */
 extern int mprWriteSocketVector(MprSocket *sp, MprIOVec *iovec, int count);
 
+/**
+ *  Write a buffer chain to a socket
+ *  @description Write as much of the chain as the socket will accept using scatter/gather I/O. The data written
+ *      is removed from the chain.
+ *  @param sp Socket object returned from #mprCreateSocket
+ *  @param chain Buffer chain created via mprCreateBufChain
+ *  @return A count of bytes actually written. Return a negative MPR error code on errors.
+ *  @ingroup MprSocket
+ */
+extern int mprWriteSocketChain(MprSocket *sp, MprBufChain *chain);
+
 /**
  *  Enable socket events for a socket callback
  *  @param sp Socket object returned from #mprCreateSocket
@@ -4662,16 +5814,47 @@ extern void mprSetSocketPrebindCallback(MprCtx ctx, MprSocketPrebind callback);
 /*********************************** Worker Threads ******************************/
 #if BLD_FEATURE_MULTITHREAD
 
+/*
+ *  Task priority classes. MPR priorities map onto classes with the same boundaries used for O/S thread priorities.
+ */
+#define MPR_CLASS_BACKGROUND    0           /**< Priority <= MPR_BACKGROUND_PRIORITY */
+#define MPR_CLASS_LOW           1           /**< Priority <= MPR_LOW_PRIORITY */
+#define MPR_CLASS_NORMAL        2           /**< Priority <= MPR_NORMAL_PRIORITY */
+#define MPR_CLASS_HIGH          3           /**< Priority <= MPR_HIGH_PRIORITY */
+#define MPR_CLASS_CRITICAL      4           /**< Priority > MPR_HIGH_PRIORITY */
+#define MPR_PRIORITY_CLASSES    5
+
+/*
+ *  Worker queue policies
+ */
+#define MPR_QUEUE_STRICT        0x1         /**< Always dequeue from the highest non-empty class */
+#define MPR_QUEUE_WEIGHTED      0x2         /**< Weighted round-robin. Class N gets up to 2^N turns per round */
+
 typedef struct MprWorkerStats {
     int             maxThreads;         /* Configured max number of threads */
     int             minThreads;         /* Configured minimum */
     int             numThreads;         /* Configured minimum */
     int             maxUse;             /* Max used */
-    int             pruneHighWater;     /* Peak thread use in last minute */
+    int             pruneHighWater;     /* Peak threads since the start of this sizing period */
     int             idleThreads;        /* Current idle */
     int             busyThreads;        /* Current busy */
+    int             spareThreads;       /* Idle threads the pool keeps ready ahead of demand */
+    int             avgWait;            /* Average msec tasks waited to start in the last sizing period */
+    int             maxWait;            /* Longest msec a task waited to start in the last sizing period */
+    int             cpuLoad;            /* Process CPU load percentage over all CPUs in the last sizing period */
+    int             rejected;           /* Tasks queued or rejected for lack of a thread in the last period */
+    int             decision;           /* Last sizing decision (MPR_WORKER_GROW, MPR_WORKER_SHRINK, MPR_WORKER_HOLD) */
+    int             grown;              /* Total threads pre-spawned by sizing */
+    int             shrunk;             /* Total threads pruned by sizing */
 } MprWorkerStats;
 
+/*
+ *  Worker pool sizing decisions
+ */
+#define MPR_WORKER_HOLD         0           /* Pool size unchanged */
+#define MPR_WORKER_GROW         1           /* Spare threads increased because tasks waited to start */
+#define MPR_WORKER_SHRINK       2           /* Idle threads pruned after sustained low demand */
+
 /**
  *  Worker thread callback signature
  *  @param data worker callback data. Set via mprStartWorker or mprActivateWorker
@@ -4692,17 +5875,38 @@ typedef struct MprWorkerService {
     int             stackSize;          /* Stack size for worker threads */
     MprList         *tasks;             /* Prioritized list of pending tasks */
 
-    MprList         *busyThreads;       /* List of threads to service tasks */
-    MprList         *idleThreads;       /* List of threads to service tasks */
+    MprLinkList     busyThreads;        /* List of threads to service tasks */
+    MprLinkList     idleThreads;        /* List of threads to service tasks */
     int             maxThreads;         /* Max # threads in worker pool */
     int             maxUseThreads;      /* Max threads ever used */
     int             minThreads;         /* Max # threads in worker pool */
     MprMutex        *mutex;             /* Per task synchronization */
     int             nextThreadNum;      /* Unique next thread number */
     int             numThreads;         /* Current number of threads in worker pool */
-    int             pruneHighWater;     /* Peak thread use in last minute */
-    struct MprEvent *pruneTimer;        /* Timer for excess threads pruner */
+    int             pruneHighWater;     /* Peak threads since the start of this sizing period */
+    struct MprEvent *pruneTimer;        /* Timer for worker pool sizing runs */
     MprWorkerProc   startWorker;        /* Worker thread startup hook */
+    MprCpuSet       affinity;           /* CPUs for worker threads */
+    int             affinityMode;       /* How workers are pinned to the affinity CPUs (MPR_AFFINITY_*) */
+    int             nextAffinity;       /* Round-robin index for the next pinned worker */
+    struct MprFuture *futureHead[MPR_PRIORITY_CLASSES]; /* Per class queues of futures waiting for a worker */
+    struct MprFuture *futureTail[MPR_PRIORITY_CLASSES]; /* Tails of the future queues */
+    int             credits[MPR_PRIORITY_CLASSES];      /* Remaining weighted round-robin turns per class */
+    int             queuePolicy;        /* Dequeue policy (MPR_QUEUE_STRICT or MPR_QUEUE_WEIGHTED) */
+    int             pendingFutures;     /* Count of queued futures */
+    int             futureDrainers;     /* Workers started to drain the queue that have not yet begun */
+    int             spareThreads;       /* Target number of idle threads to pre-spawn */
+    int             starting;           /* Spare threads spawned that have not yet gone idle */
+    int             quietPeriods;       /* Consecutive sizing periods without start delays */
+    int             grown;              /* Total threads pre-spawned by sizing */
+    int             shrunk;             /* Total threads pruned by sizing */
+    MprTime         waitTotal;          /* Sum of task start waits in this sizing period */
+    int             waitCount;          /* Number of task starts in this sizing period */
+    int             maxWait;            /* Longest start wait in this sizing period */
+    int             rejected;           /* Tasks queued or rejected for lack of a thread in this period */
+    MprTime         tuneMark;           /* Start of this sizing period */
+    MprTime         cpuMark;            /* Process CPU time at the start of this sizing period */
+    MprWorkerStats  last;               /* Measurements of the last complete sizing period */
 } MprWorkerService;
 
 
@@ -4756,8 +5960,76 @@ extern void mprSetMaxWorkers(MprCtx ctx, int count);
  */
 extern int mprGetMaxWorkers(MprCtx ctx);
 
+/**
+ *  Get worker pool statistics
+ *  @description Return the current thread counts and the measurements and decision of the last pool sizing run.
+ *  @param ps Worker service object
+ *  @param stats Reference to a statistics structure to fill
+ *  @ingroup MprWorkerService
+ */
 extern void mprGetWorkerServiceStats(MprWorkerService *ps, MprWorkerStats *stats);
 
+/**
+ *  Resize the worker pool
+ *  @description The pool is sized every MPR_TIMEOUT_WORKER_TUNE msec based on how long tasks waited to start, on
+ *      rejected tasks and on the process CPU load. If tasks waited and the CPUs are not saturated, the number of spare
+ *      idle threads is doubled and spawned ahead of demand. After MPR_WORKER_SHRINK_PERIODS quiet periods, the spare
+ *      target is halved and half of the excess idle threads are pruned. This routine runs a sizing period immediately.
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @return The sizing decision: MPR_WORKER_GROW, MPR_WORKER_SHRINK or MPR_WORKER_HOLD
+ *  @ingroup MprWorkerService
+ */
+extern int mprTuneWorkers(MprCtx ctx);
+
+/*
+ *  Internal
+ */
+extern void mprRecordWorkerWait(MprWorkerService *ws, MprTime wait);
+
+/*
+ *  Worker affinity modes
+ */
+#define MPR_AFFINITY_SHARED     0x1         /**< All workers may run on any CPU in the set */
+#define MPR_AFFINITY_CPU        0x2         /**< Workers are pinned round-robin to individual CPUs in the set */
+#define MPR_AFFINITY_NODE       0x3         /**< Workers are pinned round-robin to the set CPUs of each NUMA node */
+
+/**
+ *  Set the CPU affinity for the worker thread pool
+ *  @description Pin the worker threads to the CPUs in the given set. Existing workers are re-pinned immediately and
+ *      new workers are pinned as they are created. Use #mprSetThreadAffinity on MprWorker.thread to pin an 
+ *      individual worker.
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @param cpus CPU set. Set to NULL to remove any prior pinning.
+ *  @param mode Set to MPR_AFFINITY_SHARED to let each worker run on any CPU in the set. Set to MPR_AFFINITY_CPU to
+ *      pin each worker to a single CPU taken round-robin from the set. Set to MPR_AFFINITY_NODE to pin each worker
+ *      to the CPUs of the set belonging to one NUMA node, taking nodes round-robin.
+ *  @return Zero if successful, otherwise a negative MPR error code.
+ *  @ingroup MprWorkerService
+ */
+extern int mprSetWorkerAffinity(MprCtx ctx, MprCpuSet *cpus, int mode);
+
+/**
+ *  Map an MPR priority onto a task priority class
+ *  @param priority Priority between 0 and 100. See MPR_NORMAL_PRIORITY.
+ *  @return The priority class: MPR_CLASS_BACKGROUND, MPR_CLASS_LOW, MPR_CLASS_NORMAL, MPR_CLASS_HIGH or 
+ *      MPR_CLASS_CRITICAL
+ *  @ingroup MprWorkerService
+ */
+extern int mprGetPriorityClass(int priority);
+
+/**
+ *  Set the worker queue policy
+ *  @description Futures and tasks started by #mprStartWorker that are waiting for a worker are queued by priority 
+ *      class. With MPR_QUEUE_STRICT, the highest class
+ *      is always run first and lower classes may starve under sustained load. With MPR_QUEUE_WEIGHTED (the default),
+ *      classes are served in weighted round-robin order where class N receives up to 2^N turns per round, so 
+ *      control traffic is favored without starving bulk work. Tasks within a class run in FIFO order.
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @param policy MPR_QUEUE_STRICT or MPR_QUEUE_WEIGHTED
+ *  @ingroup MprWorkerService
+ */
+extern void mprSetWorkerQueuePolicy(MprCtx ctx, int policy);
+
 /*
  *  State
  */
@@ -4784,11 +6056,40 @@ typedef struct MprWorker {
     MprThread       *thread;                /* Thread associated with this worker */
     MprWorkerService *workerService;        /* Worker service */
     MprCond         *idleCond;              /* Used to wait for work */
+    MprTime         requested;              /* When the current task was assigned. Used to measure start delay */
+    MprLink         link;                   /* Idle or busy list linkage */
 } MprWorker;
 
 extern void mprActivateWorker(MprWorker *worker, MprWorkerProc proc, void *data, int priority);
+
+/**
+ *  Start a task on a worker thread
+ *  @description Run the procedure on an idle worker or on a new worker if the pool is below its maximum. If the pool
+ *      is saturated, the task is queued by priority class with queued futures (see #mprSetWorkerQueuePolicy) and 
+ *      runs on the next worker to become free. Queued tasks only run on pool workers.
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @param proc Procedure to run. It is passed the data argument and the worker running the task.
+ *  @param data Data argument passed to the procedure
+ *  @param priority Priority between 0 and 100. Selects the O/S thread priority and the queue class.
+ *  @return Zero if the task was started or queued. Otherwise a negative MPR error code.
+ *  @ingroup MprWorkerService
+ */
 extern int mprStartWorker(MprCtx ctx, MprWorkerProc proc, void *data, int priority);
 
+/**
+ *  Start a task on a worker thread if one is free
+ *  @description Like #mprStartWorker but never queues. Use this when the caller can run the task itself and must 
+ *      not wait behind busy workers. I/O and event dispatch use this so a pool of workers blocked on I/O can't 
+ *      delay the callbacks that would unblock them.
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @param proc Procedure to run
+ *  @param data Data argument passed to the procedure
+ *  @param priority Priority between 0 and 100
+ *  @return Zero if the task was started. MPR_ERR_BUSY if no worker is available.
+ *  @ingroup MprWorkerService
+ */
+extern int mprTryStartWorker(MprCtx ctx, MprWorkerProc proc, void *data, int priority);
+
 /**
  *  Dedicate a worker thread to a current real thread. This implements thread affinity and is required on some platforms
  *      where some APIs (waitpid on uClibc) cannot be called on a different thread.
@@ -4812,6 +6113,275 @@ extern void mprReleaseWorker(MprWorker *worker);
 extern MprWorker *mprGetCurrentWorker(MprCtx ctx);
 
 #endif /* BLD_FEATURE_MULTITHREAD */
+/************************************** Futures *******************************/
+/**
+ *  Future callback signature
+ *  @param data Callback data supplied to #mprSubmitFuture or #mprThenFuture
+ *  @param arg Result of the prior future for continuations created via #mprThenFuture. Otherwise NULL.
+ *  @return The future result. Retrieve via #mprGetFutureResult.
+ */
+typedef void *(*MprFutureProc)(void *data, void *arg);
+
+/*
+ *  Future states
+ */
+#define MPR_FUTURE_DEFERRED     0x1         /* Continuation waiting for the prior future to complete */
+#define MPR_FUTURE_PENDING      0x2         /* Queued waiting for a thread */
+#define MPR_FUTURE_RUNNING      0x4         /* Procedure is running */
+#define MPR_FUTURE_COMPLETE     0x8         /* Procedure has completed and the result is available */
+
+/**
+ *  Future
+ *  @description Futures run a procedure on the worker thread pool and provide a means to wait for completion and to
+ *      retrieve the procedure result. If no worker is available, the future is queued. Queued futures are run by 
+ *      workers as they become free and by threads waiting in #mprWaitForFuture. Without multithreading, futures run
+ *      immediately when submitted.
+ *  @stability Prototype
+ *  @see mprSubmitFuture, mprThenFuture, mprWaitForFuture, mprGetFutureResult, mprIsFutureComplete, mprParallelFor
+ *  @defgroup MprFuture MprFuture
+ */
+typedef struct MprFuture {
+    MprFutureProc   proc;                   /* Procedure to run */
+    void            *data;                  /* Procedure callback data */
+    void            *arg;                   /* Prior future result for continuations */
+    void            *result;                /* Procedure result */
+    int             state;                  /* Future state (MPR_FUTURE_*) */
+    int             orphaned;               /* Freed while running. Free when complete */
+    int             priority;               /* Task priority used to select the queue class */
+    MprTime         queued;                 /* When the future was queued */
+    MprCond         *cond;                  /* Signalled when complete (or when a continuation is queued) */
+    struct MprFuture *prior;                /* Future this continuation is waiting on */
+    struct MprFuture *thens;                /* Continuations to schedule when complete */
+    struct MprFuture *nextThen;             /* Next continuation of the prior future */
+    MprWorkerProc   task;                   /* Worker procedure for tasks queued by mprStartWorker */
+    struct MprFuture *next;                 /* Worker service queue links */
+    struct MprFuture *prev;
+} MprFuture;
+
+/**
+ *  Submit a procedure to run on the worker thread pool
+ *  @description The future is started on an idle worker if one is available. Otherwise it is queued. Freeing a 
+ *      future that is queued cancels it. Freeing a running future is deferred until it completes.
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @param proc Procedure to run
+ *  @param data Data argument passed to the procedure
+ *  @return A future object. Free via mprFree when no longer needed.
+ *  @ingroup MprFuture
+ */
+extern MprFuture *mprSubmitFuture(MprCtx ctx, MprFutureProc proc, void *data);
+
+/**
+ *  Submit a procedure to run on the worker thread pool at a given priority
+ *  @description This is the same as #mprSubmitFuture except queued futures are run in the order defined by the
+ *      priority class and the worker queue policy. See #mprSetWorkerQueuePolicy. Continuations created via 
+ *      #mprThenFuture inherit the priority. The priority does not change the O/S priority of the worker thread.
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @param proc Procedure to run
+ *  @param data Data argument passed to the procedure
+ *  @param priority Priority between 0 and 100. See MPR_NORMAL_PRIORITY.
+ *  @return A future object. Free via mprFree when no longer needed.
+ *  @ingroup MprFuture
+ */
+extern MprFuture *mprSubmitPriorityFuture(MprCtx ctx, MprFutureProc proc, void *data, int priority);
+
+/**
+ *  Run a procedure when a future completes
+ *  @description Create a continuation future that runs after \a prior completes. The continuation procedure receives
+ *      the prior future result as its \a arg. The continuation is allocated using the same memory context as \a prior.
+ *  @param prior Future to continue
+ *  @param proc Procedure to run
+ *  @param data Data argument passed to the procedure
+ *  @return A future object. Free via mprFree when no longer needed.
+ *  @ingroup MprFuture
+ */
+extern MprFuture *mprThenFuture(MprFuture *prior, MprFutureProc proc, void *data);
+
+/**
+ *  Wait for a future to complete
+ *  @description While waiting, the calling thread helps by running the future itself if it is still queued, and 
+ *      then other queued futures. A future should only have one waiter.
+ *  @param future Future returned by #mprSubmitFuture or #mprThenFuture
+ *  @param timeout Time in milliseconds to wait. Set to -1 to wait forever.
+ *  @return Zero if the future is complete, otherwise MPR_ERR_TIMEOUT.
+ *  @ingroup MprFuture
+ */
+extern int mprWaitForFuture(MprFuture *future, int timeout);
+
+/**
+ *  Get the result of a completed future
+ *  @param future Future returned by #mprSubmitFuture or #mprThenFuture
+ *  @return The value returned by the future procedure. Returns NULL if the future is not complete.
+ *  @ingroup MprFuture
+ */
+extern void *mprGetFutureResult(MprFuture *future);
+
+/**
+ *  Test if a future is complete
+ *  @param future Future returned by #mprSubmitFuture or #mprThenFuture
+ *  @return True if the future procedure has completed
+ *  @ingroup MprFuture
+ */
+extern bool mprIsFutureComplete(MprFuture *future);
+
+/**
+ *  Parallel loop callback signature
+ *  @param data Callback data supplied to #mprParallelFor
+ *  @param start First index of the chunk to process
+ *  @param end One past the last index of the chunk to process
+ */
+typedef void (*MprForProc)(void *data, int start, int end);
+
+/**
+ *  Run a loop in parallel over the worker thread pool
+ *  @description The index range is divided into chunks of \a grain indices. Chunks are claimed dynamically by the 
+ *      calling thread and by helper futures on the worker pool, so the loop adapts to uneven chunk costs. The call
+ *      returns when all chunks have been processed.
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @param start First index
+ *  @param end One past the last index
+ *  @param grain Number of indices per chunk. Set to zero for a default based on the number of CPUs.
+ *  @param fn Procedure to invoke for each chunk
+ *  @param data Data argument passed to \a fn
+ *  @return Zero if successful, otherwise a negative MPR error code.
+ *  @ingroup MprFuture
+ */
+extern int mprParallelFor(MprCtx ctx, int start, int end, int grain, MprForProc fn, void *data);
+
+#if BLD_FEATURE_MULTITHREAD
+/*
+ *  Internal
+ */
+extern MprFuture *mprGetNextFuture(MprWorkerService *ws);
+extern int mprQueueWorkerTask(MprWorkerService *ws, MprWorkerProc proc, void *data, int priority);
+extern void mprRunFuture(MprFuture *future);
+#endif
+
+/************************************** Fibers ********************************/
+#if BLD_FEATURE_FIBERS
+/**
+ *  Fiber entry point signature
+ *  @param data Callback data supplied to #mprCreateFiber
+ */
+typedef void (*MprFiberProc)(void *data);
+
+/*
+ *  Fiber states
+ */
+#define MPR_FIBER_READY         0x1         /* Ready to run */
+#define MPR_FIBER_RUNNING       0x2         /* Currently running */
+#define MPR_FIBER_WAITING       0x4         /* Suspended waiting for I/O, a condition or a timeout */
+#define MPR_FIBER_COMPLETE      0x8         /* Entry procedure has returned */
+
+/**
+ *  Fiber scheduler
+ *  @description A fiber service runs fibers cooperatively on the thread that calls #mprRunFibers. Fibers are never
+ *      migrated to other threads. MPR locks are recursive, so a lock held across a suspension does not exclude 
+ *      other fibers on the same thread. Release locks before suspending.
+ *  @stability Prototype
+ *  @see mprCreateFiberService, mprCreateFiber, mprRunFibers, mprYieldFiber, mprGetCurrentFiber
+ *  @defgroup MprFiber MprFiber
+ */
+typedef struct MprFiberService {
+    ucontext_t      context;                /* Scheduler context to resume when a fiber suspends */
+    struct MprFiber *current;               /* Fiber currently running */
+    MprList         *fibers;                /* Live fibers */
+    struct pollfd   *fds;                   /* Poll set for fibers waiting on I/O */
+    int             fdsMax;                 /* Size of the fds array */
+#if BLD_FEATURE_MULTITHREAD
+    MprMutex        *mutex;                 /* Multi-thread sync for fiber wakeups */
+    int             wakeFd[2];              /* Pipe to wake the scheduler from other threads */
+    int             awake;                  /* Scheduler has been woken and the pipe holds a byte */
+#endif
+} MprFiberService;
+
+/**
+ *  Fiber
+ *  @description Fibers are lightweight user-mode threads with their own stack. When a fiber calls a blocking MPR
+ *      routine such as #mprWaitForHttp, #mprWaitForCmd or #mprWaitForCondWithService, only the fiber is suspended. 
+ *      The scheduler runs other fibers and resumes the fiber when its I/O or condition is ready, or when the wait
+ *      times out. This permits blocking-style code to serve many concurrent requests from a single thread.
+ *  @ingroup MprFiber
+ */
+typedef struct MprFiber {
+    MprFiberProc    proc;                   /* Fiber entry point */
+    void            *data;                  /* Entry point data */
+    MprFiberService *service;               /* Owning scheduler */
+    ucontext_t      context;                /* Saved fiber context */
+    char            *stack;                 /* Fiber stack */
+    int             stackSize;              /* Size of the stack */
+    int             state;                  /* Fiber state (MPR_FIBER_*) */
+    int             fd;                     /* File descriptor for I/O waits. Set to -1 if not waiting on I/O */
+    int             mask;                   /* Desired I/O events (MPR_READABLE | MPR_WRITABLE) */
+    int             events;                 /* I/O events that caused the fiber to resume */
+    MprCond         *cond;                  /* Condition the fiber is waiting on */
+    MprTime         deadline;               /* Time when the current wait expires. Zero if no timeout */
+} MprFiber;
+
+/**
+ *  Create a fiber scheduler
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @return A fiber service object. Free via mprFree. Fibers are allocated as children of the service.
+ *  @ingroup MprFiber
+ */
+extern MprFiberService *mprCreateFiberService(MprCtx ctx);
+
+/**
+ *  Create a fiber
+ *  @description The fiber is ready to run and will be started by the next call to #mprRunFibers.
+ *  @param fs Fiber service created via #mprCreateFiberService
+ *  @param proc Fiber entry point
+ *  @param data Data argument passed to the entry point
+ *  @param stackSize Size of the fiber stack. Set to zero for a default of MPR_DEFAULT_STACK.
+ *  @return A fiber object. Free via mprFree. Freeing a suspended fiber discards its stack without unwinding.
+ *  @ingroup MprFiber
+ */
+extern MprFiber *mprCreateFiber(MprFiberService *fs, MprFiberProc proc, void *data, int stackSize);
+
+/**
+ *  Run fibers
+ *  @description Run ready fibers on the calling thread until all fibers have completed or the timeout expires.
+ *      While fibers are suspended, this call waits for their I/O. If the calling thread is the service thread, 
+ *      events are also serviced.
+ *  @param fs Fiber service created via #mprCreateFiberService
+ *  @param timeout Time in milliseconds to run. Set to -1 to run until all fibers complete.
+ *  @return Zero if all fibers have completed. Returns MPR_ERR_TIMEOUT if fibers remain.
+ *  @ingroup MprFiber
+ */
+extern int mprRunFibers(MprFiberService *fs, int timeout);
+
+/**
+ *  Return the fiber running on the current thread
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @return The current fiber or NULL if not running in a fiber
+ *  @ingroup MprFiber
+ */
+extern MprFiber *mprGetCurrentFiber(MprCtx ctx);
+
+/**
+ *  Yield the current fiber
+ *  @description Suspend the current fiber and let other ready fibers run. The fiber remains ready. This call does
+ *      nothing if not running in a fiber.
+ *  @param ctx Any memory allocation context created by MprAlloc
+ *  @ingroup MprFiber
+ */
+extern void mprYieldFiber(MprCtx ctx);
+
+/**
+ *  Resume a suspended fiber
+ *  @description Mark a waiting fiber as ready and wake its scheduler. This call is thread-safe.
+ *  @param fiber Fiber to resume
+ *  @ingroup MprFiber
+ */
+extern void mprResumeFiber(MprFiber *fiber);
+
+/*
+ *  Internal
+ */
+extern int mprWaitForFiberIO(MprFiber *fiber, int fd, int mask, int timeout);
+extern int mprWaitForFiberCond(MprFiber *fiber, MprCond *cond, int timeout);
+extern void mprSleepFiber(MprFiber *fiber, int timeout);
+#endif /* BLD_FEATURE_FIBERS */
+
 /************************************** Crypt *********************************/
 /**
  *  Deocde buffer using base-46 encoding.
@@ -5009,10 +6579,10 @@ extern char *mprValidateUrl(MprCtx ctx, char *url);
  *  Overall HTTP service
  */
 typedef struct MprHttpService {
-    MprHashTable    *codes;                                 /* Http response code hash */
-    MprList         *connections;                           /* Http connections */
+    MprLinkList     connections;                            /* Http connections */
     MprEvent        *timer;                                 /* Timeout event handle  */
     char            *secret;                                /* Random bytes to use in authentication */
+    uint            hashSeed;                               /* Hash seed for response header tables */
     int             next;                                   /* Next sequence */
 #if BLD_FEATURE_MULTITHREAD
     MprMutex        *mutex;                                 /* Mutli-thread sync */
@@ -5180,6 +6750,7 @@ typedef struct MprHttp {
     int             bufmax;             /**< Maximum buffer size. -1 is no max */
     int             secure;             /**< Request uses SSL */
     int             protocolVersion;    /**< HTTP protocol version to request */
+    MprLink         link;               /**< Http service connection list linkage */
 #if BLD_FEATURE_MULTITHREAD
     MprMutex        *mutex;             /**< Mutli-thread sync */
 #endif
@@ -5356,7 +6927,10 @@ extern char *mprGetHttpHeaders(MprHttp *http);
 
 /**
  *  Get the hash table of response Http headers
- *  @description Get the internal hash table of response headers
+ *  @description Get the internal hash table of response headers. The table is read-only. Its keys and values
+ *      reference the response header buffer, so the table and any MprHash entries or strings taken from it are only 
+ *      valid until the next request is issued on \a http or the response is freed. Do not add or remove entries. 
+ *      Copy any keys or values that must be retained.
  *  @param http Http object created via #mprCreateHttp
  *  @return Hash table. See MprHash for how to access the hash table.
  *  @ingroup MprHttp
@@ -5614,6 +7188,7 @@ extern int mprStartHttpRequest(MprHttp *http, cchar *method, cchar *uri);
 
 /**
  *  Wait for http response data to drive the Http request/response to the requested state
+ *  @description Inside a fiber, only the fiber waits and the http lock is released while it is suspended.
  *  @param http Http object created via #mprCreateHttp
  *  @param state MPR_HTTP_STATE_XXX to wait for.
  *  @param timeout Timeout in milliseconds to wait 
@@ -5748,6 +7323,8 @@ typedef struct MprCmd {
     void            *forkData;
     MprBuf          *stdoutBuf;         /* Standard output from the client */
     MprBuf          *stderrBuf;         /* Standard error output from the client */
+    MprBufChain     *stdoutChain;       /* Standard output collected by mprRunCmd */
+    MprBufChain     *stderrChain;       /* Standard error output collected by mprRunCmd */
     MprTime         lastActivity;       /* Time of last I/O */
 
     int             pid;                /* Process ID of the created process */
@@ -5844,7 +7421,7 @@ extern int mprMakeCmdIO(MprCmd *cmd);
 extern int mprReadCmdPipe(MprCmd *cmd, int channel, char *buf, int bufsize);
 
 /**
- *  Reap the command. This waits for and collect the command exit status. 
+ *  Reap the command. This waits for and collect the command exit status. Inside a fiber, only the fiber waits.
  *  @param cmd MprCmd object created via mprCreateCmd
  *  @param timeout Time in milliseconds to wait for the command to complete and exit.
  *  @return Zero if successful. Otherwise a negative MPR error code.
@@ -5937,6 +7514,7 @@ extern void mprStopCmd(MprCmd *cmd);
 
 /**
  *  Wait for the command to complete.
+ *  @description Inside a fiber, only the fiber waits. Other fibers on the thread continue to run.
  *  @param cmd MprCmd object created via mprCreateCmd
  *  @param timeout Time in milliseconds to wait for the command to complete and exit.
  *  @return Zero if successful. Otherwise a negative MPR error code.
@@ -5995,8 +7573,7 @@ typedef struct Mpr {
     int             logLevel;               /**< Log trace level */
     MprLogHandler   logHandler;             /**< Current log handler callback */
     void            *logHandlerData;        /**< Handle data for log handler */
-    MprHashTable    *timeTokens;            /**< Date/Time parsing tokens */
-    MprHashTable    *mimeTypes;             /**< Date/Time parsing tokens */
+    MprHashTable    *internPool;            /**< Interned strings. See mprIntern */
     char            *name;                  /**< Product name */
     char            *title;                 /**< Product title */
     char            *version;               /**< Product version */
@@ -6018,6 +7595,7 @@ typedef struct Mpr {
      */
     struct MprFileSystem    *fileSystem;    /**< File system service object */
     struct MprOsService     *osService;     /**< O/S service object */
+    struct MprBufPool       *bufPool;       /**< Buffer storage pool */
 
     struct MprDispatcher    *dispatcher;    /**< Event service object */
     struct MprWorkerService *workerService; /**< Worker service object */
@@ -6042,6 +7620,8 @@ typedef struct Mpr {
 
     MprMutex        *mutex;                 /**< Thread synchronization */
     MprSpin         *spin;                  /**< Quick thread synchronization */
+#elif BLD_FEATURE_FIBERS
+    struct MprFiber *fiber;                 /**< Fiber currently running (single-threaded) */
 #endif
 
 #if BLD_WIN_LIKE
@@ -6296,6 +7876,113 @@ extern int      mprGetRandomBytes(MprCtx ctx, char *buf, int size, int block);
 extern int      mprGetEndian(MprCtx ctx);
 
 /* ******************************** Unicode ***********************************/
+/**
+ *  Unicode strings
+ *  @description Unicode strings are arrays of UTF-16 code units (uni) terminated by a null unit. Characters beyond 
+ *      the basic multilingual plane are stored as surrogate pairs. These routines validate UTF-8 and convert 
+ *      between UTF-8 and uni strings. Conversions reject malformed input rather than substituting replacement
+ *      characters: UTF-8 must not contain overlong forms, encoded surrogates or values beyond U+10FFFF and uni 
+ *      strings must not contain unpaired surrogates.
+ *  @stability Evolving.
+ *  @see mprIsUtf8, mprUtf8ToUni, mprUniToUtf8, mprStrToUni, mprUniToStr, mprUniLen, mprUniStr, mprUniTrim, mprUniTok
+ *  @defgroup MprUnicode MprUnicode
+ */
+typedef struct MprUnicode { int dummy; } MprUnicode;
+
+/**
+ *  Test if a string is valid UTF-8
+ *  @param str String to test
+ *  @param len Length of the string in bytes. Set to -1 if the string is null terminated.
+ *  @return True if the string is valid UTF-8
+ *  @ingroup MprUnicode
+ */
+extern bool mprIsUtf8(cchar *str, int len);
+
+/**
+ *  Convert UTF-8 to a uni string
+ *  @description Convert a UTF-8 string into a caller supplied buffer. The result is null terminated. 
+ *  @param dest Buffer to hold the result. Set to null to compute the number of units required.
+ *  @param destCount Count of units in \a dest including room for the null. Each byte of UTF-8 converts to at 
+ *      most one unit.
+ *  @param str UTF-8 string to convert
+ *  @param len Length of \a str in bytes. Set to -1 if the string is null terminated.
+ *  @return Count of units in the result not including the null. Returns MPR_ERR_BAD_FORMAT if \a str is not valid
+ *      UTF-8 and MPR_ERR_WONT_FIT if \a dest is too small.
+ *  @ingroup MprUnicode
+ */
+extern int mprUtf8ToUni(uni *dest, int destCount, cchar *str, int len);
+
+/**
+ *  Convert a uni string to UTF-8
+ *  @description Convert a uni string into a caller supplied buffer. The result is null terminated. 
+ *  @param dest Buffer to hold the result. Set to null to compute the number of bytes required.
+ *  @param destSize Size of \a dest in bytes including room for the null. Each unit converts to at most three bytes.
+ *  @param us Uni string to convert
+ *  @param count Count of units in \a us. Set to -1 if the string is null terminated.
+ *  @return Length of the result in bytes not including the null. Returns MPR_ERR_BAD_FORMAT if \a us contains 
+ *      an unpaired surrogate and MPR_ERR_WONT_FIT if \a dest is too small.
+ *  @ingroup MprUnicode
+ */
+extern int mprUniToUtf8(char *dest, int destSize, cuni *us, int count);
+
+/**
+ *  Convert UTF-8 to an allocated uni string
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param str UTF-8 string to convert
+ *  @param len Length of \a str in bytes. Set to -1 if the string is null terminated.
+ *  @return An allocated uni string. Caller must free. Returns null if \a str is not valid UTF-8.
+ *  @ingroup MprUnicode
+ */
+extern uni *mprStrToUni(MprCtx ctx, cchar *str, int len);
+
+/**
+ *  Convert a uni string to an allocated UTF-8 string
+ *  @param ctx Any memory context allocated by the MPR.
+ *  @param us Uni string to convert
+ *  @param count Count of units in \a us. Set to -1 if the string is null terminated.
+ *  @return An allocated UTF-8 string. Caller must free. Returns null if \a us contains an unpaired surrogate.
+ *  @ingroup MprUnicode
+ */
+extern char *mprUniToStr(MprCtx ctx, cuni *us, int count);
+
+/**
+ *  Return the length of a uni string
+ *  @param us Null terminated uni string
+ *  @return Count of units not including the null
+ *  @ingroup MprUnicode
+ */
+extern int mprUniLen(cuni *us);
+
+/**
+ *  Find a pattern in a uni string
+ *  @param us Null terminated uni string to search
+ *  @param pattern Null terminated pattern to find
+ *  @return Pointer to the first occurrence of \a pattern in \a us or null if not found. Returns \a us if the 
+ *      pattern is empty.
+ *  @ingroup MprUnicode
+ */
+extern uni *mprUniStr(cuni *us, cuni *pattern);
+
+/**
+ *  Trim a uni string
+ *  @description Trim units in a set from the start and end of a uni string. The string is modified.
+ *  @param us Uni string to trim
+ *  @param set Null terminated set of units to remove
+ *  @return Pointer to the trimmed string. May not equal \a us. See #mprStrTrim.
+ *  @ingroup MprUnicode
+ */
+extern uni *mprUniTrim(uni *us, cuni *set);
+
+/**
+ *  Tokenize a uni string
+ *  @description Split a uni string into tokens. The string is modified. See #mprStrTok.
+ *  @param us Uni string to tokenize. Set to null to continue with the next token.
+ *  @param delim Null terminated set of units to use as token separators.
+ *  @param last Last token pointer.
+ *  @return Returns a pointer to the next token or null when there are no more tokens.
+ *  @ingroup MprUnicode
+ */
+extern uni *mprUniTok(uni *us, cuni *delim, uni **last);
 
 #if WIN || WINCE
 extern char* mprToAsc(MprCtx ctx, cuni *u);
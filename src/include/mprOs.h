@@ -62,6 +62,7 @@
     #include    <setjmp.h>
     #include    <signal.h>
     #include    <stdarg.h>
+    #include    <stddef.h>
     #include    <stdio.h>
     #include    <stdlib.h>
     #include    <string.h>
@@ -88,6 +89,15 @@
 #if LINUX && !__UCLIBC__
     #include    <sys/sendfile.h>
 #endif
+#if LINUX
+    #include    <sys/syscall.h>
+#endif
+#ifndef BLD_FEATURE_FIBERS
+    #define BLD_FEATURE_FIBERS 1
+#endif
+#if BLD_FEATURE_FIBERS
+    #include    <ucontext.h>
+#endif
 #if CYGWIN || LINUX
     #include    <stdint.h>
 #else
@@ -126,6 +136,7 @@
     #include    <setjmp.h>
     #include    <signal.h>
     #include    <stdarg.h>
+    #include    <stddef.h>
     #include    <stdio.h>
     #include    <stdlib.h>
     #include    <string.h>
@@ -180,6 +191,7 @@
     #include    <setjmp.h>
     #include    <signal.h>
     #include    <stdarg.h>
+    #include    <stddef.h>
     #include    <stdio.h>
     #include    <stdlib.h>
     #include    <stdint.h>
@@ -236,6 +248,7 @@
     #include    <resolv.h>
     #include    <signal.h>
     #include    <stdarg.h>
+    #include    <stddef.h>
     #include    <stdio.h>
     #include    <stdlib.h>
     #include    <stdint.h>
@@ -497,6 +510,13 @@ extern "C" {
 #define BLD_HAS_SPINLOCK    0
 #endif
 
+/*
+ *  Fibers use ucontext which is only available on Unix like systems
+ */
+#ifndef BLD_FEATURE_FIBERS
+    #define BLD_FEATURE_FIBERS  0
+#endif
+
 #if BLD_CC_DOUBLE_BRACES
     #define  VA_NULL    {{0}}
 #else
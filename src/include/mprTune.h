@@ -159,7 +159,7 @@ extern "C" {
 #define MPR_TIMEOUT_HTTP        60000       /**< HTTP Request timeout (60 sec) */
 #define MPR_TIMEOUT_SOCKETS     10000       /**< General sockets timeout */
 #define MPR_TIMEOUT_LOG_STAMP   3600000     /**< Time between log time stamps (1 hr) */
-#define MPR_TIMEOUT_PRUNER      600000      /**< Time between pruner runs (10 min) */
+#define MPR_TIMEOUT_WORKER_TUNE 1000        /**< Time between worker pool sizing runs */
 #define MPR_TIMEOUT_START_TASK  2000        /**< Time to start tasks running */
 #define MPR_TIMEOUT_STOP_TASK   5000        /**< Time to stop or reap tasks */
 #define MPR_TIMEOUT_STOP_THREAD 5000        /**< Time to stop running threads */
@@ -168,6 +168,38 @@ extern "C" {
 #define MPR_TIMEOUT_HANDLER     10000       /**< Wait period when removing a wait handler */
 
 
+/*
+ *  Hash table load factor limits (percent of entries per bucket). Tables double when the load exceeds MAX_LOAD and
+ *  halve when it falls below MIN_LOAD. The gap between the two prevents a table from thrashing at a boundary.
+ */
+#define MPR_HASH_MAX_LOAD       100         /**< Grow when count exceeds this percentage of the bucket count */
+#define MPR_HASH_MIN_LOAD       12          /**< Shrink when count falls below this percentage of the bucket count */
+#define MPR_HASH_STRIPES        16          /**< Default lock stripes for concurrent hash tables */
+
+/*
+ *  Lists shorter than this are sorted by the calling thread even when a parallel sort is requested
+ */
+#define MPR_SORT_PARALLEL_MIN   65536
+
+/*
+ *  Maximum vectors passed to a single scatter/gather write. POSIX guarantees at least 16.
+ */
+#define MPR_MAX_IOVEC           16
+
+/*
+ *  Buffer storage pool. Buffer sizes in this range are rounded up to a power of two and pooled. The retention limits
+ *  bound the free storage kept per size class by the pool and by each thread cache.
+ */
+#define MPR_BUF_POOL_MIN        1024
+#define MPR_BUF_POOL_MAX        (64 * 1024)
+#define MPR_BUF_POOL_RETAIN     (256 * 1024)
+#define MPR_BUF_CACHE_RETAIN    (16 * 1024)
+
+/*
+ *  Size of a CPU cache line. Fields written by different threads are padded apart by this so they do not false share.
+ */
+#define MPR_CACHE_LINE          64
+
 /*
  *  Default thread counts
  */
@@ -179,6 +211,21 @@ extern "C" {
 #define MPR_DEFAULT_MAX_THREADS 0
 #endif
 
+/*
+ *  Worker pool sizing. The pool grows when tasks wait longer than GROW_WAIT msec to start (or are rejected) and the
+ *  CPUs are not saturated. It shrinks only after SHRINK_PERIODS consecutive quiet sizing runs.
+ */
+#define MPR_WORKER_GROW_WAIT        2       /**< Average start wait (msec) that triggers growth */
+#define MPR_WORKER_SHRINK_WAIT      1       /**< Average start wait (msec) below which a period is quiet */
+#define MPR_WORKER_SHRINK_PERIODS   10      /**< Quiet periods before shrinking */
+#define MPR_WORKER_CPU_SATURATED    90      /**< CPU load percentage regarded as saturated */
+
+/*
+ *  CPU affinity limits
+ */
+#define MPR_MAX_CPUS            256         /**< Max CPUs addressable by an affinity set. Multiple of 64 */
+#define MPR_MAX_NUMA_NODES      64          /**< Max NUMA nodes probed */
+
 /*
  *  Debug control
  */
@@ -70,6 +70,9 @@ Mpr *mprCreateEx(int argc, char **argv, MprAllocNotifier cback, void *shell)
     if ((mpr->osService = mprCreateOsService(mpr)) < 0) {
         goto error;
     }
+    if (mprCreateBufPool(mpr) == 0) {
+        goto error;
+    }
 
     /*
      *  See if any of the preceeding allocations failed and mark all blocks allocated so far as required.
@@ -236,13 +239,26 @@ bool mprStop(Mpr *mpr)
  */
 int mprStartEventsThread(Mpr *mpr)
 {
-    MprThread   *tp;
+    MprThreadService    *ts;
+    MprThread           *tp;
+    MprCpuSet           cpus;
+    int                 pinned;
 
     mprLog(mpr, MPR_CONFIG, "Starting service thread");
 
     if ((tp = mprCreateThread(mpr, "events", serviceEvents, 0, MPR_NORMAL_PRIORITY, 0)) == 0) {
         return MPR_ERR_CANT_CREATE;
     }
+    ts = mpr->threadService;
+    mprLock(ts->mutex);
+    ts->eventsThread = tp;
+    pinned = ts->eventsPinned;
+    cpus = ts->eventsAffinity;
+    mprUnlock(ts->mutex);
+
+    if (pinned) {
+        mprSetThreadAffinity(tp, &cpus);
+    }
     mpr->hasDedicatedService = 1;
     mprStartThread(tp);
     return 0;
@@ -261,6 +277,9 @@ static void serviceEvents(void *data, MprThread *tp)
     mprServiceEvents(mpr->dispatcher, -1, MPR_SERVICE_EVENTS | MPR_SERVICE_IO);
     mpr->serviceThread = 0;
     mpr->hasDedicatedService = 1;
+    mprLock(mpr->threadService->mutex);
+    mpr->threadService->eventsThread = 0;
+    mprUnlock(mpr->threadService->mutex);
 }
 
 
@@ -343,7 +362,7 @@ bool mprServicesAreIdle(MprCtx ctx)
     }
 #endif
 #if BLD_FEATURE_MULTITHREAD
-    if (mprGetListCount(mpr->workerService->busyThreads)) {
+    if (mprGetLinkCount(&mpr->workerService->busyThreads)) {
        idle = 0;
     }
 #endif
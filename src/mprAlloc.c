@@ -108,6 +108,9 @@ static void monitorStack(Mpr *mpr);
 #if BLD_WIN_LIKE
 static int mapProt(int flags);
 #endif
+#if LINUX && BLD_FEATURE_MULTITHREAD
+static void bindToNode(void *ptr, uint size, int node);
+#endif
 
 /************************************* Code ***********************************/
 /*
@@ -1580,6 +1583,17 @@ void *mprMapAlloc(MprCtx ctx, uint size, int mode)
         if (ptr == (void*) -1) {
             ptr = 0;
         }
+        #if LINUX && BLD_FEATURE_MULTITHREAD
+        {
+            int     node;
+            /*
+             *  Pages are not yet touched, so threads pinned to a NUMA node can steer them to node-local memory
+             */
+            if (ptr && (node = mprGetCurrentNumaNode(mpr)) >= 0) {
+                bindToNode(ptr, size, node);
+            }
+        }
+        #endif
     #elif BLD_WIN_LIKE
         ptr = VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT, mapProt(mode));
     #else
@@ -1623,6 +1637,22 @@ void mprMapFree(void *ptr, uint size)
 }
 
 
+#if LINUX && BLD_FEATURE_MULTITHREAD
+/*
+ *  Set a preferred NUMA node policy for a mapped region. Failure is benign: the kernel falls back to its default policy.
+ */
+static void bindToNode(void *ptr, uint size, int node)
+{
+    ulong   mask[MPR_MAX_NUMA_NODES / (8 * sizeof(ulong)) + 1];
+
+    memset(mask, 0, sizeof(mask));
+    mask[node / (8 * sizeof(ulong))] = 1UL << (node % (8 * sizeof(ulong)));
+    /* 1 == MPOL_PREFERRED */
+    syscall(SYS_mbind, ptr, (ulong) size, 1, mask, (ulong) (sizeof(mask) * 8), 0);
+}
+#endif
+
+
 #if BLD_WIN_LIKE
 static int mapProt(int flags)
 {
@@ -86,15 +86,19 @@ int mprWaitForIO(MprWaitService *ws, int timeout)
 void mprServiceWinIO(MprWaitService *ws, int sockFd, int winMask)
 {
     MprWaitHandler      *wp;
-    int                 index, mask;
+    MprLink             *lp;
+    int                 mask;
 
     mprLock(ws->mutex);
     ws->flags &= ~MPR_BREAK_REQUESTED;
 
-    for (index = 0; (wp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &index)) != 0; ) {
+    wp = 0;
+    for (lp = mprGetFirstLink(&ws->handlers); lp; lp = mprGetNextLink(&ws->handlers, lp)) {
+        wp = mprGetLinkItem(lp, MprWaitHandler, link);
         if (wp->fd == sockFd) {
             break;
         }
+        wp = 0;
     }
     if (wp == 0) {
         /*
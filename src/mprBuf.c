@@ -10,6 +10,52 @@
 
 #include    "mpr.h"
 
+/*********************************** Locals ***********************************/
+/*
+ *  In ring mode the start and end pointers wrap at the end of the buffer and the end pointer may be below the start.
+ *  One byte is always left free so a full ring can be told from an empty one. Linear buffers never have end < start,
+ *  so routines that test for a wrap need not test the mode as well.
+ */
+#define isRing(bp)          ((bp)->flags & MPR_BUF_RING)
+
+/*
+ *  Pooled storage is owned by the pool, not the buffer, and is returned when the buffer is freed or grows. Free 
+ *  blocks are linked through their first word. The thread caches are only touched by their own thread.
+ */
+#define POOL_CLASSES        16
+#define classSize(cls)      (MPR_BUF_POOL_MIN << (cls))
+#define nextFree(block)     (*(char**) (block))
+
+typedef struct MprBufPool {
+    char            *free[POOL_CLASSES];        /* Free blocks per size class */
+    int             count[POOL_CLASSES];        /* Count of free blocks per class */
+    int             limit[POOL_CLASSES];        /* Max free blocks retained per class */
+    int             classes;                    /* Number of size classes in use */
+    MprBufPoolStats stats;                      /* Includes stats of caches that have been freed */
+#if BLD_FEATURE_MULTITHREAD
+    MprLinkList     caches;                     /* Live thread caches */
+    MprSpin         *spin;                      /* Multithread sync */
+#endif
+} MprBufPool;
+
+#if BLD_FEATURE_MULTITHREAD
+typedef struct MprBufCache {
+    MprBufPool      *pool;
+    char            *free[POOL_CLASSES];
+    int             count[POOL_CLASSES];
+    MprBufPoolStats stats;
+    MprLink         link;                       /* Pool cache list linkage */
+} MprBufCache;
+#endif
+
+/****************************** Forward Declarations **************************/
+
+static char *allocStorage(MprBuf *bp, int *size, int *pooled);
+static int bufDestructor(MprBuf *bp);
+static int poolDestructor(MprBufPool *pool);
+static void releaseStorage(MprBuf *bp, char *data, int size, int pooled);
+static int unwrapBuf(MprBuf *bp);
+
 /*********************************** Code *************************************/
 /*
  *  Create a new buffer. "maxsize" is the limit to which the buffer can ever grow. -1 means no limit. "initialSize" is 
@@ -23,7 +69,7 @@ MprBuf *mprCreateBuf(MprCtx ctx, int initialSize, int maxSize)
     if (initialSize <= 0) {
         initialSize = MPR_DEFAULT_ALLOC;
     }
-    if ((bp = mprAllocObjZeroed(ctx, MprBuf)) == 0) {
+    if ((bp = mprAllocObjWithDestructorZeroed(ctx, MprBuf, bufDestructor)) == 0) {
         return 0;
     }
     bp->growBy = MPR_BUFSIZE;
@@ -32,11 +78,20 @@ MprBuf *mprCreateBuf(MprCtx ctx, int initialSize, int maxSize)
 }
 
 
+static int bufDestructor(MprBuf *bp)
+{
+    releaseStorage(bp, bp->data, bp->buflen, bp->flags & MPR_BUF_POOLED);
+    return 0;
+}
+
+
 /*
  *  Set the current buffer size and maximum size limit.
  */
 int mprSetBufSize(MprBuf *bp, int initialSize, int maxSize)
 {
+    int     pooled;
+
     mprAssert(bp);
 
     if (initialSize <= 0) {
@@ -66,10 +121,14 @@ int mprSetBufSize(MprBuf *bp, int initialSize, int maxSize)
     /*
      *  New buffer - create storage for the data
      */
-    if ((bp->data = mprAlloc(bp, initialSize)) == 0) {
+    bp->maxsize = maxSize;
+    if ((bp->data = allocStorage(bp, &initialSize, &pooled)) == 0) {
         mprAssert(!MPR_ERR_NO_MEMORY);
         return MPR_ERR_NO_MEMORY;
     }
+    if (pooled) {
+        bp->flags |= MPR_BUF_POOLED;
+    }
     bp->growBy = initialSize;
     bp->maxsize = maxSize;
     bp->buflen = initialSize;
@@ -91,9 +150,13 @@ char *mprStealBuf(MprCtx ctx, MprBuf *bp)
 {
     char    *str;
 
+    if (unwrapBuf(bp) < 0) {
+        return 0;
+    }
     str = (char*) bp->start;
 
     mprStealBlock(ctx, bp->start);
+    bp->flags &= ~MPR_BUF_POOLED;
     bp->start = bp->end = bp->data = bp->endbuf = 0;
     bp->buflen = 0;
     return str;
@@ -124,10 +187,16 @@ void mprAdjustBufEnd(MprBuf *bp, int size)
 {
     mprAssert(bp->buflen == (bp->endbuf - bp->data));
     mprAssert(size <= bp->buflen);
-    mprAssert((bp->end + size) <= bp->endbuf);
+    mprAssert(isRing(bp) || (bp->end + size) <= bp->endbuf);
 
     bp->end += size;
-    if (bp->end > bp->endbuf) {
+    if (isRing(bp)) {
+        if (bp->end >= bp->endbuf) {
+            bp->end -= bp->buflen;
+        } else if (bp->end < bp->data) {
+            bp->end += bp->buflen;
+        }
+    } else if (bp->end > bp->endbuf) {
         mprAssert(bp->end <= bp->endbuf);
         bp->end = bp->endbuf;
     }
@@ -140,12 +209,12 @@ void mprAdjustBufEnd(MprBuf *bp, int size)
 void mprAdjustBufStart(MprBuf *bp, int size)
 {
     mprAssert(bp->buflen == (bp->endbuf - bp->data));
-    mprAssert(size <= bp->buflen);
-    mprAssert((bp->start + size) <= bp->end);
+    mprAssert(size <= mprGetBufLength(bp));
 
+    size = min(size, mprGetBufLength(bp));
     bp->start += size;
-    if (bp->start > bp->end) {
-        bp->start = bp->end;
+    if (bp->start >= bp->endbuf && isRing(bp)) {
+        bp->start -= bp->buflen;
     }
 }
 
@@ -159,10 +228,16 @@ void mprFlushBuf(MprBuf *bp)
 
 int mprGetCharFromBuf(MprBuf *bp)
 {
+    int     c;
+
     if (bp->start == bp->end) {
         return -1;
     }
-    return (uchar) *bp->start++;
+    c = (uchar) *bp->start++;
+    if (bp->start == bp->endbuf && isRing(bp)) {
+        bp->start = bp->data;
+    }
+    return c;
 }
 
 
@@ -175,11 +250,11 @@ int mprGetBlockFromBuf(MprBuf *bp, char *buf, int size)
     mprAssert(bp->buflen == (bp->endbuf - bp->data));
 
     /*
-     *  Get the max bytes in a straight copy
+     *  Get the max bytes in a straight copy. A wrapped ring takes two copies.
      */
     bytesRead = 0;
     while (size > 0) {
-        thisLen = mprGetBufLength(bp);
+        thisLen = (int) ((bp->end < bp->start) ? (bp->endbuf - bp->start) : (bp->end - bp->start));
         thisLen = min(thisLen, size);
         if (thisLen <= 0) {
             break;
@@ -188,6 +263,9 @@ int mprGetBlockFromBuf(MprBuf *bp, char *buf, int size)
         memcpy(buf, bp->start, thisLen);
         buf += thisLen;
         bp->start += thisLen;
+        if (bp->start == bp->endbuf && isRing(bp)) {
+            bp->start = bp->data;
+        }
         size -= thisLen;
         bytesRead += thisLen;
     }
@@ -197,6 +275,9 @@ int mprGetBlockFromBuf(MprBuf *bp, char *buf, int size)
 
 int mprGetBufLength(MprBuf *bp)
 {
+    if (bp->end < bp->start) {
+        return (int) ((bp->endbuf - bp->start) + (bp->end - bp->data));
+    }
     return (int) (bp->end - bp->start);
 }
 
@@ -207,8 +288,16 @@ int mprGetBufSize(MprBuf *bp)
 }
 
 
+/*
+ *  Return the space that can be written in one copy at the end pointer
+ */
 int mprGetBufSpace(MprBuf *bp)
 {
+    if (bp->end < bp->start) {
+        return (int) (bp->start - bp->end) - 1;
+    } else if (isRing(bp) && bp->start == bp->data) {
+        return (int) (bp->endbuf - bp->end) - 1;
+    }
     return (int) (bp->endbuf - bp->end);
 }
 
@@ -233,7 +322,14 @@ char *mprGetBufEnd(MprBuf *bp)
 
 int mprInsertCharToBuf(MprBuf *bp, int c)
 {
-    if (bp->start == bp->data) {
+    if (isRing(bp)) {
+        if (mprGetBufLength(bp) >= bp->buflen - 1) {
+            return MPR_ERR_BAD_STATE;
+        }
+        if (bp->start == bp->data) {
+            bp->start = bp->endbuf;
+        }
+    } else if (bp->start == bp->data) {
         return MPR_ERR_BAD_STATE;
     }
     *--bp->start = c;
@@ -255,26 +351,21 @@ int mprLookAtLastCharInBuf(MprBuf *bp)
     if (bp->start == bp->end) {
         return -1;
     }
-    return bp->end[-1];
+    return (bp->end == bp->data) ? bp->endbuf[-1] : bp->end[-1];
 }
 
 
 int mprPutCharToBuf(MprBuf *bp, int c)
 {
-    char    *cp;
-    int     space;
-
     mprAssert(bp->buflen == (bp->endbuf - bp->data));
 
-    space = bp->buflen - mprGetBufLength(bp);
-    if (space < (int) sizeof(char)) {
+    if (mprGetBufSpace(bp) < (int) sizeof(char)) {
         if (mprGrowBuf(bp, 1) < 0) {
             return MPR_ERR_NO_MEMORY;
         }
     }
-    cp = (char*) bp->end;
-    *cp++ = (char) c;
-    bp->end = (char*) cp;
+    *bp->end = (char) c;
+    mprAdjustBufEnd(bp, 1);
 
     if (bp->end < bp->endbuf) {
         *((char*) bp->end) = (char) '\0';
@@ -308,6 +399,9 @@ int mprPutBlockToBuf(MprBuf *bp, cchar *str, int size)
         memcpy(bp->end, str, thisLen);
         str += thisLen;
         bp->end += thisLen;
+        if (bp->end == bp->endbuf && isRing(bp)) {
+            bp->end = bp->data;
+        }
         size -= thisLen;
         bytes += thisLen;
     }
@@ -353,62 +447,53 @@ int mprPutPadToBuf(MprBuf *bp, int c, int count)
 }
 
 
-int mprPutFmtToBuf(MprBuf *bp, cchar *fmt, ...)
-{
-    va_list     ap;
-    char        *buf;
-    int         rc, space;
-
-    if (fmt == 0) {
-        return 0;
-    }
-    va_start(ap, fmt);
-    space = mprGetBufSpace(bp);
-
-    /*
-     *  Add max that the buffer can grow 
-     */
-    space += (bp->maxsize - bp->buflen);
-    buf = mprVasprintf(bp, space, fmt, ap);
-    rc = mprPutStringToBuf(bp, buf);
-
-    mprFree(buf);
-    va_end(ap);
-    return rc;
-}
-
-
 /*
  *  Grow the buffer. Return 0 if the buffer grows. Increase by the growBy size specified when creating the buffer. 
  */
 int mprGrowBuf(MprBuf *bp, int need)
 {
     char    *newbuf;
-    int     growBy;
+    int     growBy, len, head, size, pooled;
 
     if (bp->maxsize > 0 && bp->buflen >= bp->maxsize) {
         return MPR_ERR_TOO_MANY;
     }
-    if (bp->start > bp->end) {
-        mprCompactBuf(bp);
-    }
     if (need > 0) {
         growBy = max(bp->growBy, need);
     } else {
         growBy = bp->growBy;
     }
-    if ((newbuf = mprAlloc(bp, bp->buflen + growBy)) == 0) {
+    size = bp->buflen + growBy;
+    if ((newbuf = allocStorage(bp, &size, &pooled)) == 0) {
         mprAssert(!MPR_ERR_NO_MEMORY);
         return MPR_ERR_NO_MEMORY;
     }
-    if (bp->data) {
+    if (bp->end < bp->start) {
+        /*
+         *  Unwrap a ring while copying so the new space follows the data
+         */
+        len = mprGetBufLength(bp);
+        head = (int) (bp->endbuf - bp->start);
+        memcpy(newbuf, bp->start, head);
+        memcpy(&newbuf[head], bp->data, len - head);
+        bp->start = newbuf;
+        bp->end = newbuf + len;
+
+    } else if (bp->data) {
         memcpy(newbuf, bp->data, bp->buflen);
-        mprFree(bp->data);
-    }
+        bp->end = newbuf + (bp->end - bp->data);
+        bp->start = newbuf + (bp->start - bp->data);
 
-    bp->buflen += growBy;
-    bp->end = newbuf + (bp->end - bp->data);
-    bp->start = newbuf + (bp->start - bp->data);
+    } else {
+        bp->start = bp->end = newbuf;
+    }
+    releaseStorage(bp, bp->data, bp->buflen, bp->flags & MPR_BUF_POOLED);
+    if (pooled) {
+        bp->flags |= MPR_BUF_POOLED;
+    } else {
+        bp->flags &= ~MPR_BUF_POOLED;
+    }
+    bp->buflen = size;
     bp->data = newbuf;
     bp->endbuf = &bp->data[bp->buflen];
 
@@ -433,26 +518,32 @@ int mprGrowBuf(MprBuf *bp, int need)
  */
 int mprPutIntToBuf(MprBuf *bp, int64 i)
 {
-    char    numBuf[16];
-    int     rc;
-
-    mprItoa(numBuf, sizeof(numBuf), i, 10);
-    rc = mprPutStringToBuf(bp, numBuf);
+    char    numBuf[72];
+    char    *cp, *endp;
 
-    if (bp->end < bp->endbuf) {
-        *((char*) bp->end) = (char) '\0';
+    endp = &numBuf[sizeof(numBuf)];
+    if (i < 0) {
+        cp = mprFormatUint(endp, (uint64) 0 - (uint64) i, 10, 0);
+        *--cp = '-';
+    } else {
+        cp = mprFormatUint(endp, (uint64) i, 10, 0);
     }
-
-    return rc;
+    return mprPutBlockToBuf(bp, cp, (int) (endp - cp));
 }
 
 
+/*
+ *  Move the data to the front of the buffer. Rings wrap instead so only an empty ring is reset.
+ */
 void mprCompactBuf(MprBuf *bp)
 {
     if (mprGetBufLength(bp) == 0) {
         mprFlushBuf(bp);
         return;
     }
+    if (isRing(bp)) {
+        return;
+    }
     if (bp->start > bp->data) {
         memmove(bp->data, bp->start, (bp->end - bp->start));
         bp->end -= (bp->start - bp->data);
@@ -488,6 +579,593 @@ void mprResetBufIfEmpty(MprBuf *bp)
 }
 
 
+/*
+ *  Make the data in a wrapped ring contiguous starting at the front of the buffer
+ */
+static int unwrapBuf(MprBuf *bp)
+{
+    char    *tail;
+    int     head, tailLen;
+
+    if (bp->end >= bp->start) {
+        return 0;
+    }
+    head = (int) (bp->endbuf - bp->start);
+    tailLen = (int) (bp->end - bp->data);
+    if ((tail = (char*) mprAlloc(bp, tailLen)) == 0) {
+        return MPR_ERR_NO_MEMORY;
+    }
+    memcpy(tail, bp->data, tailLen);
+    memmove(bp->data, bp->start, head);
+    memcpy(&bp->data[head], tail, tailLen);
+    mprFree(tail);
+    bp->start = bp->data;
+    bp->end = &bp->data[head + tailLen];
+    return 0;
+}
+
+
+int mprSetBufRing(MprBuf *bp, bool enable)
+{
+    if (enable) {
+        if (!isRing(bp)) {
+            /*
+             *  The end pointer must be inside the buffer and leave one free byte
+             */
+            if (bp->data && bp->start == bp->data && bp->end == bp->endbuf && mprGrowBuf(bp, 1) < 0) {
+                return MPR_ERR_NO_MEMORY;
+            }
+            bp->flags |= MPR_BUF_RING;
+            if (bp->end == bp->endbuf) {
+                bp->end = bp->data;
+            }
+            if (bp->start == bp->endbuf) {
+                bp->start = bp->data;
+            }
+        }
+    } else if (isRing(bp)) {
+        if (unwrapBuf(bp) < 0) {
+            return MPR_ERR_NO_MEMORY;
+        }
+        bp->flags &= ~MPR_BUF_RING;
+    }
+    return 0;
+}
+
+
+/*
+ *  Describe the data in at most two segments. Rings are split where they wrap.
+ */
+int mprGetBufVector(MprBuf *bp, MprIOVec *iovec)
+{
+    int     count;
+
+    count = 0;
+    if (bp->end < bp->start) {
+        iovec[count].start = bp->start;
+        iovec[count++].len = bp->endbuf - bp->start;
+        if (bp->end > bp->data) {
+            iovec[count].start = bp->data;
+            iovec[count++].len = bp->end - bp->data;
+        }
+    } else if (bp->end > bp->start) {
+        iovec[count].start = bp->start;
+        iovec[count++].len = bp->end - bp->start;
+    }
+    return count;
+}
+
+
+/*
+ *  Describe the free space in at most two segments. Only a ring has space before the start pointer.
+ */
+int mprGetBufSpaceVector(MprBuf *bp, MprIOVec *iovec)
+{
+    int     count, space;
+
+    count = 0;
+    if ((space = mprGetBufSpace(bp)) > 0) {
+        iovec[count].start = bp->end;
+        iovec[count++].len = space;
+    }
+    if (isRing(bp) && bp->end >= bp->start && bp->start > bp->data + 1) {
+        iovec[count].start = bp->data;
+        iovec[count++].len = bp->start - bp->data - 1;
+    }
+    return count;
+}
+
+
+/*
+ *  Create the buffer pool. This must be created before the thread service so that the thread caches are freed before
+ *  the pool.
+ */
+MprBufPool *mprCreateBufPool(MprCtx ctx)
+{
+    MprBufPool  *pool;
+    int         cls;
+
+    if ((pool = mprAllocObjWithDestructorZeroed(ctx, MprBufPool, poolDestructor)) == 0) {
+        return 0;
+    }
+    for (cls = 0; cls < POOL_CLASSES && classSize(cls) <= MPR_BUF_POOL_MAX; cls++) {
+        pool->limit[cls] = MPR_BUF_POOL_RETAIN / classSize(cls);
+    }
+    pool->classes = cls;
+    mprAssert(classSize(cls - 1) == MPR_BUF_POOL_MAX);
+#if BLD_FEATURE_MULTITHREAD
+    mprInitLinkList(&pool->caches);
+    if ((pool->spin = mprCreateSpinLock(pool)) == 0) {
+        mprFree(pool);
+        return 0;
+    }
+#endif
+    mprGetMpr(ctx)->bufPool = pool;
+    return pool;
+}
+
+
+/*
+ *  Detach the pool so buffers freed after it release their storage without touching the pool
+ */
+static int poolDestructor(MprBufPool *pool)
+{
+    Mpr     *mpr;
+
+    mpr = mprGetMpr(pool);
+    if (mpr->bufPool == pool) {
+        mpr->bufPool = 0;
+    }
+    return 0;
+}
+
+
+/*
+ *  Return the size class for a request or -1 if the size is not pooled
+ */
+static int getSizeClass(int size)
+{
+    int     cls;
+
+    if (size < MPR_BUF_POOL_MIN || size > MPR_BUF_POOL_MAX) {
+        return -1;
+    }
+    for (cls = 0; classSize(cls) < size; cls++) ;
+    return cls;
+}
+
+
+#if BLD_FEATURE_MULTITHREAD
+/*
+ *  Return freed cached blocks to the pool when a thread exits
+ */
+static int cacheDestructor(MprBufCache *cache)
+{
+    MprBufPool  *pool;
+    char        *block, *discard;
+    int         cls;
+
+    pool = cache->pool;
+    discard = 0;
+    mprSpinLock(pool->spin);
+    for (cls = 0; cls < pool->classes; cls++) {
+        while ((block = cache->free[cls]) != 0) {
+            cache->free[cls] = nextFree(block);
+            if (pool->count[cls] < pool->limit[cls]) {
+                nextFree(block) = pool->free[cls];
+                pool->free[cls] = block;
+                pool->count[cls]++;
+            } else {
+                nextFree(block) = discard;
+                discard = block;
+                cache->stats.discards++;
+                cache->stats.retained -= classSize(cls);
+            }
+        }
+    }
+    pool->stats.hits += cache->stats.hits;
+    pool->stats.misses += cache->stats.misses;
+    pool->stats.releases += cache->stats.releases;
+    pool->stats.discards += cache->stats.discards;
+    pool->stats.retained += cache->stats.retained;
+    mprRemoveLink(&pool->caches, &cache->link);
+    mprSpinUnlock(pool->spin);
+
+    while ((block = discard) != 0) {
+        discard = nextFree(block);
+        mprFree(block);
+    }
+    return 0;
+}
+
+
+/*
+ *  Get the cache for the current thread. Threads not created by the MPR have no cache.
+ */
+static MprBufCache *getCache(MprBufPool *pool)
+{
+    MprThreadService    *ts;
+    MprThread           *tp;
+    MprBufCache         *cache;
+
+    ts = mprGetMpr(pool)->threadService;
+    if (ts == 0 || ts->threadKey == 0 || (tp = (MprThread*) mprGetThreadData(ts->threadKey)) == 0) {
+        return 0;
+    }
+    if ((cache = tp->bufCache) == 0) {
+        if ((cache = mprAllocObjWithDestructorZeroed(tp, MprBufCache, cacheDestructor)) == 0) {
+            return 0;
+        }
+        cache->pool = pool;
+        mprSpinLock(pool->spin);
+        mprAppendLink(&pool->caches, &cache->link);
+        mprSpinUnlock(pool->spin);
+        tp->bufCache = cache;
+    }
+    return cache;
+}
+#endif
+
+
+/*
+ *  Allocate buffer storage of at least *size bytes. Sizes in the pool range are rounded up to their size class and 
+ *  come from the thread cache, then the pool. Sets *pooled if the storage belongs to the pool.
+ */
+static char *allocStorage(MprBuf *bp, int *size, int *pooled)
+{
+    MprBufPool  *pool;
+    char        *block;
+    int         cls;
+#if BLD_FEATURE_MULTITHREAD
+    MprBufCache *cache;
+#endif
+
+    *pooled = 0;
+    pool = mprGetMpr(bp)->bufPool;
+    if (pool == 0 || (cls = getSizeClass(*size)) < 0 || (bp->maxsize > 0 && classSize(cls) > bp->maxsize)) {
+        return (char*) mprAlloc(bp, *size);
+    }
+    *size = classSize(cls);
+    *pooled = 1;
+
+#if BLD_FEATURE_MULTITHREAD
+    if ((cache = getCache(pool)) != 0 && (block = cache->free[cls]) != 0) {
+        cache->free[cls] = nextFree(block);
+        cache->count[cls]--;
+        cache->stats.hits++;
+        cache->stats.retained -= *size;
+        return block;
+    }
+    mprSpinLock(pool->spin);
+#endif
+    if ((block = pool->free[cls]) != 0) {
+        pool->free[cls] = nextFree(block);
+        pool->count[cls]--;
+        pool->stats.hits++;
+        pool->stats.retained -= *size;
+    } else {
+        pool->stats.misses++;
+    }
+#if BLD_FEATURE_MULTITHREAD
+    mprSpinUnlock(pool->spin);
+#endif
+    if (block == 0) {
+        block = (char*) mprAlloc(pool, *size);
+    }
+    return block;
+}
+
+
+/*
+ *  Release buffer storage. Pooled storage goes back to the thread cache, then the pool, unless both are at their
+ *  retention limits.
+ */
+static void releaseStorage(MprBuf *bp, char *data, int size, int pooled)
+{
+    MprBufPool  *pool;
+    int         cls;
+#if BLD_FEATURE_MULTITHREAD
+    MprBufCache *cache;
+#endif
+
+    if (data == 0) {
+        return;
+    }
+    if (!pooled) {
+        mprFree(data);
+        return;
+    }
+    if ((pool = mprGetMpr(bp)->bufPool) == 0) {
+        /* The pool and all its storage have already been freed */
+        return;
+    }
+    cls = getSizeClass(size);
+    mprAssert(cls >= 0 && classSize(cls) == size);
+
+#if BLD_FEATURE_MULTITHREAD
+    if ((cache = getCache(pool)) != 0 && cache->count[cls] < max(MPR_BUF_CACHE_RETAIN / size, 1)) {
+        nextFree(data) = cache->free[cls];
+        cache->free[cls] = data;
+        cache->count[cls]++;
+        cache->stats.releases++;
+        cache->stats.retained += size;
+        return;
+    }
+    mprSpinLock(pool->spin);
+#endif
+    if (pool->count[cls] < pool->limit[cls]) {
+        nextFree(data) = pool->free[cls];
+        pool->free[cls] = data;
+        pool->count[cls]++;
+        pool->stats.releases++;
+        pool->stats.retained += size;
+        data = 0;
+    } else {
+        pool->stats.discards++;
+    }
+#if BLD_FEATURE_MULTITHREAD
+    mprSpinUnlock(pool->spin);
+#endif
+    if (data) {
+        mprFree(data);
+    }
+}
+
+
+void mprGetBufPoolStats(MprCtx ctx, MprBufPoolStats *stats)
+{
+    MprBufPool  *pool;
+#if BLD_FEATURE_MULTITHREAD
+    MprBufCache *cache;
+    MprLink     *lp;
+#endif
+
+    memset(stats, 0, sizeof(MprBufPoolStats));
+    if ((pool = mprGetMpr(ctx)->bufPool) == 0) {
+        return;
+    }
+#if BLD_FEATURE_MULTITHREAD
+    mprSpinLock(pool->spin);
+#endif
+    *stats = pool->stats;
+#if BLD_FEATURE_MULTITHREAD
+    /*
+     *  Cache counters are updated without locking by their threads so these totals are approximate
+     */
+    for (lp = mprGetFirstLink(&pool->caches); lp; lp = mprGetNextLink(&pool->caches, lp)) {
+        cache = mprGetLinkItem(lp, MprBufCache, link);
+        stats->hits += cache->stats.hits;
+        stats->misses += cache->stats.misses;
+        stats->releases += cache->stats.releases;
+        stats->discards += cache->stats.discards;
+        stats->retained += cache->stats.retained;
+    }
+    mprSpinUnlock(pool->spin);
+#endif
+}
+
+
+/*
+ *  Buffer chains. Data is appended to the last segment and consumed from the first. Consumed segments are unlinked
+ *  and one is kept as a spare so a chain used as a FIFO does not allocate in steady state.
+ */
+MprBufChain *mprCreateBufChain(MprCtx ctx, int segmentSize, int maxSize)
+{
+    MprBufChain     *chain;
+
+    if ((chain = mprAllocObjZeroed(ctx, MprBufChain)) == 0) {
+        return 0;
+    }
+    chain->segmentSize = (segmentSize > 0) ? segmentSize : MPR_BUFSIZE;
+    chain->maxsize = maxSize;
+    return chain;
+}
+
+
+/*
+ *  Append an empty segment to the chain
+ */
+static MprBufSegment *addSegment(MprBufChain *chain)
+{
+    MprBufSegment   *seg;
+
+    if ((seg = chain->spare) != 0) {
+        chain->spare = 0;
+    } else if ((seg = (MprBufSegment*) mprAlloc(chain, (int) sizeof(MprBufSegment) + chain->segmentSize)) == 0) {
+        return 0;
+    }
+    seg->next = 0;
+    seg->start = seg->end = (char*) &seg[1];
+    seg->endbuf = &seg->start[chain->segmentSize];
+    if (chain->last) {
+        chain->last->next = seg;
+    } else {
+        chain->first = seg;
+    }
+    chain->last = seg;
+    return seg;
+}
+
+
+/*
+ *  Unlink the empty first segment
+ */
+static void removeSegment(MprBufChain *chain)
+{
+    MprBufSegment   *seg;
+
+    seg = chain->first;
+    mprAssert(seg && seg->start == seg->end);
+
+    if ((chain->first = seg->next) == 0) {
+        chain->last = 0;
+    }
+    if (chain->spare == 0) {
+        chain->spare = seg;
+    } else {
+        mprFree(seg);
+    }
+}
+
+
+int mprReserveBufChain(MprBufChain *chain, char **end)
+{
+    MprBufSegment   *seg;
+    int             space;
+
+    if (chain->maxsize >= 0 && chain->length >= chain->maxsize) {
+        return MPR_ERR_WONT_FIT;
+    }
+    seg = chain->last;
+    if (seg == 0 || seg->end == seg->endbuf) {
+        if ((seg = addSegment(chain)) == 0) {
+            return MPR_ERR_NO_MEMORY;
+        }
+    }
+    space = (int) (seg->endbuf - seg->end);
+    if (chain->maxsize >= 0) {
+        space = min(space, chain->maxsize - chain->length);
+    }
+    *end = seg->end;
+    return space;
+}
+
+
+void mprAdjustBufChainEnd(MprBufChain *chain, int size)
+{
+    mprAssert(chain->last);
+    mprAssert(size >= 0 && (chain->last->end + size) <= chain->last->endbuf);
+
+    chain->last->end += size;
+    chain->length += size;
+}
+
+
+int mprPutBlockToBufChain(MprBufChain *chain, cchar *data, int size)
+{
+    char    *end;
+    int     thisLen, bytes;
+
+    mprAssert(data);
+    mprAssert(size >= 0);
+
+    for (bytes = 0; bytes < size; bytes += thisLen) {
+        if ((thisLen = mprReserveBufChain(chain, &end)) <= 0) {
+            break;
+        }
+        thisLen = min(thisLen, size - bytes);
+        memcpy(end, &data[bytes], thisLen);
+        mprAdjustBufChainEnd(chain, thisLen);
+    }
+    return bytes;
+}
+
+
+int mprPutStringToBufChain(MprBufChain *chain, cchar *str)
+{
+    if (str) {
+        return mprPutBlockToBufChain(chain, str, (int) strlen(str));
+    }
+    return 0;
+}
+
+
+int mprPeekBufChain(MprBufChain *chain, char *buf, int size)
+{
+    MprBufSegment   *seg;
+    int             thisLen, bytes;
+
+    mprAssert(buf);
+    mprAssert(size >= 0);
+
+    bytes = 0;
+    for (seg = chain->first; seg && bytes < size; seg = seg->next) {
+        thisLen = min((int) (seg->end - seg->start), size - bytes);
+        memcpy(&buf[bytes], seg->start, thisLen);
+        bytes += thisLen;
+    }
+    return bytes;
+}
+
+
+void mprAdjustBufChainStart(MprBufChain *chain, int size)
+{
+    MprBufSegment   *seg;
+    int             thisLen;
+
+    mprAssert(size >= 0 && size <= chain->length);
+
+    size = min(size, chain->length);
+    chain->length -= size;
+    while ((seg = chain->first) != 0) {
+        thisLen = min((int) (seg->end - seg->start), size);
+        seg->start += thisLen;
+        size -= thisLen;
+        if (seg->start < seg->end) {
+            break;
+        }
+        if (seg == chain->last) {
+            /* Reuse the last segment from the beginning rather than releasing it */
+            seg->start = seg->end = (char*) &seg[1];
+            break;
+        }
+        removeSegment(chain);
+    }
+}
+
+
+int mprGetBlockFromBufChain(MprBufChain *chain, char *buf, int size)
+{
+    int     bytes;
+
+    bytes = mprPeekBufChain(chain, buf, size);
+    mprAdjustBufChainStart(chain, bytes);
+    return bytes;
+}
+
+
+int mprGetBufChainLength(MprBufChain *chain)
+{
+    return chain->length;
+}
+
+
+int mprGetBufChainVector(MprBufChain *chain, MprIOVec *iovec, int count)
+{
+    MprBufSegment   *seg;
+    int             i;
+
+    i = 0;
+    for (seg = chain->first; seg && i < count; seg = seg->next) {
+        if (seg->end > seg->start) {
+            iovec[i].start = seg->start;
+            iovec[i].len = seg->end - seg->start;
+            i++;
+        }
+    }
+    return i;
+}
+
+
+char *mprGetBufChainString(MprCtx ctx, MprBufChain *chain)
+{
+    char    *str;
+
+    if ((str = (char*) mprAlloc(ctx, chain->length + 1)) == 0) {
+        return 0;
+    }
+    mprPeekBufChain(chain, str, chain->length);
+    str[chain->length] = '\0';
+    return str;
+}
+
+
+void mprFlushBufChain(MprBufChain *chain)
+{
+    mprAdjustBufChainStart(chain, chain->length);
+}
+
+
 /*
  *  @copy   default
  *  
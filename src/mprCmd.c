@@ -219,37 +219,34 @@ int mprIsCmdComplete(MprCmd *cmd)
  */
 static int cmdCallback(MprCmd *cmd, int channel, void *data)
 {
-    MprBuf      *buf;
-    int         len, space;
+    MprBufChain     *chain;
+    char            *end;
+    int             len, space;
 
     /*
      *  Note: stdin, stdout and stderr are named from the client's perspective
      */
-    buf = 0;
+    chain = 0;
     switch (channel) {
     case MPR_CMD_STDIN:
         return 0;
     case MPR_CMD_STDOUT:
-        buf = cmd->stdoutBuf;
+        chain = cmd->stdoutChain;
         break;
     case MPR_CMD_STDERR:
-        buf = cmd->stderrBuf;
+        chain = cmd->stderrChain;
         break;
     }
 
     /*
-     *  Read and aggregate the result into a single string
+     *  Read directly into the chain. The result is aggregated into a single string once when the command completes
+     *  rather than regrowing and copying a buffer as output arrives.
      */
-    space = mprGetBufSpace(buf);
-    if (space < (MPR_BUFSIZE / 4)) {
-        if (mprGrowBuf(buf, MPR_BUFSIZE) < 0) {
-            mprCloseCmdFd(cmd, channel);
-            return 0;
-        }
-        space = mprGetBufSpace(buf);
+    if ((space = mprReserveBufChain(chain, &end)) <= 0) {
+        mprCloseCmdFd(cmd, channel);
+        return 0;
     }
-
-    len = mprReadCmdPipe(cmd, channel, mprGetBufEnd(buf), space);
+    len = mprReadCmdPipe(cmd, channel, end, space);
     if (len <= 0) {
         if (len == 0 || (len < 0 && !(errno == EAGAIN || EWOULDBLOCK))) {
             if (channel == MPR_CMD_STDOUT && cmd->flags & MPR_CMD_ERR) {
@@ -265,12 +262,31 @@ static int cmdCallback(MprCmd *cmd, int channel, void *data)
             return 0;
         }
     } else {
-        mprAdjustBufEnd(buf, len);
+        mprAdjustBufChainEnd(chain, len);
     }
     return 0;
 }
 
 
+/*
+ *  Flatten output collected by mprRunCmd into the channel buffer so it remains available via mprGetCmdBuf
+ */
+static char *getCmdOutput(MprCmd *cmd, MprBuf **bufp, MprBufChain *chain)
+{
+    MprBuf      *buf;
+    int         len;
+
+    len = mprGetBufChainLength(chain);
+    mprFree(*bufp);
+    if ((*bufp = buf = mprCreateBuf(cmd, len + 1, -1)) == 0) {
+        return 0;
+    }
+    mprAdjustBufEnd(buf, mprGetBlockFromBufChain(chain, mprGetBufEnd(buf), len));
+    mprAddNullToBuf(buf);
+    return mprGetBufStart(buf);
+}
+
+
 /*
  *  Run a simple blocking command. See arg usage below in mprRunCmdV.
  */
@@ -312,12 +328,12 @@ int mprRunCmdV(MprCmd *cmd, int argc, char **argv, char **out, char **err, int f
     }
 
     if (flags & MPR_CMD_OUT) {
-        mprFree(cmd->stdoutBuf);
-        cmd->stdoutBuf = mprCreateBuf(cmd, MPR_BUFSIZE, -1);
+        mprFree(cmd->stdoutChain);
+        cmd->stdoutChain = mprCreateBufChain(cmd, MPR_BUFSIZE, -1);
     }
     if (flags & MPR_CMD_ERR) {
-        mprFree(cmd->stderrBuf);
-        cmd->stderrBuf = mprCreateBuf(cmd, MPR_BUFSIZE, -1);
+        mprFree(cmd->stderrChain);
+        cmd->stderrChain = mprCreateBufChain(cmd, MPR_BUFSIZE, -1);
     }
     mprSetCmdCallback(cmd, cmdCallback, NULL);
     lock(cmd);
@@ -358,12 +374,10 @@ int mprRunCmdV(MprCmd *cmd, int argc, char **argv, char **out, char **err, int f
         return MPR_ERR;
     }
     if (err && flags & MPR_CMD_ERR) {
-        mprAddNullToBuf(cmd->stderrBuf);
-        *err = mprGetBufStart(cmd->stderrBuf);
+        *err = getCmdOutput(cmd, &cmd->stderrBuf, cmd->stderrChain);
     }
     if (out && flags & MPR_CMD_OUT) {
-        mprAddNullToBuf(cmd->stdoutBuf);
-        *out = mprGetBufStart(cmd->stdoutBuf);
+        *out = getCmdOutput(cmd, &cmd->stdoutBuf, cmd->stdoutChain);
     }
     unlock(cmd);
     return status;
@@ -719,6 +733,9 @@ int mprWaitForCmd(MprCmd *cmd, int timeout)
 int mprReapCmd(MprCmd *cmd, int timeout)
 {
     MprTime     mark;
+#if BLD_FEATURE_FIBERS
+    MprFiber    *fiber;
+#endif
 
     mprAssert(cmd->pid);
 
@@ -788,7 +805,13 @@ int mprReapCmd(MprCmd *cmd, int timeout)
         if (mprGetElapsedTime(cmd, mark) > timeout) {
             break;
         }
-        /* Prevent busy waiting */
+        /* Prevent busy waiting. Inside a fiber, suspend just the fiber. */
+#if BLD_FEATURE_FIBERS
+        if ((fiber = mprGetCurrentFiber(cmd)) != 0) {
+            mprSleepFiber(fiber, 10);
+            continue;
+        }
+#endif
         mprSleep(cmd, 10);
     }
     return (cmd->pid == 0) ? 0 : 1;
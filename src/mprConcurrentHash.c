@@ -0,0 +1,225 @@
+/**
+ *  mprConcurrentHash.c - Thread-safe hash tables with lock striping
+ *
+ *  A concurrent hash divides its entries over a power of two number of stripes. Each stripe is an ordinary chained
+ *  MprHashTable with its own lock. The high bits of the key hash select the stripe (the low bits select the bucket
+ *  within the stripe) so threads working on different keys rarely contend. Values are returned rather than hash
+ *  entries because an entry may be removed by another thread as soon as the stripe lock is released.
+ *
+ *  Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mpr.h"
+
+/***************************** Forward Declarations ***************************/
+
+static MprHashStripe *getStripe(MprConcurrentHash *ch, cchar *key);
+
+/*********************************** Code *************************************/
+/*
+ *  Create a concurrent hash. Stripes is rounded up to a power of two. Use zero for the default (MPR_HASH_STRIPES).
+ *  The hash is seeded randomly as shared caches are typically keyed by data from the network.
+ */
+MprConcurrentHash *mprCreateConcurrentHash(MprCtx ctx, int stripes, int flags)
+{
+    MprConcurrentHash   *ch;
+    MprHashStripe       *sp;
+    uint                seed;
+    int                 count, i;
+
+    if ((ch = mprAllocObjZeroed(ctx, MprConcurrentHash)) == 0) {
+        return 0;
+    }
+    if (stripes <= 0) {
+        stripes = MPR_HASH_STRIPES;
+    }
+    for (count = 1; count < stripes && count < 1024; count *= 2) ;
+
+    if (mprGetRandomBytes(ch, (char*) &seed, sizeof(seed), 0) < 0) {
+        seed = (uint) mprGetTime(ch);
+    }
+    ch->stripes = (MprHashStripe*) mprAllocZeroed(ch, count * (int) sizeof(MprHashStripe));
+    if (ch->stripes == 0) {
+        mprFree(ch);
+        return 0;
+    }
+    ch->stripeMask = count - 1;
+
+    for (i = 0; i < count; i++) {
+        sp = &ch->stripes[i];
+        if ((sp->table = mprCreateHash(ch, 0)) == 0) {
+            mprFree(ch);
+            return 0;
+        }
+        sp->table->flags |= (flags & MPR_HASH_CASELESS);
+        sp->table->seed = seed;
+#if BLD_FEATURE_MULTITHREAD
+        if ((sp->mutex = mprCreateLock(ch)) == 0) {
+            mprFree(ch);
+            return 0;
+        }
+#endif
+    }
+    return ch;
+}
+
+
+/*
+ *  Add or update a value
+ */
+int mprAddConcurrentHash(MprConcurrentHash *ch, cchar *key, cvoid *value)
+{
+    MprHashStripe   *sp;
+    MprHash         *hp;
+
+    sp = getStripe(ch, key);
+    mprLock(sp->mutex);
+    hp = mprAddHash(sp->table, key, value);
+    mprUnlock(sp->mutex);
+    return (hp) ? 0 : MPR_ERR_NO_MEMORY;
+}
+
+
+cvoid *mprLookupConcurrentHash(MprConcurrentHash *ch, cchar *key)
+{
+    MprHashStripe   *sp;
+    cvoid           *value;
+
+    sp = getStripe(ch, key);
+    mprLock(sp->mutex);
+    value = mprLookupHash(sp->table, key);
+    mprUnlock(sp->mutex);
+    return value;
+}
+
+
+int mprRemoveConcurrentHash(MprConcurrentHash *ch, cchar *key)
+{
+    MprHashStripe   *sp;
+    int             rc;
+
+    sp = getStripe(ch, key);
+    mprLock(sp->mutex);
+    rc = mprRemoveHash(sp->table, key);
+    mprUnlock(sp->mutex);
+    return rc;
+}
+
+
+/*
+ *  Atomically replace the value for a key if it currently equals expected. An expected value of null matches a
+ *  missing key, in which case the key is added. Returns true if the value was updated.
+ */
+bool mprCasConcurrentHash(MprConcurrentHash *ch, cchar *key, cvoid *expected, cvoid *value)
+{
+    MprHashStripe   *sp;
+    MprHash         *hp;
+    bool            updated;
+
+    sp = getStripe(ch, key);
+    updated = 0;
+    mprLock(sp->mutex);
+    if ((hp = mprLookupHashEntry(sp->table, key)) != 0) {
+        if (hp->data == expected) {
+            hp->data = value;
+            updated = 1;
+        }
+    } else if (expected == 0) {
+        updated = mprAddHash(sp->table, key, value) != 0;
+    }
+    mprUnlock(sp->mutex);
+    return updated;
+}
+
+
+/*
+ *  Visit every entry. Each stripe is locked while its entries are visited. The callback may return true to remove
+ *  the entry. It must not otherwise modify the table.
+ */
+void mprWalkConcurrentHash(MprConcurrentHash *ch, MprConcurrentHashProc proc, void *data)
+{
+    MprHashStripe   *sp;
+    MprHash         *hp, *next;
+    int             i;
+
+    for (i = 0; i <= ch->stripeMask; i++) {
+        sp = &ch->stripes[i];
+        mprLock(sp->mutex);
+        for (hp = mprGetFirstHash(sp->table); hp; hp = next) {
+            /*
+             *  Entries are relinked rather than freed when a remove shrinks the table, so next stays valid
+             */
+            next = mprGetNextHash(sp->table, hp);
+            if ((proc)(data, hp->key, hp->data)) {
+                mprRemoveHash(sp->table, hp->key);
+            }
+        }
+        mprUnlock(sp->mutex);
+    }
+}
+
+
+/*
+ *  Return the number of entries. The count is not a snapshot as other threads may update stripes already counted.
+ */
+int mprGetConcurrentHashCount(MprConcurrentHash *ch)
+{
+    MprHashStripe   *sp;
+    int             i, count;
+
+    for (count = 0, i = 0; i <= ch->stripeMask; i++) {
+        sp = &ch->stripes[i];
+        mprLock(sp->mutex);
+        count += sp->table->count;
+        mprUnlock(sp->mutex);
+    }
+    return count;
+}
+
+
+static MprHashStripe *getStripe(MprConcurrentHash *ch, cchar *key)
+{
+    uint    hash;
+
+    hash = mprHashKey(ch->stripes[0].table, key);
+    return &ch->stripes[(hash >> 20) & ch->stripeMask];
+}
+
+
+/*
+ *  @copy   default
+ *  
+ *  Copyright (c) Embedthis Software LLC, 2003-2011. All Rights Reserved.
+ *  Copyright (c) Michael O'Brien, 1993-2011. All Rights Reserved.
+ *  
+ *  This software is distributed under commercial and open source licenses.
+ *  You may use the GPL open source license described below or you may acquire 
+ *  a commercial license from Embedthis Software. You agree to be fully bound 
+ *  by the terms of either license. Consult the LICENSE.TXT distributed with 
+ *  this software for full details.
+ *  
+ *  This software is open source; you can redistribute it and/or modify it 
+ *  under the terms of the GNU General Public License as published by the 
+ *  Free Software Foundation; either version 2 of the License, or (at your 
+ *  option) any later version. See the GNU General Public License for more 
+ *  details at: http://www.embedthis.com/downloads/gplLicense.html
+ *  
+ *  This program is distributed WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
+ *  
+ *  This GPL license does NOT permit incorporating this software into 
+ *  proprietary programs. If you are unable to comply with the GPL, you must
+ *  acquire a commercial license to use this software. Commercial licenses 
+ *  for this software and support services are available from Embedthis 
+ *  Software at http://www.embedthis.com 
+ *  
+ *  Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
@@ -25,6 +25,9 @@ MprCond *mprCreateCond(MprCtx ctx)
         return 0;
     }
     cp->triggered = 0;
+#if BLD_FEATURE_FIBERS
+    cp->fiber = 0;
+#endif
 #if BLD_FEATURE_MULTITHREAD
     cp->mutex = mprCreateLock(cp);
 
@@ -80,6 +83,13 @@ int mprWaitForCond(MprCond *cp, int timeout)
     struct timeval      current;
     int                 usec;
 #endif
+#if BLD_FEATURE_FIBERS
+    MprFiber            *fiber;
+
+    if ((fiber = mprGetCurrentFiber(cp)) != 0) {
+        return mprWaitForFiberCond(fiber, cp, timeout);
+    }
+#endif
 
     rc = 0;
     if (timeout < 0) {
@@ -160,6 +170,11 @@ void mprSignalCond(MprCond *cp)
     mprLock(cp->mutex);
     if (!cp->triggered) {
         cp->triggered = 1;
+#if BLD_FEATURE_FIBERS
+        if (cp->fiber) {
+            mprResumeFiber(cp->fiber);
+        }
+#endif
 #if BLD_WIN_LIKE
         SetEvent(cp->cv);
 #elif VXWORKS
@@ -196,6 +211,11 @@ void mprResetCond(MprCond *cp)
 void mprSignalCond(MprCond *cp)
 {
     cp->triggered = 1;
+#if BLD_FEATURE_FIBERS
+    if (cp->fiber) {
+        mprResumeFiber(cp->fiber);
+    }
+#endif
 }
 
 
@@ -219,6 +239,16 @@ void mprResetCond(MprCond *cp)
 static int waitWithService(MprCond *cp, int timeout)
 {
     MprTime     mark;
+#if BLD_FEATURE_FIBERS
+    MprFiber    *fiber;
+
+    /*
+     *  A fiber is suspended rather than servicing events. The fiber scheduler services events if required.
+     */
+    if ((fiber = mprGetCurrentFiber(cp)) != 0) {
+        return mprWaitForFiberCond(fiber, cp, timeout);
+    }
+#endif
 
     if (timeout < 0) {
         timeout = MAXINT;
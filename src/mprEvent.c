@@ -309,7 +309,7 @@ void mprDoEvent(MprEvent *event, void *workerThread)
         /*
          *  Recall mprDoEvent but via a worker thread. If none available, then handle inline.
          */
-        if (mprStartWorker(event->dispatcher, (MprWorkerProc) mprDoEvent, (void*) event, event->priority) == 0) {
+        if (mprTryStartWorker(event->dispatcher, (MprWorkerProc) mprDoEvent, (void*) event, event->priority) == 0) {
             return;
         }
     }
@@ -0,0 +1,554 @@
+/**
+ *  mprFiber.c - Fibers for blocking-style code without blocking threads
+ *
+ *  A fiber is a user-mode thread with its own stack. Fibers are scheduled cooperatively by the thread that calls
+ *  mprRunFibers. When a fiber calls a blocking MPR routine (mprWaitForSingleIO, mprWaitForCond or
+ *  mprWaitForCondWithService), the fiber is suspended and the scheduler runs other fibers until the I/O is ready, the
+ *  condition is signalled or the wait times out. Fibers always resume on the scheduler thread.
+ *
+ *  Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mpr.h"
+
+#if BLD_FEATURE_FIBERS
+/***************************** Forward Declarations ***************************/
+
+static int fiberDestructor(MprFiber *fp);
+static int fiberServiceDestructor(MprFiberService *fs);
+static MprFiber **getFiberSlot(MprCtx ctx);
+static void runReadyFibers(MprFiberService *fs, MprFiber **slot);
+static void suspendFiber(MprFiber *fp);
+static void waitForFibers(MprFiberService *fs, MprTime expires);
+static void wakeScheduler(MprFiberService *fs);
+
+/************************************* Code ***********************************/
+
+MprFiberService *mprCreateFiberService(MprCtx ctx)
+{
+    MprFiberService     *fs;
+
+    fs = mprAllocObjWithDestructorZeroed(ctx, MprFiberService, fiberServiceDestructor);
+    if (fs == 0) {
+        return 0;
+    }
+    if ((fs->fibers = mprCreateList(fs)) == 0) {
+        mprFree(fs);
+        return 0;
+    }
+#if BLD_FEATURE_MULTITHREAD
+    fs->wakeFd[0] = fs->wakeFd[1] = -1;
+    if ((fs->mutex = mprCreateLock(fs)) == 0) {
+        mprFree(fs);
+        return 0;
+    }
+    if (pipe(fs->wakeFd) < 0) {
+        mprError(ctx, "Can't open fiber wakeup pipe");
+        mprFree(fs);
+        return 0;
+    }
+    fcntl(fs->wakeFd[0], F_SETFL, fcntl(fs->wakeFd[0], F_GETFL) | O_NONBLOCK);
+    fcntl(fs->wakeFd[1], F_SETFL, fcntl(fs->wakeFd[1], F_GETFL) | O_NONBLOCK);
+#endif
+    return fs;
+}
+
+
+static int fiberServiceDestructor(MprFiberService *fs)
+{
+    /*
+     *  Free the list first so the fiber destructors (run after this as children) don't remove themselves from it
+     */
+    mprFree(fs->fibers);
+    fs->fibers = 0;
+#if BLD_FEATURE_MULTITHREAD
+    if (fs->wakeFd[0] >= 0) {
+        close(fs->wakeFd[0]);
+        close(fs->wakeFd[1]);
+    }
+#endif
+    return 0;
+}
+
+
+/*
+ *  Trampoline for the fiber entry point. makecontext only portably passes int arguments, so the fiber reference is
+ *  passed in two halves.
+ */
+static void fiberMain(uint hi, uint lo)
+{
+    MprFiber    *fp;
+
+    fp = (MprFiber*) (size_t) (((uint64) hi << 32) | (uint64) lo);
+    (fp->proc)(fp->data);
+    fp->state = MPR_FIBER_COMPLETE;
+    /*
+     *  Returning resumes the scheduler via uc_link
+     */
+}
+
+
+MprFiber *mprCreateFiber(MprFiberService *fs, MprFiberProc proc, void *data, int stackSize)
+{
+    MprFiber    *fp;
+    uint64      ref;
+
+    mprAssert(fs);
+    mprAssert(proc);
+
+    fp = mprAllocObjWithDestructorZeroed(fs, MprFiber, fiberDestructor);
+    if (fp == 0) {
+        return 0;
+    }
+    if (stackSize <= 0) {
+        stackSize = MPR_DEFAULT_STACK;
+    }
+    if ((fp->stack = mprAlloc(fp, stackSize)) == 0) {
+        mprFree(fp);
+        return 0;
+    }
+    fp->stackSize = stackSize;
+    fp->proc = proc;
+    fp->data = data;
+    fp->service = fs;
+    fp->fd = -1;
+
+    if (getcontext(&fp->context) < 0) {
+        mprFree(fp);
+        return 0;
+    }
+    fp->context.uc_stack.ss_sp = fp->stack;
+    fp->context.uc_stack.ss_size = stackSize;
+    fp->context.uc_link = &fs->context;
+    ref = (uint64) (size_t) fp;
+    makecontext(&fp->context, (void (*)()) fiberMain, 2, (uint) (ref >> 32), (uint) (ref & 0xFFFFFFFF));
+
+    fp->state = MPR_FIBER_READY;
+    mprAddItem(fs->fibers, fp);
+    return fp;
+}
+
+
+/*
+ *  Freeing a suspended fiber discards its stack. Anything the fiber allocated on other contexts is not released.
+ */
+static int fiberDestructor(MprFiber *fp)
+{
+    MprFiberService     *fs;
+
+    fs = fp->service;
+    mprAssert(fs == 0 || fs->current != fp);
+
+    if (fp->cond) {
+        mprLock(fp->cond->mutex);
+        fp->cond->fiber = 0;
+        mprUnlock(fp->cond->mutex);
+    }
+    if (fs && fs->fibers) {
+        mprRemoveItem(fs->fibers, fp);
+    }
+    return 0;
+}
+
+
+/*
+ *  Return a reference to the slot holding the current fiber for this thread
+ */
+static MprFiber **getFiberSlot(MprCtx ctx)
+{
+#if BLD_FEATURE_MULTITHREAD
+    MprThreadService    *ts;
+    MprThread           *tp;
+
+    ts = mprGetMpr(ctx)->threadService;
+    if (ts == 0 || ts->threadKey == 0) {
+        return 0;
+    }
+    if ((tp = (MprThread*) mprGetThreadData(ts->threadKey)) == 0) {
+        return 0;
+    }
+    return &tp->fiber;
+#else
+    return &mprGetMpr(ctx)->fiber;
+#endif
+}
+
+
+MprFiber *mprGetCurrentFiber(MprCtx ctx)
+{
+    MprFiber    **slot;
+
+    if ((slot = getFiberSlot(ctx)) == 0) {
+        return 0;
+    }
+    return *slot;
+}
+
+
+/*
+ *  Run fibers until they all complete or the timeout expires
+ */
+int mprRunFibers(MprFiberService *fs, int timeout)
+{
+    MprFiber    **slot;
+    MprTime     expires;
+
+    mprAssert(fs);
+
+    if ((slot = getFiberSlot(fs)) == 0) {
+        mprError(fs, "Fibers must be run by an MPR thread");
+        return MPR_ERR_BAD_STATE;
+    }
+    if (*slot) {
+        mprError(fs, "Can't run fibers from inside a fiber");
+        return MPR_ERR_BAD_STATE;
+    }
+    expires = (timeout < 0) ? 0 : mprGetTime(fs) + timeout;
+
+    while (mprGetListCount(fs->fibers) > 0) {
+        runReadyFibers(fs, slot);
+        if (mprGetListCount(fs->fibers) == 0) {
+            break;
+        }
+        if (expires && mprGetTime(fs) >= expires) {
+            return MPR_ERR_TIMEOUT;
+        }
+        waitForFibers(fs, expires);
+    }
+    return 0;
+}
+
+
+/*
+ *  Give each ready fiber one run. Completed fibers are removed from the list but not freed.
+ */
+static void runReadyFibers(MprFiberService *fs, MprFiber **slot)
+{
+    MprFiber    *fp;
+    int         next, ready;
+
+    for (next = 0; (fp = (MprFiber*) mprGetNextItem(fs->fibers, &next)) != 0; ) {
+        mprLock(fs->mutex);
+        ready = (fp->state == MPR_FIBER_READY);
+        if (ready) {
+            fp->state = MPR_FIBER_RUNNING;
+        }
+        mprUnlock(fs->mutex);
+        if (!ready) {
+            continue;
+        }
+        fs->current = *slot = fp;
+        swapcontext(&fs->context, &fp->context);
+        fs->current = *slot = 0;
+
+        if (fp->state == MPR_FIBER_COMPLETE) {
+            mprRemoveItem(fs->fibers, fp);
+            next--;
+        }
+    }
+}
+
+
+/*
+ *  Wait for fiber I/O, wakeups or timeouts. If this thread is the service thread, also service events.
+ */
+static void waitForFibers(MprFiberService *fs, MprTime expires)
+{
+    MprFiber        *fp;
+    MprTime         now, deadline;
+    struct pollfd   *pfd;
+    int             next, nfds, count, delay, ready, mask, serviceEvents;
+
+#if BLD_FEATURE_MULTITHREAD
+    serviceEvents = !mprMustWakeDispatcher(fs);
+#else
+    serviceEvents = 1;
+#endif
+    if (serviceEvents) {
+        mprServiceEvents(mprGetDispatcher(fs), 0, MPR_SERVICE_EVENTS | MPR_SERVICE_IO | MPR_SERVICE_ONE_THING);
+    }
+    count = mprGetListCount(fs->fibers) + 1;
+    if (count > fs->fdsMax) {
+        fs->fdsMax = count * 2;
+        if ((fs->fds = mprRealloc(fs, fs->fds, fs->fdsMax * (uint) sizeof(struct pollfd))) == 0) {
+            fs->fdsMax = 0;
+            return;
+        }
+    }
+    now = mprGetTime(fs);
+    deadline = expires;
+    nfds = 0;
+    ready = 0;
+
+#if BLD_FEATURE_MULTITHREAD
+    pfd = &fs->fds[nfds++];
+    pfd->fd = fs->wakeFd[0];
+    pfd->events = POLLIN;
+    pfd->revents = 0;
+#endif
+
+    mprLock(fs->mutex);
+    for (next = 0; (fp = (MprFiber*) mprGetNextItem(fs->fibers, &next)) != 0; ) {
+        if (fp->state == MPR_FIBER_READY) {
+            ready++;
+        } else if (fp->state == MPR_FIBER_WAITING) {
+            if (fp->deadline && fp->deadline <= now) {
+                fp->state = MPR_FIBER_READY;
+                fp->events = 0;
+                ready++;
+                continue;
+            }
+            if (fp->deadline && (deadline == 0 || fp->deadline < deadline)) {
+                deadline = fp->deadline;
+            }
+            if (fp->fd >= 0) {
+                pfd = &fs->fds[nfds++];
+                pfd->fd = fp->fd;
+                pfd->events = 0;
+                pfd->revents = 0;
+                if (fp->mask & MPR_READABLE) {
+                    pfd->events |= (POLLIN | POLLHUP);
+                }
+                if (fp->mask & MPR_WRITABLE) {
+                    pfd->events |= POLLOUT;
+                }
+            }
+        }
+    }
+    mprUnlock(fs->mutex);
+
+    if (ready) {
+        delay = 0;
+    } else if (deadline) {
+        delay = (int) min(deadline - now, MAXINT);
+    } else {
+        delay = -1;
+    }
+    if (serviceEvents && (delay < 0 || delay > 10)) {
+        /*
+         *  Nap briefly so events are serviced promptly
+         */
+        delay = 10;
+    }
+    if (poll(fs->fds, nfds, delay) <= 0) {
+        return;
+    }
+
+#if BLD_FEATURE_MULTITHREAD
+    if (fs->fds[0].revents) {
+        char    buf[16];
+        mprLock(fs->mutex);
+        while (read(fs->wakeFd[0], buf, sizeof(buf)) > 0) { }
+        fs->awake = 0;
+        mprUnlock(fs->mutex);
+    }
+#endif
+    mprLock(fs->mutex);
+    for (next = 0; (fp = (MprFiber*) mprGetNextItem(fs->fibers, &next)) != 0; ) {
+        if (fp->state != MPR_FIBER_WAITING || fp->fd < 0) {
+            continue;
+        }
+        for (pfd = fs->fds; pfd < &fs->fds[nfds]; pfd++) {
+            if (pfd->fd == fp->fd && pfd->revents) {
+                mask = 0;
+                if (pfd->revents & (POLLIN | POLLHUP | POLLERR)) {
+                    mask |= MPR_READABLE;
+                }
+                if (pfd->revents & (POLLOUT | POLLERR)) {
+                    mask |= MPR_WRITABLE;
+                }
+                if ((mask &= fp->mask) != 0) {
+                    fp->events = mask;
+                    fp->state = MPR_FIBER_READY;
+                }
+                break;
+            }
+        }
+    }
+    mprUnlock(fs->mutex);
+}
+
+
+/*
+ *  Mark the current fiber as waiting and switch to the scheduler. The caller must have registered the wakeup source.
+ */
+static void suspendFiber(MprFiber *fp)
+{
+    MprFiberService     *fs;
+
+    fs = fp->service;
+    mprAssert(fs->current == fp);
+
+    mprLock(fs->mutex);
+    if (fp->state == MPR_FIBER_RUNNING) {
+        fp->state = MPR_FIBER_WAITING;
+    }
+    mprUnlock(fs->mutex);
+    swapcontext(&fp->context, &fs->context);
+}
+
+
+void mprYieldFiber(MprCtx ctx)
+{
+    MprFiber    *fp;
+
+    if ((fp = mprGetCurrentFiber(ctx)) == 0) {
+        return;
+    }
+    mprLock(fp->service->mutex);
+    fp->state = MPR_FIBER_READY;
+    mprUnlock(fp->service->mutex);
+    swapcontext(&fp->context, &fp->service->context);
+}
+
+
+void mprResumeFiber(MprFiber *fp)
+{
+    MprFiberService     *fs;
+
+    fs = fp->service;
+    mprLock(fs->mutex);
+    if (fp->state == MPR_FIBER_WAITING) {
+        fp->state = MPR_FIBER_READY;
+        wakeScheduler(fs);
+    }
+    mprUnlock(fs->mutex);
+}
+
+
+/*
+ *  Wake the scheduler if it is blocked in poll. Called locked.
+ */
+static void wakeScheduler(MprFiberService *fs)
+{
+#if BLD_FEATURE_MULTITHREAD
+    int     c;
+
+    if (!fs->awake) {
+        c = 0;
+        if (write(fs->wakeFd[1], (char*) &c, 1) == 1) {
+            fs->awake = 1;
+        }
+    }
+#endif
+}
+
+
+static MprTime getDeadline(MprFiber *fp, int timeout)
+{
+    return (timeout < 0) ? 0 : mprGetTime(fp) + timeout;
+}
+
+
+/*
+ *  Suspend the fiber until the fd is ready for I/O. Return a mask of the ready events or zero on a timeout.
+ */
+int mprWaitForFiberIO(MprFiber *fp, int fd, int mask, int timeout)
+{
+    mprAssert(fp);
+    mprAssert(fd >= 0);
+
+    fp->fd = fd;
+    fp->mask = mask;
+    fp->events = 0;
+    fp->deadline = getDeadline(fp, timeout);
+    suspendFiber(fp);
+    fp->fd = -1;
+    return fp->events;
+}
+
+
+/*
+ *  Suspend the fiber for a period without blocking the thread
+ */
+void mprSleepFiber(MprFiber *fp, int timeout)
+{
+    mprAssert(fp);
+
+    fp->deadline = getDeadline(fp, timeout);
+    suspendFiber(fp);
+}
+
+
+/*
+ *  Suspend the fiber until the condition is signalled. Return 0 if signalled, < 0 on a timeout.
+ */
+int mprWaitForFiberCond(MprFiber *fp, MprCond *cp, int timeout)
+{
+    int     rc;
+
+    mprAssert(fp);
+    mprAssert(cp);
+    mprAssert(cp->fiber == 0 || cp->fiber == fp);
+
+    mprLock(cp->mutex);
+    if (!cp->triggered && timeout != 0) {
+        cp->fiber = fp;
+        fp->cond = cp;
+        fp->deadline = getDeadline(fp, timeout);
+        /*
+         *  Set the fiber state while still locked so a signal from another thread can't be lost. The scheduler
+         *  will run the fiber again immediately if it is signalled before the switch.
+         */
+        mprLock(fp->service->mutex);
+        fp->state = MPR_FIBER_WAITING;
+        mprUnlock(fp->service->mutex);
+        mprUnlock(cp->mutex);
+
+        suspendFiber(fp);
+
+        mprLock(cp->mutex);
+        cp->fiber = 0;
+        fp->cond = 0;
+    }
+    if (cp->triggered) {
+        cp->triggered = 0;
+        rc = 0;
+    } else {
+        rc = MPR_ERR_TIMEOUT;
+    }
+    mprUnlock(cp->mutex);
+    return rc;
+}
+
+#else
+void __dummyMprFiber() {}
+#endif /* BLD_FEATURE_FIBERS */
+
+/*
+ *  @copy   default
+ *
+ *  Copyright (c) Embedthis Software LLC, 2003-2011. All Rights Reserved.
+ *  Copyright (c) Michael O'Brien, 1993-2011. All Rights Reserved.
+ *
+ *  This software is distributed under commercial and open source licenses.
+ *  You may use the GPL open source license described below or you may acquire
+ *  a commercial license from Embedthis Software. You agree to be fully bound
+ *  by the terms of either license. Consult the LICENSE.TXT distributed with
+ *  this software for full details.
+ *
+ *  This software is open source; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation; either version 2 of the License, or (at your
+ *  option) any later version. See the GNU General Public License for more
+ *  details at: http://www.embedthis.com/downloads/gplLicense.html
+ *
+ *  This program is distributed WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *  This GPL license does NOT permit incorporating this software into
+ *  proprietary programs. If you are unable to comply with the GPL, you must
+ *  acquire a commercial license to use this software. Commercial licenses
+ *  for this software and support services are available from Embedthis
+ *  Software at http://www.embedthis.com
+ *
+ *  Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
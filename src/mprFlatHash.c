@@ -0,0 +1,462 @@
+/**
+ *  mprFlatHash.c - Open addressing hash tables
+ *
+ *  Flat tables implement the MprHash API with a single array of entries probed in groups of 16 slots. A parallel
+ *  array holds one control byte per slot: EMPTY, DELETED or the low 7 bits of the entry hash. A probe compares the
+ *  control bytes of a whole group at once (with SSE2 where available) so most lookups touch one control group and
+ *  one entry. Keys are copied into shared key blocks rather than allocated per entry, unless the table borrows or
+ *  interns its keys.
+ *
+ *  Unlike chained tables, entries move when the table is rebuilt. A hash entry returned by the API is only valid
+ *  until the next add to the table. Entries may be removed (including the last entry returned) during a walk, but
+ *  not added.
+ *
+ *  This module is not thread-safe. It is the callers responsibility to perform all thread synchronization.
+ *
+ *  Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mpr.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include    <emmintrin.h>
+    #define USE_SSE2 1
+#endif
+
+/*********************************** Locals ***********************************/
+
+#define GROUP_SIZE      16              /* Slots per probe group */
+#define CTRL_EMPTY      0x80            /* Slot has never been used since the last rebuild */
+#define CTRL_DELETED    0xFE            /* Slot held an entry that was removed */
+#define KEY_BLOCK       1024            /* Minimum size of a key storage block */
+
+/*
+ *  Key storage block. Keys are appended and never freed individually. Space held by removed keys is reclaimed
+ *  when the table is rebuilt.
+ */
+typedef struct MprHashKeys {
+    struct MprHashKeys  *next;          /* Next (older) block */
+    int                 size;           /* Size of data */
+    int                 used;           /* Bytes used in data */
+    char                data[1];        /* Key strings */
+} MprHashKeys;
+
+/***************************** Forward Declarations ***************************/
+
+static char *saveKey(MprHashTable *table, cchar *key);
+static int findSlot(MprHashTable *table, uint hash);
+static int rebuild(MprHashTable *table, int rehashKeys);
+static MprHash *moveEntry(MprHashTable *table, MprHash *sp, int rehashKeys, int copyKey);
+
+/*********************************** Code *************************************/
+/*
+ *  Return a bit mask of the slots in the group whose control byte equals the given value
+ */
+static MPR_INLINE uint matchGroup(uchar *ctrl, int value)
+{
+#if USE_SSE2
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i*) ctrl), _mm_set1_epi8((char) value)));
+#else
+    uint    mask;
+    int     i;
+
+    for (mask = 0, i = 0; i < GROUP_SIZE; i++) {
+        if (ctrl[i] == value) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+
+/*
+ *  Return a bit mask of the slots in the group that are empty or deleted (control byte high bit set)
+ */
+static MPR_INLINE uint matchFree(uchar *ctrl)
+{
+#if USE_SSE2
+    return _mm_movemask_epi8(_mm_loadu_si128((__m128i*) ctrl));
+#else
+    uint    mask;
+    int     i;
+
+    for (mask = 0, i = 0; i < GROUP_SIZE; i++) {
+        if (ctrl[i] & 0x80) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+
+static MPR_INLINE int lowestBit(uint mask)
+{
+#if __GNUC__
+    return __builtin_ctz(mask);
+#else
+    int     i;
+
+    for (i = 0; (mask & 1) == 0; i++) {
+        mask >>= 1;
+    }
+    return i;
+#endif
+}
+
+
+/*
+ *  Create a flat hash table. The size is an estimate of the number of entries.
+ */
+MprHashTable *mprCreateFlatHash(MprCtx ctx, int hashSize)
+{
+    MprHashTable    *table;
+    int             capacity;
+
+    table = mprAllocObjZeroed(ctx, MprHashTable);
+    if (table == 0) {
+        return 0;
+    }
+    if (hashSize < MPR_DEFAULT_HASH_SIZE) {
+        hashSize = MPR_DEFAULT_HASH_SIZE;
+    }
+    for (capacity = GROUP_SIZE; (capacity / 8 * 7) < hashSize; capacity *= 2) ;
+
+    table->flags = MPR_HASH_FLAT;
+    table->minSize = capacity;
+    if (rebuild(table, 0) < 0) {
+        mprFree(table);
+        return 0;
+    }
+    return table;
+}
+
+
+MprHash *mprAddFlatHash(MprHashTable *table, cchar *key, cvoid *ptr, int duplicate)
+{
+    MprHash     *sp;
+    char        *saved;
+    uint        hash;
+    int         index;
+
+    hash = mprHashKey(table, key);
+    if (!duplicate && (sp = mprLookupFlatHash(table, key, hash)) != 0) {
+        sp->data = ptr;
+        return sp;
+    }
+    if (table->growthLeft == 0 && rebuild(table, 0) < 0) {
+        return 0;
+    }
+    if (table->flags & MPR_HASH_BORROWED_KEYS) {
+        saved = (char*) key;
+    } else if (table->flags & MPR_HASH_INTERNED_KEYS) {
+        saved = (char*) mprIntern(table, key);
+    } else {
+        saved = saveKey(table, key);
+    }
+    if (saved == 0) {
+        return 0;
+    }
+    /*
+     *  Only claim the slot once the key is saved so a failed add leaves the table unchanged
+     */
+    index = findSlot(table, hash);
+    if (table->ctrl[index] == CTRL_EMPTY) {
+        table->growthLeft--;
+    }
+    sp = &table->slots[index];
+    sp->key = saved;
+    table->ctrl[index] = hash & 0x7f;
+    sp->next = 0;
+    sp->data = ptr;
+    sp->hash = hash;
+    sp->bucket = index;
+    if (table->flags & MPR_HASH_ORDERED) {
+        mprLinkHashOrder(table, sp);
+    }
+    table->count++;
+    return sp;
+}
+
+
+MprHash *mprLookupFlatHash(MprHashTable *table, cchar *key, uint hash)
+{
+    MprHash     *sp;
+    uchar       *ctrl;
+    uint        mask, group, groupMask, step;
+
+    groupMask = (table->hashSize / GROUP_SIZE) - 1;
+    group = (hash >> 7) & groupMask;
+
+    for (step = 1; step <= groupMask + 1; step++) {
+        ctrl = &table->ctrl[group * GROUP_SIZE];
+        for (mask = matchGroup(ctrl, hash & 0x7f); mask; mask &= mask - 1) {
+            sp = &table->slots[group * GROUP_SIZE + lowestBit(mask)];
+            if (sp->hash == hash) {
+                if (sp->key == key) {
+                    return sp;
+                } else if (table->flags & MPR_HASH_CASELESS) {
+                    if (mprStrcmpAnyCase(sp->key, key) == 0) {
+                        return sp;
+                    }
+                } else if (strcmp(sp->key, key) == 0) {
+                    return sp;
+                }
+            }
+        }
+        if (matchGroup(ctrl, CTRL_EMPTY)) {
+            return 0;
+        }
+        /*
+         *  Triangular probing visits every group when the group count is a power of two
+         */
+        group = (group + step) & groupMask;
+    }
+    return 0;
+}
+
+
+int mprRemoveFlatHash(MprHashTable *table, cchar *key)
+{
+    MprHash     *sp;
+    int         index;
+
+    if ((sp = mprLookupFlatHash(table, key, mprHashKey(table, key))) == 0) {
+        return MPR_ERR_NOT_FOUND;
+    }
+    index = (int) (sp - table->slots);
+
+    /*
+     *  A group that still has an empty slot has never been full, so no probe has passed through it and the slot can
+     *  be made empty. Otherwise leave a tombstone so probes continue past it.
+     */
+    if (matchGroup(&table->ctrl[index / GROUP_SIZE * GROUP_SIZE], CTRL_EMPTY)) {
+        table->ctrl[index] = CTRL_EMPTY;
+        table->growthLeft++;
+    } else {
+        table->ctrl[index] = CTRL_DELETED;
+    }
+    if (!(table->flags & (MPR_HASH_BORROWED_KEYS | MPR_HASH_INTERNED_KEYS))) {
+        table->keyGarbage += (int) strlen(sp->key) + 1;
+    }
+    if (table->flags & MPR_HASH_ORDERED) {
+        /* The removed entry keeps its own links so a walk can continue from it */
+        mprUnlinkHashOrder(table, sp);
+    }
+    sp->data = 0;
+    table->count--;
+    return 0;
+}
+
+
+/*
+ *  Return the next entry after last in slot order. The slot of a removed entry is not reused until the next add,
+ *  so last may have been removed.
+ */
+MprHash *mprGetNextFlatHash(MprHashTable *table, MprHash *last)
+{
+    int     index;
+
+    index = (last) ? (int) (last - table->slots) + 1 : 0;
+    for (; index < table->hashSize; index++) {
+        if ((table->ctrl[index] & 0x80) == 0) {
+            return &table->slots[index];
+        }
+    }
+    return 0;
+}
+
+
+/*
+ *  Recompute the hash of every entry after the seed or case sensitivity has changed
+ */
+int mprRehashFlatHash(MprHashTable *table)
+{
+    return rebuild(table, 1);
+}
+
+
+/*
+ *  Find the first free slot in the probe sequence for a hash
+ */
+static int findSlot(MprHashTable *table, uint hash)
+{
+    uint        mask, group, groupMask, step;
+
+    groupMask = (table->hashSize / GROUP_SIZE) - 1;
+    group = (hash >> 7) & groupMask;
+
+    for (step = 1; ; step++) {
+        if ((mask = matchFree(&table->ctrl[group * GROUP_SIZE])) != 0) {
+            return group * GROUP_SIZE + lowestBit(mask);
+        }
+        group = (group + step) & groupMask;
+    }
+}
+
+
+static char *saveKey(MprHashTable *table, cchar *key)
+{
+    MprHashKeys     *kp;
+    char            *saved;
+    int             len;
+
+    len = (int) strlen(key) + 1;
+    kp = table->keys;
+    if (kp == 0 || (kp->size - kp->used) < len) {
+        kp = (MprHashKeys*) mprAlloc(table, (int) sizeof(MprHashKeys) + max(len, KEY_BLOCK));
+        if (kp == 0) {
+            return 0;
+        }
+        kp->size = max(len, KEY_BLOCK);
+        kp->used = 0;
+        kp->next = table->keys;
+        table->keys = kp;
+    }
+    saved = &kp->data[kp->used];
+    memcpy(saved, key, len);
+    kp->used += len;
+    table->keyBytes += len;
+    return saved;
+}
+
+
+/*
+ *  Move an entry from the old slot array into the table's new arrays
+ */
+static MprHash *moveEntry(MprHashTable *table, MprHash *sp, int rehashKeys, int copyKey)
+{
+    MprHash     *np;
+    int         index;
+
+    if (rehashKeys) {
+        sp->hash = mprHashKey(table, sp->key);
+    }
+    index = findSlot(table, sp->hash);
+    np = &table->slots[index];
+    *np = *sp;
+    np->bucket = index;
+    if (copyKey) {
+        np->key = saveKey(table, sp->key);
+    }
+    table->ctrl[index] = sp->hash & 0x7f;
+    return np;
+}
+
+
+/*
+ *  Rebuild the table into new arrays sized for the current count. This drops tombstones and, if removed keys hold
+ *  more than half the key storage, compacts the keys. Set rehashKeys to recompute the hash of each entry.
+ */
+static int rebuild(MprHashTable *table, int rehashKeys)
+{
+    MprHash         *slots, *oldSlots, *sp;
+    MprHashKeys     *oldKeys, *keys, *kp, *next;
+    uchar           *ctrl, *oldCtrl;
+    int             capacity, oldCapacity, live, i;
+
+    for (capacity = table->minSize; (capacity / 8 * 7) < (table->count + 1) * 2; capacity *= 2) ;
+
+    /*
+     *  Compacted keys go into one new block sized for the live keys, so copying them below cannot fail
+     */
+    keys = 0;
+    live = table->keyBytes - table->keyGarbage;
+    if (table->keyGarbage > live) {
+        if ((keys = (MprHashKeys*) mprAlloc(table, (int) sizeof(MprHashKeys) + max(live, KEY_BLOCK))) == 0) {
+            return MPR_ERR_NO_MEMORY;
+        }
+        keys->next = 0;
+        keys->size = max(live, KEY_BLOCK);
+        keys->used = 0;
+    }
+    ctrl = (uchar*) mprAlloc(table, capacity);
+    slots = (MprHash*) mprAllocZeroed(table, capacity * (int) sizeof(MprHash));
+    if (ctrl == 0 || slots == 0) {
+        mprFree(keys);
+        mprFree(ctrl);
+        mprFree(slots);
+        return MPR_ERR_NO_MEMORY;
+    }
+    memset(ctrl, CTRL_EMPTY, capacity);
+
+    oldCtrl = table->ctrl;
+    oldSlots = table->slots;
+    oldCapacity = table->hashSize;
+    oldKeys = table->keys;
+
+    if (keys) {
+        table->keys = keys;
+        table->keyBytes = table->keyGarbage = 0;
+    }
+    table->ctrl = ctrl;
+    table->slots = slots;
+    table->hashSize = capacity;
+    table->growthLeft = (capacity / 8 * 7) - table->count;
+
+    if (table->flags & MPR_HASH_ORDERED) {
+        /*
+         *  Move entries in insertion order so the order links can be rebuilt as the entries move
+         */
+        sp = table->head;
+        table->head = table->tail = 0;
+        for (; sp; sp = sp->nextOrder) {
+            mprLinkHashOrder(table, moveEntry(table, sp, rehashKeys, keys != 0));
+        }
+    } else {
+        for (i = 0; i < oldCapacity; i++) {
+            if ((oldCtrl[i] & 0x80) == 0) {
+                moveEntry(table, &oldSlots[i], rehashKeys, keys != 0);
+            }
+        }
+    }
+    if (keys) {
+        for (kp = oldKeys; kp; kp = next) {
+            next = kp->next;
+            mprFree(kp);
+        }
+    }
+    mprFree(oldCtrl);
+    mprFree(oldSlots);
+    return 0;
+}
+
+
+/*
+ *  @copy   default
+ *  
+ *  Copyright (c) Embedthis Software LLC, 2003-2011. All Rights Reserved.
+ *  Copyright (c) Michael O'Brien, 1993-2011. All Rights Reserved.
+ *  
+ *  This software is distributed under commercial and open source licenses.
+ *  You may use the GPL open source license described below or you may acquire 
+ *  a commercial license from Embedthis Software. You agree to be fully bound 
+ *  by the terms of either license. Consult the LICENSE.TXT distributed with 
+ *  this software for full details.
+ *  
+ *  This software is open source; you can redistribute it and/or modify it 
+ *  under the terms of the GNU General Public License as published by the 
+ *  Free Software Foundation; either version 2 of the License, or (at your 
+ *  option) any later version. See the GNU General Public License for more 
+ *  details at: http://www.embedthis.com/downloads/gplLicense.html
+ *  
+ *  This program is distributed WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
+ *  
+ *  This GPL license does NOT permit incorporating this software into 
+ *  proprietary programs. If you are unable to comply with the GPL, you must
+ *  acquire a commercial license to use this software. Commercial licenses 
+ *  for this software and support services are available from Embedthis 
+ *  Software at http://www.embedthis.com 
+ *  
+ *  Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
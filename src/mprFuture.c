@@ -0,0 +1,626 @@
+/**
+ *  mprFuture.c - Futures and parallel loops over the worker thread pool
+ *
+ *  A future runs a procedure on a worker thread and provides a means to wait for completion and retrieve the result.
+ *  Futures that cannot be started immediately are queued on the worker service. The queue is drained by idle workers,
+ *  by workers as they finish other tasks and by threads waiting in mprWaitForFuture.
+ *
+ *  Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mpr.h"
+
+/*********************************** Locals ***********************************/
+/*
+ *  Parallel loop state shared by the calling thread and the helper futures
+ */
+typedef struct ForJob {
+    MprForProc      fn;                 /* Per chunk procedure */
+    void            *data;              /* Procedure data */
+    int             next;               /* Next index to claim */
+    int             end;                /* One past the last index */
+    int             grain;              /* Chunk size */
+#if BLD_FEATURE_MULTITHREAD
+    MprSpin         *spin;              /* Protects next */
+#endif
+} ForJob;
+
+/***************************** Forward Declarations ***************************/
+
+static MprFuture *createFuture(MprCtx ctx, MprFutureProc proc, void *data);
+static int futureDestructor(MprFuture *fp);
+static void runChunks(ForJob *job);
+
+#if BLD_FEATURE_MULTITHREAD
+static bool canStartWorker(MprWorkerService *ws);
+static void dequeueFuture(MprWorkerService *ws, MprFuture *fp);
+static MprFuture *getNextQueued(MprWorkerService *ws, bool tasks);
+static MprFuture *getFirstQueued(MprWorkerService *ws, int cls, bool tasks);
+static void drainFutures(MprWorkerService *ws, MprWorker *worker);
+static void *forHelper(void *data, void *arg);
+static void queueFuture(MprWorkerService *ws, MprFuture *fp);
+#endif
+
+/************************************* Code ***********************************/
+
+static MprFuture *createFuture(MprCtx ctx, MprFutureProc proc, void *data)
+{
+    MprFuture   *fp;
+
+    fp = mprAllocObjWithDestructorZeroed(ctx, MprFuture, futureDestructor);
+    if (fp == 0) {
+        return 0;
+    }
+    if ((fp->cond = mprCreateCond(fp)) == 0) {
+        mprFree(fp);
+        return 0;
+    }
+    fp->proc = proc;
+    fp->data = data;
+    fp->priority = MPR_NORMAL_PRIORITY;
+    return fp;
+}
+
+
+MprFuture *mprSubmitFuture(MprCtx ctx, MprFutureProc proc, void *data)
+{
+    return mprSubmitPriorityFuture(ctx, proc, data, MPR_NORMAL_PRIORITY);
+}
+
+
+#if BLD_FEATURE_MULTITHREAD
+
+MprFuture *mprSubmitPriorityFuture(MprCtx ctx, MprFutureProc proc, void *data, int priority)
+{
+    MprWorkerService    *ws;
+    MprFuture           *fp;
+
+    if ((fp = createFuture(ctx, proc, data)) == 0) {
+        return 0;
+    }
+    fp->priority = priority;
+    ws = mprGetMpr(ctx)->workerService;
+    mprLock(ws->mutex);
+    queueFuture(ws, fp);
+    mprUnlock(ws->mutex);
+    return fp;
+}
+
+
+MprFuture *mprThenFuture(MprFuture *prior, MprFutureProc proc, void *data)
+{
+    MprWorkerService    *ws;
+    MprFuture           *fp;
+
+    if ((fp = createFuture(mprGetParent(prior), proc, data)) == 0) {
+        return 0;
+    }
+    fp->priority = prior->priority;
+    ws = mprGetMpr(prior)->workerService;
+    mprLock(ws->mutex);
+    if (prior->state & MPR_FUTURE_COMPLETE) {
+        fp->arg = prior->result;
+        queueFuture(ws, fp);
+    } else {
+        fp->state = MPR_FUTURE_DEFERRED;
+        fp->prior = prior;
+        fp->nextThen = prior->thens;
+        prior->thens = fp;
+    }
+    mprUnlock(ws->mutex);
+    return fp;
+}
+
+
+int mprWaitForFuture(MprFuture *fp, int timeout)
+{
+    MprWorkerService    *ws;
+    MprFuture           *job;
+    MprTime             mark;
+    int                 remaining;
+
+    ws = mprGetMpr(fp)->workerService;
+    if (timeout < 0) {
+        timeout = MAXINT;
+    }
+    mark = mprGetTime(fp);
+
+    while (1) {
+        mprLock(ws->mutex);
+        if (fp->state & MPR_FUTURE_COMPLETE) {
+            mprUnlock(ws->mutex);
+            return 0;
+        }
+        /*
+         *  Help out. Run this future if it is still queued, otherwise run the next queued future.
+         */
+        if (fp->state & MPR_FUTURE_PENDING) {
+            dequeueFuture(ws, fp);
+            job = fp;
+        } else {
+            job = mprGetNextFuture(ws);
+        }
+        mprUnlock(ws->mutex);
+
+        if (job) {
+            mprRunFuture(job);
+            continue;
+        }
+        remaining = timeout - (int) mprGetElapsedTime(fp, mark);
+        if (remaining <= 0) {
+            return MPR_ERR_TIMEOUT;
+        }
+        mprWaitForCondWithService(fp->cond, remaining);
+    }
+}
+
+
+/*
+ *  Dequeue the next future according to the queue policy and mark it running. Returns null if the queue is empty.
+ *  Tasks queued by mprStartWorker need a worker and are only returned to worker threads.
+ */
+MprFuture *mprGetNextFuture(MprWorkerService *ws)
+{
+    MprFuture   *fp;
+    bool        tasks;
+
+    tasks = mprGetCurrentWorker(ws) != 0;
+    mprLock(ws->mutex);
+    if ((fp = getNextQueued(ws, tasks)) != 0) {
+        dequeueFuture(ws, fp);
+    }
+    mprUnlock(ws->mutex);
+    return fp;
+}
+
+
+/*
+ *  Queue a task for mprStartWorker when no worker is available. The task is freed once it has run. Must be called 
+ *  locked.
+ */
+int mprQueueWorkerTask(MprWorkerService *ws, MprWorkerProc proc, void *data, int priority)
+{
+    MprFuture   *fp;
+
+    if ((fp = createFuture(ws, 0, data)) == 0) {
+        return MPR_ERR_NO_MEMORY;
+    }
+    fp->task = proc;
+    fp->priority = priority;
+    fp->orphaned = 1;
+    queueFuture(ws, fp);
+    return 0;
+}
+
+
+/*
+ *  Select the next future to run. Must be called locked.
+ */
+static MprFuture *getNextQueued(MprWorkerService *ws, bool tasks)
+{
+    MprFuture   *fp;
+    int         cls, round;
+
+    if (ws->pendingFutures == 0) {
+        return 0;
+    }
+    if (ws->queuePolicy != MPR_QUEUE_WEIGHTED) {
+        for (cls = MPR_PRIORITY_CLASSES - 1; cls >= 0; cls--) {
+            if ((fp = getFirstQueued(ws, cls, tasks)) != 0) {
+                return fp;
+            }
+        }
+        return 0;
+    }
+    /*
+     *  Weighted round-robin. Take the highest class with turns remaining. When no waiting class has turns left, 
+     *  start a new round.
+     */
+    for (round = 0; round < 2; round++) {
+        for (cls = MPR_PRIORITY_CLASSES - 1; cls >= 0; cls--) {
+            if (ws->credits[cls] > 0 && (fp = getFirstQueued(ws, cls, tasks)) != 0) {
+                ws->credits[cls]--;
+                return fp;
+            }
+        }
+        for (cls = 0; cls < MPR_PRIORITY_CLASSES; cls++) {
+            ws->credits[cls] = 1 << cls;
+        }
+    }
+    return 0;
+}
+
+
+/*
+ *  Return the first entry in a class queue that the caller can run. Must be called locked.
+ */
+static MprFuture *getFirstQueued(MprWorkerService *ws, int cls, bool tasks)
+{
+    MprFuture   *fp;
+
+    for (fp = ws->futureHead[cls]; fp; fp = fp->next) {
+        if (tasks || fp->task == 0) {
+            return fp;
+        }
+    }
+    return 0;
+}
+
+
+/*
+ *  Run a future that has been removed from the queue. Continuations are queued once the result is available.
+ */
+void mprRunFuture(MprFuture *fp)
+{
+    MprWorkerService    *ws;
+    MprWorker           *worker;
+    MprFuture           *then, *next;
+    void                *result;
+    int                 orphaned;
+
+    mprAssert(fp->state & MPR_FUTURE_RUNNING);
+
+    ws = mprGetMpr(fp)->workerService;
+    mprRecordWorkerWait(ws, mprGetTime(fp) - fp->queued);
+
+    if (fp->task) {
+        worker = mprGetCurrentWorker(fp);
+        mprAssert(worker);
+        if (mprMapMprPriorityToOs(fp->priority) != mprMapMprPriorityToOs(worker->thread->priority)) {
+            mprSetThreadPriority(worker->thread, fp->priority);
+        }
+        (fp->task)(fp->data, worker);
+        result = 0;
+    } else {
+        result = (fp->proc)(fp->data, fp->arg);
+    }
+
+    mprLock(ws->mutex);
+    fp->result = result;
+    fp->state = MPR_FUTURE_COMPLETE;
+    for (then = fp->thens; then; then = next) {
+        next = then->nextThen;
+        then->nextThen = 0;
+        then->prior = 0;
+        then->arg = result;
+        queueFuture(ws, then);
+        /* Wake any waiter so it can help run the continuation */
+        mprSignalCond(then->cond);
+    }
+    fp->thens = 0;
+    orphaned = fp->orphaned;
+    mprSignalCond(fp->cond);
+    mprUnlock(ws->mutex);
+
+    if (orphaned) {
+        mprFree(fp);
+    }
+}
+
+
+/*
+ *  Append a future to the queue and start a worker to drain the queue if one is available. Must be called locked.
+ */
+static void queueFuture(MprWorkerService *ws, MprFuture *fp)
+{
+    int     cls;
+
+    cls = mprGetPriorityClass(fp->priority);
+    fp->state = MPR_FUTURE_PENDING;
+    fp->queued = mprGetTime(ws);
+    fp->next = 0;
+    fp->prev = ws->futureTail[cls];
+    if (ws->futureTail[cls]) {
+        ws->futureTail[cls]->next = fp;
+    } else {
+        ws->futureHead[cls] = fp;
+    }
+    ws->futureTail[cls] = fp;
+    ws->pendingFutures++;
+
+    /*
+     *  Busy workers drain the queue when they complete their current task, so only start as many drainers as 
+     *  there are queued futures.
+     */
+    if (ws->pendingFutures > ws->futureDrainers && canStartWorker(ws)) {
+        ws->futureDrainers++;
+        if (mprTryStartWorker(ws, (MprWorkerProc) drainFutures, ws, MPR_WORKER_PRIORITY) < 0) {
+            ws->futureDrainers--;
+        }
+    }
+}
+
+
+/*
+ *  Remove a future from the queue and mark it running. Must be called locked.
+ */
+static void dequeueFuture(MprWorkerService *ws, MprFuture *fp)
+{
+    int     cls;
+
+    mprAssert(fp->state & MPR_FUTURE_PENDING);
+
+    cls = mprGetPriorityClass(fp->priority);
+    if (fp->prev) {
+        fp->prev->next = fp->next;
+    } else {
+        ws->futureHead[cls] = fp->next;
+    }
+    if (fp->next) {
+        fp->next->prev = fp->prev;
+    } else {
+        ws->futureTail[cls] = fp->prev;
+    }
+    fp->next = fp->prev = 0;
+    fp->state = MPR_FUTURE_RUNNING;
+    ws->pendingFutures--;
+}
+
+
+/*
+ *  Test if there is an idle non-dedicated worker or if another worker can be created. Must be called locked.
+ */
+static bool canStartWorker(MprWorkerService *ws)
+{
+    MprWorker   *worker;
+    MprLink     *lp;
+
+    if (ws->numThreads < ws->maxThreads) {
+        return 1;
+    }
+    for (lp = mprGetFirstLink(&ws->idleThreads); lp; lp = mprGetNextLink(&ws->idleThreads, lp)) {
+        worker = mprGetLinkItem(lp, MprWorker, link);
+        if (!(worker->flags & MPR_WORKER_DEDICATED)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+static void drainFutures(MprWorkerService *ws, MprWorker *worker)
+{
+    MprFuture   *fp;
+
+    mprLock(ws->mutex);
+    ws->futureDrainers--;
+    mprUnlock(ws->mutex);
+
+    while ((fp = mprGetNextFuture(ws)) != 0) {
+        mprRunFuture(fp);
+    }
+}
+
+
+static int futureDestructor(MprFuture *fp)
+{
+    MprWorkerService    *ws;
+    MprFuture           **pp, *then;
+
+    ws = mprGetMpr(fp)->workerService;
+    mprLock(ws->mutex);
+    if (fp->state & MPR_FUTURE_RUNNING) {
+        /*
+         *  Can't free while the procedure is running. mprRunFuture will free on completion.
+         */
+        fp->orphaned = 1;
+        mprUnlock(ws->mutex);
+        return 1;
+    }
+    if (fp->state & MPR_FUTURE_PENDING) {
+        dequeueFuture(ws, fp);
+
+    } else if ((fp->state & MPR_FUTURE_DEFERRED) && fp->prior) {
+        for (pp = &fp->prior->thens; *pp; pp = &(*pp)->nextThen) {
+            if (*pp == fp) {
+                *pp = fp->nextThen;
+                break;
+            }
+        }
+    }
+    /*
+     *  Continuations of a cancelled future can never run. Complete them without a result.
+     */
+    for (then = fp->thens; then; then = then->nextThen) {
+        then->prior = 0;
+        then->state = MPR_FUTURE_COMPLETE;
+        mprSignalCond(then->cond);
+    }
+    fp->state = MPR_FUTURE_COMPLETE;
+    mprUnlock(ws->mutex);
+    return 0;
+}
+
+#else /* !BLD_FEATURE_MULTITHREAD */
+/*
+ *  Single-threaded futures run immediately
+ */
+MprFuture *mprSubmitPriorityFuture(MprCtx ctx, MprFutureProc proc, void *data, int priority)
+{
+    MprFuture   *fp;
+
+    if ((fp = createFuture(ctx, proc, data)) == 0) {
+        return 0;
+    }
+    fp->result = (proc)(data, 0);
+    fp->state = MPR_FUTURE_COMPLETE;
+    return fp;
+}
+
+
+MprFuture *mprThenFuture(MprFuture *prior, MprFutureProc proc, void *data)
+{
+    MprFuture   *fp;
+
+    if ((fp = createFuture(mprGetParent(prior), proc, data)) == 0) {
+        return 0;
+    }
+    fp->arg = prior->result;
+    fp->result = (proc)(data, fp->arg);
+    fp->state = MPR_FUTURE_COMPLETE;
+    return fp;
+}
+
+
+int mprWaitForFuture(MprFuture *fp, int timeout)
+{
+    return (fp->state & MPR_FUTURE_COMPLETE) ? 0 : MPR_ERR_TIMEOUT;
+}
+
+
+static int futureDestructor(MprFuture *fp)
+{
+    return 0;
+}
+#endif /* BLD_FEATURE_MULTITHREAD */
+
+
+void *mprGetFutureResult(MprFuture *fp)
+{
+    return (fp->state & MPR_FUTURE_COMPLETE) ? fp->result : 0;
+}
+
+
+bool mprIsFutureComplete(MprFuture *fp)
+{
+    return (fp->state & MPR_FUTURE_COMPLETE) != 0;
+}
+
+
+int mprParallelFor(MprCtx ctx, int start, int end, int grain, MprForProc fn, void *data)
+{
+    ForJob      job;
+    int         numCpu;
+#if BLD_FEATURE_MULTITHREAD
+    MprFuture   **futures;
+    int         i, chunks, helpers;
+#endif
+
+    if (end <= start) {
+        return 0;
+    }
+#if BLD_FEATURE_MULTITHREAD
+    numCpu = max(mprGetCpuCount(ctx), 1);
+#else
+    numCpu = 1;
+#endif
+    if (grain <= 0) {
+        grain = max((end - start) / (numCpu * 4), 1);
+    }
+
+    job.fn = fn;
+    job.data = data;
+    job.next = start;
+    job.end = end;
+    job.grain = grain;
+
+#if BLD_FEATURE_MULTITHREAD
+    /*
+     *  The calling thread is one of the participants, so only create helpers for the remaining CPUs
+     */
+    chunks = (end - start + grain - 1) / grain;
+    helpers = min(min(chunks, numCpu) - 1, mprGetMaxWorkers(ctx));
+    if (helpers > 0) {
+        if ((job.spin = mprCreateSpinLock(ctx)) == 0) {
+            return MPR_ERR_NO_MEMORY;
+        }
+        if ((futures = (MprFuture**) mprAllocZeroed(ctx, helpers * sizeof(MprFuture*))) == 0) {
+            mprFree(job.spin);
+            return MPR_ERR_NO_MEMORY;
+        }
+        for (i = 0; i < helpers; i++) {
+            futures[i] = mprSubmitFuture(futures, forHelper, &job);
+        }
+        runChunks(&job);
+
+        for (i = 0; i < helpers; i++) {
+            if (futures[i]) {
+                mprWaitForFuture(futures[i], -1);
+            }
+        }
+        mprFree(futures);
+        mprFree(job.spin);
+        return 0;
+    }
+    job.spin = 0;
+#endif
+    runChunks(&job);
+    return 0;
+}
+
+
+/*
+ *  Claim and run chunks until the range is exhausted
+ */
+static void runChunks(ForJob *job)
+{
+    int     start, end;
+
+    while (1) {
+#if BLD_FEATURE_MULTITHREAD
+        if (job->spin) {
+            mprSpinLock(job->spin);
+        }
+#endif
+        start = job->next;
+        end = (job->end - start > job->grain) ? start + job->grain : job->end;
+        job->next = end;
+#if BLD_FEATURE_MULTITHREAD
+        if (job->spin) {
+            mprSpinUnlock(job->spin);
+        }
+#endif
+        if (start >= end) {
+            break;
+        }
+        (job->fn)(job->data, start, end);
+    }
+}
+
+
+#if BLD_FEATURE_MULTITHREAD
+static void *forHelper(void *data, void *arg)
+{
+    runChunks((ForJob*) data);
+    return 0;
+}
+#endif
+
+
+/*
+ *  @copy   default
+ *  
+ *  Copyright (c) Embedthis Software LLC, 2003-2011. All Rights Reserved.
+ *  Copyright (c) Michael O'Brien, 1993-2011. All Rights Reserved.
+ *  
+ *  This software is distributed under commercial and open source licenses.
+ *  You may use the GPL open source license described below or you may acquire 
+ *  a commercial license from Embedthis Software. You agree to be fully bound 
+ *  by the terms of either license. Consult the LICENSE.TXT distributed with 
+ *  this software for full details.
+ *  
+ *  This software is open source; you can redistribute it and/or modify it 
+ *  under the terms of the GNU General Public License as published by the 
+ *  Free Software Foundation; either version 2 of the License, or (at your 
+ *  option) any later version. See the GNU General Public License for more 
+ *  details at: http://www.embedthis.com/downloads/gplLicense.html
+ *  
+ *  This program is distributed WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
+ *  
+ *  This GPL license does NOT permit incorporating this software into 
+ *  proprietary programs. If you are unable to comply with the GPL, you must
+ *  acquire a commercial license to use this software. Commercial licenses 
+ *  for this software and support services are available from Embedthis 
+ *  Software at http://www.embedthis.com 
+ *  
+ *  Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
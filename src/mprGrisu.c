@@ -0,0 +1,503 @@
+/**
+ *  mprGrisu.c - Fast double to decimal conversion
+ *
+ *  Implements Grisu3 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers"). The
+ *  double is scaled by a cached power of ten so its digits can be generated with 64-bit integer arithmetic. Grisu3
+ *  produces either the shortest digits that round trip or a fixed count of correctly rounded digits. For roughly
+ *  0.5% of values it cannot prove its result is correct and says so. Callers then fall back to the bignum dtoa().
+ *
+ *  Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mpr.h"
+
+#if BLD_FEATURE_FLOATING_POINT
+/*********************************** Locals ***********************************/
+
+typedef struct DiyFp {
+    uint64      f;                      /* Significand */
+    int         e;                      /* Binary exponent */
+} DiyFp;
+
+typedef struct CachedPower {
+    uint64      f;
+    short       e;                      /* Binary exponent */
+    short       k;                      /* Decimal exponent */
+} CachedPower;
+
+/*
+ *  Normalized 64-bit approximations of 10^k for k = -348 to 340 in steps of 8
+ */
+static const CachedPower cachedPowers[] = {
+    { UINT64(0xfa8fd5a0081c0288), -1220, -348 },
+    { UINT64(0xbaaee17fa23ebf76), -1193, -340 },
+    { UINT64(0x8b16fb203055ac76), -1166, -332 },
+    { UINT64(0xcf42894a5dce35ea), -1140, -324 },
+    { UINT64(0x9a6bb0aa55653b2d), -1113, -316 },
+    { UINT64(0xe61acf033d1a45df), -1087, -308 },
+    { UINT64(0xab70fe17c79ac6ca), -1060, -300 },
+    { UINT64(0xff77b1fcbebcdc4f), -1034, -292 },
+    { UINT64(0xbe5691ef416bd60c), -1007, -284 },
+    { UINT64(0x8dd01fad907ffc3c),  -980, -276 },
+    { UINT64(0xd3515c2831559a83),  -954, -268 },
+    { UINT64(0x9d71ac8fada6c9b5),  -927, -260 },
+    { UINT64(0xea9c227723ee8bcb),  -901, -252 },
+    { UINT64(0xaecc49914078536d),  -874, -244 },
+    { UINT64(0x823c12795db6ce57),  -847, -236 },
+    { UINT64(0xc21094364dfb5637),  -821, -228 },
+    { UINT64(0x9096ea6f3848984f),  -794, -220 },
+    { UINT64(0xd77485cb25823ac7),  -768, -212 },
+    { UINT64(0xa086cfcd97bf97f4),  -741, -204 },
+    { UINT64(0xef340a98172aace5),  -715, -196 },
+    { UINT64(0xb23867fb2a35b28e),  -688, -188 },
+    { UINT64(0x84c8d4dfd2c63f3b),  -661, -180 },
+    { UINT64(0xc5dd44271ad3cdba),  -635, -172 },
+    { UINT64(0x936b9fcebb25c996),  -608, -164 },
+    { UINT64(0xdbac6c247d62a584),  -582, -156 },
+    { UINT64(0xa3ab66580d5fdaf6),  -555, -148 },
+    { UINT64(0xf3e2f893dec3f126),  -529, -140 },
+    { UINT64(0xb5b5ada8aaff80b8),  -502, -132 },
+    { UINT64(0x87625f056c7c4a8b),  -475, -124 },
+    { UINT64(0xc9bcff6034c13053),  -449, -116 },
+    { UINT64(0x964e858c91ba2655),  -422, -108 },
+    { UINT64(0xdff9772470297ebd),  -396, -100 },
+    { UINT64(0xa6dfbd9fb8e5b88f),  -369,  -92 },
+    { UINT64(0xf8a95fcf88747d94),  -343,  -84 },
+    { UINT64(0xb94470938fa89bcf),  -316,  -76 },
+    { UINT64(0x8a08f0f8bf0f156b),  -289,  -68 },
+    { UINT64(0xcdb02555653131b6),  -263,  -60 },
+    { UINT64(0x993fe2c6d07b7fac),  -236,  -52 },
+    { UINT64(0xe45c10c42a2b3b06),  -210,  -44 },
+    { UINT64(0xaa242499697392d3),  -183,  -36 },
+    { UINT64(0xfd87b5f28300ca0e),  -157,  -28 },
+    { UINT64(0xbce5086492111aeb),  -130,  -20 },
+    { UINT64(0x8cbccc096f5088cc),  -103,  -12 },
+    { UINT64(0xd1b71758e219652c),   -77,   -4 },
+    { UINT64(0x9c40000000000000),   -50,    4 },
+    { UINT64(0xe8d4a51000000000),   -24,   12 },
+    { UINT64(0xad78ebc5ac620000),     3,   20 },
+    { UINT64(0x813f3978f8940984),    30,   28 },
+    { UINT64(0xc097ce7bc90715b3),    56,   36 },
+    { UINT64(0x8f7e32ce7bea5c70),    83,   44 },
+    { UINT64(0xd5d238a4abe98068),   109,   52 },
+    { UINT64(0x9f4f2726179a2245),   136,   60 },
+    { UINT64(0xed63a231d4c4fb27),   162,   68 },
+    { UINT64(0xb0de65388cc8ada8),   189,   76 },
+    { UINT64(0x83c7088e1aab65db),   216,   84 },
+    { UINT64(0xc45d1df942711d9a),   242,   92 },
+    { UINT64(0x924d692ca61be758),   269,  100 },
+    { UINT64(0xda01ee641a708dea),   295,  108 },
+    { UINT64(0xa26da3999aef774a),   322,  116 },
+    { UINT64(0xf209787bb47d6b85),   348,  124 },
+    { UINT64(0xb454e4a179dd1877),   375,  132 },
+    { UINT64(0x865b86925b9bc5c2),   402,  140 },
+    { UINT64(0xc83553c5c8965d3d),   428,  148 },
+    { UINT64(0x952ab45cfa97a0b3),   455,  156 },
+    { UINT64(0xde469fbd99a05fe3),   481,  164 },
+    { UINT64(0xa59bc234db398c25),   508,  172 },
+    { UINT64(0xf6c69a72a3989f5c),   534,  180 },
+    { UINT64(0xb7dcbf5354e9bece),   561,  188 },
+    { UINT64(0x88fcf317f22241e2),   588,  196 },
+    { UINT64(0xcc20ce9bd35c78a5),   614,  204 },
+    { UINT64(0x98165af37b2153df),   641,  212 },
+    { UINT64(0xe2a0b5dc971f303a),   667,  220 },
+    { UINT64(0xa8d9d1535ce3b396),   694,  228 },
+    { UINT64(0xfb9b7cd9a4a7443c),   720,  236 },
+    { UINT64(0xbb764c4ca7a44410),   747,  244 },
+    { UINT64(0x8bab8eefb6409c1a),   774,  252 },
+    { UINT64(0xd01fef10a657842c),   800,  260 },
+    { UINT64(0x9b10a4e5e9913129),   827,  268 },
+    { UINT64(0xe7109bfba19c0c9d),   853,  276 },
+    { UINT64(0xac2820d9623bf429),   880,  284 },
+    { UINT64(0x80444b5e7aa7cf85),   907,  292 },
+    { UINT64(0xbf21e44003acdd2d),   933,  300 },
+    { UINT64(0x8e679c2f5e44ff8f),   960,  308 },
+    { UINT64(0xd433179d9c8cb841),   986,  316 },
+    { UINT64(0x9e19db92b4e31ba9),  1013,  324 },
+    { UINT64(0xeb96bf6ebadf77d9),  1039,  332 },
+    { UINT64(0xaf87023b9bf0ee6b),  1066,  340 },
+};
+
+#define POWERS_OFFSET       348         /* -cachedPowers[0].k */
+#define POWERS_STEP         8           /* Decimal exponent distance between cached powers */
+#define MIN_TARGET_EXP      -60         /* Range for the binary exponent of the scaled value */
+#define MAX_TARGET_EXP      -32
+#define D_1_LOG2_10         0.30102999566398114
+
+#define HIDDEN_BIT          UINT64(0x0010000000000000)
+#define SIGNIFICAND_MASK    UINT64(0x000FFFFFFFFFFFFF)
+#define EXPONENT_BIAS       (0x3FF + 52)
+#define DENORMAL_EXPONENT   (-EXPONENT_BIAS + 1)
+
+/***************************** Forward Declarations ***************************/
+
+static int digitGen(DiyFp low, DiyFp w, DiyFp high, char *buf, int *length, int *kappa);
+static int digitGenCounted(DiyFp w, int requested, char *buf, int *length, int *kappa);
+
+/*********************************** Code *************************************/
+
+static DiyFp multiply(DiyFp x, DiyFp y)
+{
+    DiyFp       r;
+    uint64      a, b, c, d, ac, bc, ad, bd, tmp, m32;
+
+    /*
+     *  128-bit product of the significands keeping the upper 64 bits, rounded
+     */
+    m32 = UINT64(0xFFFFFFFF);
+    a = x.f >> 32;
+    b = x.f & m32;
+    c = y.f >> 32;
+    d = y.f & m32;
+    ac = a * c;
+    bc = b * c;
+    ad = a * d;
+    bd = b * d;
+    tmp = (bd >> 32) + (ad & m32) + (bc & m32);
+    tmp += UINT64(1) << 31;
+    r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+    r.e = x.e + y.e + 64;
+    return r;
+}
+
+
+static DiyFp normalize(DiyFp v)
+{
+    while (!(v.f & UINT64(0xFFC0000000000000))) {
+        v.f <<= 10;
+        v.e -= 10;
+    }
+    while (!(v.f & UINT64(0x8000000000000000))) {
+        v.f <<= 1;
+        v.e--;
+    }
+    return v;
+}
+
+
+/*
+ *  Split a finite, positive double into its significand and binary exponent
+ */
+static DiyFp toDiyFp(double value, int *lowerBoundaryIsCloser)
+{
+    DiyFp       v;
+    uint64      bits;
+    int         biased;
+
+    memcpy(&bits, &value, sizeof(bits));
+    biased = (int) ((bits >> 52) & 0x7FF);
+    if (biased == 0) {
+        v.f = bits & SIGNIFICAND_MASK;
+        v.e = DENORMAL_EXPONENT;
+    } else {
+        v.f = (bits & SIGNIFICAND_MASK) + HIDDEN_BIT;
+        v.e = biased - EXPONENT_BIAS;
+    }
+    if (lowerBoundaryIsCloser) {
+        *lowerBoundaryIsCloser = (bits & SIGNIFICAND_MASK) == 0 && biased > 1;
+    }
+    return v;
+}
+
+
+/*
+ *  Get a cached power of ten that scales a value with binary exponent "e" into the target exponent range
+ */
+static DiyFp getCachedPower(int e, int *decimalExponent)
+{
+    const CachedPower   *cp;
+    DiyFp               power;
+    int                 k, index;
+
+    k = (int) ceil((MIN_TARGET_EXP - (e + 64) + 64 - 1) * D_1_LOG2_10);
+    index = (POWERS_OFFSET + k - 1) / POWERS_STEP + 1;
+    cp = &cachedPowers[index];
+    mprAssert(MIN_TARGET_EXP <= e + 64 + cp->e && e + 64 + cp->e <= MAX_TARGET_EXP);
+    *decimalExponent = cp->k;
+    power.f = cp->f;
+    power.e = cp->e;
+    return power;
+}
+
+
+/*
+ *  Get the largest power of ten that is less than or equal to number. Returns the power and the number of digits.
+ */
+static uint biggestPowerTen(uint number, int *digits)
+{
+    uint    power;
+    int     count;
+
+    if (number == 0) {
+        *digits = 0;
+        return 0;
+    }
+    power = 1;
+    count = 1;
+    while (count < 10 && number / 10 >= power) {
+        power *= 10;
+        count++;
+    }
+    *digits = count;
+    return power;
+}
+
+
+/*
+ *  Adjust the last digit so the result is closest to the real value. Return false if the digits can't be shown 
+ *  to be the shortest and closest. All distances are in units of the scaled value.
+ */
+static int roundWeed(char *buf, int length, uint64 distanceTooHighW, uint64 unsafeInterval, uint64 rest, 
+        uint64 tenKappa, uint64 unit)
+{
+    uint64  smallDistance, bigDistance;
+
+    smallDistance = distanceTooHighW - unit;
+    bigDistance = distanceTooHighW + unit;
+
+    while (rest < smallDistance && unsafeInterval - rest >= tenKappa &&
+            (rest + tenKappa < smallDistance || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        buf[length - 1]--;
+        rest += tenKappa;
+    }
+    if (rest < bigDistance && unsafeInterval - rest >= tenKappa &&
+            (rest + tenKappa < bigDistance || bigDistance - rest > rest + tenKappa - bigDistance)) {
+        return 0;
+    }
+    return (2 * unit <= rest) && (rest <= unsafeInterval - 4 * unit);
+}
+
+
+/*
+ *  Generate the shortest digits of w that lie inside the (low, high) boundaries. The boundaries are widened by one
+ *  unit of imprecision so the digits are only trusted if roundWeed can prove them.
+ */
+static int digitGen(DiyFp low, DiyFp w, DiyFp high, char *buf, int *length, int *kappa)
+{
+    DiyFp       tooLow, tooHigh, one;
+    uint64      unsafeInterval, fractionals, rest, unit;
+    uint        integrals, divisor;
+    int         digit, digits;
+
+    unit = 1;
+    tooLow.f = low.f - unit;
+    tooLow.e = low.e;
+    tooHigh.f = high.f + unit;
+    tooHigh.e = high.e;
+    unsafeInterval = tooHigh.f - tooLow.f;
+    one.f = UINT64(1) << -w.e;
+    one.e = w.e;
+
+    integrals = (uint) (tooHigh.f >> -one.e);
+    fractionals = tooHigh.f & (one.f - 1);
+    divisor = biggestPowerTen(integrals, &digits);
+    *kappa = digits;
+    *length = 0;
+
+    while (*kappa > 0) {
+        digit = integrals / divisor;
+        buf[(*length)++] = (char) ('0' + digit);
+        integrals %= divisor;
+        (*kappa)--;
+        rest = ((uint64) integrals << -one.e) + fractionals;
+        if (rest < unsafeInterval) {
+            return roundWeed(buf, *length, tooHigh.f - w.f, unsafeInterval, rest, (uint64) divisor << -one.e, unit);
+        }
+        divisor /= 10;
+    }
+    for (;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        digit = (int) (fractionals >> -one.e);
+        buf[(*length)++] = (char) ('0' + digit);
+        fractionals &= one.f - 1;
+        (*kappa)--;
+        if (fractionals < unsafeInterval) {
+            return roundWeed(buf, *length, (tooHigh.f - w.f) * unit, unsafeInterval, fractionals, one.f, unit);
+        }
+    }
+}
+
+
+/*
+ *  Round the counted digits up if the rest is more than half. Return false if the error makes this uncertain.
+ */
+static int roundWeedCounted(char *buf, int length, uint64 rest, uint64 tenKappa, uint64 unit, int *kappa)
+{
+    int     i;
+
+    if (unit >= tenKappa || tenKappa - unit <= unit) {
+        return 0;
+    }
+    if ((tenKappa - rest > rest) && (tenKappa - 2 * rest >= 2 * unit)) {
+        return 1;
+    }
+    if ((rest > unit) && (tenKappa - (rest - unit) <= (rest - unit))) {
+        buf[length - 1]++;
+        for (i = length - 1; i > 0; i--) {
+            if (buf[i] != '0' + 10) {
+                break;
+            }
+            buf[i] = '0';
+            buf[i - 1]++;
+        }
+        if (buf[0] == '0' + 10) {
+            buf[0] = '1';
+            (*kappa)++;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+
+/*
+ *  Generate a fixed count of correctly rounded digits
+ */
+static int digitGenCounted(DiyFp w, int requested, char *buf, int *length, int *kappa)
+{
+    DiyFp       one;
+    uint64      error, fractionals, rest;
+    uint        integrals, divisor;
+    int         digit, digits;
+
+    error = 1;
+    one.f = UINT64(1) << -w.e;
+    one.e = w.e;
+    integrals = (uint) (w.f >> -one.e);
+    fractionals = w.f & (one.f - 1);
+    divisor = biggestPowerTen(integrals, &digits);
+    *kappa = digits;
+    *length = 0;
+
+    while (*kappa > 0) {
+        digit = integrals / divisor;
+        buf[(*length)++] = (char) ('0' + digit);
+        requested--;
+        integrals %= divisor;
+        (*kappa)--;
+        if (requested == 0) {
+            break;
+        }
+        divisor /= 10;
+    }
+    if (requested == 0) {
+        rest = ((uint64) integrals << -one.e) + fractionals;
+        return roundWeedCounted(buf, *length, rest, (uint64) divisor << -one.e, error, kappa);
+    }
+    while (requested > 0 && fractionals > error) {
+        fractionals *= 10;
+        error *= 10;
+        digit = (int) (fractionals >> -one.e);
+        buf[(*length)++] = (char) ('0' + digit);
+        requested--;
+        fractionals &= one.f - 1;
+        (*kappa)--;
+    }
+    if (requested != 0) {
+        return 0;
+    }
+    return roundWeedCounted(buf, *length, fractionals, one.f, error, kappa);
+}
+
+
+/*
+ *  Convert a finite, positive double to decimal digits. Mode is MPR_DTOA_ALL_DIGITS for the shortest digits that
+ *  round trip or MPR_DTOA_N_DIGITS for ndigits correctly rounded digits. The digits are null terminated without 
+ *  trailing zeros and *period is set to the position of the decimal point like dtoa(). Returns the count of digits
+ *  or zero if the conversion could not be done and the caller must fall back to dtoa(). Buf must hold at least
+ *  MPR_GRISU_BUFSIZE bytes.
+ */
+int mprGrisuDtoa(double value, int mode, int ndigits, char *buf, int *period)
+{
+    DiyFp       v, w, plus, minus, power, scaledW, scaledPlus, scaledMinus;
+    int         closer, mk, kappa, length, ok;
+
+    if (!(value > 0) || mprIsInfinite(value)) {
+        return 0;
+    }
+    v = toDiyFp(value, &closer);
+    w = normalize(v);
+    power = getCachedPower(w.e, &mk);
+    scaledW = multiply(w, power);
+
+    if (mode == MPR_DTOA_ALL_DIGITS) {
+        /*
+         *  Boundaries are halfway to the neighboring doubles
+         */
+        plus.f = (v.f << 1) + 1;
+        plus.e = v.e - 1;
+        plus = normalize(plus);
+        if (closer) {
+            minus.f = (v.f << 2) - 1;
+            minus.e = v.e - 2;
+        } else {
+            minus.f = (v.f << 1) - 1;
+            minus.e = v.e - 1;
+        }
+        minus.f <<= minus.e - plus.e;
+        minus.e = plus.e;
+        scaledMinus = multiply(minus, power);
+        scaledPlus = multiply(plus, power);
+        ok = digitGen(scaledMinus, scaledW, scaledPlus, buf, &length, &kappa);
+
+    } else if (mode == MPR_DTOA_N_DIGITS && 0 < ndigits && ndigits <= MPR_GRISU_MAX_DIGITS) {
+        ok = digitGenCounted(scaledW, ndigits, buf, &length, &kappa);
+
+    } else {
+        return 0;
+    }
+    if (!ok) {
+        return 0;
+    }
+    while (length > 1 && buf[length - 1] == '0') {
+        length--;
+        kappa++;
+    }
+    buf[length] = '\0';
+    *period = length - mk + kappa;
+    return length;
+}
+
+#else
+void __dummyGrisu() {}
+#endif /* BLD_FEATURE_FLOATING_POINT */
+
+/*
+ *  @copy   default
+ *
+ *  Copyright (c) Embedthis Software LLC, 2003-2011. All Rights Reserved.
+ *  Copyright (c) Michael O'Brien, 1993-2011. All Rights Reserved.
+ *
+ *  This software is distributed under commercial and open source licenses.
+ *  You may use the GPL open source license described below or you may acquire
+ *  a commercial license from Embedthis Software. You agree to be fully bound
+ *  by the terms of either license. Consult the LICENSE.TXT distributed with
+ *  this software for full details.
+ *
+ *  This software is open source; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation; either version 2 of the License, or (at your
+ *  option) any later version. See the GNU General Public License for more
+ *  details at: http://www.embedthis.com/downloads/gplLicense.html
+ *
+ *  This program is distributed WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *  This GPL license does NOT permit incorporating this software into
+ *  proprietary programs. If you are unable to comply with the GPL, you must
+ *  acquire a commercial license to use this software. Commercial licenses
+ *  for this software and support services are available from Embedthis
+ *  Software at http://www.embedthis.com
+ *
+ *  Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
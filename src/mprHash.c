@@ -2,9 +2,25 @@
  *  mprHash.cpp - Fast hashing table lookup module
  *
  *  This hash table uses a fast key lookup mechanism. Keys are strings and the value entries are arbitrary pointers.
- *  The keys are hashed into a series of buckets which then have a chain of hash entries using the standard doubly
- *  linked list classes (List/Link). The chain in in collating sequence so search time through the chain is on
- *  average (N/hashSize)/2.
+ *  The keys are hashed into a series of buckets which then have a chain of hash entries. The number of buckets is
+ *  a power of two and the table is resized automatically as entries are added and removed so that the load factor
+ *  stays between MPR_HASH_MIN_LOAD and MPR_HASH_MAX_LOAD percent.
+ *
+ *  Each entry stores its full hash code. Entries are kept in the order of their bit-reversed hash code: the low
+ *  bits select the bucket and the chain within a bucket is sorted by the remaining bits. Buckets are visited in
+ *  bit-reversed index order. This gives a walk order that does not depend on the number of buckets, so a resize
+ *  triggered by an add or remove in the middle of a mprGetFirstHash/mprGetNextHash walk neither skips nor repeats
+ *  the entries that were already in the table.
+ *
+ *  Keys are hashed 8 bytes at a time with a 64x64->128 bit multiply-fold mixer (the same construction as wyhash).
+ *  Caseless tables fold ASCII case a word at a time instead of per character. Tables holding keys from an untrusted
+ *  peer should be given a random seed via mprSetHashSeed so an attacker cannot precompute colliding keys.
+ *
+ *  Tables flagged MPR_HASH_ORDERED also link every entry into a list in insertion order. Walks then follow that list,
+ *  so they are O(count) and deterministic.
+ *
+ *  Tables created via mprCreateFlatHash use open addressing instead (see mprFlatHash.c). The API below dispatches
+ *  to that implementation for flat tables.
  *
  *  This module is not thread-safe. It is the callers responsibility to perform all thread synchronization.
  *
@@ -17,18 +33,23 @@
 
 /**************************** Forward Declarations ****************************/
 
-static int hashIndex(MprHashTable *table, cchar *key, int size);
 static MprHash  *lookupInner(int *bucketIndex, MprHash **prevSp, MprHashTable *table, cchar *key);
+static void linkHash(MprHashTable *table, MprHash *sp);
+static MprHash *nextBucket(MprHashTable *table, uint pos);
+static int resizeHash(MprHashTable *table, int hashSize);
+static void rehash(MprHashTable *table);
+static uint reverseBits(uint x);
 
 /*********************************** Code *************************************/
 /*
- *  Create a new hash table of a given size. Caller should provide a size that is a prime number for the greatest
- *  efficiency. Caller should use mprFree to free the hash table.
+ *  Create a new hash table of a given size. The size is an initial hint only and is rounded up to a power of two.
+ *  The table will grow as required. Caller should use mprFree to free the hash table.
  */
 
 MprHashTable *mprCreateHash(MprCtx ctx, int hashSize)
 {
     MprHashTable    *table;
+    int             bits;
 
     table = mprAllocObjZeroed(ctx, MprHashTable);
     if (table == 0) {
@@ -38,11 +59,13 @@ MprHashTable *mprCreateHash(MprCtx ctx, int hashSize)
     if (hashSize < MPR_DEFAULT_HASH_SIZE) {
         hashSize = MPR_DEFAULT_HASH_SIZE;
     }
-    table->hashSize = hashSize;
+    for (bits = 1; (1 << bits) < hashSize && bits < 30; bits++) ;
 
     table->count = 0;
-    table->hashSize = hashSize;
-    table->buckets = (MprHash**) mprAllocZeroed(table, (int) sizeof(MprHash*) * hashSize);
+    table->bits = bits;
+    table->hashSize = 1 << bits;
+    table->minSize = table->hashSize;
+    table->buckets = (MprHash**) mprAllocZeroed(table, (int) sizeof(MprHash*) * table->hashSize);
 
     if (table->buckets == 0) {
         mprFree(table);
@@ -56,6 +79,63 @@ MprHashTable *mprCreateHash(MprCtx ctx, int hashSize)
 void mprSetHashCaseless(MprHashTable *table)
 {
     table->flags |= MPR_HASH_CASELESS;
+    rehash(table);
+}
+
+
+void mprSetHashSeed(MprHashTable *table, uint seed)
+{
+    table->seed = seed;
+    rehash(table);
+}
+
+
+void mprSetHashOrdered(MprHashTable *table)
+{
+    mprAssert(table->count == 0);
+    table->flags |= MPR_HASH_ORDERED;
+}
+
+
+void mprSetHashBorrowedKeys(MprHashTable *table)
+{
+    mprAssert(table->count == 0);
+    table->flags |= MPR_HASH_BORROWED_KEYS;
+}
+
+
+void mprSetHashInternedKeys(MprHashTable *table)
+{
+    mprAssert(table->count == 0);
+    table->flags |= MPR_HASH_INTERNED_KEYS;
+}
+
+
+/*
+ *  Return the canonical copy of a string. The pool is a chained table so the key of each entry never moves.
+ */
+cchar *mprIntern(MprCtx ctx, cchar *str)
+{
+    Mpr         *mpr;
+    MprHash     *sp;
+    cchar       *interned;
+
+    mpr = mprGetMpr(ctx);
+    mprLock(mpr->mutex);
+    if (mpr->internPool == 0) {
+        mpr->internPool = mprCreateHash(mpr, 0);
+    }
+    interned = 0;
+    if (mpr->internPool) {
+        if ((sp = lookupInner(0, 0, mpr->internPool, str)) == 0) {
+            sp = mprAddDuplicateHash(mpr->internPool, str, 0);
+        }
+        if (sp) {
+            interned = sp->key;
+        }
+    }
+    mprUnlock(mpr->mutex);
+    return interned;
 }
 
 
@@ -64,10 +144,16 @@ MprHashTable *mprCopyHash(MprCtx ctx, MprHashTable *master)
     MprHash         *hp;
     MprHashTable    *table;
 
-    table = mprCreateHash(ctx, master->hashSize);
+    if (master->flags & MPR_HASH_FLAT) {
+        table = mprCreateFlatHash(ctx, master->count);
+    } else {
+        table = mprCreateHash(ctx, master->hashSize);
+    }
     if (table == 0) {
         return 0;
     }
+    table->flags |= (master->flags & ~MPR_HASH_BORROWED_KEYS);
+    table->seed = master->seed;
 
     hp = mprGetFirstHash(master);
     while (hp) {
@@ -83,10 +169,12 @@ MprHashTable *mprCopyHash(MprCtx ctx, MprHashTable *master)
  */
 MprHash *mprAddHash(MprHashTable *table, cchar *key, cvoid *ptr)
 {
-    MprHash     *sp, *prevSp;
-    int         index;
+    MprHash     *sp;
 
-    sp = lookupInner(&index, &prevSp, table, key);
+    if (table->flags & MPR_HASH_FLAT) {
+        return mprAddFlatHash(table, key, ptr, 0);
+    }
+    sp = lookupInner(0, 0, table, key);
 
     if (sp != 0) {
         /*
@@ -95,24 +183,7 @@ MprHash *mprAddHash(MprHashTable *table, cchar *key, cvoid *ptr)
         sp->data = ptr;
         return sp;
     }
-
-    /*
-     *  New entry
-     */
-    sp = mprAllocObjZeroed(table, MprHash);
-    if (sp == 0) {
-        return 0;
-    }
-
-    sp->data = ptr;
-    sp->key = mprStrdup(sp, key);
-    sp->bucket = index;
-
-    sp->next = table->buckets[index];
-    table->buckets[index] = sp;
-
-    table->count++;
-    return sp;
+    return mprAddDuplicateHash(table, key, ptr);
 }
 
 
@@ -124,23 +195,40 @@ MprHash *mprAddHash(MprHashTable *table, cchar *key, cvoid *ptr)
 MprHash *mprAddDuplicateHash(MprHashTable *table, cchar *key, cvoid *ptr)
 {
     MprHash     *sp;
-    int         index;
 
+    if (table->flags & MPR_HASH_FLAT) {
+        return mprAddFlatHash(table, key, ptr, 1);
+    }
     sp = mprAllocObjZeroed(table, MprHash);
     if (sp == 0) {
         return 0;
     }
 
-    index = hashIndex(table, key, table->hashSize);
-
     sp->data = ptr;
-    sp->key = mprStrdup(sp, key);
-    sp->bucket = index;
-
-    sp->next = table->buckets[index];
-    table->buckets[index] = sp;
-
+    if (table->flags & MPR_HASH_BORROWED_KEYS) {
+        sp->key = (char*) key;
+    } else if (table->flags & MPR_HASH_INTERNED_KEYS) {
+        sp->key = (char*) mprIntern(table, key);
+    } else {
+        sp->key = mprStrdup(sp, key);
+    }
+    if (sp->key == 0) {
+        mprFree(sp);
+        return 0;
+    }
+    sp->hash = mprHashKey(table, key);
+    linkHash(table, sp);
+    if (table->flags & MPR_HASH_ORDERED) {
+        mprLinkHashOrder(table, sp);
+    }
     table->count++;
+
+    if ((table->count * 100) > (table->hashSize * MPR_HASH_MAX_LOAD)) {
+        /*
+         *  Failure to grow is not fatal. The table keeps working with longer chains.
+         */
+        resizeHash(table, table->hashSize * 2);
+    }
     return sp;
 }
 
@@ -153,6 +241,9 @@ int mprRemoveHash(MprHashTable *table, cchar *key)
     MprHash     *sp, *prevSp;
     int         index;
 
+    if (table->flags & MPR_HASH_FLAT) {
+        return mprRemoveFlatHash(table, key);
+    }
     if ((sp = lookupInner(&index, &prevSp, table, key)) == 0) {
         return MPR_ERR_NOT_FOUND;
     }
@@ -162,9 +253,16 @@ int mprRemoveHash(MprHashTable *table, cchar *key)
     } else {
         table->buckets[index] = sp->next;
     }
+    if (table->flags & MPR_HASH_ORDERED) {
+        mprUnlinkHashOrder(table, sp);
+    }
     table->count--;
 
     mprFree(sp);
+
+    if (table->hashSize > table->minSize && (table->count * 100) < (table->hashSize * MPR_HASH_MIN_LOAD)) {
+        resizeHash(table, table->hashSize / 2);
+    }
     return 0;
 }
 
@@ -197,45 +295,20 @@ cvoid *mprLookupHash(MprHashTable *table, cchar *key)
 }
 
 
-static int sncasecmp(cchar *s1, cchar *s2, int n)
-{
-    int     rc;
-
-    mprAssert(0 <= n && n < MAXINT);
-
-    if (s1 == 0 || s2 == 0) {
-        return -1;
-    } else if (s1 == 0) {
-        return -1;
-    } else if (s2 == 0) {
-        return 1;
-    }
-    for (rc = 0; n > 0 && *s1 && rc == 0; s1++, s2++, n--) {
-        rc = tolower((int) *s1) - tolower((int) *s2);
-    }
-    if (rc) {
-        return (rc > 0) ? 1 : -1;
-    } else if (n == 0) {
-        return 0;
-    } else if (*s1 == '\0' && *s2 == '\0') {
-        return 0;
-    } else if (*s1 == '\0') {
-        return -1;
-    } else if (*s2 == '\0') {
-        return 1;
-    }
-    return 0;
-}
-
-
 static MprHash *lookupInner(int *bucketIndex, MprHash **prevSp, MprHashTable *table, cchar *key)
 {
     MprHash     *sp, *prev;
+    uint        hash, order;
     int         index, rc;
 
     mprAssert(key);
 
-    index = hashIndex(table, key, table->hashSize);
+    hash = mprHashKey(table, key);
+    if (table->flags & MPR_HASH_FLAT) {
+        return mprLookupFlatHash(table, key, hash);
+    }
+    order = reverseBits(hash);
+    index = hash & (table->hashSize - 1);
     if (bucketIndex) {
         *bucketIndex = index;
     }
@@ -244,8 +317,18 @@ static MprHash *lookupInner(int *bucketIndex, MprHash **prevSp, MprHashTable *ta
     prev = 0;
 
     while (sp) {
-        if (table->flags & MPR_HASH_CASELESS) {
-            rc = sncasecmp(sp->key, key, (int) max(strlen(sp->key), strlen(key)));
+        /*
+         *  Chains are sorted, so stop once past the place where the key would be
+         */
+        if (reverseBits(sp->hash) > order) {
+            break;
+        }
+        if (sp->hash != hash) {
+            rc = 1;
+        } else if (sp->key == key) {
+            rc = 0;
+        } else if (table->flags & MPR_HASH_CASELESS) {
+            rc = mprStrcmpAnyCase(sp->key, key);
         } else {
             rc = strcmp(sp->key, key);
         }
@@ -263,6 +346,135 @@ static MprHash *lookupInner(int *bucketIndex, MprHash **prevSp, MprHashTable *ta
 }
 
 
+/*
+ *  Link an entry into its bucket chain keeping the chain in bit-reversed hash order. Entries with an equal hash are
+ *  inserted in front of their peers so the most recent duplicate is found first by lookup.
+ */
+static void linkHash(MprHashTable *table, MprHash *sp)
+{
+    MprHash     **link;
+    uint        order;
+
+    order = reverseBits(sp->hash);
+    sp->bucket = sp->hash & (table->hashSize - 1);
+
+    for (link = &table->buckets[sp->bucket]; *link && reverseBits((*link)->hash) < order; link = &(*link)->next) ;
+    sp->next = *link;
+    *link = sp;
+}
+
+
+/*
+ *  Rebuild the table with a new number of buckets. Entries are relinked, not reallocated, so hash entry references
+ *  held by callers remain valid. Walking the old table in order and appending to the new chains preserves order.
+ */
+static int resizeHash(MprHashTable *table, int hashSize)
+{
+    MprHash     **buckets, **tails, *sp, *next;
+    uint        pos;
+    int         bits, index, oldSize, oldBits;
+
+    for (bits = 1; (1 << bits) < hashSize && bits < 30; bits++) ;
+    hashSize = 1 << bits;
+    if (hashSize == table->hashSize) {
+        return 0;
+    }
+    buckets = (MprHash**) mprAllocZeroed(table, (int) sizeof(MprHash*) * hashSize);
+    tails = (MprHash**) mprAllocZeroed(table, (int) sizeof(MprHash*) * hashSize);
+    if (buckets == 0 || tails == 0) {
+        mprFree(buckets);
+        mprFree(tails);
+        return MPR_ERR_NO_MEMORY;
+    }
+    oldSize = table->hashSize;
+    oldBits = table->bits;
+
+    for (pos = 0; pos < (uint) oldSize; pos++) {
+        index = reverseBits(pos << (32 - oldBits));
+        for (sp = table->buckets[index]; sp; sp = next) {
+            next = sp->next;
+            sp->next = 0;
+            sp->bucket = sp->hash & (hashSize - 1);
+            if (tails[sp->bucket]) {
+                tails[sp->bucket]->next = sp;
+            } else {
+                buckets[sp->bucket] = sp;
+            }
+            tails[sp->bucket] = sp;
+        }
+    }
+    mprFree(tails);
+    mprFree(table->buckets);
+    table->buckets = buckets;
+    table->hashSize = hashSize;
+    table->bits = bits;
+    return 0;
+}
+
+
+/*
+ *  Recompute the hash of every entry after the seed or case sensitivity has changed
+ */
+static void rehash(MprHashTable *table)
+{
+    MprHash     *list, *sp, *next;
+    int         i;
+
+    if (table->flags & MPR_HASH_FLAT) {
+        mprRehashFlatHash(table);
+        return;
+    }
+    if (table->count == 0) {
+        return;
+    }
+    list = 0;
+    for (i = 0; i < table->hashSize; i++) {
+        for (sp = table->buckets[i]; sp; sp = next) {
+            next = sp->next;
+            sp->next = list;
+            list = sp;
+        }
+        table->buckets[i] = 0;
+    }
+    for (sp = list; sp; sp = next) {
+        next = sp->next;
+        sp->hash = mprHashKey(table, sp->key);
+        linkHash(table, sp);
+    }
+}
+
+
+/*
+ *  Append an entry to the insertion order list of an ordered table
+ */
+void mprLinkHashOrder(MprHashTable *table, MprHash *sp)
+{
+    sp->nextOrder = 0;
+    sp->prevOrder = table->tail;
+    if (table->tail) {
+        table->tail->nextOrder = sp;
+    } else {
+        table->head = sp;
+    }
+    table->tail = sp;
+}
+
+
+void mprUnlinkHashOrder(MprHashTable *table, MprHash *sp)
+{
+    if (sp->prevOrder) {
+        sp->prevOrder->nextOrder = sp->nextOrder;
+    } else {
+        table->head = sp->nextOrder;
+    }
+    if (sp->nextOrder) {
+        sp->nextOrder->prevOrder = sp->prevOrder;
+    } else {
+        table->tail = sp->prevOrder;
+    }
+}
+
+
 int mprGetHashCount(MprHashTable *table)
 {
     return table->count;
@@ -270,17 +482,14 @@ int mprGetHashCount(MprHashTable *table)
 
 
 /*
- *  Return the first entry in the table.
+ *  Return the first non-empty bucket chain at or after the given walk position
  */
-MprHash *mprGetFirstHash(MprHashTable *table)
+static MprHash *nextBucket(MprHashTable *table, uint pos)
 {
     MprHash     *sp;
-    int         i;
 
-    mprAssert(table);
-
-    for (i = 0; i < table->hashSize; i++) {
-        if ((sp = (MprHash*) table->buckets[i]) != 0) {
+    for (; pos < (uint) table->hashSize; pos++) {
+        if ((sp = table->buckets[reverseBits(pos << (32 - table->bits))]) != 0) {
             return sp;
         }
     }
@@ -289,51 +498,179 @@ MprHash *mprGetFirstHash(MprHashTable *table)
 
 
 /*
- *  Return the next entry in the table
+ *  Return the first entry in the table.
  */
-MprHash *mprGetNextHash(MprHashTable *table, MprHash *last)
+MprHash *mprGetFirstHash(MprHashTable *table)
 {
-    MprHash     *sp;
-    int         i;
+    mprAssert(table);
+
+    if (table->flags & MPR_HASH_ORDERED) {
+        return table->head;
+    } else if (table->flags & MPR_HASH_FLAT) {
+        return mprGetNextFlatHash(table, 0);
+    }
+    return nextBucket(table, 0);
+}
+
 
+/*
+ *  Return the next entry in the table. The walk position is derived from the hash of the last entry rather than a
+ *  saved bucket index, so this is correct even if the table has been resized since the last call.
+ */
+MprHash *mprGetNextHash(MprHashTable *table, MprHash *last)
+{
     mprAssert(table);
 
     if (last == 0) {
         return mprGetFirstHash(table);
     }
+    if (table->flags & MPR_HASH_ORDERED) {
+        return last->nextOrder;
+    } else if (table->flags & MPR_HASH_FLAT) {
+        return mprGetNextFlatHash(table, last);
+    }
 
     if (last->next) {
         return last->next;
     }
+    return nextBucket(table, (reverseBits(last->hash) >> (32 - table->bits)) + 1);
+}
 
-    for (i = last->bucket + 1; i < table->hashSize; i++) {
-        if ((sp = (MprHash*) table->buckets[i]) != 0) {
-            return sp;
-        }
-    }
-    return 0;
+
+static uint reverseBits(uint x)
+{
+    x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+    x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F) | ((x & 0x0F0F0F0F) << 4);
+    x = ((x >> 8) & 0x00FF00FF) | ((x & 0x00FF00FF) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+
+#define HASH_P0     UINT64(0xa0761d6478bd642f)
+#define HASH_P1     UINT64(0xe7037ed1a0b428db)
+#define HASH_P2     UINT64(0x8ebc6af09c88c6e3)
+
+/*
+ *  Multiply two 64 bit values and fold the 128 bit product into 64 bits
+ */
+static MPR_INLINE uint64 mum(uint64 a, uint64 b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t     r;
+
+    r = (__uint128_t) a * b;
+    return (uint64) r ^ (uint64) (r >> 64);
+#else
+    uint64      ha, hb, la, lb, rh, rm0, rm1, rl, t, lo, carry;
+
+    ha = a >> 32;
+    hb = b >> 32;
+    la = (uint) a;
+    lb = (uint) b;
+    rh = ha * hb;
+    rm0 = ha * lb;
+    rm1 = hb * la;
+    rl = la * lb;
+    t = rl + (rm0 << 32);
+    carry = t < rl;
+    lo = t + (rm1 << 32);
+    carry += lo < t;
+    return lo ^ (rh + (rm0 >> 32) + (rm1 >> 32) + carry);
+#endif
 }
 
 
 /*
- *  Hash the key to produce a hash index.
+ *  Convert the ASCII upper case letters in each byte of a word to lower case
  */
-static int hashIndex(MprHashTable *table, cchar *key, int size)
+static MPR_INLINE uint64 foldCase(uint64 w)
 {
-    uint        sum;
+    uint64      low, ge, gt;
 
-    sum = 0;
-    if (table->flags & MPR_HASH_CASELESS) {
-        while (*key) {
-            sum += (sum * 33) + tolower((int) *key);
-            key++;
+    low = w & UINT64(0x7f7f7f7f7f7f7f7f);
+    ge = low + UINT64(0x3f3f3f3f3f3f3f3f);       /* High bit set if byte >= 'A' */
+    gt = low + UINT64(0x2525252525252525);       /* High bit set if byte > 'Z' */
+    return w | (((ge & ~gt & ~w) & UINT64(0x8080808080808080)) >> 2);
+}
+
+
+/*
+ *  Hash the key. Reads are done with memcpy so the key need not be aligned.
+ */
+/*
+ *  Load up to 8 bytes as a little endian word so hashes are the same on all hosts. Perfect hash tables generated
+ *  by makehash on the build host depend on this.
+ */
+static MPR_INLINE uint64 loadWord(cchar *key, size_t len)
+{
+    uint64      w;
+
+    w = 0;
+    memcpy(&w, key, len);
+#if MPR_ENDIAN == MPR_BIG_ENDIAN
+    w = ((w & UINT64(0x00000000000000ff)) << 56) | ((w & UINT64(0x000000000000ff00)) << 40) |
+        ((w & UINT64(0x0000000000ff0000)) << 24) | ((w & UINT64(0x00000000ff000000)) << 8) |
+        ((w & UINT64(0x000000ff00000000)) >> 8) | ((w & UINT64(0x0000ff0000000000)) >> 24) |
+        ((w & UINT64(0x00ff000000000000)) >> 40) | ((w & UINT64(0xff00000000000000)) >> 56);
+#endif
+    return w;
+}
+
+
+static uint hashString(cchar *key, uint seed, int caseless)
+{
+    uint64      h, w;
+    size_t      len, remaining;
+
+    len = strlen(key);
+    h = seed ^ HASH_P0;
+
+    for (remaining = len; remaining >= 8; remaining -= 8, key += 8) {
+        w = loadWord(key, 8);
+        if (caseless) {
+            w = foldCase(w);
         }
-    } else {
-        while (*key) {
-            sum += (sum * 33) + *key++;
+        h = mum(w ^ HASH_P1, h ^ HASH_P2) ^ h;
+    }
+    if (remaining > 0) {
+        w = loadWord(key, remaining);
+        if (caseless) {
+            w = foldCase(w);
         }
+        h = mum(w ^ HASH_P1, h ^ HASH_P2) ^ h;
+    }
+    h = mum(h ^ HASH_P2, (uint64) len ^ HASH_P1);
+    return (uint) (h ^ (h >> 32));
+}
+
+
+uint mprHashKey(MprHashTable *table, cchar *key)
+{
+    return hashString(key, table->seed, table->flags & MPR_HASH_CASELESS);
+}
+
+
+uint mprHashString(cchar *str, uint seed)
+{
+    return hashString(str, seed, 0);
+}
+
+
+/*
+ *  Return the slot for a key in a perfect hash table generated by makehash. The key hashes to one of size seeds.
+ *  A negative seed gives the slot directly, otherwise the seed is used to rehash the key. The caller must compare
+ *  the key at the slot as keys outside the generated set also map to a slot.
+ */
+int mprLookupPerfectHash(const short *seeds, int size, cchar *key)
+{
+    int     seed;
+
+    seed = seeds[mprHashString(key, 0) % size];
+    if (seed < 0) {
+        return -seed - 1;
     }
-    return sum % size;
+    return mprHashString(key, seed) % size;
 }
 
 
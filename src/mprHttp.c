@@ -17,6 +17,7 @@
 static void cleanup(MprHttp *http);
 static void completeRequest(MprHttp *http);
 static MprHttpRequest *createRequest(MprHttp *http);
+static MprHashTable *createHeaders(MprCtx ctx);
 static void badRequest(MprHttp *http, cchar *fmt, ...);
 static bool parseChunk(MprHttp *http, MprBuf *buf);
 static char *getHttpToken(MprBuf *buf, cchar *delim);
@@ -27,6 +28,7 @@ static int  parseAuthenticate(MprHttp *http, char *authDetails);
 static bool parseFirstLine(MprHttp *http, MprBuf *buf);
 static bool parseHeaders(MprHttp *http, MprBuf *buf);
 static void processResponse(MprHttp *http, MprBuf *buf, int nbytes);
+static int  waitForIO(MprHttp *http, int mask, int timeout);
 static int  writeData(MprHttp *http, cchar *buf, int len, int block);
 
 #if BLD_DEBUG
@@ -50,49 +52,58 @@ typedef struct MprHttpCode {
 } MprHttpCode;
 
 
+/*
+ *  Perfect hash table generated by makehash from httpCodes.txt. Do not edit.
+ *  Lookup with mprLookupPerfectHash(MprHttpCodesSeeds, MPR_HTTP_CODES_SIZE, key).
+ */
+#define MPR_HTTP_CODES_SIZE 37
+
+static const short MprHttpCodesSeeds[MPR_HTTP_CODES_SIZE] = {
+    -1, 1, 0, -10, -14, 0, 1, 0, 0, 0, -18, 4,
+    -19, 5, 0, 1, -20, -22, 0, 0, 0, 1, -23, -24,
+    1, -26, -27, 0, 5, -30, -31, 0, -32, 3, 0, -34,
+    -37,
+};
+
 MprHttpCode MprHttpCodes[] = {
-    { 100, "100", "Continue" },
-    { 200, "200", "OK" },
-    { 201, "201", "Created" },
-    { 202, "202", "Accepted" },
-    { 204, "204", "No Content" },
-    { 205, "205", "Reset Content" },
-    { 206, "206", "Partial Content" },
-    { 301, "301", "Moved Permanently" },
-    { 302, "302", "Moved Temporarily" },
-    { 304, "304", "Not Modified" },
-    { 305, "305", "Use Proxy" },
-    { 307, "307", "Temporary Redirect" },
-    { 400, "400", "Bad Request" },
-    { 401, "401", "Unauthorized" },
-    { 402, "402", "Payment Required" },
-    { 403, "403", "Forbidden" },
-    { 404, "404", "Not Found" },
-    { 405, "405", "Method Not Allowed" },
-    { 406, "406", "Not Acceptable" },
-    { 408, "408", "Request Timeout" },
     { 409, "409", "Conflict" },
+    { 417, "417", "Expectation Failed" },
     { 410, "410", "Length Required" },
-    { 411, "411", "Length Required" },
-    { 413, "413", "Request Entity Too Large" },
-    { 414, "414", "Request-URI Too Large" },
+    { 406, "406", "Not Acceptable" },
+    { 204, "204", "No Content" },
+    { 400, "400", "Bad Request" },
+    { 202, "202", "Accepted" },
     { 415, "415", "Unsupported Media Type" },
-    { 416, "416", "Requested Range Not Satisfiable" },
-    { 417, "417", "Expectation Failed" },
     { 500, "500", "Internal Server Error" },
-    { 501, "501", "Not Implemented" },
-    { 502, "502", "Bad Gateway" },
+    { 414, "414", "Request-URI Too Large" },
+    { 416, "416", "Requested Range Not Satisfiable" },
+    { 402, "402", "Payment Required" },
+    { 408, "408", "Request Timeout" },
+    { 505, "505", "Http Version Not Supported" },
+    { 201, "201", "Created" },
     { 503, "503", "Service Unavailable" },
+    { 301, "301", "Moved Permanently" },
     { 504, "504", "Gateway Timeout" },
-    { 505, "505", "Http Version Not Supported" },
+    { 411, "411", "Length Required" },
+    { 206, "206", "Partial Content" },
+    { 404, "404", "Not Found" },
+    { 305, "305", "Use Proxy" },
+    { 403, "403", "Forbidden" },
+    { 100, "100", "Continue" },
     { 507, "507", "Insufficient Storage" },
-
-    /*
-     *  Proprietary codes (used internally) when connection to client is severed
-     */
+    { 200, "200", "OK" },
+    { 405, "405", "Method Not Allowed" },
+    { 413, "413", "Request Entity Too Large" },
     { 550, "550", "Comms Error" },
     { 551, "551", "General Client Error" },
-    { 0,   0 }
+    { 307, "307", "Temporary Redirect" },
+    { 205, "205", "Reset Content" },
+    { 302, "302", "Moved Temporarily" },
+    { 304, "304", "Not Modified" },
+    { 401, "401", "Unauthorized" },
+    { 501, "501", "Not Implemented" },
+    { 502, "502", "Bad Gateway" },
+    { 0, 0 },
 };
 
 /************************************ Code **********************************/
@@ -103,17 +114,18 @@ MprHttpCode MprHttpCodes[] = {
 MprHttpService *mprCreateHttpService(MprCtx ctx)
 {
     MprHttpService      *hs;
-    MprHttpCode         *ep;
 
     hs = mprAllocObjZeroed(ctx, MprHttpService);
     if (hs == 0) {
         return 0;
     }
-    hs->connections = mprCreateList(hs);
+    mprInitLinkList(&hs->connections);
 
-    hs->codes = mprCreateHash(hs, 41);
-    for (ep = MprHttpCodes; ep->code; ep++) {
-        mprAddHash(hs->codes, ep->codeString, ep);
+    /*
+     *  Response header keys come from the peer. Seed their hash so colliding keys cannot be precomputed.
+     */
+    if (mprGetRandomBytes(hs, (char*) &hs->hashSeed, sizeof(hs->hashSeed), 0) < 0) {
+        hs->hashSeed = (uint) mprGetTime(hs);
     }
 #if BLD_FEATURE_MULTITHREAD
     hs->mutex = mprCreateLock(hs);
@@ -128,8 +140,8 @@ cchar *mprGetHttpCodeString(MprCtx ctx, int code)
     MprHttpCode     *ep;
     
     mprItoa(key, sizeof(key), code, 10);
-    ep = (MprHttpCode*) mprLookupHash(mprGetMpr(ctx)->httpService->codes, key);
-    if (ep == 0) {
+    ep = &MprHttpCodes[mprLookupPerfectHash(MprHttpCodesSeeds, MPR_HTTP_CODES_SIZE, key)];
+    if (strcmp(ep->codeString, key) != 0) {
         return "Custom error";
     }
     return ep->msg;
@@ -171,8 +183,9 @@ static void startHttpTimer(MprHttpService *hs)
 static void httpTimer(MprHttpService *hs, MprEvent *event)
 {
     MprHttp     *http;
+    MprLink     *lp, *next;
     MprTime     now;
-    int         next, count;
+    int         count;
 
     mprAssert(hs);
     mprAssert(event);
@@ -183,7 +196,9 @@ static void httpTimer(MprHttpService *hs, MprEvent *event)
     mprLock(hs->mutex);
 
     now = mprGetTime(hs);
-    for (count = 0, next = 0; (http = mprGetNextItem(hs->connections, &next)) != 0; count++) {
+    for (count = 0, lp = mprGetFirstLink(&hs->connections); lp; lp = next, count++) {
+        next = mprGetNextLink(&hs->connections, lp);
+        http = mprGetLinkItem(lp, MprHttp, link);
         /*
          *  See if more than the timeout period has passed since the last I/O. If so, disconnect and let the event 
          *  mechanism clean up. Add grace period of 5 seconds to allow blocked requests to cleanup first. 
@@ -208,7 +223,7 @@ static void httpTimer(MprHttpService *hs, MprEvent *event)
 static void addHttp(MprHttpService *hs, MprHttp *http)
 {
     mprLock(hs->mutex);
-    mprAddItem(hs->connections, http);
+    mprAppendLink(&hs->connections, &http->link);
     if (hs->timer == 0) {
         startHttpTimer(hs);
     }
@@ -264,7 +279,7 @@ static int httpDestructor(MprHttp *http)
     hs = http->service;
 
     mprLock(hs->mutex);
-    mprRemoveItem(hs->connections, http);
+    mprRemoveLink(&hs->connections, &http->link);
     mprFree(http->sock);
     mprUnlock(hs->mutex);
     return 0;
@@ -333,6 +348,7 @@ static MprHttpRequest *createRequest(MprHttp *http)
     }
     req->http = http;
     req->headers = mprCreateHash(req, -1);
+    mprSetHashOrdered(req->headers);
     req->outBuf = mprCreateBuf(req, http->bufsize, http->bufmax);
     req->chunked = -1;
     return req;
@@ -352,7 +368,7 @@ static void resetResponse(MprHttp *http)
     mprFlushBuf(resp->dataBuf);
     mprFlushBuf(resp->chunkBuf);
     mprFree(resp->headers);
-    resp->headers = mprCreateHash(resp, -1);
+    resp->headers = createHeaders(resp);
 }
 
 
@@ -384,6 +400,7 @@ static void cleanup(MprHttp *http)
 
     mprFree(req->headers);
     req->headers = mprCreateHash(req, -1);
+    mprSetHashOrdered(req->headers);
 
     if (req->bodyData != req->formData) {
         mprFree(req->bodyData);
@@ -398,6 +415,23 @@ static void cleanup(MprHttp *http)
 }
 
 
+/*
+ *  Create a hash for response headers using the service hash seed. Keys and values are references into the
+ *  response header buffer (see parseHeaders).
+ */
+static MprHashTable *createHeaders(MprCtx ctx)
+{
+    MprHashTable    *headers;
+
+    if ((headers = mprCreateFlatHash(ctx, -1)) != 0) {
+        mprSetHashSeed(headers, mprGetMpr(ctx)->httpService->hashSeed);
+        mprSetHashBorrowedKeys(headers);
+        mprSetHashOrdered(headers);
+    }
+    return headers;
+}
+
+
 /*
  *  Create a new response object. 
  */
@@ -409,7 +443,7 @@ static MprHttpResponse *createResponse(MprHttp *http)
     if (resp == 0) {
         return 0;
     }
-    resp->headers = mprCreateHash(resp, -1);
+    resp->headers = createHeaders(resp);
     resp->http = http;
     resp->code = -1;
     resp->headerBuf = mprCreateBuf(resp, http->bufsize, http->bufmax);
@@ -471,11 +505,17 @@ int mprStartHttpRequest(MprHttp *http, cchar *method, cchar *requestUrl)
     char                *host;
     int                 len, written, port, rc;
 
+    /*
+     *  Request lines and headers are formatted for every request so cache the compiled formats
+     */
+    static MprFormat    *requestFormat, *queryFormat, *hostFormat, *lengthFormat, *headerFormat;
+    static MprFormat    *logRequestFormat, *logReuseFormat;
+
     mprAssert(http);
     mprAssert(method && *method);
     mprAssert(requestUrl && *requestUrl);
 
-    mprLog(http, 4, "Http: request: %s %s", method, requestUrl);
+    mprLogFormat(http, 4, mprGetFormat(http, &logRequestFormat, "Http: request: %s %s"), method, requestUrl);
 
     rc = 0;
     req = http->request;
@@ -530,7 +570,8 @@ int mprStartHttpRequest(MprHttp *http, cchar *method, cchar *requestUrl)
             return MPR_ERR_CANT_OPEN;
         }
     } else {
-        mprLog(http, 4, "Http: reusing keep-alive socket on: %s:%d", host, port);
+        mprLogFormat(http, 4, mprGetFormat(http, &logReuseFormat, "Http: reusing keep-alive socket on: %s:%d"), 
+            host, port);
     }
 
     /*
@@ -546,9 +587,11 @@ int mprStartHttpRequest(MprHttp *http, cchar *method, cchar *requestUrl)
         }
     } else {
         if (url->query && *url->query) {
-            mprPutFmtToBuf(outBuf, "%s %s?%s %s\r\n", method, url->url, url->query, http->protocol);
+            mprPutFormatToBuf(outBuf, mprGetFormat(http, &queryFormat, "%s %s?%s %s\r\n"), method, url->url, 
+                url->query, http->protocol);
         } else {
-            mprPutFmtToBuf(outBuf, "%s %s %s\r\n", method, url->url, http->protocol);
+            mprPutFormatToBuf(outBuf, mprGetFormat(http, &requestFormat, "%s %s %s\r\n"), method, url->url, 
+                http->protocol);
         }
     }
 
@@ -616,17 +659,17 @@ int mprStartHttpRequest(MprHttp *http, cchar *method, cchar *requestUrl)
         req->sentCredentials = 1;
     }
 
-    mprPutFmtToBuf(outBuf, "Host: %s\r\n", host);
-    mprPutFmtToBuf(outBuf, "User-Agent: %s\r\n", MPR_HTTP_NAME);
+    mprPutFormatToBuf(outBuf, mprGetFormat(http, &hostFormat, "Host: %s\r\n"), host);
+    mprPutStringToBuf(outBuf, "User-Agent: " MPR_HTTP_NAME "\r\n");
 
     if (http->protocolVersion == 1) {
         if (http->keepAlive) {
-            mprPutFmtToBuf(outBuf, "Connection: Keep-Alive\r\n");
+            mprPutStringToBuf(outBuf, "Connection: Keep-Alive\r\n");
         } else {
-            mprPutFmtToBuf(outBuf, "Connection: close\r\n");
+            mprPutStringToBuf(outBuf, "Connection: close\r\n");
         }
         if (req->bodyLen > 0) {
-            mprPutFmtToBuf(outBuf, "Content-Length: %d\r\n", req->bodyLen);
+            mprPutFormatToBuf(outBuf, mprGetFormat(http, &lengthFormat, "Content-Length: %d\r\n"), req->bodyLen);
             req->chunked = 0;
 
         } else if (strcmp(method, "POST") == 0 || strcmp(method, "PUT") == 0) {
@@ -640,13 +683,13 @@ int mprStartHttpRequest(MprHttp *http, cchar *method, cchar *requestUrl)
 
     } else {
         http->keepAlive = 0;
-        mprPutFmtToBuf(outBuf, "Connection: close\r\n");
+        mprPutStringToBuf(outBuf, "Connection: close\r\n");
     }
 
     headers = http->request->headers;
     if (mprGetHashCount(headers) > 0) {
         for (header = 0; (header = mprGetNextHash(headers, header)) != 0; ) {
-            mprPutFmtToBuf(outBuf, "%s: %s\r\n", header->key, header->data);
+            mprPutFormatToBuf(outBuf, mprGetFormat(http, &headerFormat, "%s: %s\r\n"), header->key, header->data);
         }
     }
 
@@ -765,8 +808,12 @@ int mprWaitForHttp(MprHttp *http, int state, int timeout)
             if (http->sock) {
                 if (!mprIsSocketEof(http->sock) && !mprHasSocketPendingData(http->sock)) {
                     mprSetSocketBlockingMode(http->sock, 1);
-                    if (((events = mprWaitForSingleIO(http, http->sock->fd, mask, timeout)) == 0) || 
-                            mprGetElapsedTime(http, mark) >= timeout) {
+                    events = waitForIO(http, mask, timeout);
+                    if (http->sock == 0) {
+                        unlock(http);
+                        return MPR_ERR_BAD_STATE;
+                    }
+                    if (events == 0 || mprGetElapsedTime(http, mark) >= timeout) {
                         if (!mprGetDebugMode(http)) {
                             unlock(http);
                             return MPR_ERR_TIMEOUT;
@@ -785,6 +832,27 @@ int mprWaitForHttp(MprHttp *http, int state, int timeout)
 }
 
 
+/*
+ *  Wait for I/O on the http socket. Must be called locked. Inside a fiber, the lock is released while the fiber is
+ *  suspended. Other fibers run on this thread and would otherwise re-enter the recursive lock. The caller must 
+ *  recheck the http state as it may have changed.
+ */
+static int waitForIO(MprHttp *http, int mask, int timeout)
+{
+#if BLD_FEATURE_FIBERS
+    int     events;
+
+    if (mprGetCurrentFiber(http)) {
+        unlock(http);
+        events = mprWaitForSingleIO(http, http->sock->fd, mask, timeout);
+        lock(http);
+        return events;
+    }
+#endif
+    return mprWaitForSingleIO(http, http->sock->fd, mask, timeout);
+}
+
+
 /*
  *  Wait for receipt of the response headers from the remote server.
  */
@@ -825,7 +893,10 @@ int mprReadHttp(MprHttp *http, char *data, int size)
          *  Block if no data and no callback
          */
         if (mprGetBufLength(buf) == 0 && !http->callback && http->sock) {
-            if (mprWaitForSingleIO(http, http->sock->fd, MPR_READABLE, http->timeoutPeriod) < 0) {
+            if (waitForIO(http, MPR_READABLE, http->timeoutPeriod) < 0) {
+                break;
+            }
+            if (http->sock == 0 || http->response != resp) {
                 break;
             }
         }
@@ -841,23 +912,30 @@ int mprReadHttp(MprHttp *http, char *data, int size)
  */
 char *mprReadHttpString(MprHttp *http)
 {
-    MprBuf      *buf;
-    char        data[MPR_HTTP_BUFSIZE], *result;
-    int         count;
+    MprBufChain     *chain;
+    char            *end, *result;
+    int             count, space;
 
     if (http->state == MPR_HTTP_STATE_BEGIN) {
         return 0;
     } 
-    buf = mprCreateBuf(http, MPR_HTTP_BUFSIZE, -1);
+    /*
+     *  Read directly into a chain so a large body is copied once when flattened rather than each time a buffer grows
+     */
+    if ((chain = mprCreateBufChain(http, MPR_HTTP_BUFSIZE, -1)) == 0) {
+        return 0;
+    }
     do {
-        if ((count = mprReadHttp(http, data, sizeof(data))) > 0) {
-            mprPutBlockToBuf(buf, data, count);
+        if ((space = mprReserveBufChain(chain, &end)) <= 0) {
+            break;
+        }
+        if ((count = mprReadHttp(http, end, space)) > 0) {
+            mprAdjustBufChainEnd(chain, count);
         }
     } while (count > 0 && !http->callback);
 
-    mprAddNullToBuf(buf);
-    result = mprStealBuf(http, buf);
-    mprFree(buf);
+    result = mprGetBufChainString(http, chain);
+    mprFree(chain);
     return result;
 }
 
@@ -908,6 +986,8 @@ static int httpReadEvent(MprHttp *http)
     MprBuf          *buf;
     int             nbytes, len;
 
+    static MprFormat *readFormat;
+
     mprAssert(http->sock);
     mprAssert(http->request);
     mprAssert(http->response);
@@ -948,7 +1028,7 @@ static int httpReadEvent(MprHttp *http)
         }
 
     } else if (nbytes > 0) {
-        mprLog(http, 5, "Read %d bytes from socket, ask for %d", nbytes, len);
+        mprLogFormat(http, 5, mprGetFormat(http, &readFormat, "Read %d bytes from socket, ask for %d"), nbytes, len);
         traceData(http, mprGetBufStart(buf), nbytes);
         mprAdjustBufEnd(buf, nbytes);
         processResponse(http, buf, nbytes);
@@ -1110,7 +1190,7 @@ static bool parseHeaders(MprHttp *http, MprBuf *buf)
             value++;
         }
         /*
-         *  Save each header in the headers hash. Not strduped, these are references into the buffer.
+         *  Save each header in the headers hash. Neither key nor value is strduped, these are references into the buffer.
          */
         mprAddHash(resp->headers, mprStrUpper(key), value);
 
@@ -1425,6 +1505,7 @@ int mprAddHttpFormData(MprHttp *http, cchar *body, int len)
 int mprAddHttpFormItem(MprHttp *http, cchar *keyArg, cchar *valueArg)
 {
     MprHttpRequest  *req;
+    MprStrBuilder   sb;
     char            *value, *key, *encodedKey, *encodedValue;
 
     req = http->request;
@@ -1451,16 +1532,24 @@ int mprAddHttpFormItem(MprHttp *http, cchar *keyArg, cchar *valueArg)
      */
     encodedKey = mprUrlEncode(http, key);
     encodedValue = mprUrlEncode(http, value);
+
+    mprInitStrBuilder(req, &sb, -1);
     if (req->formData) {
-        req->formData = mprReallocStrcat(req, -1, req->formData, "&", encodedKey, "=", encodedValue, NULL);
-    } else {
-        req->formData = mprStrcat(req, -1, encodedKey, "=", encodedValue, NULL);
+        mprPutBlockToBuilder(&sb, req->formData, req->formLen);
+        mprPutCharToBuilder(&sb, '&');
     }
+    mprPutStringToBuilder(&sb, encodedKey);
+    mprPutCharToBuilder(&sb, '=');
+    mprPutStringToBuilder(&sb, encodedValue);
+    mprFree(encodedKey);
     mprFree(encodedValue);
-    if (req->formData == 0) {
-        return 0;
+
+    mprFree(req->formData);
+    req->formLen = sb.length;
+    if ((req->formData = mprStealBuilder(&sb)) == 0) {
+        req->formLen = 0;
+        return MPR_ERR_NO_MEMORY;
     }
-    req->formLen = strlen(req->formData);
     return 0;
 }
 
@@ -1705,28 +1794,33 @@ char *mprGetHttpHeaders(MprHttp *http)
 {
     MprHttpResponse     *resp;
     MprHash             *hp;
-    char                *headers, *key, *cp;
-    int                 len;
+    MprStrBuilder       sb;
+    cchar               *cp;
 
     if (mprWaitForHttpResponse(http, -1) < 0) {
         return 0;
     }
     resp = http->response;
-    headers = 0;
-    for (len = 0, hp = mprGetFirstHash(resp->headers); hp; ) {
-        headers = mprReallocStrcat(http, -1, headers, hp->key, NULL);
-        key = &headers[len];
-        for (cp = &key[1]; *cp; cp++) {
-            *cp = tolower((int) *cp);
-            if (*cp == '-') {
-                cp++;
+    mprInitStrBuilder(http, &sb, -1);
+    for (hp = mprGetFirstHash(resp->headers); hp; hp = mprGetNextHash(resp->headers, hp)) {
+        /*
+         *  Keys are stored in upper case. Emit them capitalized: "Content-Length".
+         */
+        for (cp = hp->key; *cp; cp++) {
+            if (cp == hp->key || cp[-1] == '-') {
+                mprPutCharToBuilder(&sb, *cp);
+            } else {
+                mprPutCharToBuilder(&sb, tolower((int) *cp));
             }
         }
-        headers = mprReallocStrcat(http, -1, headers, ": ", hp->data, "\n", NULL);
-        len = (int) strlen(headers);
-        hp = mprGetNextHash(resp->headers, hp);
+        mprPutStringToBuilder(&sb, ": ");
+        mprPutStringToBuilder(&sb, hp->data);
+        mprPutCharToBuilder(&sb, '\n');
     }
-    return headers;
+    if (sb.length == 0) {
+        return 0;
+    }
+    return mprStealBuilder(&sb);
 }
 
 
@@ -14,9 +14,34 @@
 
 #include    "mpr.h"
 
+/*********************************** Locals ***********************************/
+/*
+ *  Lists are sorted with a stable merge sort. Short runs are insertion sorted and then merged bottom up, alternating
+ *  between the list items and a scratch array of the same length.
+ */
+#define SORT_RUN            16          /* Length of runs sorted by insertion before merging */
+#define SORT_MAX_SLICES     256         /* Maximum slices a parallel sort is divided into */
+
+#if BLD_FEATURE_MULTITHREAD
+/*
+ *  State shared by the participants of a parallel sort
+ */
+typedef struct ParallelSort {
+    MprListCompareProc  compare;
+    void                **items;        /* List items being sorted */
+    void                **tmp;          /* Scratch array */
+    void                **src;          /* Runs being merged in this pass */
+    void                **dest;         /* Output of this pass */
+    int                 length;         /* Number of items */
+    int                 width;          /* Length of the sorted runs in src */
+    int                 slices;         /* Number of independent pieces of work per pass */
+} ParallelSort;
+#endif
+
 /****************************** Forward Declarations **************************/
 
 static int growList(MprList *lp, int incr);
+static void sortRange(MprListCompareProc compare, void **items, void **tmp, int lo, int hi);
 
 /************************************ Code ************************************/
 /*
@@ -533,9 +558,230 @@ static int growList(MprList *lp, int incr)
 }
 
 
-void mprSortList(MprList *lp, MprListCompareProc compare)
+/*
+ *  A null compare function selects an inline string comparison so sorting strings does not pay for an indirect call
+ *  per comparison.
+ */
+static MPR_INLINE int sortCompare(MprListCompareProc compare, void **a, void **b)
+{
+    if (compare) {
+        return compare(a, b);
+    }
+    return strcmp((char*) *a, (char*) *b);
+}
+
+
+static void insertionSort(MprListCompareProc compare, void **items, int lo, int hi)
+{
+    void    *item;
+    int     i, j;
+
+    for (i = lo + 1; i < hi; i++) {
+        item = items[i];
+        for (j = i; j > lo && sortCompare(compare, &items[j - 1], &item) > 0; j--) {
+            items[j] = items[j - 1];
+        }
+        items[j] = item;
+    }
+}
+
+
+/*
+ *  Merge the sorted runs [a, aend) and [b, bend) into dest. Ties take the item from a which keeps the sort stable.
+ */
+static void mergeRuns(MprListCompareProc compare, void **a, void **aend, void **b, void **bend, void **dest)
+{
+    while (a < aend && b < bend) {
+        if (sortCompare(compare, b, a) < 0) {
+            *dest++ = *b++;
+        } else {
+            *dest++ = *a++;
+        }
+    }
+    if (a < aend) {
+        memcpy(dest, a, (aend - a) * sizeof(void*));
+    } else if (b < bend) {
+        memcpy(dest, b, (bend - b) * sizeof(void*));
+    }
+}
+
+
+/*
+ *  Sort items[lo, hi) using the same range of tmp as scratch. The result is left in items.
+ */
+static void sortRange(MprListCompareProc compare, void **items, void **tmp, int lo, int hi)
+{
+    void    **src, **dest, **t;
+    int     width, start, mid, end;
+
+    for (start = lo; start < hi; start += SORT_RUN) {
+        insertionSort(compare, items, start, min(start + SORT_RUN, hi));
+    }
+    src = items;
+    dest = tmp;
+    for (width = SORT_RUN; width < hi - lo; width *= 2) {
+        for (start = lo; start < hi; start += 2 * width) {
+            mid = min(start + width, hi);
+            end = min(start + 2 * width, hi);
+            if (mid < end && sortCompare(compare, &src[mid - 1], &src[mid]) > 0) {
+                mergeRuns(compare, &src[start], &src[mid], &src[mid], &src[end], &dest[start]);
+            } else {
+                /* Already in order. Common for presorted input */
+                memcpy(&dest[start], &src[start], (end - start) * sizeof(void*));
+            }
+        }
+        t = src;
+        src = dest;
+        dest = t;
+    }
+    if (src != items) {
+        memcpy(&items[lo], &src[lo], (hi - lo) * sizeof(void*));
+    }
+}
+
+
+int mprSortList(MprList *lp, MprListCompareProc compare)
+{
+    void    **tmp;
+
+    if (lp->length <= SORT_RUN) {
+        insertionSort(compare, lp->items, 0, lp->length);
+        return 0;
+    }
+    if ((tmp = (void**) mprAlloc(lp, lp->length * (int) sizeof(void*))) == 0) {
+        return MPR_ERR_NO_MEMORY;
+    }
+    sortRange(compare, lp->items, tmp, 0, lp->length);
+    mprFree(tmp);
+    return 0;
+}
+
+
+#if BLD_FEATURE_MULTITHREAD
+/*
+ *  Return how many of the first k items of the merge of a and b come from a. Each slice of a merge pass uses this to
+ *  find its inputs with a binary search so slices can be merged independently (merge path partitioning).
+ */
+static int coRank(MprListCompareProc compare, int k, void **a, int na, void **b, int nb)
 {
-    qsort(lp->items, lp->length, sizeof(void*), compare);
+    int     lo, hi, mid;
+
+    lo = max(0, k - nb);
+    hi = min(k, na);
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (sortCompare(compare, &b[k - mid - 1], &a[mid]) >= 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+
+static void sortChunks(void *data, int start, int end)
+{
+    ParallelSort    *ps;
+    int             i, lo;
+
+    ps = (ParallelSort*) data;
+    for (i = start; i < end; i++) {
+        lo = i * ps->width;
+        if (lo < ps->length) {
+            sortRange(ps->compare, ps->items, ps->tmp, lo, min(lo + ps->width, ps->length));
+        }
+    }
+}
+
+
+/*
+ *  Merge one slice of the output of a pass. A slice may span several pairs of runs or part of one pair.
+ */
+static void mergeSlices(void *data, int start, int end)
+{
+    ParallelSort    *ps;
+    void            **a, **b;
+    int             s, k0, k1, pair, first, mid, last, lo, hi, na, nb, i0, i1;
+
+    ps = (ParallelSort*) data;
+    for (s = start; s < end; s++) {
+        k0 = (int) ((int64) s * ps->length / ps->slices);
+        k1 = (int) ((int64) (s + 1) * ps->length / ps->slices);
+        for (pair = k0 / (2 * ps->width); pair * 2 * ps->width < k1; pair++) {
+            first = pair * 2 * ps->width;
+            mid = min(first + ps->width, ps->length);
+            last = min(first + 2 * ps->width, ps->length);
+            lo = max(k0, first);
+            hi = min(k1, last);
+            a = &ps->src[first];
+            b = &ps->src[mid];
+            na = mid - first;
+            nb = last - mid;
+            i0 = coRank(ps->compare, lo - first, a, na, b, nb);
+            i1 = coRank(ps->compare, hi - first, a, na, b, nb);
+            mergeRuns(ps->compare, &a[i0], &a[i1], &b[lo - first - i0], &b[hi - first - i1], &ps->dest[lo]);
+        }
+    }
+}
+
+
+static void runSortPass(MprList *lp, ParallelSort *ps, MprForProc proc)
+{
+    if (mprParallelFor(lp, 0, ps->slices, 1, proc, ps) < 0) {
+        /* Could not start helpers. The slices are independent so run them all here */
+        proc(ps, 0, ps->slices);
+    }
+}
+#endif
+
+
+int mprParallelSortList(MprList *lp, MprListCompareProc compare)
+{
+    return mprSortListInParallel(lp, compare, MPR_SORT_PARALLEL_MIN, mprGetCpuCount(lp));
+}
+
+
+int mprSortListInParallel(MprList *lp, MprListCompareProc compare, int minLength, int numCpu)
+{
+#if BLD_FEATURE_MULTITHREAD
+    ParallelSort    ps;
+    void            **t;
+
+    if (lp->length < minLength || numCpu <= 1) {
+        return mprSortList(lp, compare);
+    }
+    if ((ps.tmp = (void**) mprAlloc(lp, lp->length * (int) sizeof(void*))) == 0) {
+        return MPR_ERR_NO_MEMORY;
+    }
+    ps.compare = compare;
+    ps.items = lp->items;
+    ps.length = lp->length;
+
+    /*
+     *  Use a few slices per CPU so uneven slices balance out. Sort one chunk per slice, then merge pairs of runs until
+     *  one run remains. Every merge pass is split into the same number of equal slices of output.
+     */
+    for (ps.slices = 1; ps.slices < numCpu * 4 && ps.slices < SORT_MAX_SLICES; ps.slices *= 2) ;
+    ps.width = (ps.length + ps.slices - 1) / ps.slices;
+    runSortPass(lp, &ps, sortChunks);
+
+    ps.src = ps.items;
+    ps.dest = ps.tmp;
+    for (; ps.width < ps.length; ps.width *= 2) {
+        runSortPass(lp, &ps, mergeSlices);
+        t = ps.src;
+        ps.src = ps.dest;
+        ps.dest = t;
+    }
+    if (ps.src != ps.items) {
+        memcpy(ps.items, ps.src, ps.length * sizeof(void*));
+    }
+    mprFree(ps.tmp);
+    return 0;
+#else
+    return mprSortList(lp, compare);
+#endif
 }
 
 
@@ -553,6 +799,73 @@ MprKeyValue *mprCreateKeyPair(MprCtx ctx, cchar *key, cchar *value)
 }
 
 
+void mprInitLinkList(MprLinkList *list)
+{
+    list->head.next = list->head.prev = &list->head;
+    list->length = 0;
+}
+
+
+void mprAppendLink(MprLinkList *list, MprLink *link)
+{
+    mprAssert(link->next == 0);
+
+    link->next = &list->head;
+    link->prev = list->head.prev;
+    list->head.prev->next = link;
+    list->head.prev = link;
+    list->length++;
+}
+
+
+void mprPrependLink(MprLinkList *list, MprLink *link)
+{
+    mprAssert(link->next == 0);
+
+    link->prev = &list->head;
+    link->next = list->head.next;
+    list->head.next->prev = link;
+    list->head.next = link;
+    list->length++;
+}
+
+
+void mprRemoveLink(MprLinkList *list, MprLink *link)
+{
+    if (link->next == 0) {
+        return;
+    }
+    link->next->prev = link->prev;
+    link->prev->next = link->next;
+    link->next = link->prev = 0;
+    list->length--;
+}
+
+
+MprLink *mprGetFirstLink(MprLinkList *list)
+{
+    return (list->head.next == &list->head) ? 0 : list->head.next;
+}
+
+
+MprLink *mprGetLastLink(MprLinkList *list)
+{
+    return (list->head.prev == &list->head) ? 0 : list->head.prev;
+}
+
+
+MprLink *mprGetNextLink(MprLinkList *list, MprLink *link)
+{
+    return (link->next == &list->head) ? 0 : link->next;
+}
+
+
+MprLink *mprGetPrevLink(MprLinkList *list, MprLink *link)
+{
+    return (link->prev == &list->head) ? 0 : link->prev;
+}
+
+
 /*
  *  @copy   default
  *  
@@ -424,10 +424,104 @@ void mprSpinUnlock(MprSpin *lock)
 }
 
 
-#else /* BLD_FEATURE_MULTITHREAD */
-void __dummyMprLock() {}
 #endif /* BLD_FEATURE_MULTITHREAD */
 
+/*
+ *  Atomic operations. These use the compiler or O/S primitives and are plain memory operations if single-threaded.
+ */
+void mprAtomicBarrier()
+{
+#if BLD_FEATURE_MULTITHREAD
+    #if BLD_WIN_LIKE
+        MemoryBarrier();
+    #elif VXWORKS && _WRS_VXWORKS_MAJOR >= 6
+        VX_MEM_BARRIER_RW();
+    #else
+        __sync_synchronize();
+    #endif
+#endif
+}
+
+
+bool mprAtomicCas(void * volatile *addr, cvoid *expected, cvoid *value)
+{
+#if !BLD_FEATURE_MULTITHREAD
+    if (*addr == expected) {
+        *addr = (void*) value;
+        return 1;
+    }
+    return 0;
+#elif BLD_WIN_LIKE
+    return InterlockedCompareExchangePointer(addr, (void*) value, (void*) expected) == expected;
+#elif VXWORKS && _WRS_VXWORKS_MAJOR >= 6 && !__GNUC__
+    /*
+     *  vxCas is only as wide as an int. Use the 64-bit primitive for 64-bit pointers.
+     */
+    #if MPR_64_BIT
+        return vxAtomic64Cas((atomic64_t*) addr, (atomic64Val_t) expected, (atomic64Val_t) value);
+    #else
+        return vxCas((atomic_t*) addr, (atomicVal_t) expected, (atomicVal_t) value);
+    #endif
+#else
+    return __sync_bool_compare_and_swap(addr, (void*) expected, (void*) value);
+#endif
+}
+
+
+bool mprAtomicCasInt(volatile int *addr, int expected, int value)
+{
+#if !BLD_FEATURE_MULTITHREAD
+    if (*addr == expected) {
+        *addr = value;
+        return 1;
+    }
+    return 0;
+#elif BLD_WIN_LIKE
+    return InterlockedCompareExchange((volatile LONG*) addr, value, expected) == expected;
+#elif VXWORKS && _WRS_VXWORKS_MAJOR >= 6 && !__GNUC__
+    #if MPR_64_BIT
+        return vxAtomic32Cas((atomic32_t*) addr, expected, value);
+    #else
+        return vxCas((atomic_t*) addr, expected, value);
+    #endif
+#else
+    return __sync_bool_compare_and_swap(addr, expected, value);
+#endif
+}
+
+
+void *mprAtomicExchange(void * volatile *addr, cvoid *value)
+{
+    void    *prior;
+
+#if !BLD_FEATURE_MULTITHREAD
+    prior = *addr;
+    *addr = (void*) value;
+#elif BLD_WIN_LIKE
+    prior = InterlockedExchangePointer(addr, (void*) value);
+#else
+    do {
+        prior = *addr;
+    } while (!mprAtomicCas(addr, prior, value));
+#endif
+    return prior;
+}
+
+
+int mprAtomicAdd(volatile int *addr, int value)
+{
+#if !BLD_FEATURE_MULTITHREAD
+    *addr += value;
+    return *addr;
+#elif BLD_WIN_LIKE
+    return InterlockedExchangeAdd((volatile LONG*) addr, value) + value;
+#elif VXWORKS && _WRS_VXWORKS_MAJOR >= 6
+    return vxAtomicAdd((atomic_t*) addr, value) + value;
+#else
+    return __sync_add_and_fetch(addr, value);
+#endif
+}
+
 /*
  *  @copy   default
  *
@@ -53,6 +53,25 @@ void mprLog(MprCtx ctx, int level, cchar *fmt, ...)
 }
 
 
+void mprLogFormat(MprCtx ctx, int level, MprFormat *format, ...)
+{
+    va_list     args;
+    char        *buf;
+
+    mprAssert(ctx);
+
+    if (level > mprGetLogLevel(ctx) || format == 0) {
+        return;
+    }
+    va_start(args, format);
+    buf = mprVasprintfFormat(ctx, -1, format, args);
+    va_end(args);
+
+    logOutput(ctx, MPR_LOG_SRC, level, buf);
+    mprFree(buf);
+}
+
+
 /*
  *  Do raw output
  */
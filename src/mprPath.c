@@ -687,7 +687,8 @@ bool mprIsRelPath(MprCtx ctx, cchar *path)
 char *mprJoinPath(MprCtx ctx, cchar *path, cchar *other)
 {
     MprFileSystem   *fs;
-    char            *join, *result, *drive, *cp;
+    MprStrBuilder   sb;
+    char            *result, *cp;
     int             sep;
 
     fs = mprLookupFileSystem(ctx, path);
@@ -699,13 +700,14 @@ char *mprJoinPath(MprCtx ctx, cchar *path, cchar *other)
             /*
              *  Other is absolute, but without a drive. Use the drive from path.
              */
-            drive = mprStrdup(ctx, path);
-            if ((cp = strchr(drive, ':')) != 0) {
-                *++cp = '\0';
+            mprInitStrBuilder(ctx, &sb, -1);
+            if ((cp = strchr(path, ':')) != 0) {
+                mprPutBlockToBuilder(&sb, path, (int) (cp - path) + 1);
+            } else {
+                mprPutStringToBuilder(&sb, path);
             }
-            result = mprStrcat(ctx, -1, drive, other, NULL);
-            mprFree(drive);
-            return result;
+            mprPutStringToBuilder(&sb, other);
+            return mprStealBuilder(&sb);
         } else {
             return mprGetNormalizedPath(ctx, other);
         }
@@ -720,11 +722,15 @@ char *mprJoinPath(MprCtx ctx, cchar *path, cchar *other)
     } else {
         sep = defaultSep(fs);
     }
-    if ((join = mprAsprintf(ctx, -1, "%s%c%s", path, sep, other)) == 0) {
-        return 0;
-    }
-    result = mprGetNormalizedPath(ctx, join);
-    mprFree(join);
+    /*
+     *  Join in the builder local storage so short paths need no temporary allocation
+     */
+    mprInitStrBuilder(ctx, &sb, -1);
+    mprPutStringToBuilder(&sb, path);
+    mprPutCharToBuilder(&sb, sep);
+    mprPutStringToBuilder(&sb, other);
+    result = (sb.error) ? 0 : mprGetNormalizedPath(ctx, mprGetBuilderString(&sb));
+    mprFreeBuilder(&sb);
     return result;
 }
 
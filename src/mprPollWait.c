@@ -44,6 +44,16 @@ int mprInitSelectWait(MprWaitService *ws)
 int mprWaitForSingleIO(MprCtx ctx, int fd, int mask, int timeout)
 {
     struct pollfd   fds[1];
+#if BLD_FEATURE_FIBERS
+    MprFiber        *fiber;
+
+    /*
+     *  Inside a fiber, suspend just the fiber and let the scheduler wait for the I/O
+     */
+    if (timeout != 0 && (fiber = mprGetCurrentFiber(ctx)) != 0) {
+        return mprWaitForFiberIO(fiber, fd, mask, timeout);
+    }
+#endif
 
     fds[0].fd = fd;
     fds[0].events = 0;
@@ -72,11 +82,14 @@ int mprWaitForSingleIO(MprCtx ctx, int fd, int mask, int timeout)
 static void serviceRecall(MprWaitService *ws)
 {
     MprWaitHandler      *wp;
-    int                 index;
+    MprLink             *lp, *next;
+    int                 removals;
 
     mprLock(ws->mutex);
     ws->flags &= ~MPR_NEED_RECALL;
-    for (index = 0; (wp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &index)) != 0; ) {
+    for (lp = mprGetFirstLink(&ws->handlers); lp; lp = next) {
+        next = mprGetNextLink(&ws->handlers, lp);
+        wp = mprGetLinkItem(lp, MprWaitHandler, link);
         if (wp->flags & MPR_WAIT_RECALL_HANDLER) {
             if ((wp->desiredMask & wp->disableMask) && wp->inUse == 0) {
                 wp->presentMask |= MPR_READABLE;
@@ -88,9 +101,16 @@ static void serviceRecall(MprWaitService *ws)
                 mprAssert(wp->inUse == 0);
                 wp->inUse++;
 #endif
+                removals = ws->removals;
                 mprUnlock(ws->mutex);
                 mprInvokeWaitCallback(wp);
                 mprLock(ws->mutex);
+                /*
+                 *  If handlers were removed while unlocked, the next link may be stale. Rescan from the list head.
+                 */
+                if (ws->removals != removals) {
+                    next = mprGetFirstLink(&ws->handlers);
+                }
 
             } else {
                 ws->flags |= MPR_NEED_RECALL;
@@ -149,9 +169,10 @@ int mprWaitForIO(MprWaitService *ws, int timeout)
  */
 static void getWaitFds(MprWaitService *ws)
 {
-    MprWaitHandler  *wp, *nextWp;
+    MprWaitHandler  *wp;
+    MprLink         *lp;
     struct pollfd   *pollfd;
-    int             mask, next;
+    int             mask;
 
     mprLock(ws->mutex);
 
@@ -171,9 +192,8 @@ static void getWaitFds(MprWaitService *ws)
     /*
      *  Add an entry for each descriptor desiring service.
      */
-    next = 0;
-    for (wp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &next); wp; wp = nextWp) {
-        nextWp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &next);
+    for (lp = mprGetFirstLink(&ws->handlers); lp; lp = mprGetNextLink(&ws->handlers, lp)) {
+        wp = mprGetLinkItem(lp, MprWaitHandler, link);
 
         if (wp->fd >= 0 && wp->proc && wp->desiredMask) {
             /*
@@ -210,8 +230,9 @@ static void getWaitFds(MprWaitService *ws)
 static void serviceIO(MprWaitService *ws, struct pollfd *fds, int count)
 {
     MprWaitHandler      *wp;
+    MprLink             *lp;
     struct pollfd       *fp;
-    int                 i, mask, index, start;
+    int                 i, mask, start;
 
     /*
      *  Must have the wait list stable while we service events
@@ -247,7 +268,8 @@ static void serviceIO(MprWaitService *ws, struct pollfd *fds, int count)
         /*
          *  Go in reverse order to maximize the chance of getting the most active connection
          */
-        for (index = -1; (wp = (MprWaitHandler*) mprGetPrevItem(ws->handlers, &index)) != 0; ) {
+        for (lp = mprGetLastLink(&ws->handlers); lp; lp = mprGetPrevLink(&ws->handlers, lp)) {
+            wp = mprGetLinkItem(lp, MprWaitHandler, link);
             mprAssert(wp->fd >= 0);
             if (wp->fd != fp->fd) {
                 continue;
@@ -329,7 +351,7 @@ static void growFds(MprWaitService *ws)
 {
     int     len;
 
-    len = max(ws->fdsSize, mprGetListCount(ws->handlers) + 1);
+    len = max(ws->fdsSize, mprGetLinkCount(&ws->handlers) + 1);
     if (len > ws->fdsSize) {
         ws->fds = mprRealloc(ws, ws->fds, len * (int) sizeof(struct pollfd));
         if (ws->fds == 0) {
@@ -56,12 +56,21 @@
 #define SPRINTF_INT64       0x80        /* 64-bit */
 #define SPRINTF_COMMA       0x100       /* Thousand comma separators */
 #define SPRINTF_UPPER_CASE  0x200       /* As the name says for numbers */
+#define SPRINTF_WIDTH_ARG   0x400       /* Width supplied by arg */
+#define SPRINTF_PRECISION_ARG 0x800     /* Precision supplied by arg */
 
+/*
+    Output goes to a string that is allocated and grown as required, a caller supplied string or directly into the
+    free space of an MprBuf sink or string builder. Sinks are grown in place so formatting into a buffer or builder 
+    needs no temporary string.
+ */
 typedef struct Format {
     uchar   *buf;
     uchar   *endbuf;
     uchar   *start;
     uchar   *end;
+    MprBuf  *sink;                      /* Buffer to format into. Null when formatting into a string */
+    MprStrBuilder *builder;             /* String builder to format into */
     int     growBy;
     int     maxsize;
 
@@ -72,6 +81,27 @@ typedef struct Format {
     int     len;
 } Format;
 
+/*
+    A format string is a sequence of literal runs and conversion specs
+ */
+typedef struct FormatOp {
+    cchar   *str;                       /* Literal text */
+    int     len;                        /* Length of literal text */
+    int     type;                       /* Conversion type character. Zero for literal text */
+    int     flags;
+    int     width;
+    int     precision;
+} FormatOp;
+
+/*
+    Compiled format. The ops refer to a private copy of the format string stored after the ops.
+ */
+struct MprFormat {
+    struct MprFormat **cache;           /* Call site cache holding this format (see mprGetFormat) */
+    int         count;
+    FormatOp    ops[1];
+};
+
 #define BPUT(ctx, fmt, c) \
     if (1) { \
         /* Less one to allow room for the null */ \
@@ -97,13 +127,23 @@ typedef struct Format {
 
 /***************************** Forward Declarations ***************************/
 
+static void bputBlock(MprCtx ctx, Format *fmt, cchar *str, int len);
+static void bputFill(MprCtx ctx, Format *fmt, int c, int count);
+static int  formatDestructor(MprFormat *format);
 static int  getState(char c, int state);
 static int  growBuf(MprCtx ctx, Format *fmt);
-static char *sprintfCore(MprCtx ctx, char *buf, int maxsize, cchar *fmt, va_list arg);
+static int  growSink(Format *fmt);
+static int  growBuilder(Format *fmt);
+static cchar *parseFormat(cchar *spec, FormatOp *op);
+static int  putToBuf(MprBuf *bp, cchar *spec, MprFormat *compiled, va_list arg);
+static void sprintfCore(MprCtx ctx, Format *fmt, cchar *spec, MprFormat *compiled, va_list arg);
+static char *sprintfString(MprCtx ctx, char *buf, int maxsize, cchar *spec, MprFormat *compiled, va_list arg);
 static void outNum(MprCtx ctx, Format *fmt, cchar *prefix, uint64 val);
 
 #if BLD_FEATURE_FLOATING_POINT
 static void outFloat(MprCtx ctx, Format *fmt, char specChar, double value);
+static char *putDigits(char *cp, cchar *digits, int count);
+static char *putPad(char *cp, int count);
 #endif
 
 /************************************* Code ***********************************/
@@ -192,7 +232,7 @@ int mprStaticPrintf(MprCtx ctx, cchar *fmt, ...)
     fs = mprLookupFileSystem(ctx, "/");
 
     va_start(ap, fmt);
-    sprintfCore(NULL, buf, MPR_MAX_STRING, fmt, ap);
+    sprintfString(NULL, buf, MPR_MAX_STRING, fmt, 0, ap);
     va_end(ap);
     return mprWrite(fs->stdOutput, buf, (int) strlen(buf));
 }
@@ -210,7 +250,7 @@ int mprStaticPrintfError(MprCtx ctx, cchar *fmt, ...)
     fs = mprLookupFileSystem(ctx, "/");
 
     va_start(ap, fmt);
-    sprintfCore(NULL, buf, MPR_MAX_STRING, fmt, ap);
+    sprintfString(NULL, buf, MPR_MAX_STRING, fmt, 0, ap);
     va_end(ap);
     return mprWrite(fs->stdError, buf, (int) strlen(buf));
 }
@@ -226,7 +266,7 @@ char *mprSprintf(char *buf, int bufsize, cchar *fmt, ...)
     mprAssert(bufsize > 0);
 
     va_start(ap, fmt);
-    result = sprintfCore(NULL, buf, bufsize, fmt, ap);
+    result = sprintfString(NULL, buf, bufsize, fmt, 0, ap);
     va_end(ap);
     return result;
 }
@@ -238,7 +278,7 @@ char *mprVsprintf(char *buf, int bufsize, cchar *fmt, va_list arg)
     mprAssert(fmt);
     mprAssert(bufsize > 0);
 
-    return sprintfCore(NULL, buf, bufsize, fmt, arg);
+    return sprintfString(NULL, buf, bufsize, fmt, 0, arg);
 }
 
 
@@ -250,7 +290,7 @@ char *mprAsprintf(MprCtx ctx, int maxSize, cchar *fmt, ...)
     mprAssert(fmt);
 
     va_start(ap, fmt);
-    buf = sprintfCore(ctx, NULL, maxSize, fmt, ap);
+    buf = sprintfString(ctx, NULL, maxSize, fmt, 0, ap);
     va_end(ap);
     return buf;
 }
@@ -259,7 +299,221 @@ char *mprAsprintf(MprCtx ctx, int maxSize, cchar *fmt, ...)
 char *mprVasprintf(MprCtx ctx, int maxSize, cchar *fmt, va_list arg)
 {
     mprAssert(fmt);
-    return sprintfCore(ctx, NULL, maxSize, fmt, arg);
+    return sprintfString(ctx, NULL, maxSize, fmt, 0, arg);
+}
+
+
+int mprPutFmtToBuf(MprBuf *bp, cchar *spec, ...)
+{
+    va_list     ap;
+    int         rc;
+
+    if (spec == 0) {
+        return 0;
+    }
+    va_start(ap, spec);
+    rc = putToBuf(bp, spec, 0, ap);
+    va_end(ap);
+    return rc;
+}
+
+
+/*
+    Compile a format string into a list of literal runs and conversion specs so it need not be parsed again
+ */
+MprFormat *mprCompileFormat(MprCtx ctx, cchar *spec)
+{
+    MprFormat   *format;
+    FormatOp    op;
+    cchar       *cp;
+    char        *text;
+    int         count, size, len;
+
+    mprAssert(spec);
+
+    for (count = 0, cp = spec; (cp = parseFormat(cp, &op)) != 0; ) {
+        count++;
+    }
+    len = (int) strlen(spec) + 1;
+    size = (int) sizeof(MprFormat) + (max(count, 1) - 1) * (int) sizeof(FormatOp);
+    if ((format = (MprFormat*) mprAllocWithDestructor(ctx, size + len, (MprDestructor) formatDestructor)) == 0) {
+        return 0;
+    }
+    text = &((char*) format)[size];
+    memcpy(text, spec, len);
+
+    format->cache = 0;
+    format->count = 0;
+    for (cp = text; (cp = parseFormat(cp, &op)) != 0; ) {
+        format->ops[format->count++] = op;
+    }
+    mprAssert(format->count == count);
+    return format;
+}
+
+
+/*
+    Clear the call site cache when the format is freed with the Mpr so a later Mpr in the same process recompiles
+ */
+static int formatDestructor(MprFormat *format)
+{
+    if (format->cache && *format->cache == format) {
+        *format->cache = 0;
+    }
+    return 0;
+}
+
+
+/*
+    Get a compiled format from a call site cache. The cache must be a static variable at the call site. The format
+    is compiled on first use and lives as long as the Mpr.
+ */
+MprFormat *mprGetFormat(MprCtx ctx, MprFormat **cache, cchar *spec)
+{
+    MprFormat   *format;
+
+    if ((format = *cache) != 0) {
+        return format;
+    }
+    if ((format = mprCompileFormat(mprGetMpr(ctx), spec)) == 0) {
+        return 0;
+    }
+    format->cache = cache;
+    if (!mprAtomicCas((void* volatile*) cache, 0, format)) {
+        /*
+            Another thread compiled it first
+         */
+        mprFree(format);
+        format = *cache;
+    }
+    return format;
+}
+
+
+char *mprAsprintfFormat(MprCtx ctx, int maxSize, MprFormat *format, ...)
+{
+    va_list     ap;
+    char        *buf;
+
+    mprAssert(format);
+
+    va_start(ap, format);
+    buf = sprintfString(ctx, NULL, maxSize, 0, format, ap);
+    va_end(ap);
+    return buf;
+}
+
+
+char *mprVasprintfFormat(MprCtx ctx, int maxSize, MprFormat *format, va_list arg)
+{
+    mprAssert(format);
+    return sprintfString(ctx, NULL, maxSize, 0, format, arg);
+}
+
+
+char *mprSprintfFormat(char *buf, int bufsize, MprFormat *format, ...)
+{
+    va_list     ap;
+    char        *result;
+
+    mprAssert(buf);
+    mprAssert(format);
+    mprAssert(bufsize > 0);
+
+    va_start(ap, format);
+    result = sprintfString(NULL, buf, bufsize, 0, format, ap);
+    va_end(ap);
+    return result;
+}
+
+
+int mprPutFormatToBuf(MprBuf *bp, MprFormat *format, ...)
+{
+    va_list     ap;
+    int         rc;
+
+    if (format == 0) {
+        return 0;
+    }
+    va_start(ap, format);
+    rc = putToBuf(bp, 0, format, ap);
+    va_end(ap);
+    return rc;
+}
+
+
+/*
+    Format directly into the builder storage, growing it in place as required
+ */
+int mprPutFmtToBuilder(MprStrBuilder *sb, cchar *spec, ...)
+{
+    Format      fmt;
+    va_list     ap;
+    int         count;
+
+    if (spec == 0) {
+        return 0;
+    }
+    if ((sb->length + 1) >= sb->size && mprGrowBuilder(sb, 1) < 0) {
+        return 0;
+    }
+    fmt.sink = 0;
+    fmt.builder = sb;
+    fmt.buf = (uchar*) sb->buf;
+    fmt.endbuf = (uchar*) &sb->buf[sb->size];
+    fmt.start = fmt.end = (uchar*) &sb->buf[sb->length];
+    fmt.growBy = 0;
+    fmt.maxsize = sb->maxsize;
+
+    va_start(ap, spec);
+    sprintfCore(NULL, &fmt, spec, 0, ap);
+    va_end(ap);
+
+    count = (int) (fmt.end - fmt.start);
+    sb->length = (int) ((char*) fmt.end - sb->buf);
+    sb->buf[sb->length] = '\0';
+    return count;
+}
+
+
+/*
+    Format directly into the free space of the buffer, growing it in place as required. Rings may have their free
+    space split around the end of the buffer so they are formatted via a temporary string instead.
+ */
+static int putToBuf(MprBuf *bp, cchar *spec, MprFormat *compiled, va_list arg)
+{
+    Format      fmt;
+    char        *buf;
+    int         rc, space;
+
+    if (bp->flags & MPR_BUF_RING) {
+        /*
+            Rings keep one byte free. Allow for the null in the formatted string.
+         */
+        space = (bp->maxsize > 0) ? (bp->maxsize - mprGetBufLength(bp)) : -1;
+        buf = sprintfString(bp, NULL, space, spec, compiled, arg);
+        rc = mprPutStringToBuf(bp, buf);
+        mprFree(buf);
+        return rc;
+    }
+    /*
+        Need room for at least the trailing null
+     */
+    if ((bp->endbuf - bp->end) < 2 && mprGrowBuf(bp, 0) < 0 && bp->end >= bp->endbuf) {
+        return 0;
+    }
+    fmt.sink = bp;
+    fmt.builder = 0;
+    fmt.buf = (uchar*) bp->data;
+    fmt.endbuf = (uchar*) bp->endbuf;
+    fmt.start = fmt.end = (uchar*) bp->end;
+    fmt.growBy = bp->growBy;
+    fmt.maxsize = bp->maxsize;
+    sprintfCore(NULL, &fmt, spec, compiled, arg);
+
+    rc = (int) (fmt.end - fmt.start);
+    mprAdjustBufEnd(bp, (int) ((char*) fmt.end - bp->end));
+    return rc;
 }
 
 
@@ -328,17 +582,15 @@ static int getState(char c, int state)
 }
 
 
-static char *sprintfCore(MprCtx ctx, char *buf, int maxsize, cchar *spec, va_list arg)
+/*
+    Format into a string. If buf is null, the string is allocated and grown as required up to maxsize. The format 
+    is either the spec string or a compiled format.
+ */
+static char *sprintfString(MprCtx ctx, char *buf, int maxsize, cchar *spec, MprFormat *compiled, va_list arg)
 {
     Format      fmt;
-    char        *cp, *sValue, c, *tmpBuf;
-    int64       iValue;
-    uint64      uValue;
-    int         i, len, state;
+    int         len;
 
-    if (spec == 0) {
-        spec = "";
-    }
     if (buf != 0) {
         mprAssert(maxsize > 0);
         fmt.buf = (uchar*) buf;
@@ -357,13 +609,32 @@ static char *sprintfCore(MprCtx ctx, char *buf, int maxsize, cchar *spec, va_lis
         fmt.endbuf = &fmt.buf[len];
         fmt.growBy = min(MPR_DEFAULT_ALLOC * 2, maxsize - len);
     }
-
+    fmt.sink = 0;
+    fmt.builder = 0;
     fmt.maxsize = maxsize;
     fmt.start = fmt.buf;
     fmt.end = fmt.buf;
-    fmt.len = 0;
     *fmt.start = '\0';
 
+    sprintfCore(ctx, &fmt, spec, compiled, arg);
+    return (char*) fmt.buf;
+}
+
+
+/*
+    Parse the next literal run or conversion spec from a format string. Returns a pointer to the rest of the string
+    or null at the end of the string.
+ */
+static cchar *parseFormat(cchar *spec, FormatOp *op)
+{
+    cchar   *cp;
+    char    c;
+    int     state;
+
+    op->type = 0;
+    op->flags = 0;
+    op->width = 0;
+    op->precision = -1;
     state = STATE_NORMAL;
 
     while ((c = *spec++) != '\0') {
@@ -371,48 +642,50 @@ static char *sprintfCore(MprCtx ctx, char *buf, int maxsize, cchar *spec, va_lis
 
         switch (state) {
         case STATE_NORMAL:
-            BPUT(ctx, &fmt, c);
-            break;
+            /*
+                A literal run up to the next format spec. Also ends a spec that is not valid.
+             */
+            for (cp = spec; *cp && *cp != '%'; cp++) ;
+            op->type = 0;
+            op->str = spec - 1;
+            op->len = (int) (cp - spec) + 1;
+            return cp;
 
         case STATE_PERCENT:
-            fmt.precision = -1;
-            fmt.width = 0;
-            fmt.flags = 0;
+            op->precision = -1;
+            op->width = 0;
+            op->flags = 0;
             break;
 
         case STATE_MODIFIER:
             switch (c) {
             case '+':
-                fmt.flags |= SPRINTF_SIGN;
+                op->flags |= SPRINTF_SIGN;
                 break;
             case '-':
-                fmt.flags |= SPRINTF_LEFT;
+                op->flags |= SPRINTF_LEFT;
                 break;
             case '#':
-                fmt.flags |= SPRINTF_ALTERNATE;
+                op->flags |= SPRINTF_ALTERNATE;
                 break;
             case '0':
-                fmt.flags |= SPRINTF_LEAD_ZERO;
+                op->flags |= SPRINTF_LEAD_ZERO;
                 break;
             case ' ':
-                fmt.flags |= SPRINTF_LEAD_SPACE;
+                op->flags |= SPRINTF_LEAD_SPACE;
                 break;
             case ',':
-                fmt.flags |= SPRINTF_COMMA;
+                op->flags |= SPRINTF_COMMA;
                 break;
             }
             break;
 
         case STATE_WIDTH:
             if (c == '*') {
-                fmt.width = va_arg(arg, int);
-                if (fmt.width < 0) {
-                    fmt.width = -fmt.width;
-                    fmt.flags |= SPRINTF_LEFT;
-                }
+                op->flags |= SPRINTF_WIDTH_ARG;
             } else {
                 while (isdigit((int) c)) {
-                    fmt.width = fmt.width * 10 + (c - '0');
+                    op->width = op->width * 10 + (c - '0');
                     c = *spec++;
                 }
                 spec--;
@@ -420,15 +693,15 @@ static char *sprintfCore(MprCtx ctx, char *buf, int maxsize, cchar *spec, va_lis
             break;
 
         case STATE_DOT:
-            fmt.precision = 0;
+            op->precision = 0;
             break;
 
         case STATE_PRECISION:
             if (c == '*') {
-                fmt.precision = va_arg(arg, int);
+                op->flags |= SPRINTF_PRECISION_ARG;
             } else {
                 while (isdigit((int) c)) {
-                    fmt.precision = fmt.precision * 10 + (c - '0');
+                    op->precision = op->precision * 10 + (c - '0');
                     c = *spec++;
                 }
                 spec--;
@@ -438,195 +711,252 @@ static char *sprintfCore(MprCtx ctx, char *buf, int maxsize, cchar *spec, va_lis
         case STATE_BITS:
             switch (c) {
             case 'L':
-                fmt.flags |= SPRINTF_INT64;
+                op->flags |= SPRINTF_INT64;
                 break;
 
             case 'l':
-                fmt.flags |= SPRINTF_LONG;
+                op->flags |= SPRINTF_LONG;
                 break;
 
             case 'h':
-                fmt.flags |= SPRINTF_SHORT;
+                op->flags |= SPRINTF_SHORT;
                 break;
             }
             break;
 
         case STATE_TYPE:
-            switch (c) {
-#if BLD_FEATURE_FLOATING_POINT
-            case 'e':
-            case 'g':
-            case 'f':
-                fmt.radix = 10;
-                outFloat(ctx, &fmt, c, (double) va_arg(arg, double));
+            op->type = c;
+            op->str = 0;
+            op->len = 0;
+            return spec;
+        }
+    }
+    return 0;
+}
+
+
+/*
+    Format output to the sink described by fmt. The format is either parsed from spec as it is output or taken 
+    from a compiled format. The result is always null terminated.
+ */
+static void sprintfCore(MprCtx ctx, Format *fp, cchar *spec, MprFormat *compiled, va_list arg)
+{
+    Format      fmt;
+    FormatOp    op, *opp;
+    char        *cp, *sValue, c, *tmpBuf;
+    int64       iValue;
+    uint64      uValue;
+    int         len, next;
+
+    if (spec == 0) {
+        spec = "";
+    }
+    fmt = *fp;
+    fmt.len = 0;
+    next = 0;
+
+    for (;;) {
+        if (compiled) {
+            if (next >= compiled->count) {
                 break;
-#endif
-            case 'c':
-                BPUT(ctx, &fmt, (char) va_arg(arg, int));
+            }
+            opp = &compiled->ops[next++];
+        } else {
+            if ((spec = parseFormat(spec, &op)) == 0) {
                 break;
+            }
+            opp = &op;
+        }
+        if (opp->type == 0) {
+            bputBlock(ctx, &fmt, opp->str, opp->len);
+            continue;
+        }
+        fmt.flags = opp->flags;
+        fmt.width = opp->width;
+        fmt.precision = opp->precision;
+        if (fmt.flags & SPRINTF_WIDTH_ARG) {
+            fmt.width = va_arg(arg, int);
+            if (fmt.width < 0) {
+                fmt.width = -fmt.width;
+                fmt.flags |= SPRINTF_LEFT;
+            }
+        }
+        if (fmt.flags & SPRINTF_PRECISION_ARG) {
+            fmt.precision = va_arg(arg, int);
+        }
+        c = (char) opp->type;
+
+        switch (c) {
+#if BLD_FEATURE_FLOATING_POINT
+        case 'e':
+        case 'g':
+        case 'f':
+            fmt.radix = 10;
+            outFloat(ctx, &fmt, c, (double) va_arg(arg, double));
+            break;
+#endif
+        case 'c':
+            BPUT(ctx, &fmt, (char) va_arg(arg, int));
+            break;
 
 #if FUTURE
-            case 'N':
-                qualifier = va_arg(arg, char*);
-                len = strlen(qualifier);
-                name = va_arg(arg, char*);
-                tmpBuf = mprAlloc(ctx, len + strlen(name) + 2);
-                if (tmpBuf == 0) {
-                    return NULL;
-                }
-                strcpy(tmpBuf, qualifier);
-                tmpBuf[len++] = ':';
-                strcpy(&tmpBuf[len], name);
-                sValue = tmpBuf;
-                goto emitString;
+        case 'N':
+            qualifier = va_arg(arg, char*);
+            len = strlen(qualifier);
+            name = va_arg(arg, char*);
+            tmpBuf = mprAlloc(ctx, len + strlen(name) + 2);
+            if (tmpBuf == 0) {
+                break;
+            }
+            strcpy(tmpBuf, qualifier);
+            tmpBuf[len++] = ':';
+            strcpy(&tmpBuf[len], name);
+            sValue = tmpBuf;
+            goto emitString;
 #endif
 
-            case 's':
-            case 'S':
-                sValue = va_arg(arg, char*);
-                tmpBuf = 0;
+        case 's':
+        case 'S':
+            sValue = va_arg(arg, char*);
+            tmpBuf = 0;
 
 #if FUTURE
-            emitString:
+        emitString:
 #endif
-                if (sValue == 0) {
-                    sValue = "null";
-                    len = (int) strlen(sValue);
-                } else if (fmt.flags & SPRINTF_ALTERNATE) {
-                    sValue++;
-                    len = (int) *sValue;
-                } else if (fmt.precision >= 0) {
-                    /*
-                     *  Can't use strlen(), the string may not have a null
-                     */
-                    cp = sValue;
-                    for (len = 0; len < fmt.precision; len++) {
-                        if (*cp++ == '\0') {
-                            break;
-                        }
-                    }
-                } else {
-                    len = (int) strlen(sValue);
-                }
-                if (!(fmt.flags & SPRINTF_LEFT)) {
-                    for (i = len; i < fmt.width; i++) {
-                        BPUT(ctx, &fmt, (char) ' ');
-                    }
-                }
-                for (i = 0; i < len && *sValue; i++) {
-                    BPUT(ctx, &fmt, *sValue++);
+            if (sValue == 0) {
+                sValue = "null";
+                len = (int) strlen(sValue);
+            } else if (fmt.flags & SPRINTF_ALTERNATE) {
+                sValue++;
+                len = (int) *sValue;
+                if ((cp = memchr(sValue, '\0', len)) != 0) {
+                    len = (int) (cp - sValue);
                 }
-                if (fmt.flags & SPRINTF_LEFT) {
-                    for (i = len; i < fmt.width; i++) {
-                        BPUT(ctx, &fmt, (char) ' ');
+            } else if (fmt.precision >= 0) {
+                /*
+                 *  Can't use strlen(), the string may not have a null
+                 */
+                cp = sValue;
+                for (len = 0; len < fmt.precision; len++) {
+                    if (*cp++ == '\0') {
+                        break;
                     }
                 }
-                if (tmpBuf) {
-                    mprFree(tmpBuf);
-                }
-                break;
+            } else {
+                len = (int) strlen(sValue);
+            }
+            if (!(fmt.flags & SPRINTF_LEFT)) {
+                bputFill(ctx, &fmt, ' ', fmt.width - len);
+            }
+            bputBlock(ctx, &fmt, sValue, len);
+            if (fmt.flags & SPRINTF_LEFT) {
+                bputFill(ctx, &fmt, ' ', fmt.width - len);
+            }
+            if (tmpBuf) {
+                mprFree(tmpBuf);
+            }
+            break;
 
-            case 'i':
-                ;
-            case 'd':
-                fmt.radix = 10;
-                if (fmt.flags & SPRINTF_SHORT) {
-                    iValue = (short) va_arg(arg, int);
-                } else if (fmt.flags & SPRINTF_LONG) {
-                    iValue = (long) va_arg(arg, long);
-                } else if (fmt.flags & SPRINTF_INT64) {
-                    iValue = (int64) va_arg(arg, int64);
-                } else {
-                    iValue = (int) va_arg(arg, int);
-                }
-                if (iValue >= 0) {
-                    if (fmt.flags & SPRINTF_LEAD_SPACE) {
-                        outNum(ctx, &fmt, " ", iValue);
-                    } else if (fmt.flags & SPRINTF_SIGN) {
-                        outNum(ctx, &fmt, "+", iValue);
-                    } else {
-                        outNum(ctx, &fmt, 0, iValue);
-                    }
+        case 'i':
+            ;
+        case 'd':
+            fmt.radix = 10;
+            if (fmt.flags & SPRINTF_SHORT) {
+                iValue = (short) va_arg(arg, int);
+            } else if (fmt.flags & SPRINTF_LONG) {
+                iValue = (long) va_arg(arg, long);
+            } else if (fmt.flags & SPRINTF_INT64) {
+                iValue = (int64) va_arg(arg, int64);
+            } else {
+                iValue = (int) va_arg(arg, int);
+            }
+            if (iValue >= 0) {
+                if (fmt.flags & SPRINTF_LEAD_SPACE) {
+                    outNum(ctx, &fmt, " ", iValue);
+                } else if (fmt.flags & SPRINTF_SIGN) {
+                    outNum(ctx, &fmt, "+", iValue);
                 } else {
-                    outNum(ctx, &fmt, "-", -iValue);
+                    outNum(ctx, &fmt, 0, iValue);
                 }
-                break;
+            } else {
+                outNum(ctx, &fmt, "-", -iValue);
+            }
+            break;
 
-            case 'X':
-                fmt.flags |= SPRINTF_UPPER_CASE;
+        case 'X':
+            fmt.flags |= SPRINTF_UPPER_CASE;
 #if MPR_64_BIT
-                fmt.flags &= ~(SPRINTF_SHORT|SPRINTF_LONG);
-                fmt.flags |= SPRINTF_INT64;
+            fmt.flags &= ~(SPRINTF_SHORT|SPRINTF_LONG);
+            fmt.flags |= SPRINTF_INT64;
 #else
-                fmt.flags &= ~(SPRINTF_INT64);
+            fmt.flags &= ~(SPRINTF_INT64);
 #endif
-                /*  Fall through  */
-            case 'o':
-            case 'x':
-            case 'u':
-                if (fmt.flags & SPRINTF_SHORT) {
-                    uValue = (ushort) va_arg(arg, uint);
-                } else if (fmt.flags & SPRINTF_LONG) {
-                    uValue = (ulong) va_arg(arg, ulong);
-                } else if (fmt.flags & SPRINTF_INT64) {
-                    uValue = (uint64) va_arg(arg, uint64);
+            /*  Fall through  */
+        case 'o':
+        case 'x':
+        case 'u':
+            if (fmt.flags & SPRINTF_SHORT) {
+                uValue = (ushort) va_arg(arg, uint);
+            } else if (fmt.flags & SPRINTF_LONG) {
+                uValue = (ulong) va_arg(arg, ulong);
+            } else if (fmt.flags & SPRINTF_INT64) {
+                uValue = (uint64) va_arg(arg, uint64);
+            } else {
+                uValue = va_arg(arg, uint);
+            }
+            if (c == 'u') {
+                fmt.radix = 10;
+                outNum(ctx, &fmt, 0, uValue);
+            } else if (c == 'o') {
+                fmt.radix = 8;
+                if (fmt.flags & SPRINTF_ALTERNATE && uValue != 0) {
+                    outNum(ctx, &fmt, "0", uValue);
                 } else {
-                    uValue = va_arg(arg, uint);
-                }
-                if (c == 'u') {
-                    fmt.radix = 10;
                     outNum(ctx, &fmt, 0, uValue);
-                } else if (c == 'o') {
-                    fmt.radix = 8;
-                    if (fmt.flags & SPRINTF_ALTERNATE && uValue != 0) {
-                        outNum(ctx, &fmt, "0", uValue);
+                }
+            } else {
+                fmt.radix = 16;
+                if (fmt.flags & SPRINTF_ALTERNATE && uValue != 0) {
+                    if (c == 'X') {
+                        outNum(ctx, &fmt, "0X", uValue);
                     } else {
-                        outNum(ctx, &fmt, 0, uValue);
+                        outNum(ctx, &fmt, "0x", uValue);
                     }
                 } else {
-                    fmt.radix = 16;
-                    if (fmt.flags & SPRINTF_ALTERNATE && uValue != 0) {
-                        if (c == 'X') {
-                            outNum(ctx, &fmt, "0X", uValue);
-                        } else {
-                            outNum(ctx, &fmt, "0x", uValue);
-                        }
-                    } else {
-                        outNum(ctx, &fmt, 0, uValue);
-                    }
+                    outNum(ctx, &fmt, 0, uValue);
                 }
-                break;
+            }
+            break;
 
-            case 'n':       /* Count of chars seen thus far */
-                if (fmt.flags & SPRINTF_SHORT) {
-                    short *count = va_arg(arg, short*);
-                    *count = (int) (fmt.end - fmt.start);
-                } else if (fmt.flags & SPRINTF_LONG) {
-                    long *count = va_arg(arg, long*);
-                    *count = (int) (fmt.end - fmt.start);
-                } else {
-                    int *count = va_arg(arg, int *);
-                    *count = (int) (fmt.end - fmt.start);
-                }
-                break;
+        case 'n':       /* Count of chars seen thus far */
+            if (fmt.flags & SPRINTF_SHORT) {
+                short *count = va_arg(arg, short*);
+                *count = (int) (fmt.end - fmt.start);
+            } else if (fmt.flags & SPRINTF_LONG) {
+                long *count = va_arg(arg, long*);
+                *count = (int) (fmt.end - fmt.start);
+            } else {
+                int *count = va_arg(arg, int *);
+                *count = (int) (fmt.end - fmt.start);
+            }
+            break;
 
-            case 'p':       /* Pointer */
+        case 'p':       /* Pointer */
 #if MPR_64_BIT
-                uValue = (uint64) va_arg(arg, void*);
+            uValue = (uint64) va_arg(arg, void*);
 #else
-                uValue = (uint) PTOI(va_arg(arg, void*));
+            uValue = (uint) PTOI(va_arg(arg, void*));
 #endif
-                fmt.radix = 16;
-                outNum(ctx, &fmt, "0x", uValue);
-                break;
+            fmt.radix = 16;
+            outNum(ctx, &fmt, "0x", uValue);
+            break;
 
-            default:
-                BPUT(ctx, &fmt, c);
-            }
+        default:
+            BPUT(ctx, &fmt, c);
         }
     }
     BPUTNULL(ctx, &fmt);
-    return (char*) fmt.buf;
+    *fp = fmt;
 }
 
 
@@ -635,36 +965,20 @@ static char *sprintfCore(MprCtx ctx, char *buf, int maxsize, cchar *spec, va_lis
  */
 static void outNum(MprCtx ctx, Format *fmt, cchar *prefix, uint64 value)
 {
-    char    numBuf[64];
-    char    *cp;
-    char    *endp;
-    char    c;
-    int     letter, len, leadingZeros, i, fill;
+    char    numBuf[96];
+    char    *cp, *endp;
+    int     len, leadingZeros, i, fill, prefixLen;
 
-    endp = &numBuf[sizeof(numBuf) - 1];
-    *endp = '\0';
-    cp = endp;
+    endp = &numBuf[sizeof(numBuf)];
 
     /*
      *  Convert to ascii
      */
-    if (fmt->radix == 16) {
-        do {
-            letter = (int) (value % fmt->radix);
-            if (letter > 9) {
-                if (fmt->flags & SPRINTF_UPPER_CASE) {
-                    letter = 'A' + letter - 10;
-                } else {
-                    letter = 'a' + letter - 10;
-                }
-            } else {
-                letter += '0';
-            }
-            *--cp = letter;
-            value /= fmt->radix;
-        } while (value > 0);
-
-    } else if (fmt->flags & SPRINTF_COMMA) {
+    if (fmt->flags & SPRINTF_COMMA && fmt->radix != 16) {
+        /*
+         *  Hex ignores the comma flag. Other radixes are grouped in threes.
+         */
+        cp = endp;
         i = 1;
         do {
             *--cp = '0' + (int) (value % fmt->radix);
@@ -674,42 +988,61 @@ static void outNum(MprCtx ctx, Format *fmt, cchar *prefix, uint64 value)
             }
         } while (value > 0);
     } else {
-        do {
-            *--cp = '0' + (int) (value % fmt->radix);
-            value /= fmt->radix;
-        } while (value > 0);
+        cp = mprFormatUint(endp, value, fmt->radix, fmt->flags & SPRINTF_UPPER_CASE);
     }
-
     len = (int) (endp - cp);
-    fill = fmt->width - len;
+    prefixLen = (prefix) ? (int) strlen(prefix) : 0;
+    leadingZeros = (fmt->precision > len) ? fmt->precision - len : 0;
+    fill = fmt->width - len - prefixLen - leadingZeros;
 
-    if (prefix != 0) {
-        fill -= (int) strlen(prefix);
+    if (!(fmt->flags & SPRINTF_LEFT) && fill > 0) {
+        bputFill(ctx, fmt, (fmt->flags & SPRINTF_LEAD_ZERO) ? '0': ' ', fill);
     }
-    leadingZeros = (fmt->precision > len) ? fmt->precision - len : 0;
-    fill -= leadingZeros;
+    if (prefixLen) {
+        bputBlock(ctx, fmt, prefix, prefixLen);
+    }
+    if (leadingZeros) {
+        bputFill(ctx, fmt, '0', leadingZeros);
+    }
+    bputBlock(ctx, fmt, cp, len);
+    if (fmt->flags & SPRINTF_LEFT && fill > 0) {
+        bputFill(ctx, fmt, ' ', fill);
+    }
+}
 
-    if (!(fmt->flags & SPRINTF_LEFT)) {
-        c = (fmt->flags & SPRINTF_LEAD_ZERO) ? '0': ' ';
-        for (i = 0; i < fill; i++) {
-            BPUT(ctx, fmt, c);
-        }
+
+/*
+    Copy a block of characters. Copy in one step when there is room and otherwise fall back to BPUT which grows 
+    the buffer.
+ */
+static void bputBlock(MprCtx ctx, Format *fmt, cchar *str, int len)
+{
+    if (len <= 0) {
+        return;
     }
-    if (prefix != 0) {
-        while (*prefix) {
-            BPUT(ctx, fmt, *prefix++);
+    /* Less one to allow room for the null */
+    if (len < (fmt->endbuf - fmt->end)) {
+        memcpy(fmt->end, str, len);
+        fmt->end += len;
+    } else {
+        while (len-- > 0) {
+            BPUT(ctx, fmt, *str++);
         }
     }
-    for (i = 0; i < leadingZeros; i++) {
-        BPUT(ctx, fmt, '0');
-    }
-    while (*cp) {
-        BPUT(ctx, fmt, *cp);
-        cp++;
+}
+
+
+static void bputFill(MprCtx ctx, Format *fmt, int c, int count)
+{
+    if (count <= 0) {
+        return;
     }
-    if (fmt->flags & SPRINTF_LEFT) {
-        for (i = 0; i < fill; i++) {
-            BPUT(ctx, fmt, ' ');
+    if (count < (fmt->endbuf - fmt->end)) {
+        memset(fmt->end, c, count);
+        fmt->end += count;
+    } else {
+        while (count-- > 0) {
+            BPUT(ctx, fmt, c);
         }
     }
 }
@@ -812,131 +1145,174 @@ int mprIsZero(double value) {
  */
 char *mprDtoa(MprCtx ctx, double value, int ndigits, int mode, int flags)
 {
-    MprBuf  *buf;
-    char    *intermediate, *ip;
+    char    digits[MPR_GRISU_BUFSIZE], numBuf[16], *intermediate, *ip, *result, *cp, *np, *fraction;
     int     period, sign, len, exponentForm, fixedForm, exponent, count, totalDigits;
 
-    buf = mprCreateBuf(ctx, 64, -1);
+    if (mprIsNan(value)) {
+        return mprStrdup(ctx, "NaN");
+    } else if (mprIsInfinite(value)) {
+        return mprStrdup(ctx, (value < 0) ? "-Infinity" : "Infinity");
+    } else if (value == 0) {
+        return mprStrdup(ctx, "0");
+    }
     intermediate = 0;
     exponentForm = 0;
     fixedForm = 0;
 
-    if (mprIsNan(value)) {
-        mprPutStringToBuf(buf, "NaN");
-
-    } else if (mprIsInfinite(value)) {
-        if (value < 0) {
-            mprPutStringToBuf(buf, "-Infinity");
-        } else {
-            mprPutStringToBuf(buf, "Infinity");
+    if (ndigits <= 0) {
+        if (!(flags & MPR_DTOA_FIXED_FORM)) {
+            mode = MPR_DTOA_ALL_DIGITS;
         }
-    } else if (value == 0) {
-        mprPutCharToBuf(buf, '0');
+        ndigits = 0;
 
-    } else {
-        if (ndigits <= 0) {
-            if (!(flags & MPR_DTOA_FIXED_FORM)) {
-                mode = MPR_DTOA_ALL_DIGITS;
-            }
+    } else if (mode == MPR_DTOA_ALL_DIGITS) {
+        mode = MPR_DTOA_N_DIGITS;
+    }
+    if (flags & MPR_DTOA_EXPONENT_FORM) {
+        exponentForm = 1;
+        if (ndigits > 0) {
+            ndigits++;
+        } else {
             ndigits = 0;
-
-        } else if (mode == MPR_DTOA_ALL_DIGITS) {
-            mode = MPR_DTOA_N_DIGITS;
-        }
-        if (flags & MPR_DTOA_EXPONENT_FORM) {
-            exponentForm = 1;
-            if (ndigits > 0) {
-                ndigits++;
-            } else {
-                ndigits = 0;
-                mode = MPR_DTOA_ALL_DIGITS;
-            }
-        } else if (flags & MPR_DTOA_FIXED_FORM) {
-            fixedForm = 1;
+            mode = MPR_DTOA_ALL_DIGITS;
         }
+    } else if (flags & MPR_DTOA_FIXED_FORM) {
+        fixedForm = 1;
+    }
 
+    /*
+        Convert to an intermediate string representation. Period is the offset of the decimal point. NOTE: the
+        intermediate representation may have less digits than period.
+        Note: ndigits < 0 seems to trim N digits from the end with rounding.
+     */
+    sign = (value < 0);
+    if ((len = mprGrisuDtoa(sign ? -value : value, mode, ndigits, digits, &period)) > 0) {
+        ip = digits;
+    } else {
         /*
-            Convert to an intermediate string representation. Period is the offset of the decimal point. NOTE: the
-            intermediate representation may have less digits than period.
-            Note: ndigits < 0 seems to trim N digits from the end with rounding.
+            dtoa is not thread-safe. It keeps global free lists and frees its last result on the next call, 
+            so copy the digits before releasing the lock.
          */
-        ip = intermediate = dtoa(value, mode, ndigits, &period, &sign, NULL);
+        mprGlobalLock(ctx);
+        ip = dtoa(value, mode, ndigits, &period, &sign, NULL);
+        intermediate = mprStrdup(ctx, ip);
+        freedtoa(ip);
+        mprGlobalUnlock(ctx);
+        if ((ip = intermediate) == 0) {
+            return 0;
+        }
         len = (int) strlen(intermediate);
-        exponent = period - 1;
+    }
+    exponent = period - 1;
 
-        if (mode == MPR_DTOA_ALL_DIGITS && ndigits == 0) {
-            ndigits = len;
-        }
-        if (!fixedForm) {
-            if (period <= -6 || period > 21) {
-                exponentForm = 1;
-            }
+    if (mode == MPR_DTOA_ALL_DIGITS && ndigits == 0) {
+        ndigits = len;
+    }
+    if (!fixedForm) {
+        if (period <= -6 || period > 21) {
+            exponentForm = 1;
         }
-        if (sign) {
-            mprPutCharToBuf(buf, '-');
+    }
+
+    /*
+        Size the result for the digits, zero padding and decorations so it can be built in place
+     */
+    if ((result = mprAlloc(ctx, len + ndigits + abs(period) + 16)) == 0) {
+        mprFree(intermediate);
+        return 0;
+    }
+    cp = result;
+    if (sign) {
+        *cp++ = '-';
+    }
+    if (exponentForm) {
+        *cp++ = ip[0] ? ip[0] : '0';
+        if (len > 1) {
+            *cp++ = '.';
+            cp = putDigits(cp, &ip[1], (ndigits == 0) ? len - 1: ndigits);
         }
-        if (exponentForm) {
-            mprPutCharToBuf(buf, ip[0] ? ip[0] : '0');
-            if (len > 1) {
-                mprPutCharToBuf(buf, '.');
-                mprPutSubStringToBuf(buf, &ip[1], (ndigits == 0) ? len - 1: ndigits);
-            }
-            mprPutCharToBuf(buf, 'e');
-            mprPutCharToBuf(buf, (period < 0) ? '-' : '+');
-            mprPutFmtToBuf(buf, "%d", (exponent < 0) ? -exponent: exponent);
+        *cp++ = 'e';
+        *cp++ = (exponent < 0) ? '-' : '+';
+        np = mprFormatUint(&numBuf[sizeof(numBuf)], (exponent < 0) ? -exponent : exponent, 10, 0);
+        count = (int) (&numBuf[sizeof(numBuf)] - np);
+        memcpy(cp, np, count);
+        cp += count;
 
-        } else {
-            if (mode == MPR_DTOA_N_FRACTION_DIGITS) {
-                /* Count of digits */
-                if (period <= 0) {
-                    /* Leading fractional zeros required */
-                    mprPutStringToBuf(buf, "0.");
-                    mprPutPadToBuf(buf, '0', -period);
-                    mprPutStringToBuf(buf, ip);
-                    mprPutPadToBuf(buf, '0', ndigits - len + period);
+    } else {
+        if (mode == MPR_DTOA_N_FRACTION_DIGITS) {
+            /* Count of digits */
+            if (period <= 0) {
+                /* Leading fractional zeros required */
+                *cp++ = '0';
+                *cp++ = '.';
+                cp = putPad(cp, -period);
+                cp = putDigits(cp, ip, len);
+                cp = putPad(cp, ndigits - len + period);
 
-                } else {
-                    count = min(len, period);
-                    /* Leading integral digits */
-                    mprPutSubStringToBuf(buf, ip, count);
-                    /* Trailing zero pad */
-                    mprPutPadToBuf(buf, '0', period - len);
-                    totalDigits = count + ndigits;
-                    if (period < totalDigits) {
-                        count = totalDigits + sign - mprGetBufLength(buf);
-                        mprPutCharToBuf(buf, '.');
-                        mprPutSubStringToBuf(buf, &ip[period], count);
-                        mprPutPadToBuf(buf, '0', count - (int) strlen(&ip[period]));
-                    }
+            } else {
+                count = min(len, period);
+                /* Leading integral digits */
+                cp = putDigits(cp, ip, count);
+                /* Trailing zero pad */
+                cp = putPad(cp, period - len);
+                totalDigits = count + ndigits;
+                if (period < totalDigits) {
+                    /* The digits may all be integral */
+                    fraction = (period < len) ? &ip[period] : "";
+                    count = totalDigits + sign - (int) (cp - result);
+                    *cp++ = '.';
+                    cp = putDigits(cp, fraction, count);
+                    cp = putPad(cp, count - (int) strlen(fraction));
                 }
+            }
 
-            } else if (len <= period && period <= 21) {
-                /* data shorter than period */
-                mprPutStringToBuf(buf, ip);
-                mprPutPadToBuf(buf, '0', period - len);
+        } else if (len <= period && period <= 21) {
+            /* data shorter than period */
+            cp = putDigits(cp, ip, len);
+            cp = putPad(cp, period - len);
 
-            } else if (0 < period && period <= 21) {
-                /* Period shorter than data */
-                mprPutSubStringToBuf(buf, ip, period);
-                mprPutCharToBuf(buf, '.');
-                mprPutStringToBuf(buf, &ip[period]);
+        } else if (0 < period && period <= 21) {
+            /* Period shorter than data */
+            cp = putDigits(cp, ip, period);
+            *cp++ = '.';
+            cp = putDigits(cp, &ip[period], len - period);
 
-            } else if (-6 < period && period <= 0) {
-                /* Small negative exponent */
-                mprPutStringToBuf(buf, "0.");
-                mprPutPadToBuf(buf, '0', -period);
-                mprPutStringToBuf(buf, ip);
+        } else if (-6 < period && period <= 0) {
+            /* Small negative exponent */
+            *cp++ = '0';
+            *cp++ = '.';
+            cp = putPad(cp, -period);
+            cp = putDigits(cp, ip, len);
 
-            } else {
-                mprAssert(0);
-            }
+        } else {
+            mprAssert(0);
         }
     }
-    mprAddNullToBuf(buf);
-    if (intermediate) {
-        freedtoa(intermediate);
+    *cp = '\0';
+    mprFree(intermediate);
+    return result;
+}
+
+
+/*
+    Copy up to count digits stopping at the end of the digit string
+ */
+static char *putDigits(char *cp, cchar *digits, int count)
+{
+    while (count-- > 0 && *digits) {
+        *cp++ = *digits++;
+    }
+    return cp;
+}
+
+
+static char *putPad(char *cp, int count)
+{
+    if (count > 0) {
+        memset(cp, '0', count);
+        cp += count;
     }
-    return mprStealBuf(ctx, buf);
+    return cp;
 }
 #endif /* BLD_FEATURE_FLOATING_POINT */
 
@@ -950,6 +1326,11 @@ static int growBuf(MprCtx ctx, Format *fmt)
     uchar   *newbuf;
     int     buflen;
 
+    if (fmt->sink) {
+        return growSink(fmt);
+    } else if (fmt->builder) {
+        return growBuilder(fmt);
+    }
     buflen = (int) (fmt->endbuf - fmt->buf);
     if (fmt->maxsize >= 0 && buflen >= fmt->maxsize) {
         return 0;
@@ -986,6 +1367,50 @@ static int growBuf(MprCtx ctx, Format *fmt)
 }
 
 
+/*
+    Grow a buffer sink in place. The output so far is committed first so the buffer preserves it when it grows.
+ */
+static int growSink(Format *fmt)
+{
+    MprBuf  *bp;
+    int     count;
+
+    bp = fmt->sink;
+    count = (int) (fmt->end - fmt->start);
+    mprAdjustBufEnd(bp, (int) ((char*) fmt->end - bp->end));
+    if (mprGrowBuf(bp, 0) < 0) {
+        return 0;
+    }
+    fmt->buf = (uchar*) bp->data;
+    fmt->endbuf = (uchar*) bp->endbuf;
+    fmt->end = (uchar*) bp->end;
+    fmt->start = fmt->end - count;
+    return 1;
+}
+
+
+/*
+    Grow a string builder sink. As with buffers, the output so far is committed first.
+ */
+static int growBuilder(Format *fmt)
+{
+    MprStrBuilder   *sb;
+    int             count;
+
+    sb = fmt->builder;
+    count = (int) (fmt->end - fmt->start);
+    sb->length = (int) ((char*) fmt->end - sb->buf);
+    if (mprGrowBuilder(sb, sb->size - sb->length) < 0) {
+        return 0;
+    }
+    fmt->buf = (uchar*) sb->buf;
+    fmt->endbuf = (uchar*) &sb->buf[sb->size];
+    fmt->end = (uchar*) &sb->buf[sb->length];
+    fmt->start = fmt->end - count;
+    return 1;
+}
+
+
 /*
     For easy debug trace
  */
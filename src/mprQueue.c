@@ -0,0 +1,223 @@
+/**
+ *  mprQueue.c - Lock-free queues
+ *
+ *  Bounded queues are a ring of cells, each with a sequence number (Vyukov's MPMC queue). A producer claims the
+ *  enqueue position with a compare and swap when the cell sequence equals the position, writes the item and then
+ *  publishes it by advancing the cell sequence. Consumers do the reverse and release the cell for the next lap.
+ *  Threads only contend on the position they are claiming so producers and consumers do not interfere.
+ *
+ *  Unbounded queues are an intrusive linked list (Vyukov's MPSC queue). Producers swap themselves into the head and
+ *  then link the prior head to themselves. The single consumer follows the links from the tail. A stub link keeps
+ *  the list from ever becoming empty so producers never touch the tail.
+ *
+ *  Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mpr.h"
+
+/*********************************** Locals ***********************************/
+/*
+ *  Positions and sequence numbers wrap. Do the arithmetic unsigned and compare differences.
+ */
+#define advance(pos, n)     ((int) ((uint) (pos) + (uint) (n)))
+#define distance(a, b)      ((int) ((uint) (a) - (uint) (b)))
+
+#define MAX_QUEUE_SIZE      (1 << 30)
+
+/*********************************** Code *************************************/
+
+MprQueue *mprCreateQueue(MprCtx ctx, int size)
+{
+    MprQueue    *q;
+    size_t      len;
+    int         count, i;
+
+    mprAssert(size >= 0);
+
+    if (size > MAX_QUEUE_SIZE) {
+        return 0;
+    }
+    for (count = 2; count < size; count *= 2) ;
+    len = (size_t) count * sizeof(MprQueueCell);
+    if (size > 0 && len > MAXINT) {
+        return 0;
+    }
+    if ((q = mprAllocObjZeroed(ctx, MprQueue)) == 0) {
+        return 0;
+    }
+    if (size > 0) {
+        if ((q->cells = (MprQueueCell*) mprAlloc(q, (uint) len)) == 0) {
+            mprFree(q);
+            return 0;
+        }
+        for (i = 0; i < count; i++) {
+            q->cells[i].seq = i;
+            q->cells[i].data = 0;
+        }
+        q->mask = count - 1;
+    }
+    q->stub.next = 0;
+    q->head = q->tail = &q->stub;
+    return q;
+}
+
+
+int mprEnqueue(MprQueue *q, cvoid *item)
+{
+    MprQueueCell    *cell;
+    int             pos, diff;
+
+    mprAssert(q->cells);
+
+    pos = q->enqueuePos;
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        diff = distance(cell->seq, pos);
+        mprAtomicBarrier();
+        if (diff == 0) {
+            if (mprAtomicCasInt(&q->enqueuePos, pos, advance(pos, 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            /*
+             *  The cell still holds an item from the prior lap
+             */
+            return MPR_ERR_WONT_FIT;
+        }
+        pos = q->enqueuePos;
+    }
+    cell->data = (void*) item;
+    mprAtomicBarrier();
+    cell->seq = advance(pos, 1);
+    return 0;
+}
+
+
+void *mprDequeue(MprQueue *q)
+{
+    MprQueueCell    *cell;
+    void            *item;
+    int             pos, diff;
+
+    mprAssert(q->cells);
+
+    pos = q->dequeuePos;
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        diff = distance(cell->seq, advance(pos, 1));
+        mprAtomicBarrier();
+        if (diff == 0) {
+            if (mprAtomicCasInt(&q->dequeuePos, pos, advance(pos, 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0;
+        }
+        pos = q->dequeuePos;
+    }
+    item = cell->data;
+    mprAtomicBarrier();
+    cell->seq = advance(pos, q->mask + 1);
+    return item;
+}
+
+
+int mprGetQueueCount(MprQueue *q)
+{
+    int     count;
+
+    count = distance(q->enqueuePos, q->dequeuePos);
+    return (count < 0) ? 0 : min(count, q->mask + 1);
+}
+
+
+void mprEnqueueLink(MprQueue *q, MprQueueLink *link)
+{
+    MprQueueLink    *prev;
+
+    link->next = 0;
+    prev = (MprQueueLink*) mprAtomicExchange((void* volatile*) &q->head, link);
+    /*
+     *  Until this store the consumer can't see the link or anything enqueued after it
+     */
+    prev->next = link;
+}
+
+
+MprQueueLink *mprDequeueLink(MprQueue *q)
+{
+    MprQueueLink    *tail, *next;
+
+    tail = q->tail;
+    next = tail->next;
+    mprAtomicBarrier();
+
+    if (tail == &q->stub) {
+        if (next == 0) {
+            return 0;
+        }
+        q->tail = tail = next;
+        next = next->next;
+        mprAtomicBarrier();
+    }
+    if (next) {
+        q->tail = next;
+        return tail;
+    }
+    if (tail != q->head) {
+        /*
+         *  A producer has swapped in a new head but not yet linked it
+         */
+        return 0;
+    }
+    /*
+     *  The tail is the last link. Requeue the stub behind it so the tail can be removed.
+     */
+    mprEnqueueLink(q, &q->stub);
+    next = tail->next;
+    mprAtomicBarrier();
+    if (next) {
+        q->tail = next;
+        return tail;
+    }
+    return 0;
+}
+
+
+/*
+ *  @copy   default
+ *
+ *  Copyright (c) Embedthis Software LLC, 2003-2011. All Rights Reserved.
+ *  Copyright (c) Michael O'Brien, 1993-2011. All Rights Reserved.
+ *
+ *  This software is distributed under commercial and open source licenses.
+ *  You may use the GPL open source license described below or you may acquire
+ *  a commercial license from Embedthis Software. You agree to be fully bound
+ *  by the terms of either license. Consult the LICENSE.TXT distributed with
+ *  this software for full details.
+ *
+ *  This software is open source; you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the
+ *  Free Software Foundation; either version 2 of the License, or (at your
+ *  option) any later version. See the GNU General Public License for more
+ *  details at: http://www.embedthis.com/downloads/gplLicense.html
+ *
+ *  This program is distributed WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *  This GPL license does NOT permit incorporating this software into
+ *  proprietary programs. If you are unable to comply with the GPL, you must
+ *  acquire a commercial license to use this software. Commercial licenses
+ *  for this software and support services are available from Embedthis
+ *  Software at http://www.embedthis.com
+ *
+ *  Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
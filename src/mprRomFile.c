@@ -204,6 +204,7 @@ int mprSetRomFileSystem(MprCtx ctx, MprRomInode *inodeList)
 
     rfs->romInodes = inodeList;
     rfs->fileIndex = mprCreateHash(rfs, MPR_FILES_HASH_SIZE);
+    mprSetHashBorrowedKeys(rfs->fileIndex);
 
     for (ri = inodeList; ri->path; ri++) {
         if (mprAddHash(rfs->fileIndex, ri->path, ri) < 0) {
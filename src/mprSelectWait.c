@@ -90,6 +90,16 @@ int mprWaitForSingleIO(MprCtx ctx, int fd, int mask, int timeout)
     MprWaitService  *ws;
     struct timeval  tval;
     fd_set          readMask, writeMask;
+#if BLD_FEATURE_FIBERS
+    MprFiber        *fiber;
+
+    /*
+     *  Inside a fiber, suspend just the fiber and let the scheduler wait for the I/O
+     */
+    if (timeout != 0 && (fiber = mprGetCurrentFiber(ctx)) != 0) {
+        return mprWaitForFiberIO(fiber, fd, mask, timeout);
+    }
+#endif
 
     ws = mprGetMpr(ctx)->waitService;
     tval.tv_sec = timeout / 1000;
@@ -118,11 +128,14 @@ int mprWaitForSingleIO(MprCtx ctx, int fd, int mask, int timeout)
 static void serviceRecall(MprWaitService *ws) 
 {
     MprWaitHandler      *wp;
-    int                 index;
+    MprLink             *lp, *next;
+    int                 removals;
 
     mprLock(ws->mutex);
     ws->flags &= ~MPR_NEED_RECALL;
-    for (index = 0; (wp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &index)) != 0; ) {
+    for (lp = mprGetFirstLink(&ws->handlers); lp; lp = next) {
+        next = mprGetNextLink(&ws->handlers, lp);
+        wp = mprGetLinkItem(lp, MprWaitHandler, link);
         if (wp->flags & MPR_WAIT_RECALL_HANDLER) {
             if ((wp->desiredMask & wp->disableMask) && wp->inUse == 0) {
                 wp->presentMask |= MPR_READABLE;
@@ -134,9 +147,16 @@ static void serviceRecall(MprWaitService *ws)
                 mprAssert(wp->inUse == 0);
                 wp->inUse++;
 #endif
+                removals = ws->removals;
                 mprUnlock(ws->mutex);
                 mprInvokeWaitCallback(wp);
                 mprLock(ws->mutex);
+                /*
+                 *  If handlers were removed while unlocked, the next link may be stale. Rescan from the list head.
+                 */
+                if (ws->removals != removals) {
+                    next = mprGetFirstLink(&ws->handlers);
+                }
 
             } else {
                 ws->flags |= MPR_NEED_RECALL;
@@ -199,8 +219,9 @@ int mprWaitForIO(MprWaitService *ws, int timeout)
  */
 static void getWaitFds(MprWaitService *ws)
 {
-    MprWaitHandler  *wp, *nextWp;
-    int             mask, next;
+    MprWaitHandler  *wp;
+    MprLink         *lp;
+    int             mask;
 
     mprLock(ws->mutex);
 
@@ -221,9 +242,8 @@ static void getWaitFds(MprWaitService *ws)
     /*
      *  Add an entry for each descriptor desiring service.
      */
-    next = 0;
-    for (wp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &next); wp; wp = nextWp) {
-        nextWp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &next);
+    for (lp = mprGetFirstLink(&ws->handlers); lp; lp = mprGetNextLink(&ws->handlers, lp)) {
+        wp = mprGetLinkItem(lp, MprWaitHandler, link);
         mprAssert(wp->fd >= 0);
 
         if (wp->proc && wp->desiredMask) {
@@ -255,7 +275,8 @@ static void getWaitFds(MprWaitService *ws)
 static void serviceIO(MprWaitService *ws)
 {
     MprWaitHandler      *wp;
-    int                 mask, index;
+    MprLink             *lp, *next;
+    int                 mask, removals;
 
     /*
      *  Must have the wait list stable while we service events
@@ -290,7 +311,9 @@ static void serviceIO(MprWaitService *ws)
     /*
      *  Now service all IO wait handlers
      */
-    for (index = 0; (wp = (MprWaitHandler*) mprGetNextItem(ws->handlers, &index)) != 0; ) {
+    for (lp = mprGetFirstLink(&ws->handlers); lp; lp = next) {
+        next = mprGetNextLink(&ws->handlers, lp);
+        wp = mprGetLinkItem(lp, MprWaitHandler, link);
         mprAssert(wp->fd >= 0);
         /*
          *  Present mask is only cleared after the io handler callback has completed
@@ -323,9 +346,17 @@ static void serviceIO(MprWaitService *ws)
 #endif
             wp->presentMask = mask;
 
+            removals = ws->removals;
             mprUnlock(ws->mutex);
             mprInvokeWaitCallback(wp);
             mprLock(ws->mutex);
+            /*
+             *  If handlers were removed while unlocked, the next link may be stale. Rescan from the list head. The
+             *  serviced fds have been cleared so they are not serviced twice.
+             */
+            if (ws->removals != removals) {
+                next = mprGetFirstLink(&ws->handlers);
+            }
         }
     }
 
@@ -517,6 +517,8 @@ static void disconnectSocket(MprSocket *sp)
     char    buf[MPR_BUFSIZE];
     int     i;
 
+    static MprFormat    *disconnectFormat;
+
     /*
      *  Defensive lock buster. Use try lock incase an operation is blocked somewhere with a lock asserted. 
      *  Should never happen.
@@ -529,7 +531,7 @@ static void disconnectSocket(MprSocket *sp)
          *  Read a reasonable amount of outstanding data to minimize resets. Then do a shutdown to send a FIN and read 
          *  outstanding data.  All non-blocking.
          */
-        mprLog(sp, 6, "Disconnect socket %d", sp->fd);
+        mprLogFormat(sp, 6, mprGetFormat(sp, &disconnectFormat, "Disconnect socket %d"), sp->fd);
         mprSetSocketBlockingMode(sp, 0);
         for (i = 0; i < 8; i++) {
             if (recv(sp->fd, buf, sizeof(buf), 0) <= 0) {
@@ -571,6 +573,8 @@ static void closeSocket(MprSocket *sp, bool gracefully)
     MprTime             timesUp;
     char                buf[16];
 
+    static MprFormat    *closeFormat;
+
     waitService = mprGetMpr(sp)->waitService;
     ss = mprGetMpr(sp)->socketService;
 
@@ -592,7 +596,7 @@ static void closeSocket(MprSocket *sp, bool gracefully)
          *  Read any outstanding read data to minimize resets. Then do a shutdown to send a FIN and read outstanding 
          *  data. All non-blocking.
          */
-        mprLog(sp, 6, "Close socket %d", sp->fd);
+        mprLogFormat(sp, 6, mprGetFormat(sp, &closeFormat, "Close socket %d"), sp->fd);
         if (gracefully) {
             mprSetSocketBlockingMode(sp, 0);
             while (recv(sp->fd, buf, sizeof(buf), 0) > 0) {
@@ -938,8 +942,7 @@ int mprWriteSocketVector(MprSocket *sp, MprIOVec *iovec, int count)
                 len -= written;
                 start += written;
                 total += written;
-                if (len <= 0) {
-                    i++;
+                if (len <= 0 && ++i < count) {
                     start = iovec[i].start;
                     len = (int) iovec[i].len;
                 }
@@ -950,6 +953,21 @@ int mprWriteSocketVector(MprSocket *sp, MprIOVec *iovec, int count)
 }
 
 
+int mprWriteSocketChain(MprSocket *sp, MprBufChain *chain)
+{
+    MprIOVec    iovec[MPR_MAX_IOVEC];
+    int         count, written;
+
+    if ((count = mprGetBufChainVector(chain, iovec, MPR_MAX_IOVEC)) == 0) {
+        return 0;
+    }
+    if ((written = mprWriteSocketVector(sp, iovec, count)) > 0) {
+        mprAdjustBufChainStart(chain, written);
+    }
+    return written;
+}
+
+
 #if !BLD_FEATURE_ROMFS
 #if !LINUX || __UCLIBC__
 static int localSendfile(MprSocket *sp, MprFile *file, MprOffset offset, int len)
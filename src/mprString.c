@@ -13,7 +13,72 @@
 
 #include    "mpr.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+    #include    <emmintrin.h>
+    #define USE_SSE2 1
+#endif
+
+/*********************************** Locals ***********************************/
+
+#define BLOCK_SIZE      16              /* Bytes examined at once by the SSE2 routines */
+#define BLOCK_PAGE      4096            /* Smallest page size. Loads within a page can't fault. */
+#define MAX_DELIMS      4               /* Most delimiters matched with a vector compare each */
+
+/*
+ *  Test if a block load at the given address stays within one page. Such a load may read past the null at the end
+ *  of a string without faulting.
+ */
+#define blockInPage(p)  ((((size_t) (p)) & (BLOCK_PAGE - 1)) <= BLOCK_PAGE - BLOCK_SIZE)
+#define samePage(a, b)  ((((size_t) (a)) & ~(size_t) (BLOCK_PAGE - 1)) == (((size_t) (b)) & ~(size_t) (BLOCK_PAGE - 1)))
+#define isAligned(p)    ((((size_t) (p)) & (BLOCK_SIZE - 1)) == 0)
+
+/***************************** Forward Declarations ***************************/
+
+static int matchAnyCase(cchar *str1, cchar *str2, int max);
+static char *findDelim(cchar *str, cchar *delim);
+static char *skipDelim(cchar *str, cchar *delim);
+
 /************************************ Code ************************************/
+#if USE_SSE2
+static MPR_INLINE int lowestBit(uint mask)
+{
+#if __GNUC__
+    return __builtin_ctz(mask);
+#else
+    int     i;
+
+    for (i = 0; (mask & 1) == 0; i++) {
+        mask >>= 1;
+    }
+    return i;
+#endif
+}
+
+
+/*
+ *  Map the ASCII upper case characters in a block to lower case. Adding 0x80 - 'A' maps 'A'..'Z' onto the 26 lowest
+ *  signed byte values so one signed compare selects them.
+ */
+static MPR_INLINE __m128i lowerBlock(__m128i block)
+{
+    __m128i     upper;
+
+    upper = _mm_cmplt_epi8(_mm_add_epi8(block, _mm_set1_epi8((char) (0x80 - 'A'))), 
+        _mm_set1_epi8((char) (0x80 + 26)));
+    return _mm_or_si128(block, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+
+static MPR_INLINE __m128i upperBlock(__m128i block)
+{
+    __m128i     lower;
+
+    lower = _mm_cmplt_epi8(_mm_add_epi8(block, _mm_set1_epi8((char) (0x80 - 'a'))), 
+        _mm_set1_epi8((char) (0x80 + 26)));
+    return _mm_xor_si128(block, _mm_and_si128(lower, _mm_set1_epi8(0x20)));
+}
+#endif
+
 
 int mprStrcpy(char *dest, int destMax, cchar *src)
 {
@@ -117,52 +182,26 @@ int mprMemcpy(void *dest, int destMax, const void *src, int nbytes)
 
 char *mprStrcatV(MprCtx ctx, int destMax, cchar *src, va_list args)
 {
-    va_list     ap;
-    char        *dest, *str, *dp;
-    int         required;
+    MprStrBuilder   sb;
+    va_list         ap;
+    cchar           *str;
 
     mprAssert(ctx);
     mprAssert(src);
 
-    if (destMax <= 0) {
-        destMax = INT_MAX;
-    }
-
 #ifdef __va_copy
     __va_copy(ap, args);
 #else
     ap = args;
 #endif
-
-    required = 1;
-    str = (char*) src;
-
-    while (str) {
-        required += (int) strlen(str);
-        str = va_arg(ap, char*);
-    }
-    if (required >= destMax) {
-        return 0;
+    mprInitStrBuilder(ctx, &sb, destMax);
+    for (str = src; str; str = va_arg(ap, char*)) {
+        mprPutStringToBuilder(&sb, str);
     }
-
-    if ((dest = (char*) mprAlloc(ctx, required)) == 0) {
-        return 0;
-    }
-
-    dp = dest;
 #ifdef __va_copy
-    __va_copy(ap, args);
-#else
-    ap = args;
+    va_end(ap);
 #endif
-    str = (char*) src;
-    while (str) {
-        strcpy(dp, str);
-        dp += (int) strlen(str);
-        str = va_arg(ap, char*);
-    }
-    *dp = '\0';
-    return dest;
+    return mprStealBuilder(&sb);
 }
 
 
@@ -264,7 +303,10 @@ char *mprStrTrim(char *str, cchar *set)
  */
 char *mprStrLower(char *str)
 {
-    char    *cp;
+    char        *cp;
+#if USE_SSE2
+    __m128i     block;
+#endif
 
     mprAssert(str);
 
@@ -272,7 +314,24 @@ char *mprStrLower(char *str)
         return 0;
     }
 
-    for (cp = str; *cp; cp++) {
+    cp = str;
+#if USE_SSE2
+    for (; !isAligned(cp) && *cp; cp++) {
+        if (isupper((int) *cp)) {
+            *cp = (char) tolower((int) *cp);
+        }
+    }
+    if (*cp) {
+        for (; ; cp += BLOCK_SIZE) {
+            block = _mm_load_si128((__m128i*) cp);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128()))) {
+                break;
+            }
+            _mm_store_si128((__m128i*) cp, lowerBlock(block));
+        }
+    }
+#endif
+    for (; *cp; cp++) {
         if (isupper((int) *cp)) {
             *cp = (char) tolower((int) *cp);
         }
@@ -286,14 +345,34 @@ char *mprStrLower(char *str)
  */
 char *mprStrUpper(char *str)
 {
-    char    *cp;
+    char        *cp;
+#if USE_SSE2
+    __m128i     block;
+#endif
 
     mprAssert(str);
     if (str == 0) {
         return 0;
     }
 
-    for (cp = str; *cp; cp++) {
+    cp = str;
+#if USE_SSE2
+    for (; !isAligned(cp) && *cp; cp++) {
+        if (islower((int) *cp)) {
+            *cp = (char) toupper((int) *cp);
+        }
+    }
+    if (*cp) {
+        for (; ; cp += BLOCK_SIZE) {
+            block = _mm_load_si128((__m128i*) cp);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128()))) {
+                break;
+            }
+            _mm_store_si128((__m128i*) cp, upperBlock(block));
+        }
+    }
+#endif
+    for (; *cp; cp++) {
         if (islower((int) *cp)) {
             *cp = (char) toupper((int) *cp);
         }
@@ -376,7 +455,7 @@ int mprStrStartsWith(cchar *dest, cchar *pat)
  */
 int mprStrcmpAnyCase(cchar *str1, cchar *str2)
 {
-    int     rc;
+    int     rc, len;
 
     if (str1 == 0) {
         return -1;
@@ -387,6 +466,9 @@ int mprStrcmpAnyCase(cchar *str1, cchar *str2)
     if (str1 == str2) {
         return 0;
     }
+    len = matchAnyCase(str1, str2, MAXINT);
+    str1 += len;
+    str2 += len;
     for (rc = 0; *str1 && *str2 && rc == 0; str1++, str2++) {
         rc = tolower((int) *str1) - tolower((int) *str2);
     }
@@ -409,7 +491,7 @@ int mprStrcmpAnyCase(cchar *str1, cchar *str2)
  */
 int mprStrcmpAnyCaseCount(cchar *str1, cchar *str2, int len)
 {
-    int     rc;
+    int     rc, matched;
 
     if (str1 == 0 || str2 == 0) {
         return -1;
@@ -417,6 +499,10 @@ int mprStrcmpAnyCaseCount(cchar *str1, cchar *str2, int len)
     if (str1 == str2) {
         return 0;
     }
+    matched = matchAnyCase(str1, str2, len);
+    str1 += matched;
+    str2 += matched;
+    len -= matched;
 
     for (rc = 0; len-- > 0 && *str1 && rc == 0; str1++, str2++) {
         rc = tolower((int) *str1) - tolower((int) *str2);
@@ -440,7 +526,6 @@ int mprStrcmpAnyCaseCount(cchar *str1, cchar *str2, int len)
 char *mprStrTok(char *str, cchar *delim, char **last)
 {
     char    *start, *end;
-    int     i;
 
     start = str ? str : *last;
 
@@ -448,18 +533,17 @@ char *mprStrTok(char *str, cchar *delim, char **last)
         *last = 0;
         return 0;
     }
-    
-    i = (int) strspn(start, delim);
-    start += i;
+    start = skipDelim(start, delim);
     if (*start == '\0') {
         *last = 0;
         return 0;
     }
-    end = strpbrk(start, delim);
-    if (end) {
+    end = findDelim(start, delim);
+    if (*end) {
         *end++ = '\0';
-        i = (int) strspn(end, delim);
-        end += i;
+        end = skipDelim(end, delim);
+    } else {
+        end = 0;
     }
     *last = end;
     return start;
@@ -504,45 +588,107 @@ char *mprGetWordTok(char *buf, int bufsize, cchar *str, cchar *delim, cchar **to
 
 
 /*
- *  Format a number as a string. Support radix 10 and 16.
+ *  Digit pairs for converting decimal numbers two digits at a time
  */
-char *mprItoa(char *buf, int size, int64 value, int radix)
+static cchar decimalPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static cchar lowerDigits[] = "0123456789abcdef";
+static cchar upperDigits[] = "0123456789ABCDEF";
+
+/*
+ *  Convert an unsigned number to ascii. The digits are written backwards ending just before "end" and are not null
+ *  terminated. Returns a pointer to the first digit. The caller must provide room for 64 digits before end.
+ *  Decimal converts two digits per division and uses 32-bit division once the value fits. Power of two radixes
+ *  shift and mask instead of dividing.
+ */
+char *mprFormatUint(char *end, uint64 value, int radix, int upper)
 {
-    char    numBuf[32];
-    char    *cp, *dp, *endp;
-    char    digits[] = "0123456789ABCDEF";
-    int     negative;
+    cchar   *digits;
+    char    *cp;
+    uint    small, shift, mask;
+    int     i;
 
-    if (radix != 10 && radix != 16) {
-        return 0;
-    }
+    mprAssert(2 <= radix && radix <= 16);
 
-    cp = &numBuf[sizeof(numBuf)];
-    *--cp = '\0';
+    cp = end;
+    digits = upper ? upperDigits : lowerDigits;
+
+    if (radix == 10) {
+        while (value > 0xFFFFFFFF) {
+            i = (int) (value % 100) * 2;
+            value /= 100;
+            cp -= 2;
+            cp[0] = decimalPairs[i];
+            cp[1] = decimalPairs[i + 1];
+        }
+        small = (uint) value;
+        while (small >= 100) {
+            i = (small % 100) * 2;
+            small /= 100;
+            cp -= 2;
+            cp[0] = decimalPairs[i];
+            cp[1] = decimalPairs[i + 1];
+        }
+        if (small >= 10) {
+            i = small * 2;
+            cp -= 2;
+            cp[0] = decimalPairs[i];
+            cp[1] = decimalPairs[i + 1];
+        } else {
+            *--cp = (char) ('0' + small);
+        }
+
+    } else if (radix == 16 || radix == 8 || radix == 2) {
+        shift = (radix == 16) ? 4 : (radix == 8) ? 3 : 1;
+        mask = radix - 1;
+        do {
+            *--cp = digits[(uint) value & mask];
+            value >>= shift;
+        } while (value > 0);
 
-    if (value < 0) {
-        negative = 1;
-        value = -value;
-        size--;
     } else {
-        negative = 0;
+        do {
+            *--cp = digits[value % radix];
+            value /= radix;
+        } while (value > 0);
     }
+    return cp;
+}
 
-    do {
-        *--cp = digits[value % radix];
-        value /= radix;
-    } while (value > 0);
 
-    if (negative) {
-        *--cp = '-';
-    }
+/*
+ *  Format a number as a string. Support radix 10 and 16.
+ */
+char *mprItoa(char *buf, int size, int64 value, int radix)
+{
+    char    numBuf[72];
+    char    *cp, *endp;
+    uint64  uval;
+    int     len;
 
-    dp = buf;
-    endp = &buf[size];
-    while (dp < endp && *cp) {
-        *dp++ = *cp++;
+    if (radix != 10 && radix != 16) {
+        return 0;
+    }
+    if (size <= 0) {
+        return buf;
+    }
+    endp = &numBuf[sizeof(numBuf)];
+    if (value < 0) {
+        /*
+         *  Negate as unsigned so the most negative value does not overflow
+         */
+        uval = (uint64) 0 - (uint64) value;
+        cp = mprFormatUint(endp, uval, radix, 1);
+        *--cp = '-';
+    } else {
+        cp = mprFormatUint(endp, (uint64) value, radix, 1);
     }
-    *dp++ = '\0';
+    len = min((int) (endp - cp), size - 1);
+    memcpy(buf, cp, len);
+    buf[len] = '\0';
     return buf;
 }
 
@@ -690,32 +836,315 @@ int mprMakeArgv(MprCtx ctx, cchar *program, cchar *cmd, int *argcp, char ***argv
 }
 
 
+/*
+ *  Find a pattern within the first len characters of a string. Blocks of candidate positions are filtered by
+ *  comparing both the first and last characters of the pattern before comparing the rest.
+ */
 char *mprStrnstr(cchar *str, cchar *pattern, int len)
 {
-    cchar   *start, *p;
-    int     i;
+    int         i, plen, first;
+#if USE_SSE2
+    __m128i     firstSet, lastSet, block;
+    uint        mask, nulls;
+    int         j;
+#endif
 
-    if (str == 0 || pattern == 0 || len == 0) {
+    if (str == 0 || pattern == 0 || len <= 0 || *pattern == '\0') {
         return 0;
     }
-
-    while (*str && len-- > 0) {
-        if (*str++ == *pattern) {
-            start = str - 1;
-            for (p = pattern + 1, i = len; *p && *str && i >= 0; i--, p++) {
-                if (*p != *str++) {
-                    break;
+    plen = (int) strlen(pattern);
+    first = *pattern;
+#if USE_SSE2
+    firstSet = _mm_set1_epi8((char) first);
+    lastSet = _mm_set1_epi8(pattern[plen - 1]);
+#endif
+    for (i = 0; i < len && str[i]; ) {
+#if USE_SSE2
+        if (plen > 1 && (len - i) >= plen + BLOCK_SIZE - 1 && samePage(&str[i], &str[i + plen + BLOCK_SIZE - 2])) {
+            block = _mm_loadu_si128((__m128i*) &str[i]);
+            nulls = _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128()));
+            mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block, firstSet), 
+                _mm_cmpeq_epi8(_mm_loadu_si128((__m128i*) &str[i + plen - 1]), lastSet)));
+            if (nulls) {
+                mask &= (1 << lowestBit(nulls)) - 1;
+            }
+            for (; mask; mask &= mask - 1) {
+                j = i + lowestBit(mask);
+                if (strncmp(&str[j + 1], &pattern[1], plen - 2) == 0) {
+                    return (char*) &str[j];
                 }
             }
-            if (*p == '\0') {
-                return (char*) start;
+            if (nulls) {
+                return 0;
             }
+            i += BLOCK_SIZE;
+            continue;
+        }
+#endif
+        if (str[i] == first && (len - i) >= plen && strncmp(&str[i], pattern, plen) == 0) {
+            return (char*) &str[i];
+        }
+        i++;
+    }
+    return 0;
+}
+
+
+void mprInitStrBuilder(MprCtx ctx, MprStrBuilder *sb, int maxSize)
+{
+    mprAssert(sb);
+
+    sb->ctx = ctx;
+    sb->buf = sb->local;
+    sb->maxsize = (maxSize > 0) ? maxSize : 0;
+    sb->size = (sb->maxsize > 0) ? min(sb->maxsize, (int) sizeof(sb->local)) : (int) sizeof(sb->local);
+    sb->length = 0;
+    sb->error = 0;
+    sb->local[0] = '\0';
+}
+
+
+/*
+ *  Grow geometrically so a string built by many small appends is copied a logarithmic number of times
+ */
+int mprGrowBuilder(MprStrBuilder *sb, int count)
+{
+    char    *buf;
+    int     required, size;
+
+    mprAssert(count >= 0);
+
+    required = sb->length + count + 1;
+    if (required <= sb->size) {
+        return 0;
+    }
+    if (sb->error || required < 0 || (sb->maxsize > 0 && required > sb->maxsize)) {
+        sb->error = 1;
+        return MPR_ERR_WONT_FIT;
+    }
+    for (size = sb->size * 2; size < required && size > 0; size *= 2) ;
+    if (size < required) {
+        size = required;
+    }
+    if (sb->maxsize > 0 && size > sb->maxsize) {
+        size = sb->maxsize;
+    }
+    if (sb->buf == sb->local) {
+        if ((buf = (char*) mprAlloc(sb->ctx, size)) != 0) {
+            memcpy(buf, sb->local, sb->length + 1);
         }
+    } else {
+        buf = (char*) mprRealloc(sb->ctx, sb->buf, size);
+    }
+    if (buf == 0) {
+        sb->error = 1;
+        return MPR_ERR_NO_MEMORY;
     }
+    sb->buf = buf;
+    sb->size = size;
     return 0;
 }
 
 
+int mprPutBlockToBuilder(MprStrBuilder *sb, cchar *str, int len)
+{
+    mprAssert(str || len == 0);
+    mprAssert(len >= 0);
+
+    if ((sb->length + len) >= sb->size && mprGrowBuilder(sb, len) < 0) {
+        return MPR_ERR_WONT_FIT;
+    }
+    memcpy(&sb->buf[sb->length], str, len);
+    sb->length += len;
+    sb->buf[sb->length] = '\0';
+    return len;
+}
+
+
+/*
+ *  Copy in one pass while the string fits. Only a string that outgrows the storage is measured.
+ */
+int mprPutStringToBuilder(MprStrBuilder *sb, cchar *str)
+{
+    char    *dp, *end;
+    int     count, rc;
+
+    if (str == 0) {
+        return 0;
+    }
+    dp = &sb->buf[sb->length];
+    end = &sb->buf[sb->size - 1];
+    while (dp < end && *str) {
+        *dp++ = *str++;
+    }
+    *dp = '\0';
+    count = (int) (dp - &sb->buf[sb->length]);
+    sb->length += count;
+    if (*str) {
+        if ((rc = mprPutBlockToBuilder(sb, str, (int) strlen(str))) < 0) {
+            return rc;
+        }
+        count += rc;
+    }
+    return count;
+}
+
+
+int mprPutCharToBuilder(MprStrBuilder *sb, int c)
+{
+    if ((sb->length + 1) >= sb->size && mprGrowBuilder(sb, 1) < 0) {
+        return MPR_ERR_WONT_FIT;
+    }
+    sb->buf[sb->length++] = (char) c;
+    sb->buf[sb->length] = '\0';
+    return 1;
+}
+
+
+int mprPutIntToBuilder(MprStrBuilder *sb, int64 value)
+{
+    char    numBuf[32], *cp, *endp;
+
+    endp = &numBuf[sizeof(numBuf)];
+    if (value < 0) {
+        cp = mprFormatUint(endp, (uint64) 0 - (uint64) value, 10, 0);
+        *--cp = '-';
+    } else {
+        cp = mprFormatUint(endp, (uint64) value, 10, 0);
+    }
+    return mprPutBlockToBuilder(sb, cp, (int) (endp - cp));
+}
+
+
+cchar *mprGetBuilderString(MprStrBuilder *sb)
+{
+    return sb->buf;
+}
+
+
+char *mprStealBuilder(MprStrBuilder *sb)
+{
+    char    *str;
+
+    if (sb->error) {
+        str = 0;
+        if (sb->buf != sb->local) {
+            mprFree(sb->buf);
+        }
+    } else if (sb->buf == sb->local) {
+        str = (char*) mprMemdup(sb->ctx, sb->local, sb->length + 1);
+    } else {
+        str = sb->buf;
+    }
+    mprInitStrBuilder(sb->ctx, sb, sb->maxsize);
+    return str;
+}
+
+
+void mprFreeBuilder(MprStrBuilder *sb)
+{
+    if (sb->buf != sb->local) {
+        mprFree(sb->buf);
+    }
+    mprInitStrBuilder(sb->ctx, sb, sb->maxsize);
+}
+
+
+/*
+ *  Return the count of leading characters (at most max) that match ignoring case before the end of str1. 
+ *  The caller compares the remainder.
+ */
+static int matchAnyCase(cchar *str1, cchar *str2, int max)
+{
+    int         i;
+#if USE_SSE2
+    __m128i     block1, block2;
+    uint        stop;
+
+    for (i = 0; i < max; ) {
+        if (blockInPage(&str1[i]) && blockInPage(&str2[i])) {
+            block1 = _mm_loadu_si128((__m128i*) &str1[i]);
+            block2 = _mm_loadu_si128((__m128i*) &str2[i]);
+            stop = (~_mm_movemask_epi8(_mm_cmpeq_epi8(lowerBlock(block1), lowerBlock(block2))) & 0xFFFF) |
+                _mm_movemask_epi8(_mm_cmpeq_epi8(block1, _mm_setzero_si128()));
+            if ((max - i) < BLOCK_SIZE) {
+                stop |= 1 << (max - i);
+            }
+            if (stop) {
+                return i + lowestBit(stop);
+            }
+            i += BLOCK_SIZE;
+        } else {
+            if (str1[i] == '\0' || tolower((int) str1[i]) != tolower((int) str2[i])) {
+                break;
+            }
+            i++;
+        }
+    }
+#else
+    i = 0;
+#endif
+    return i;
+}
+
+
+/*
+ *  Return a pointer to the first character in str that is not one of the delimiters. Runs of delimiters are 
+ *  usually short so this is a simple scan.
+ */
+static char *skipDelim(cchar *str, cchar *delim)
+{
+    cchar   *dp;
+
+    for (; *str; str++) {
+        for (dp = delim; *dp && *dp != *str; dp++) ;
+        if (*dp == '\0') {
+            break;
+        }
+    }
+    return (char*) str;
+}
+
+
+/*
+ *  Return a pointer to the first character in str that is one of the delimiters, or to the terminating null
+ */
+static char *findDelim(cchar *str, cchar *delim)
+{
+#if USE_SSE2
+    __m128i     set[MAX_DELIMS], block, match;
+    uint        mask;
+    int         count, i;
+
+    count = (int) strlen(delim);
+    if (count <= MAX_DELIMS) {
+        for (i = 0; i < count; i++) {
+            set[i] = _mm_set1_epi8(delim[i]);
+        }
+        for (;;) {
+            if (blockInPage(str)) {
+                block = _mm_loadu_si128((__m128i*) str);
+                match = _mm_cmpeq_epi8(block, _mm_setzero_si128());
+                for (i = 0; i < count; i++) {
+                    match = _mm_or_si128(match, _mm_cmpeq_epi8(block, set[i]));
+                }
+                if ((mask = _mm_movemask_epi8(match)) != 0) {
+                    return (char*) &str[lowestBit(mask)];
+                }
+                str += BLOCK_SIZE;
+            } else {
+                if (*str == '\0' || strchr(delim, *str)) {
+                    return (char*) str;
+                }
+                str++;
+            }
+        }
+    }
+#endif
+    return (char*) &str[strcspn(str, delim)];
+}
+
+
 /*
  *  @copy   default
  *  
@@ -14,13 +14,23 @@
 
 /*************************** Forward Declarations ****************************/
 
+static int  applyAffinity(MprThread *tp);
+static void assignWorkerAffinity(MprWorkerService *ws, MprWorker *worker);
 static int  changeState(MprWorker *worker, int state);
 static MprWorker *createWorker(MprWorkerService *ws, int stackSize);
+static MprTime getCpuTime();
 static int  getNextThreadNum(MprWorkerService *ws);
+static int  getSetNode(MprThreadService *ts, MprCpuSet *cpus);
+static void loadNumaTopology(MprThreadService *ts);
 static int  workerDestructor(MprWorker *worker);
 static void pruneWorkers(MprWorkerService *ws, MprEvent *timer);
+static void resetCredits(MprWorkerService *ws);
+static MprWorker *spawnWorker(MprWorkerService *ws, MprWorkerProc proc, void *data, int priority);
+static int  startWorker(MprCtx ctx, MprWorkerProc proc, void *data, int priority, bool queue);
 static void threadProc(MprThread *tp);
 static int threadDestructor(MprThread *tp);
+static int  tuneWorkers(MprWorkerService *ws);
+static void tuneWorkersTimer(MprWorkerService *ws, MprEvent *timer);
 static void workerMain(MprWorker *worker, MprThread *tp);
 
 /************************************ Code ***********************************/
@@ -40,11 +50,7 @@ MprThreadService *mprCreateThreadService(Mpr *mpr)
         mprFree(ts);
         return 0;
     }
-    ts->threads = mprCreateList(ts);
-    if (ts->threads == 0) {
-        mprFree(ts);
-        return 0;
-    }
+    mprInitLinkList(&ts->threads);
     mpr->serviceThread = mpr->mainOsThread = mprGetCurrentOsThread();
     mpr->threadService = ts;
     ts->stackSize = MPR_DEFAULT_STACK;
@@ -58,17 +64,23 @@ MprThreadService *mprCreateThreadService(Mpr *mpr)
         return 0;
     }
     ts->mainThread->isMain = 1;
+#if LINUX
+    ts->mainThread->osTid = (int) syscall(SYS_gettid);
+#endif
+    if ((ts->threadKey = mprCreateThreadLocal(ts)) != 0) {
+        mprSetThreadData(ts->threadKey, ts->mainThread);
+    }
     return ts;
 }
 
 
 bool mprStopThreadService(MprThreadService *ts, int timeout)
 {
-    while (timeout > 0 && ts->threads->length > 1) {
+    while (timeout > 0 && mprGetLinkCount(&ts->threads) > 1) {
         mprSleep(ts, 50);
         timeout -= 50;
     }
-    return ts->threads->length == 0;
+    return mprGetLinkCount(&ts->threads) == 0;
 }
 
 
@@ -85,14 +97,14 @@ MprThread *mprGetCurrentThread(MprCtx ctx)
 {
     MprThreadService    *ts;
     MprThread           *tp;
+    MprLink             *lp;
     MprOsThread         id;
-    int                 i;
 
     ts = mprGetMpr(ctx)->threadService;
     mprLock(ts->mutex);
     id = mprGetCurrentOsThread();
-    for (i = 0; i < ts->threads->length; i++) {
-        tp = (MprThread*) mprGetItem(ts->threads, i);
+    for (lp = mprGetFirstLink(&ts->threads); lp; lp = mprGetNextLink(&ts->threads, lp)) {
+        tp = mprGetLinkItem(lp, MprThread, link);
         if (tp->osThread == id) {
             mprUnlock(ts->mutex);
             return tp;
@@ -155,6 +167,7 @@ MprThread *mprCreateThread(MprCtx ctx, cchar *name, MprThreadProc entry, void *d
     tp->mutex = mprCreateLock(tp);
     tp->pid = getpid();
     tp->priority = priority;
+    tp->numaNode = -1;
 
     if (stackSize == 0) {
         tp->stackSize = ts->stackSize;
@@ -164,13 +177,9 @@ MprThread *mprCreateThread(MprCtx ctx, cchar *name, MprThreadProc entry, void *d
 #if BLD_WIN_LIKE
     tp->threadHandle = 0;
 #endif
-    if (ts && ts->threads) {
+    if (ts) {
         mprLock(ts->mutex);
-        if (mprAddItem(ts->threads, tp) < 0) {
-            mprFree(tp);
-            mprUnlock(ts->mutex);
-            return 0;
-        }
+        mprAppendLink(&ts->threads, &tp->link);
         mprUnlock(ts->mutex);
     }
     return tp;
@@ -187,7 +196,16 @@ static int threadDestructor(MprThread *tp)
     mprLock(tp->mutex);
 
     ts = mprGetMpr(tp)->threadService;
-    mprRemoveItem(ts->threads, tp);
+    mprLock(ts->mutex);
+    mprRemoveLink(&ts->threads, &tp->link);
+    mprUnlock(ts->mutex);
+
+    /*
+     *  Stop the thread finding itself while its children, including its buffer cache, are freed
+     */
+    if (ts->threadKey && mprGetThreadData(ts->threadKey) == tp) {
+        mprSetThreadData(ts->threadKey, 0);
+    }
 
 #if BLD_WIN_LIKE
     if (tp->threadHandle) {
@@ -230,8 +248,12 @@ void *threadProcWrapper(void *data)
  */
 static void threadProc(MprThread *tp)
 {
+    MprThreadService    *ts;
+
     mprAssert(tp);
 
+    ts = mprGetMpr(tp)->threadService;
+    mprLock(tp->mutex);
     tp->osThread = mprGetCurrentOsThread();
 
 #if VXWORKS
@@ -239,6 +261,16 @@ static void threadProc(MprThread *tp)
 #else
     tp->pid = getpid();
 #endif
+#if LINUX
+    tp->osTid = (int) syscall(SYS_gettid);
+#endif
+    if (tp->pinned) {
+        applyAffinity(tp);
+    }
+    mprUnlock(tp->mutex);
+    if (ts->threadKey) {
+        mprSetThreadData(ts->threadKey, tp);
+    }
     (tp->entry)(tp->data, tp);
     mprFree(tp);
 }
@@ -327,6 +359,11 @@ void mprSetThreadPriority(MprThread *tp, int newPriority)
     SetThreadPriority(tp->threadHandle, osPri);
 #elif VXWORKS
     taskPrioritySet(tp->osThread, osPri);
+#elif LINUX
+    /*
+     *  On Linux, setpriority on a kernel task ID changes just that thread. The process ID would change the main thread.
+     */
+    setpriority(PRIO_PROCESS, (uint) (tp->osTid ? tp->osTid : tp->pid), osPri);
 #else
     setpriority(PRIO_PROCESS, (uint) tp->pid, osPri);
 #endif
@@ -335,6 +372,309 @@ void mprSetThreadPriority(MprThread *tp, int newPriority)
 }
 
 
+void mprInitCpuSet(MprCpuSet *cpus)
+{
+    memset(cpus, 0, sizeof(MprCpuSet));
+}
+
+
+void mprAddCpuToSet(MprCpuSet *cpus, int cpu)
+{
+    if (cpu >= 0 && cpu < MPR_MAX_CPUS) {
+        cpus->bits[cpu / (8 * sizeof(ulong))] |= (1UL << (cpu % (8 * sizeof(ulong))));
+    }
+}
+
+
+void mprRemoveCpuFromSet(MprCpuSet *cpus, int cpu)
+{
+    if (cpu >= 0 && cpu < MPR_MAX_CPUS) {
+        cpus->bits[cpu / (8 * sizeof(ulong))] &= ~(1UL << (cpu % (8 * sizeof(ulong))));
+    }
+}
+
+
+bool mprIsCpuInSet(MprCpuSet *cpus, int cpu)
+{
+    if (cpu < 0 || cpu >= MPR_MAX_CPUS) {
+        return 0;
+    }
+    return (cpus->bits[cpu / (8 * sizeof(ulong))] & (1UL << (cpu % (8 * sizeof(ulong))))) != 0;
+}
+
+
+int mprGetCpuSetCount(MprCpuSet *cpus)
+{
+    int     cpu, count;
+
+    for (count = cpu = 0; cpu < MPR_MAX_CPUS; cpu++) {
+        if (mprIsCpuInSet(cpus, cpu)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+
+/*
+ *  Return the Nth CPU in the set
+ */
+static int getCpuFromSet(MprCpuSet *cpus, int index)
+{
+    int     cpu;
+
+    for (cpu = 0; cpu < MPR_MAX_CPUS; cpu++) {
+        if (mprIsCpuInSet(cpus, cpu) && index-- == 0) {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+
+int mprGetCpuCount(MprCtx ctx)
+{
+    return mprGetMpr(ctx)->alloc.numCpu;
+}
+
+
+/*
+ *  Parse a Linux cpulist of the form "0-3,8,10-11"
+ */
+static void parseCpuList(MprCpuSet *cpus, char *list)
+{
+    char    *tok, *cp;
+    int     first, last;
+
+    mprInitCpuSet(cpus);
+    for (tok = list; tok && *tok; tok = cp) {
+        if ((cp = strchr(tok, ',')) != 0) {
+            *cp++ = '\0';
+        }
+        first = last = atoi(tok);
+        if (strchr(tok, '-')) {
+            last = atoi(strchr(tok, '-') + 1);
+        }
+        for (; first <= last; first++) {
+            mprAddCpuToSet(cpus, first);
+        }
+    }
+}
+
+
+/*
+ *  Probe the NUMA topology. Systems without NUMA information get one node with all CPUs.
+ */
+static void loadNumaTopology(MprThreadService *ts)
+{
+    MprCpuSet   *cpus;
+    int         node, cpu;
+
+    mprLock(ts->mutex);
+    if (ts->numaNodes > 0) {
+        mprUnlock(ts->mutex);
+        return;
+    }
+    cpus = (MprCpuSet*) mprAllocZeroed(ts, sizeof(MprCpuSet) * MPR_MAX_NUMA_NODES);
+    if (cpus == 0) {
+        mprUnlock(ts->mutex);
+        return;
+    }
+    node = 0;
+#if LINUX
+    {
+        char    path[MPR_MAX_FNAME], buf[MPR_MAX_STRING];
+        int     fd, len;
+
+        for (; node < MPR_MAX_NUMA_NODES; node++) {
+            mprSprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+            if ((fd = open(path, O_RDONLY)) < 0) {
+                break;
+            }
+            len = (int) read(fd, buf, sizeof(buf) - 1);
+            close(fd);
+            if (len <= 0) {
+                break;
+            }
+            buf[len] = '\0';
+            parseCpuList(&cpus[node], buf);
+        }
+    }
+#endif
+    if (node == 0) {
+        for (cpu = 0; cpu < mprGetCpuCount(ts); cpu++) {
+            mprAddCpuToSet(&cpus[0], cpu);
+        }
+        node = 1;
+    }
+    ts->numaCpus = cpus;
+    ts->numaNodes = node;
+    mprUnlock(ts->mutex);
+}
+
+
+int mprGetNumaNodeCount(MprCtx ctx)
+{
+    MprThreadService    *ts;
+
+    ts = mprGetMpr(ctx)->threadService;
+    loadNumaTopology(ts);
+    return max(ts->numaNodes, 1);
+}
+
+
+int mprGetNumaCpuSet(MprCtx ctx, int node, MprCpuSet *cpus)
+{
+    MprThreadService    *ts;
+
+    ts = mprGetMpr(ctx)->threadService;
+    loadNumaTopology(ts);
+    if (node < 0 || node >= ts->numaNodes) {
+        return MPR_ERR_BAD_ARGS;
+    }
+    *cpus = ts->numaCpus[node];
+    return 0;
+}
+
+
+int mprGetCurrentNumaNode(MprCtx ctx)
+{
+    MprThreadService    *ts;
+    MprThread           *tp;
+
+    ts = mprGetMpr(ctx)->threadService;
+    if (ts == 0 || ts->threadKey == 0) {
+        return -1;
+    }
+    if ((tp = (MprThread*) mprGetThreadData(ts->threadKey)) == 0) {
+        return -1;
+    }
+    return tp->numaNode;
+}
+
+
+/*
+ *  Return the NUMA node containing all the CPUs in the set. Return -1 if the set spans nodes or if there is only
+ *  one node (there is nothing to be gained by binding memory).
+ */
+static int getSetNode(MprThreadService *ts, MprCpuSet *cpus)
+{
+    int     node, cpu;
+
+    loadNumaTopology(ts);
+    if (ts->numaNodes <= 1) {
+        return -1;
+    }
+    for (node = 0; node < ts->numaNodes; node++) {
+        for (cpu = 0; cpu < MPR_MAX_CPUS; cpu++) {
+            if (mprIsCpuInSet(cpus, cpu) && !mprIsCpuInSet(&ts->numaCpus[node], cpu)) {
+                break;
+            }
+        }
+        if (cpu == MPR_MAX_CPUS) {
+            return node;
+        }
+    }
+    return -1;
+}
+
+
+/*
+ *  Apply the thread affinity to a running thread. Unpinned threads may run on any CPU.
+ */
+static int applyAffinity(MprThread *tp)
+{
+    MprCpuSet   all, *cpus;
+    int         cpu;
+
+    if (tp->pinned) {
+        cpus = &tp->affinity;
+    } else {
+        mprInitCpuSet(&all);
+        for (cpu = 0; cpu < mprGetCpuCount(tp); cpu++) {
+            mprAddCpuToSet(&all, cpu);
+        }
+        cpus = &all;
+    }
+#if LINUX
+    if (tp->osTid == 0) {
+        return 0;
+    }
+    if (syscall(SYS_sched_setaffinity, tp->osTid, sizeof(MprCpuSet), cpus->bits) < 0) {
+        return MPR_ERR_CANT_COMPLETE;
+    }
+    return 0;
+#elif BLD_WIN_LIKE && !WINCE
+    if (tp->threadHandle == 0) {
+        return 0;
+    }
+    return (SetThreadAffinityMask(tp->threadHandle, (DWORD_PTR) cpus->bits[0]) == 0) ? MPR_ERR_CANT_COMPLETE : 0;
+#else
+    return 0;
+#endif
+}
+
+
+int mprSetThreadAffinity(MprThread *tp, MprCpuSet *cpus)
+{
+    MprThreadService    *ts;
+    int                 node, rc;
+
+    ts = mprGetMpr(tp)->threadService;
+    if (cpus && mprGetCpuSetCount(cpus) == 0) {
+        return MPR_ERR_BAD_ARGS;
+    }
+    /*
+     *  Find the node before locking the thread. Loading the topology takes ts->mutex which must never be 
+     *  acquired while holding tp->mutex.
+     */
+    node = cpus ? getSetNode(ts, cpus) : -1;
+
+    mprLock(tp->mutex);
+    if (cpus) {
+        tp->affinity = *cpus;
+        tp->pinned = 1;
+        tp->numaNode = node;
+    } else {
+        mprInitCpuSet(&tp->affinity);
+        tp->pinned = 0;
+        tp->numaNode = -1;
+    }
+    rc = applyAffinity(tp);
+    mprUnlock(tp->mutex);
+    return rc;
+}
+
+
+int mprSetServiceThreadAffinity(MprCtx ctx, MprCpuSet *cpus)
+{
+    return mprSetThreadAffinity(mprGetMpr(ctx)->threadService->mainThread, cpus);
+}
+
+
+int mprSetEventsThreadAffinity(MprCtx ctx, MprCpuSet *cpus)
+{
+    MprThreadService    *ts;
+    MprThread           *tp;
+
+    ts = mprGetMpr(ctx)->threadService;
+    mprLock(ts->mutex);
+    if (cpus) {
+        ts->eventsAffinity = *cpus;
+        ts->eventsPinned = 1;
+    } else {
+        ts->eventsPinned = 0;
+    }
+    tp = ts->eventsThread;
+    mprUnlock(ts->mutex);
+
+    /*
+     *  Apply outside ts->mutex. mprSetThreadAffinity takes tp->mutex.
+     */
+    return (tp) ? mprSetThreadAffinity(tp, cpus) : 0;
+}
+
+
 static int threadLocalDestructor(MprThreadLocal *tls)
 {
 #if BLD_UNIX_LIKE
@@ -537,15 +877,10 @@ MprWorkerService *mprCreateWorkerService(MprCtx ctx)
     ws->mutex = mprCreateLock(ws);
     ws->minThreads = MPR_DEFAULT_MIN_THREADS;
     ws->maxThreads = MPR_DEFAULT_MAX_THREADS;
-
-    /*
-     *  Presize the lists so they cannot get memory allocation failures later on.
-     */
-    ws->idleThreads = mprCreateList(ws);
-    mprSetListLimits(ws->idleThreads, ws->maxThreads, -1);
-
-    ws->busyThreads = mprCreateList(ws);
-    mprSetListLimits(ws->busyThreads, ws->maxThreads, -1);
+    ws->queuePolicy = MPR_QUEUE_WEIGHTED;
+    resetCredits(ws);
+    mprInitLinkList(&ws->idleThreads);
+    mprInitLinkList(&ws->busyThreads);
     return ws;
 }
 
@@ -553,19 +888,21 @@ MprWorkerService *mprCreateWorkerService(MprCtx ctx)
 int mprStartWorkerService(MprWorkerService *ws)
 {
     /*
-     *  Create a timer to trim excess threads in the worker
+     *  Create a timer to periodically resize the worker pool
      */
     mprSetMinWorkers(ws, ws->minThreads);
-    ws->pruneTimer = mprCreateTimerEvent(mprGetDispatcher(ws), (MprEventProc) pruneWorkers, MPR_TIMEOUT_PRUNER, 
-        MPR_NORMAL_PRIORITY, (void*) ws, 0);
+    ws->tuneMark = mprGetTime(ws);
+    ws->cpuMark = getCpuTime();
+    ws->pruneTimer = mprCreateTimerEvent(mprGetDispatcher(ws), (MprEventProc) tuneWorkersTimer, 
+        MPR_TIMEOUT_WORKER_TUNE, MPR_NORMAL_PRIORITY, (void*) ws, 0);
     return 0;
 }
 
 
 bool mprStopWorkerService(MprWorkerService *ws, int timeout)
 {
-    MprWorker     *worker;
-    int           rc, next;
+    MprLink       *lp, *prev;
+    int           rc;
 
     rc = 0;
     mprLock(ws->mutex);
@@ -580,8 +917,9 @@ bool mprStopWorkerService(MprWorkerService *ws, int timeout)
      *  removed from the busy list and then delete the thread. We progressively remove the last thread in the idle
      *  list. ChangeState will move the threads to the busy queue.
      */
-    for (next = -1; (worker = (MprWorker*) mprGetPrevItem(ws->idleThreads, &next)) != 0; ) {
-        changeState(worker, MPR_WORKER_BUSY);
+    for (lp = mprGetLastLink(&ws->idleThreads); lp; lp = prev) {
+        prev = mprGetPrevLink(&ws->idleThreads, lp);
+        changeState(mprGetLinkItem(lp, MprWorker, link), MPR_WORKER_BUSY);
     }
 
     /*
@@ -594,8 +932,8 @@ bool mprStopWorkerService(MprWorkerService *ws, int timeout)
         mprLock(ws->mutex);
     }
 
-    mprAssert(ws->idleThreads->length == 0);
-    mprAssert(ws->busyThreads->length == 0);
+    mprAssert(mprGetLinkCount(&ws->idleThreads) == 0);
+    mprAssert(mprGetLinkCount(&ws->busyThreads) == 0);
     mprUnlock(ws->mutex);
     return ws->numThreads == 0;
 }
@@ -606,7 +944,6 @@ bool mprStopWorkerService(MprWorkerService *ws, int timeout)
  */
 void mprSetMinWorkers(MprCtx ctx, int n)
 { 
-    MprWorker           *worker;
     MprWorkerService    *ws;
 
     ws = mprGetMpr(ctx)->workerService;
@@ -615,12 +952,9 @@ void mprSetMinWorkers(MprCtx ctx, int n)
 
     ws->minThreads = n; 
     while (ws->numThreads < ws->minThreads) {
-        worker = createWorker(ws, ws->stackSize);
-        ws->numThreads++;
-        ws->maxUseThreads = max(ws->numThreads, ws->maxUseThreads);
-        ws->pruneHighWater = max(ws->numThreads, ws->pruneHighWater);
-        changeState(worker, MPR_WORKER_BUSY);
-        mprStartThread(worker->thread);
+        if (spawnWorker(ws, 0, 0, 0) == 0) {
+            break;
+        }
     }
     mprUnlock(ws->mutex);
 }
@@ -654,27 +988,21 @@ int mprGetMaxWorkers(MprCtx ctx)
 
 
 /*
- *  Return the current worker thread object
+ *  Return the current worker thread object. Only pool worker threads run workerMain.
  */
 MprWorker *mprGetCurrentWorker(MprCtx ctx)
 {
-    MprWorkerService    *ws;
-    MprWorker           *worker;
-    MprThread           *thread;
-    int                 next;
-
-    ws = mprGetMpr(ctx)->workerService;
+    MprThreadService    *ts;
+    MprThread           *tp;
 
-    mprLock(ws->mutex);
-    thread = mprGetCurrentThread(ws);
-    for (next = -1; (worker = (MprWorker*) mprGetPrevItem(ws->busyThreads, &next)) != 0; ) {
-        if (worker->thread == thread) {
-            mprUnlock(ws->mutex);
-            return worker;
-        }
+    ts = mprGetMpr(ctx)->threadService;
+    if (ts == 0 || ts->threadKey == 0) {
+        return 0;
     }
-    mprUnlock(ws->mutex);
-    return 0;
+    if ((tp = (MprThread*) mprGetThreadData(ts->threadKey)) == 0 || tp->entry != (MprThreadProc) workerMain) {
+        return 0;
+    }
+    return (MprWorker*) tp->data;
 }
 
 
@@ -714,10 +1042,27 @@ void mprActivateWorker(MprWorker *worker, MprWorkerProc proc, void *data, int pr
 
 
 int mprStartWorker(MprCtx ctx, MprWorkerProc proc, void *data, int priority)
+{
+    return startWorker(ctx, proc, data, priority, 1);
+}
+
+
+int mprTryStartWorker(MprCtx ctx, MprWorkerProc proc, void *data, int priority)
+{
+    return startWorker(ctx, proc, data, priority, 0);
+}
+
+
+/*
+ *  Start a task on an idle or new worker. If the pool is saturated, queue the task by priority class if requested,
+ *  otherwise return MPR_ERR_BUSY so the caller can run the task itself.
+ */
+static int startWorker(MprCtx ctx, MprWorkerProc proc, void *data, int priority, bool queue)
 {
     MprWorkerService    *ws;
     MprWorker           *worker;
-    int                 next;
+    MprLink             *lp;
+    int                 rc;
 
     ws = mprGetMpr(ctx)->workerService;
 
@@ -728,16 +1073,20 @@ int mprStartWorker(MprCtx ctx, MprWorkerProc proc, void *data, int priority)
      *  another thread to the worker. Must account for threads we've already created but have not yet gone to work 
      *  and inserted themselves in the idle/busy queues.
      */
-    for (next = 0; (worker = (MprWorker*) mprGetNextItem(ws->idleThreads, &next)) != 0; ) {
+    worker = 0;
+    for (lp = mprGetFirstLink(&ws->idleThreads); lp; lp = mprGetNextLink(&ws->idleThreads, lp)) {
+        worker = mprGetLinkItem(lp, MprWorker, link);
         if (!(worker->flags & MPR_WORKER_DEDICATED)) {
             break;
         }
+        worker = 0;
     }
 
     if (worker) {
         worker->proc = proc;
         worker->data = data;
         worker->priority = priority;
+        worker->requested = mprGetTime(ws);
         changeState(worker, MPR_WORKER_BUSY);
 
     } else if (ws->numThreads < ws->maxThreads) {
@@ -746,42 +1095,211 @@ int mprStartWorker(MprCtx ctx, MprWorkerProc proc, void *data, int priority)
          *  Can't find an idle thread. Try to create more threads in the worker. Otherwise, we will have to wait. 
          *  No need to wakeup the thread -- it will immediately go to work.
          */
-        worker = createWorker(ws, ws->stackSize);
-
-        ws->numThreads++;
-        ws->maxUseThreads = max(ws->numThreads, ws->maxUseThreads);
-        ws->pruneHighWater = max(ws->numThreads, ws->pruneHighWater);
-
-        worker->proc = proc;
-        worker->data = data;
-        worker->priority = priority;
-
-        changeState(worker, MPR_WORKER_BUSY);
-        mprStartThread(worker->thread);
+        if (spawnWorker(ws, proc, data, priority) == 0) {
+            mprUnlock(ws->mutex);
+            return MPR_ERR_NO_MEMORY;
+        }
 
     } else {
         static int warned = 0;
         /*
-         *  No free threads and can't create anymore
+         *  No free threads and can't create anymore. Queued tasks are run by busy workers as they complete.
          */
+        ws->rejected++;
+        if (queue) {
+            rc = mprQueueWorkerTask(ws, proc, data, priority);
+        } else {
+            rc = MPR_ERR_BUSY;
+        }
         if (warned++ == 0) {
-            mprError(ctx, "No free worker threads, using service thread. (currently allocated %d)", ws->numThreads);
+            mprError(ctx, "No free worker threads, %s. (currently allocated %d)", 
+                queue ? "queueing task" : "using service thread", ws->numThreads);
         }
         mprUnlock(ws->mutex);
-        return MPR_ERR_BUSY;
+        return rc;
+    }
+
+    /*
+     *  Keep spare threads ready ahead of demand. Spawn at most one per request to avoid thread creation storms.
+     */
+    if ((mprGetLinkCount(&ws->idleThreads) + ws->starting) < ws->spareThreads && ws->numThreads < ws->maxThreads) {
+        if (spawnWorker(ws, 0, 0, 0) != 0) {
+            ws->grown++;
+        }
     }
     mprUnlock(ws->mutex);
     return 0;
 }
 
 
+/*
+ *  Create and start a new worker thread. If proc is null, the worker goes idle as a spare. Must be called locked.
+ */
+static MprWorker *spawnWorker(MprWorkerService *ws, MprWorkerProc proc, void *data, int priority)
+{
+    MprWorker   *worker;
+
+    if ((worker = createWorker(ws, ws->stackSize)) == 0) {
+        return 0;
+    }
+    ws->numThreads++;
+    ws->maxUseThreads = max(ws->numThreads, ws->maxUseThreads);
+    ws->pruneHighWater = max(ws->numThreads, ws->pruneHighWater);
+
+    worker->proc = proc;
+    worker->data = data;
+    worker->priority = priority;
+    if (proc) {
+        worker->requested = mprGetTime(ws);
+    } else {
+        ws->starting++;
+    }
+    changeState(worker, MPR_WORKER_BUSY);
+    mprStartThread(worker->thread);
+    return worker;
+}
+
+
+/*
+ *  Account for the time a task waited before it started to run
+ */
+void mprRecordWorkerWait(MprWorkerService *ws, MprTime wait)
+{
+    mprLock(ws->mutex);
+    ws->waitTotal += wait;
+    ws->waitCount++;
+    ws->maxWait = max(ws->maxWait, (int) wait);
+    mprUnlock(ws->mutex);
+}
+
+
+int mprTuneWorkers(MprCtx ctx)
+{
+    return tuneWorkers(mprGetMpr(ctx)->workerService);
+}
+
+
+static void tuneWorkersTimer(MprWorkerService *ws, MprEvent *timer)
+{
+    tuneWorkers(ws);
+}
+
+
+/*
+ *  Resize the pool based on the start delays, rejections and CPU load measured since the last run. Growth is
+ *  immediate but shrinking requires sustained quiet periods so the pool does not oscillate under bursty load.
+ */
+static int tuneWorkers(MprWorkerService *ws)
+{
+    MprLink     *lp, *prev;
+    MprTime     now, cpu, elapsed;
+    int         avgWait, load, ncpu, pressure, decision, excess;
+
+    now = mprGetTime(ws);
+    cpu = getCpuTime();
+    ncpu = max(mprGetCpuCount(ws), 1);
+
+    mprLock(ws->mutex);
+    elapsed = now - ws->tuneMark;
+    avgWait = ws->waitCount ? (int) (ws->waitTotal / ws->waitCount) : 0;
+    load = 0;
+    if (cpu >= 0 && ws->cpuMark >= 0 && elapsed > 0) {
+        load = (int) ((cpu - ws->cpuMark) * 100 / (elapsed * ncpu));
+    }
+    pressure = avgWait >= MPR_WORKER_GROW_WAIT || ws->rejected > 0 || ws->pendingFutures > 0;
+    decision = MPR_WORKER_HOLD;
+
+    if (pressure) {
+        ws->quietPeriods = 0;
+        /*
+         *  More threads will not help if the CPUs are already saturated
+         */
+        if (load < MPR_WORKER_CPU_SATURATED) {
+            ws->spareThreads = min(max(ws->spareThreads * 2, 1), ws->maxThreads);
+            decision = MPR_WORKER_GROW;
+        }
+
+    } else if (avgWait < MPR_WORKER_SHRINK_WAIT && ++ws->quietPeriods >= MPR_WORKER_SHRINK_PERIODS &&
+            !mprGetDebugMode(ws)) {
+        ws->quietPeriods = 0;
+        ws->spareThreads /= 2;
+        /*
+         *  Prune half of the idle threads in excess of the spare target and the minimum. This gives exponential decay.
+         */
+        excess = min(mprGetLinkCount(&ws->idleThreads) - ws->spareThreads, ws->numThreads - ws->minThreads);
+        excess = (excess + 1) / 2;
+        for (lp = mprGetLastLink(&ws->idleThreads); excess > 0 && lp; lp = prev) {
+            prev = mprGetPrevLink(&ws->idleThreads, lp);
+            changeState(mprGetLinkItem(lp, MprWorker, link), MPR_WORKER_PRUNED);
+            ws->shrunk++;
+            excess--;
+            decision = MPR_WORKER_SHRINK;
+        }
+    }
+    while ((mprGetLinkCount(&ws->idleThreads) + ws->starting) < ws->spareThreads && ws->numThreads < ws->maxThreads) {
+        if (spawnWorker(ws, 0, 0, 0) == 0) {
+            break;
+        }
+        ws->grown++;
+    }
+
+    ws->last.avgWait = avgWait;
+    ws->last.maxWait = ws->maxWait;
+    ws->last.cpuLoad = load;
+    ws->last.rejected = ws->rejected;
+    ws->last.decision = decision;
+
+    ws->waitTotal = 0;
+    ws->waitCount = 0;
+    ws->maxWait = 0;
+    ws->rejected = 0;
+    ws->tuneMark = now;
+    ws->cpuMark = cpu;
+    ws->pruneHighWater = ws->numThreads;
+    mprUnlock(ws->mutex);
+
+    if (decision != MPR_WORKER_HOLD) {
+        mprLog(ws, 5, "Worker pool %s: threads %d, spare %d, wait %d msec, cpu %d%%", 
+            (decision == MPR_WORKER_GROW) ? "grow" : "shrink", ws->numThreads, ws->spareThreads, avgWait, load);
+    }
+    return decision;
+}
+
+
+/*
+ *  Return the process CPU time (user + system) in msec. Return -1 if not available.
+ */
+static MprTime getCpuTime()
+{
+#if BLD_UNIX_LIKE && !VXWORKS
+    struct rusage   usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) < 0) {
+        return -1;
+    }
+    return ((MprTime) usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 + 
+        (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+#elif BLD_WIN_LIKE && !WINCE
+    FILETIME    created, exited, kernel, user;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) {
+        return -1;
+    }
+    return (MprTime) (((((uint64) kernel.dwHighDateTime) << 32 | kernel.dwLowDateTime) + 
+        (((uint64) user.dwHighDateTime) << 32 | user.dwLowDateTime)) / 10000);
+#else
+    return -1;
+#endif
+}
+
+
 /*
  *  Trim idle threads from a task
  */
 static void pruneWorkers(MprWorkerService *ws, MprEvent *timer)
 {
-    MprWorker     *worker;
-    int           index, toTrim;
+    MprLink       *lp, *next;
+    int           toTrim;
 
     if (mprGetDebugMode(ws)) {
         return;
@@ -793,12 +1311,12 @@ static void pruneWorkers(MprWorkerService *ws, MprEvent *timer)
     mprLock(ws->mutex);
     toTrim = (ws->pruneHighWater - ws->minThreads) / 2;
 
-    for (index = 0; toTrim-- > 0 && index < ws->idleThreads->length; index++) {
-        worker = (MprWorker*) mprGetItem(ws->idleThreads, index);
+    for (lp = mprGetFirstLink(&ws->idleThreads); toTrim-- > 0 && lp; lp = next) {
+        next = mprGetNextLink(&ws->idleThreads, lp);
         /*
          *  Leave floating -- in no queue. The thread will kill itself.
          */
-        changeState(worker, MPR_WORKER_PRUNED);
+        changeState(mprGetLinkItem(lp, MprWorker, link), MPR_WORKER_PRUNED);
     }
     ws->pruneHighWater = ws->minThreads;
     mprUnlock(ws->mutex);
@@ -810,7 +1328,7 @@ int mprGetAvailableWorkers(MprCtx ctx)
     MprWorkerService  *ws;
 
     ws = mprGetMpr(ctx)->workerService;
-    return ws->idleThreads->length + (ws->maxThreads - ws->numThreads); 
+    return mprGetLinkCount(&ws->idleThreads) + (ws->maxThreads - ws->numThreads); 
 }
 
 
@@ -846,8 +1364,137 @@ void mprGetWorkerServiceStats(MprWorkerService *ws, MprWorkerStats *stats)
     stats->numThreads = ws->numThreads;
     stats->maxUse = ws->maxUseThreads;
     stats->pruneHighWater = ws->pruneHighWater;
-    stats->idleThreads = ws->idleThreads->length;
-    stats->busyThreads = ws->busyThreads->length;
+    stats->idleThreads = mprGetLinkCount(&ws->idleThreads);
+    stats->busyThreads = mprGetLinkCount(&ws->busyThreads);
+    stats->spareThreads = ws->spareThreads;
+    stats->avgWait = ws->last.avgWait;
+    stats->maxWait = ws->last.maxWait;
+    stats->cpuLoad = ws->last.cpuLoad;
+    stats->rejected = ws->last.rejected;
+    stats->decision = ws->last.decision;
+    stats->grown = ws->grown;
+    stats->shrunk = ws->shrunk;
+}
+
+
+int mprSetWorkerAffinity(MprCtx ctx, MprCpuSet *cpus, int mode)
+{
+    MprWorkerService    *ws;
+    MprLink             *lp;
+
+    ws = mprGetMpr(ctx)->workerService;
+    if (cpus && mprGetCpuSetCount(cpus) == 0) {
+        return MPR_ERR_BAD_ARGS;
+    }
+    mprLock(ws->mutex);
+    if (cpus) {
+        ws->affinity = *cpus;
+        ws->affinityMode = mode;
+    } else {
+        mprInitCpuSet(&ws->affinity);
+        ws->affinityMode = 0;
+    }
+    ws->nextAffinity = 0;
+    for (lp = mprGetFirstLink(&ws->idleThreads); lp; lp = mprGetNextLink(&ws->idleThreads, lp)) {
+        assignWorkerAffinity(ws, mprGetLinkItem(lp, MprWorker, link));
+    }
+    for (lp = mprGetFirstLink(&ws->busyThreads); lp; lp = mprGetNextLink(&ws->busyThreads, lp)) {
+        assignWorkerAffinity(ws, mprGetLinkItem(lp, MprWorker, link));
+    }
+    mprUnlock(ws->mutex);
+    return 0;
+}
+
+
+/*
+ *  Pin a worker according to the worker service affinity mode. Must be called locked.
+ */
+static void assignWorkerAffinity(MprWorkerService *ws, MprWorker *worker)
+{
+    MprCpuSet   cpus;
+    int         count, cpu, node;
+
+    if (worker->thread == 0) {
+        return;
+    }
+    switch (ws->affinityMode) {
+    case MPR_AFFINITY_SHARED:
+        mprSetThreadAffinity(worker->thread, &ws->affinity);
+        break;
+
+    case MPR_AFFINITY_CPU:
+        count = mprGetCpuSetCount(&ws->affinity);
+        cpu = getCpuFromSet(&ws->affinity, ws->nextAffinity++ % count);
+        mprInitCpuSet(&cpus);
+        mprAddCpuToSet(&cpus, cpu);
+        mprSetThreadAffinity(worker->thread, &cpus);
+        break;
+
+    case MPR_AFFINITY_NODE:
+        /*
+         *  Intersect the node CPUs with the requested set. Skip nodes that have no CPUs in the set.
+         */
+        count = mprGetNumaNodeCount(ws);
+        for (node = 0; node < count; node++) {
+            mprGetNumaCpuSet(ws, ws->nextAffinity++ % count, &cpus);
+            for (cpu = 0; cpu < MPR_MAX_CPUS; cpu++) {
+                if (!mprIsCpuInSet(&ws->affinity, cpu)) {
+                    mprRemoveCpuFromSet(&cpus, cpu);
+                }
+            }
+            if (mprGetCpuSetCount(&cpus) > 0) {
+                break;
+            }
+        }
+        mprSetThreadAffinity(worker->thread, (node < count) ? &cpus : &ws->affinity);
+        break;
+
+    default:
+        if (worker->thread->pinned) {
+            mprSetThreadAffinity(worker->thread, NULL);
+        }
+        break;
+    }
+}
+
+
+int mprGetPriorityClass(int priority)
+{
+    if (priority <= MPR_BACKGROUND_PRIORITY) {
+        return MPR_CLASS_BACKGROUND;
+    } else if (priority <= MPR_LOW_PRIORITY) {
+        return MPR_CLASS_LOW;
+    } else if (priority <= MPR_NORMAL_PRIORITY) {
+        return MPR_CLASS_NORMAL;
+    } else if (priority <= MPR_HIGH_PRIORITY) {
+        return MPR_CLASS_HIGH;
+    }
+    return MPR_CLASS_CRITICAL;
+}
+
+
+void mprSetWorkerQueuePolicy(MprCtx ctx, int policy)
+{
+    MprWorkerService    *ws;
+
+    ws = mprGetMpr(ctx)->workerService;
+    mprLock(ws->mutex);
+    ws->queuePolicy = policy;
+    resetCredits(ws);
+    mprUnlock(ws->mutex);
+}
+
+
+/*
+ *  Start a new weighted round-robin round. Class N gets 2^N turns.
+ */
+static void resetCredits(MprWorkerService *ws)
+{
+    int     cls;
+
+    for (cls = 0; cls < MPR_PRIORITY_CLASSES; cls++) {
+        ws->credits[cls] = 1 << cls;
+    }
 }
 
 
@@ -885,6 +1532,9 @@ static MprWorker *createWorker(MprWorkerService *ws, int stackSize)
 
     mprSprintf(name, sizeof(name), "worker.%u", getNextThreadNum(ws));
     worker->thread = mprCreateThread(ws, name, (MprThreadProc) workerMain, (void*) worker, MPR_WORKER_PRIORITY, 0);
+    if (ws->affinityMode && worker->thread) {
+        assignWorkerAffinity(ws, worker);
+    }
     return worker;
 }
 
@@ -905,7 +1555,8 @@ static int workerDestructor(MprWorker *worker)
 static void workerMain(MprWorker *worker, MprThread *tp)
 {
     MprWorkerService    *ws;
-    int                 rc;
+    MprFuture           *fp;
+    int                 rc, spare;
 
     ws = mprGetMpr(worker)->workerService;
     mprAssert(worker->state == MPR_WORKER_BUSY);
@@ -915,19 +1566,42 @@ static void workerMain(MprWorker *worker, MprThread *tp)
         (*ws->startWorker)(worker->data, worker);
     }
     mprLock(ws->mutex);
+    spare = (worker->proc == 0);
 
     while (!(worker->state & MPR_WORKER_PRUNED)) {
         if (worker->proc) {
+            if (worker->requested) {
+                mprRecordWorkerWait(ws, mprGetTime(ws) - worker->requested);
+                worker->requested = 0;
+            }
             mprUnlock(ws->mutex);
-            mprSetThreadPriority(worker->thread, worker->priority);
-
+            /*
+             *  Only change the O/S priority when the task needs a different O/S priority from the last task. This
+             *  avoids system calls for the common case where consecutive tasks share a priority class.
+             */
+            if (mprMapMprPriorityToOs(worker->priority) != mprMapMprPriorityToOs(tp->priority)) {
+                mprSetThreadPriority(tp, worker->priority);
+            }
             (*worker->proc)(worker->data, worker);
 
             mprLock(ws->mutex);
             worker->proc = 0;
-            mprSetThreadPriority(worker->thread, MPR_WORKER_PRIORITY);
+        }
+        if (!(worker->flags & MPR_WORKER_DEDICATED)) {
+            /*
+             *  Run queued futures before sleeping
+             */
+            while ((fp = mprGetNextFuture(ws)) != 0) {
+                mprUnlock(ws->mutex);
+                mprRunFuture(fp);
+                mprLock(ws->mutex);
+            }
         }
         changeState(worker, MPR_WORKER_SLEEPING);
+        if (spare) {
+            ws->starting--;
+            spare = 0;
+        }
 
         if (worker->cleanup) {
             (*worker->cleanup)(worker->data, worker);
@@ -955,50 +1629,34 @@ static void workerMain(MprWorker *worker, MprThread *tp)
 static int changeState(MprWorker *worker, int state)
 {
     MprWorkerService    *ws;
-    MprList             *lp;
+    MprLinkList         *lp;
 
     mprAssert(worker->state != state);
 
     ws = worker->workerService;
 
-    lp = 0;
     mprLock(ws->mutex);
-    switch (worker->state) {
-    case MPR_WORKER_BUSY:
-        lp = ws->busyThreads;
-        break;
-
-    case MPR_WORKER_IDLE:
-        lp = ws->idleThreads;
-        break;
-
-    case MPR_WORKER_SLEEPING:
-        if (!(worker->flags & MPR_WORKER_DEDICATED)) {
-            lp = ws->idleThreads;
-        }
+    if (worker->state == MPR_WORKER_SLEEPING) {
         mprSignalCond(worker->idleCond); 
-        break;
-        
-    case MPR_WORKER_PRUNED:
-        break;
     }
 
     /*
-     *  Reassign the worker to the appropriate queue
+     *  Reassign the worker to the appropriate queue. Only busy workers are on the busy queue. The dedicated flag may
+     *  have changed since the worker was queued, so test the link rather than the flag.
      */
-    if (lp) {
-        mprRemoveItem(lp, worker);
+    if (mprIsLinked(&worker->link)) {
+        mprRemoveLink((worker->state == MPR_WORKER_BUSY) ? &ws->busyThreads : &ws->idleThreads, &worker->link);
     }
     lp = 0;
     switch (state) {
     case MPR_WORKER_BUSY:
-        lp = ws->busyThreads;
+        lp = &ws->busyThreads;
         break;
 
     case MPR_WORKER_IDLE:
     case MPR_WORKER_SLEEPING:
         if (!(worker->flags & MPR_WORKER_DEDICATED)) {
-            lp = ws->idleThreads;
+            lp = &ws->idleThreads;
         }
         break;
 
@@ -1010,10 +1668,7 @@ static int changeState(MprWorker *worker, int state)
     worker->state = state;
 
     if (lp) {
-        if (mprAddItem(lp, worker) < 0) {
-            mprUnlock(ws->mutex);
-            return MPR_ERR_NO_MEMORY;
-        }
+        mprAppendLink(lp, &worker->link);
     }
     mprUnlock(ws->mutex);
     return 0;
@@ -49,92 +49,75 @@ typedef struct TimeToken {
     int     value;
 } TimeToken;
 
-static TimeToken days[] = {
-    { "sun",  0 | TOKEN_DAY },
-    { "mon",  1 | TOKEN_DAY },
-    { "tue",  2 | TOKEN_DAY },
-    { "wed",  3 | TOKEN_DAY },
-    { "thu",  4 | TOKEN_DAY },
-    { "fri",  5 | TOKEN_DAY },
-    { "sat",  6 | TOKEN_DAY },
-    { 0, 0 },
-};
-
-static TimeToken fullDays[] = {
-    { "sunday",     0 | TOKEN_DAY },
-    { "monday",     1 | TOKEN_DAY },
-    { "tuesday",    2 | TOKEN_DAY },
-    { "wednesday",  3 | TOKEN_DAY },
-    { "thursday",   4 | TOKEN_DAY },
-    { "friday",     5 | TOKEN_DAY },
-    { "saturday",   6 | TOKEN_DAY },
-    { 0, 0 },
-};
-
 /*
-    Make origin 1 to correspond to user date entries 10/28/2011
+ *  Perfect hash table generated by makehash from timeTokens.txt. Do not edit.
+ *  Lookup with mprLookupPerfectHash(timeTokensSeeds, TIME_TOKENS_SIZE, key).
  */
-static TimeToken months[] = {
-    { "jan",  1 | TOKEN_MONTH },
-    { "feb",  2 | TOKEN_MONTH },
-    { "mar",  3 | TOKEN_MONTH },
-    { "apr",  4 | TOKEN_MONTH },
-    { "may",  5 | TOKEN_MONTH },
-    { "jun",  6 | TOKEN_MONTH },
-    { "jul",  7 | TOKEN_MONTH },
-    { "aug",  8 | TOKEN_MONTH },
-    { "sep",  9 | TOKEN_MONTH },
-    { "oct", 10 | TOKEN_MONTH },
-    { "nov", 11 | TOKEN_MONTH },
-    { "dec", 12 | TOKEN_MONTH },
-    { 0, 0 },
-};
-
-static TimeToken fullMonths[] = {
-    { "january",    1 | TOKEN_MONTH },
-    { "february",   2 | TOKEN_MONTH },
-    { "march",      3 | TOKEN_MONTH },
-    { "april",      4 | TOKEN_MONTH },
-    { "may",        5 | TOKEN_MONTH },
-    { "june",       6 | TOKEN_MONTH },
-    { "july",       7 | TOKEN_MONTH },
-    { "august",     8 | TOKEN_MONTH },
-    { "september",  9 | TOKEN_MONTH },
-    { "october",   10 | TOKEN_MONTH },
-    { "november",  11 | TOKEN_MONTH },
-    { "december",  12 | TOKEN_MONTH },
-    { 0, 0 }
+#define TIME_TOKENS_SIZE 54
+
+static const short timeTokensSeeds[TIME_TOKENS_SIZE] = {
+    0, 0, 0, -4, 1, -6, 1, -8, -12, 1, -13, 0,
+    -17, 1, -18, 7, -19, 1, -28, 0, 1, -31, 0, 0,
+    0, 3, 2, -32, 1, -33, 1, -37, 0, 1, -39, 0,
+    -40, -42, 2, 0, 0, 0, 20, -46, 0, 0, 0, 8,
+    0, 0, 0, 0, -47, -49,
 };
 
-static TimeToken ampm[] = {
+static TimeToken timeTokens[] = {
+    { "ut", 0 | TOKEN_ZONE },
+    { "tue", 2 | TOKEN_DAY },
+    { "pst", -480 | TOKEN_ZONE },
+    { "march", 3 | TOKEN_MONTH },
+    { "november", 11 | TOKEN_MONTH },
+    { "january", 1 | TOKEN_MONTH },
+    { "mdt", -360 | TOKEN_ZONE },
+    { "thursday", 4 | TOKEN_DAY },
+    { "september", 9 | TOKEN_MONTH },
+    { "tuesday", 2 | TOKEN_DAY },
+    { "sat", 6 | TOKEN_DAY },
+    { "april", 4 | TOKEN_MONTH },
+    { "next week", (86400 * 7) | TOKEN_OFFSET },
+    { "october", 10 | TOKEN_MONTH },
+    { "august", 8 | TOKEN_MONTH },
     { "am", 0 | TOKEN_OFFSET },
+    { "mon", 1 | TOKEN_DAY },
+    { "friday", 5 | TOKEN_DAY },
+    { "edt", -240 | TOKEN_ZONE },
+    { "sep", 9 | TOKEN_MONTH },
+    { "december", 12 | TOKEN_MONTH },
+    { "feb", 2 | TOKEN_MONTH },
+    { "cdt", -300 | TOKEN_ZONE },
+    { "mst", -420 | TOKEN_ZONE },
+    { "yesterday", -86400 | TOKEN_OFFSET },
+    { "oct", 10 | TOKEN_MONTH },
+    { "thu", 4 | TOKEN_DAY },
+    { "saturday", 6 | TOKEN_DAY },
+    { "july", 7 | TOKEN_MONTH },
+    { "june", 6 | TOKEN_MONTH },
+    { "sunday", 0 | TOKEN_DAY },
+    { "may", 5 | TOKEN_MONTH },
+    { "wed", 3 | TOKEN_DAY },
+    { "monday", 1 | TOKEN_DAY },
     { "pm", (12 * 3600) | TOKEN_OFFSET },
-    { 0, 0 },
-};
-
-
-static TimeToken zones[] = {
-    { "ut",      0 | TOKEN_ZONE},
-    { "utc",     0 | TOKEN_ZONE},
-    { "gmt",     0 | TOKEN_ZONE},
-    { "edt",  -240 | TOKEN_ZONE},
-    { "est",  -300 | TOKEN_ZONE},
-    { "cdt",  -300 | TOKEN_ZONE},
-    { "cst",  -360 | TOKEN_ZONE},
-    { "mdt",  -360 | TOKEN_ZONE},
-    { "mst",  -420 | TOKEN_ZONE},
-    { "pdt",  -420 | TOKEN_ZONE},
-    { "pst",  -480 | TOKEN_ZONE},
-    { 0, 0 },
-};
-
-
-static TimeToken offsets[] = {
-    { "tomorrow",    86400 | TOKEN_OFFSET},
-    { "yesterday",  -86400 | TOKEN_OFFSET},
-    { "next week",   (86400 * 7) | TOKEN_OFFSET},
-    { "last week",  -(86400 * 7) | TOKEN_OFFSET},
-    { 0, 0 },
+    { "dec", 12 | TOKEN_MONTH },
+    { "mar", 3 | TOKEN_MONTH },
+    { "cst", -360 | TOKEN_ZONE },
+    { "fri", 5 | TOKEN_DAY },
+    { "pdt", -420 | TOKEN_ZONE },
+    { "tomorrow", 86400 | TOKEN_OFFSET },
+    { "apr", 4 | TOKEN_MONTH },
+    { "est", -300 | TOKEN_ZONE },
+    { "jul", 7 | TOKEN_MONTH },
+    { "aug", 8 | TOKEN_MONTH },
+    { "february", 2 | TOKEN_MONTH },
+    { "sun", 0 | TOKEN_DAY },
+    { "gmt", 0 | TOKEN_ZONE },
+    { "wednesday", 3 | TOKEN_DAY },
+    { "jan", 1 | TOKEN_MONTH },
+    { "utc", 0 | TOKEN_ZONE },
+    { "nov", 11 | TOKEN_MONTH },
+    { "last week", -(86400 * 7) | TOKEN_OFFSET },
+    { "jun", 6 | TOKEN_MONTH },
 };
 
 static int timeSep = ':';
@@ -186,6 +169,7 @@ static int leapMonthStart[] = {
 };
 
 static MprTime daysSinceEpoch(int year);
+static TimeToken *lookupToken(cchar *token);
 static void decodeTime(MprCtx ctx, struct tm *tp, MprTime when, bool local);
 static int getTimeZoneOffsetFromTm(MprCtx ctx, struct tm *tp);
 static int leapYear(int year);
@@ -195,38 +179,10 @@ static void validateTime(MprCtx ctx, struct tm *tm, struct tm *defaults);
 
 /************************************ Code ************************************/
 /*
-    Initialize the time service
+    Initialize the time service. The parsing tokens are a static perfect hash table so there is nothing to build.
  */
 int mprCreateTimeService(MprCtx ctx)
 {
-    Mpr                 *mpr;
-    TimeToken           *tt;
-
-    mpr = mprGetMpr(ctx);
-    mpr->timeTokens = mprCreateHash(mpr, -1);
-    ctx = mpr->timeTokens;
-
-    for (tt = days; tt->name; tt++) {
-        mprAddHash(mpr->timeTokens, tt->name, (void*) tt);
-    }
-    for (tt = fullDays; tt->name; tt++) {
-        mprAddHash(mpr->timeTokens, tt->name, (void*) tt);
-    }
-    for (tt = months; tt->name; tt++) {
-        mprAddHash(mpr->timeTokens, tt->name, (void*) tt);
-    }
-    for (tt = fullMonths; tt->name; tt++) {
-        mprAddHash(mpr->timeTokens, tt->name, (void*) tt);
-    }
-    for (tt = ampm; tt->name; tt++) {
-        mprAddHash(mpr->timeTokens, tt->name, (void*) tt);
-    }
-    for (tt = zones; tt->name; tt++) {
-        mprAddHash(mpr->timeTokens, tt->name, (void*) tt);
-    }
-    for (tt = offsets; tt->name; tt++) {
-        mprAddHash(mpr->timeTokens, tt->name, (void*) tt);
-    }
     return 0;
 }
 
@@ -1223,11 +1179,20 @@ char *mprFormatTime(MprCtx ctx, cchar *fmt, struct tm *tp)
 
 /*************************************** Parsing ************************************/
 
+static TimeToken *lookupToken(cchar *token)
+{
+    TimeToken   *tt;
+
+    tt = &timeTokens[mprLookupPerfectHash(timeTokensSeeds, TIME_TOKENS_SIZE, token)];
+    return (strcmp(tt->name, token) == 0) ? tt : 0;
+}
+
+
 static int lookupSym(Mpr *mpr, cchar *token, int kind)
 {
     TimeToken   *tt;
 
-    if ((tt = (TimeToken*) mprLookupHash(mpr->timeTokens, token)) == 0) {
+    if ((tt = lookupToken(token)) == 0) {
         return -1;
     }
     if (kind != (tt->value & TOKEN_MASK)) {
@@ -1404,7 +1369,7 @@ int mprParseTime(MprCtx ctx, MprTime *time, cchar *dateString, int zoneFlags, st
             explicitZone = 1;
 
         } else if (isalpha((int) *token)) {
-            if ((tt = (TimeToken*) mprLookupHash(mpr->timeTokens, token)) != 0) {
+            if ((tt = lookupToken(token)) != 0) {
                 kind = tt->value & TOKEN_MASK;
                 value = tt->value & ~TOKEN_MASK; 
                 switch (kind) {
@@ -1,541 +1,557 @@
 /**
- *  mprUnicode.c - Unicode 
+ *  mprUnicode.c - Unicode support
+ *
+ *  UTF-8 validation and conversion between UTF-8 and UTF-16 (uni) strings. Most text is ASCII, so each routine 
+ *  examines 16 bytes at a time (with SSE2 where available) and converts ASCII blocks directly. Only the multibyte 
+ *  sequences are decoded one at a time. Decoding rejects overlong forms, surrogates and values beyond U+10FFFF.
+ *
+ *  Uni strings are arrays of UTF-16 code units terminated by a null unit.
  *
  *  Copyright (c) All Rights Reserved. See details at the end of the file.
  */
 
 /********************************** Includes **********************************/
-#if KEEP
 
 #include    "mpr.h"
 
-/************************************ Code ************************************/
-/*
- *  Allocate a new (empty) unicode string
- */
-uni *mprAllocUs(MprCtx ctx)
-{
-    mprAssert(ctx);
-
-    return mprAllocObjZeroed(ctx, uni);
-}
-
+#if defined(__SSE2__) || defined(_M_X64)
+    #include    <emmintrin.h>
+    #define USE_SSE2 1
+#endif
 
+/*********************************** Locals ***********************************/
 
-/*
- *  Grow the string buffer for a unicode string
- */
-static int growUs(uni *us, int len)
-{
-    mprAssert(us);
-    mprAssert(len >= 0);
+#define BLOCK_SIZE          16              /* Bytes examined at once */
+#define MAX_CODE            0x10FFFF        /* Largest unicode code point */
+#define SURROGATE_HIGH      0xD800          /* First high (leading) surrogate */
+#define SURROGATE_LOW       0xDC00          /* First low (trailing) surrogate */
+#define SURROGATE_END       0xE000          /* End of the surrogate range */
 
-    if (len < us->length) {
-        return 0;
-    }
-
-    us->str = mprRealloc(us, us->str, len);
-    if (us->str == 0) {
-        return MPR_ERR_NO_MEMORY;
-    }
-    us->length = len;
-    return 0;
-}
+#define isCont(c)           (((c) & 0xC0) == 0x80)
+#define isSurrogate(c)      ((c) >= SURROGATE_HIGH && (c) < SURROGATE_END)
 
+/***************************** Forward Declarations ***************************/
 
+static int asciiPrefix(cuchar *str, int len);
+static int decodeUtf8(cuchar *str, int len, int *code);
+static int isInSet(int c, cuni *set);
+static int utf8Length(cuni *us, int count);
 
-/*
- *  Convert a ASCII string to UTF-8/16
- */
-static int memToUs(uni *us, const uchar *str, int len)
+/************************************ Code ************************************/
+#if USE_SSE2
+static MPR_INLINE int lowestBit(uint mask)
 {
-    uniData   *up;
-    cchar       *cp;
-
-    mprAssert(us);
-    mprAssert(str);
-
-    if (len > us->length) {
-        if (growUs(us, len) < 0) {
-            return MPR_ERR_NO_MEMORY;
-        }
-    }
-    us->length = len;
+#if __GNUC__
+    return __builtin_ctz(mask);
+#else
+    int     i;
 
-#if BLD_FEATURE_UTF16
-    cp = (cchar*) str;
-    up = us->str;
-    while (*cp) {
-        *up++ = *cp++;
+    for (i = 0; (mask & 1) == 0; i++) {
+        mask >>= 1;
     }
-#else
-    memcpy((void*) us->str, str, len);
+    return i;
 #endif
-
-    return 0;
 }
+#endif
 
 
-
-/*
- *  Convert a C string to a newly allocated unicode string
- */
-uni *mprStrToUs(MprCtx ctx, cchar *str)
+bool mprIsUtf8(cchar *str, int len)
 {
-    uni   *us;
-    int     len;
+    cuchar  *cp;
+    int     i, n, code;
 
-    mprAssert(ctx);
     mprAssert(str);
 
-    us = mprAllocUs(ctx);
-    if (us == 0) {
-        return 0;
+    if (len < 0) {
+        len = (int) strlen(str);
     }
-
-    if (str == 0) {
-        str = "";
-    }
-
-    len = strlen(str);
-
-    if (memToUs(us, (const uchar*) str, len) < 0) {
-        return 0;
+    cp = (cuchar*) str;
+    for (i = 0; i < len; ) {
+        i += asciiPrefix(&cp[i], len - i);
+        while (i < len && cp[i] >= 0x80) {
+            if ((n = decodeUtf8(&cp[i], len - i, &code)) == 0) {
+                return 0;
+            }
+            i += n;
+        }
     }
-    
-    return us;
+    return 1;
 }
 
 
-
-/*
- *  Convert a memory buffer to a newly allocated unicode string
- */
-uni *mprMemToUs(MprCtx ctx, const uchar *buf, int len)
+int mprUtf8ToUni(uni *dest, int destCount, cchar *str, int len)
 {
-    uni   *us;
+    cuchar      *cp;
+    int         i, j, n, code;
+#if USE_SSE2
+    __m128i     block, zero;
 
-    mprAssert(ctx);
-    mprAssert(buf);
+    zero = _mm_setzero_si128();
+#endif
 
-    us = mprAllocUs(ctx);
-    if (us == 0) {
-        return 0;
+    mprAssert(str);
+
+    if (len < 0) {
+        len = (int) strlen(str);
     }
+    cp = (cuchar*) str;
 
-    if (memToUs(us, buf, len) < 0) {
-        return 0;
+    if (dest == 0) {
+        /*
+         *  Measure only
+         */
+        for (i = j = 0; i < len; ) {
+            n = asciiPrefix(&cp[i], len - i);
+            i += n;
+            j += n;
+            while (i < len && cp[i] >= 0x80) {
+                if ((n = decodeUtf8(&cp[i], len - i, &code)) == 0) {
+                    return MPR_ERR_BAD_FORMAT;
+                }
+                i += n;
+                j += (code >= 0x10000) ? 2 : 1;
+            }
+        }
+        return j;
     }
-    
-    return us;
+    mprAssert(destCount > 0);
+
+    for (i = j = 0; i < len; ) {
+#if USE_SSE2
+        /*
+         *  Widen blocks of ASCII directly. Leave room for the null.
+         */
+        while ((len - i) >= BLOCK_SIZE && (destCount - j) > BLOCK_SIZE) {
+            block = _mm_loadu_si128((__m128i*) &cp[i]);
+            if (_mm_movemask_epi8(block)) {
+                break;
+            }
+            _mm_storeu_si128((__m128i*) &dest[j], _mm_unpacklo_epi8(block, zero));
+            _mm_storeu_si128((__m128i*) &dest[j + 8], _mm_unpackhi_epi8(block, zero));
+            i += BLOCK_SIZE;
+            j += BLOCK_SIZE;
+        }
+        if (i >= len) {
+            break;
+        }
+#endif
+        /*
+         *  The rest of the ASCII run then the multibyte run that follows
+         */
+        for (; i < len && cp[i] < 0x80; i++) {
+            if (j >= destCount - 1) {
+                return MPR_ERR_WONT_FIT;
+            }
+            dest[j++] = cp[i];
+        }
+        while (i < len && cp[i] >= 0x80) {
+            if ((n = decodeUtf8(&cp[i], len - i, &code)) == 0) {
+                return MPR_ERR_BAD_FORMAT;
+            }
+            i += n;
+            if (code >= 0x10000) {
+                if (j >= destCount - 2) {
+                    return MPR_ERR_WONT_FIT;
+                }
+                code -= 0x10000;
+                dest[j++] = (uni) (SURROGATE_HIGH | (code >> 10));
+                dest[j++] = (uni) (SURROGATE_LOW | (code & 0x3FF));
+            } else {
+                if (j >= destCount - 1) {
+                    return MPR_ERR_WONT_FIT;
+                }
+                dest[j++] = (uni) code;
+            }
+        }
+    }
+    dest[j] = 0;
+    return j;
 }
 
 
-
-/*
- *  Convert a unicode string newly allocated C string
- */
-char *mprUsToStr(uni *us)
+int mprUniToUtf8(char *dest, int destSize, cuni *us, int count)
 {
-    char    *str, *cp;
+    uchar       *dp;
+    int         i, j, c, code;
+#if USE_SSE2
+    __m128i     lo, hi, high;
+
+    high = _mm_set1_epi16((short) 0xFF80);
+#endif
 
     mprAssert(us);
 
-    str = cp = mprAlloc(us, us->length + 1);
-    if (cp == 0) {
-        return 0;
+    if (count < 0) {
+        count = mprUniLen(us);
     }
-
-#if BLD_FEATURE_UTF16
-{
-    uniData   *up;
-    int         i;
-
-    up = us->str;
-    for (i = 0; i < us->length; i++) {
-        cp[i] = up[i];
+    if (dest == 0) {
+        return utf8Length(us, count);
     }
-}
-#else
-    mprStrcpy(cp, us->length, us->str);
+    mprAssert(destSize > 0);
+
+    dp = (uchar*) dest;
+    for (i = j = 0; i < count; ) {
+#if USE_SSE2
+        /*
+         *  Narrow blocks of ASCII directly. Leave room for the null.
+         */
+        while ((count - i) >= BLOCK_SIZE && (destSize - j) > BLOCK_SIZE) {
+            lo = _mm_loadu_si128((__m128i*) &us[i]);
+            hi = _mm_loadu_si128((__m128i*) &us[i + 8]);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(lo, hi), high), 
+                    _mm_setzero_si128())) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128((__m128i*) &dp[j], _mm_packus_epi16(lo, hi));
+            i += BLOCK_SIZE;
+            j += BLOCK_SIZE;
+        }
+        if (i >= count) {
+            break;
+        }
 #endif
-    return str;
-}
-
-
-
-/*
- *  Copy one unicode string to another. No allocation
- */
-static void copyUs(uni *dest, uni *src)
-{
-    mprAssert(dest);
-    mprAssert(src);
-    mprAssert(dest->length <= src->length);
-    mprAssert(dest->str);
-    mprAssert(src->str);
-
-    memcpy(dest->str, src->str, src->length * sizeof(uniData));
-    dest->length = src->length;
-}
-
-
-
-/*
- *  Copy one unicode string to another. Grow the destination unicode string buffer as required.
- */
-int mprCopyUs(uni *dest, uni *src)
-{
-    mprAssert(dest);
-    mprAssert(src);
-
-    dest->length = src->length;
-
-    if (src->length > dest->length) {
-        if (growUs(dest, src->length) < 0) {
-            return MPR_ERR_NO_MEMORY;
+        for (; i < count && (ushort) us[i] < 0x80; i++) {
+            if (j >= destSize - 1) {
+                return MPR_ERR_WONT_FIT;
+            }
+            dp[j++] = (uchar) us[i];
         }
-    }
-
-    copyUs(dest, src);
-
-    return 0;
-}
-
-
-
-/*
- *  Catenate a unicode string onto another.
- */
-int mprCatUs(uni *dest, uni *src)
-{
-    int     len;
+        if (i >= count) {
+            break;
+        }
+        c = (ushort) us[i++];
+        if (c < 0x800) {
+            if (j >= destSize - 2) {
+                return MPR_ERR_WONT_FIT;
+            }
+            dp[j++] = (uchar) (0xC0 | (c >> 6));
+            dp[j++] = (uchar) (0x80 | (c & 0x3F));
 
-    len = dest->length + src->length;
-    if (growUs(dest, len) < 0) {
-        return MPR_ERR_NO_MEMORY;
+        } else if (isSurrogate(c)) {
+            if (c >= SURROGATE_LOW || i >= count || ((ushort) us[i] & 0xFC00) != SURROGATE_LOW) {
+                return MPR_ERR_BAD_FORMAT;
+            }
+            if (j >= destSize - 4) {
+                return MPR_ERR_WONT_FIT;
+            }
+            code = 0x10000 + ((c - SURROGATE_HIGH) << 10) + ((ushort) us[i++] - SURROGATE_LOW);
+            dp[j++] = (uchar) (0xF0 | (code >> 18));
+            dp[j++] = (uchar) (0x80 | ((code >> 12) & 0x3F));
+            dp[j++] = (uchar) (0x80 | ((code >> 6) & 0x3F));
+            dp[j++] = (uchar) (0x80 | (code & 0x3F));
+
+        } else {
+            if (j >= destSize - 3) {
+                return MPR_ERR_WONT_FIT;
+            }
+            dp[j++] = (uchar) (0xE0 | (c >> 12));
+            dp[j++] = (uchar) (0x80 | ((c >> 6) & 0x3F));
+            dp[j++] = (uchar) (0x80 | (c & 0x3F));
+        }
     }
-
-    memcpy(&dest->str[dest->length], src->str, src->length * sizeof(uniData));
-    dest->length += src->length;
-
-    return 0;
+    dp[j] = '\0';
+    return j;
 }
 
 
-
 /*
- *  Catenate a set of unicode string arguments onto another.
+ *  Each UTF-8 byte converts to at most one UTF-16 unit so len + 1 units always suffice
  */
-int mprCatUsArgs(uni *dest, uni *src, ...)
+uni *mprStrToUni(MprCtx ctx, cchar *str, int len)
 {
-    va_list     args;
-    uni       *us;
-    int         len;
-
-    va_start(args, src);
+    uni     *us;
 
-    len = 0;
-    us = src;
-    for (us = src; us; ) {
-        us = va_arg(args, uni*);
-        len += us->length;
-    }
+    mprAssert(str);
 
-    if (growUs(dest, len) < 0) {
-        return MPR_ERR_NO_MEMORY;
+    if (len < 0) {
+        len = (int) strlen(str);
     }
-
-    va_start(args, src);
-    for (us = src; us; ) {
-        us = va_arg(args, uni*);
-        
-        memcpy(&dest->str[dest->length], src->str, src->length * sizeof(uniData));
-        dest->length += src->length;
+    if ((us = (uni*) mprAlloc(ctx, (len + 1) * (int) sizeof(uni))) == 0) {
+        return 0;
     }
-
-    va_end(args);
-    
-    return 0;
-}
-
-
-
-/*
- *  Duplicate a unicode string by allocating a new unicode string and copying the source data.
- */
-uni *mprDupUs(uni *src)
-{
-    uni   *dest;
-
-    dest = mprAllocUs(src);
-    if (dest == 0) {
+    if (mprUtf8ToUni(us, len + 1, str, len) < 0) {
+        mprFree(us);
         return 0;
     }
-
-    copyUs(dest, src);
-
-    return dest;
-}
-
-
-
-
-/*
- *  Copy a C string into an existing unicode string.
- */
-int mprCopyStrToUs(uni *dest, cchar *str)
-{
-    mprAssert(dest);
-    mprAssert(str);
-
-    return memToUs(dest, (const uchar*) str, strlen(str));
-}
-
-
-
-/*
- *  Return the lenght of a unicoded string.
- */
-int mprGetUsLength(uni *us)
-{
-    mprAssert(us);
-
-    return us->length;
+    return us;
 }
 
 
-
-
-/*
- *  Return the index in a unicode string of a given unicode character code. Return -1 if not found.
- */
-int mprContainsChar(uni *us, int charPat)
+char *mprUniToStr(MprCtx ctx, cuni *us, int count)
 {
-    int     i;
+    char    *str;
+    int     len;
 
     mprAssert(us);
 
-    for (i = 0; i < us->length; i++) {
-        if (us->str[i] == charPat) {
-            return i;
-        }
+    if (count < 0) {
+        count = mprUniLen(us);
     }
-    return -1;
-}
-
-
-
-/*
- *  Return TRUE if a unicode string contains a given unicode string.
- */
-int mprContainsUs(uni *us, uni *pat)
-{
-    int     i, j;
-
-    mprAssert(us);
-    mprAssert(pat);
-    mprAssert(pat->str);
-
-    if (pat == 0 || pat->str == 0) {
+    if ((len = utf8Length(us, count)) < 0) {
         return 0;
     }
-    
-    for (i = 0; i < us->length; i++) {
-        for (j = 0; j < pat->length; j++) {
-            if (us->str[i] != pat->str[j]) {
-                break;
-            }
-        }
-        if (j == pat->length) {
-            return i;
-        }
+    if ((str = (char*) mprAlloc(ctx, len + 1)) == 0) {
+        return 0;
     }
-    return -1;
+    mprUniToUtf8(str, len + 1, us, count);
+    return str;
 }
 
 
-
-/*
- *  Return TRUE if a unicode string contains a given unicode string after doing a case insensitive comparison.
- */
-int mprContainsCaselessUs(uni *us, uni *pat)
+int mprUniLen(cuni *us)
 {
-    int     i, j;
+    cuni        *up;
+#if USE_SSE2
+    uint        mask;
+#endif
 
     mprAssert(us);
-    mprAssert(pat);
-    mprAssert(pat->str);
 
-    for (i = 0; i < us->length; i++) {
-        for (j = 0; j < pat->length; j++) {
-            if (tolower(us->str[i]) != tolower(pat->str[j])) {
-                break;
+    up = us;
+#if USE_SSE2
+    if (((size_t) up & (sizeof(uni) - 1)) == 0) {
+        /*
+         *  Aligned loads never cross a page so may safely read past the null
+         */
+        for (; ((size_t) up & (BLOCK_SIZE - 1)) != 0; up++) {
+            if (*up == 0) {
+                return (int) (up - us);
             }
         }
-        if (j == pat->length) {
-            return i;
+        for (; ; up += BLOCK_SIZE / sizeof(uni)) {
+            mask = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_load_si128((__m128i*) up), _mm_setzero_si128()));
+            if (mask) {
+                return (int) (up - us) + lowestBit(mask) / (int) sizeof(uni);
+            }
         }
     }
-    return -1;
+#endif
+    while (*up) {
+        up++;
+    }
+    return (int) (up - us);
 }
 
 
-
 /*
- *  Return TRUE if a unicode string contains a given C string.
+ *  Find a pattern in a uni string. Candidate positions are filtered by comparing both the first and last units of 
+ *  the pattern, eight positions at a time.
  */
-int mprContainsStr(uni *us, cchar *pat)
+uni *mprUniStr(cuni *us, cuni *pattern)
 {
-    int     i, j, len;
+    int         i, len, plen;
+#if USE_SSE2
+    __m128i     first, last;
+    uint        mask;
+    int         k;
+#endif
 
     mprAssert(us);
-    mprAssert(pat);
+    mprAssert(pattern);
 
-    if (pat == 0 || *pat == '\0') {
-        return 0;
+    if ((plen = mprUniLen(pattern)) == 0) {
+        return (uni*) us;
     }
-    
-    len = strlen(pat);
-    
-    for (i = 0; i < us->length; i++) {
-        for (j = 0; j < len; j++) {
-            if (us->str[i] != pat[j]) {
-                break;
+    len = mprUniLen(us);
+    i = 0;
+#if USE_SSE2
+    first = _mm_set1_epi16(pattern[0]);
+    last = _mm_set1_epi16(pattern[plen - 1]);
+    for (; (i + plen + 7) <= len; i += 8) {
+        mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi16(_mm_loadu_si128((__m128i*) &us[i]), first),
+            _mm_cmpeq_epi16(_mm_loadu_si128((__m128i*) &us[i + plen - 1]), last)));
+        while (mask) {
+            k = lowestBit(mask) / 2;
+            if (plen <= 2 || memcmp(&us[i + k + 1], &pattern[1], (plen - 2) * sizeof(uni)) == 0) {
+                return (uni*) &us[i + k];
             }
-        }
-        if (j == len) {
-            return i;
+            mask &= ~(3 << (k * 2));
         }
     }
-    return -1;
-}
-
-
-
-#if FUTURE
-int mprContainsPattern(uni *us, MprRegex *pat)
-{
-    return 0;
-}
 #endif
-
-
-
-
-uni *mprTrimUs(uni *us, uni *pat)
-{
+    for (; (i + plen) <= len; i++) {
+        if (us[i] == pattern[0] && memcmp(&us[i], pattern, plen * sizeof(uni)) == 0) {
+            return (uni*) &us[i];
+        }
+    }
     return 0;
 }
 
 
-
-int mprTruncateUs(uni *us, int len)
+/*
+ *  Trim units in the set from both ends of a uni string. The string is modified.
+ */
+uni *mprUniTrim(uni *us, cuni *set)
 {
-    mprAssert(us);
-
-    mprAssert(us->length >= len);
+    int     len;
 
-    if (us->length < len) {
-        return MPR_ERR_WONT_FIT;
+    if (us == 0 || set == 0) {
+        return us;
     }
-
-    us->length = len;
-    return 0;
+    while (*us && isInSet(*us, set)) {
+        us++;
+    }
+    len = mprUniLen(us);
+    while (len > 0 && isInSet(us[len - 1], set)) {
+        us[--len] = 0;
+    }
+    return us;
 }
 
 
-
-uni *mprSubUs(uni *src, int start, int len)
+/*
+ *  Thread-safe tokenizing of a uni string. The string is modified as per mprStrTok.
+ */
+uni *mprUniTok(uni *us, cuni *delim, uni **last)
 {
-    uni   *dest;
+    uni     *start, *end;
 
-    mprAssert(src);
-    mprAssert(start >= 0);
-    mprAssert(len > 0);
-    mprAssert((start + len) <= src->length);
+    mprAssert(delim);
+    mprAssert(last);
 
-    if ((start + len) > src->length) {
+    start = us ? us : *last;
+    if (start == 0) {
+        *last = 0;
         return 0;
     }
-
-    dest = mprAllocUs(src);
-    if (dest == 0) {
-        return 0;
+    while (*start && isInSet(*start, delim)) {
+        start++;
     }
-
-    if (growUs(dest, len) < 0) {
-        mprFree(dest);
+    if (*start == 0) {
+        *last = 0;
         return 0;
     }
-    memcpy(dest->str, &src->str[start], len * sizeof(uniData));
-    dest->length = len;
-
-    return dest;
+    for (end = start; *end && !isInSet(*end, delim); end++) ;
+    if (*end) {
+        *end++ = 0;
+        while (*end && isInSet(*end, delim)) {
+            end++;
+        }
+    } else {
+        end = 0;
+    }
+    *last = end;
+    return start;
 }
 
 
-
-
-
-
-
-void mprUsToLower(uni *us)
+/*
+ *  Return the count of leading ASCII bytes
+ */
+static int asciiPrefix(cuchar *str, int len)
 {
     int     i;
+#if !USE_SSE2
+    uint64  word;
+#endif
 
-    mprAssert(us);
-    mprAssert(us->str);
-
-    for (i = 0; i < us->length; i++) {
-        us->str[i] = tolower(us->str[i]);
+    i = 0;
+#if USE_SSE2
+    for (; (len - i) >= BLOCK_SIZE; i += BLOCK_SIZE) {
+        if (_mm_movemask_epi8(_mm_loadu_si128((__m128i*) &str[i]))) {
+            break;
+        }
+    }
+#else
+    for (; (len - i) >= (int) sizeof(word); i += sizeof(word)) {
+        memcpy(&word, &str[i], sizeof(word));
+        if (word & UINT64(0x8080808080808080)) {
+            break;
+        }
     }
+#endif
+    while (i < len && str[i] < 0x80) {
+        i++;
+    }
+    return i;
 }
 
 
-
-void mprUsToUpper(uni *us)
+/*
+ *  Decode one UTF-8 sequence. Return the length of the sequence or zero if it is not valid.
+ */
+static int decodeUtf8(cuchar *str, int len, int *code)
 {
-    int     i;
-
-    mprAssert(us);
-    mprAssert(us->str);
+    int     c;
 
-    for (i = 0; i < us->length; i++) {
-        us->str[i] = toupper(us->str[i]);
-    }
-}
+    c = str[0];
+    if (c < 0x80) {
+        *code = c;
+        return 1;
 
+    } else if (c < 0xC2) {
+        /* Continuation byte or overlong two byte form */
+        return 0;
 
+    } else if (c < 0xE0) {
+        if (len < 2 || !isCont(str[1])) {
+            return 0;
+        }
+        *code = ((c & 0x1F) << 6) | (str[1] & 0x3F);
+        return 2;
 
+    } else if (c < 0xF0) {
+        if (len < 3 || !isCont(str[1]) || !isCont(str[2])) {
+            return 0;
+        }
+        *code = ((c & 0x0F) << 12) | ((str[1] & 0x3F) << 6) | (str[2] & 0x3F);
+        if (*code < 0x800 || isSurrogate(*code)) {
+            return 0;
+        }
+        return 3;
 
-uni *mprTokenizeUs(uni *us, uni *delim, int *last)
-{
+    } else if (c < 0xF5) {
+        if (len < 4 || !isCont(str[1]) || !isCont(str[2]) || !isCont(str[3])) {
+            return 0;
+        }
+        *code = ((c & 0x07) << 18) | ((str[1] & 0x3F) << 12) | ((str[2] & 0x3F) << 6) | (str[3] & 0x3F);
+        if (*code < 0x10000 || *code > MAX_CODE) {
+            return 0;
+        }
+        return 4;
+    }
     return 0;
 }
 
 
-
-
-int mprFormatUs(uni *us, int maxSize, cchar *fmt, ...)
+/*
+ *  Return the UTF-8 length of a uni string or MPR_ERR_BAD_FORMAT if it has an unpaired surrogate
+ */
+static int utf8Length(cuni *us, int count)
 {
-    return 0;
+    int     i, c, len;
+
+    for (i = len = 0; i < count; i++) {
+        c = (ushort) us[i];
+        if (c < 0x80) {
+            len++;
+        } else if (c < 0x800) {
+            len += 2;
+        } else if (isSurrogate(c)) {
+            if (c >= SURROGATE_LOW || (i + 1) >= count || ((ushort) us[i + 1] & 0xFC00) != SURROGATE_LOW) {
+                return MPR_ERR_BAD_FORMAT;
+            }
+            len += 4;
+            i++;
+        } else {
+            len += 3;
+        }
+    }
+    return len;
 }
 
 
-
-int mprScanUs(uni *us, cchar *fmt, ...)
+static int isInSet(int c, cuni *set)
 {
+    for (; *set; set++) {
+        if (*set == c) {
+            return 1;
+        }
+    }
     return 0;
 }
 
 
-
-/******************************************************************************/
-#else
-void __mprDummyUnicode() {}
-#endif
-
 /*
  *  @copy   default
  *  
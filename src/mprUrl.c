@@ -36,53 +36,70 @@ static uchar charMatch[256] = {
 /*
  *  Basic mime type support
  */
-static char *mimeTypes[] = {
-    "ai", "application/postscript",
-    "asc", "text/plain",
-    "au", "audio/basic",
-    "avi", "video/x-msvideo",
-    "bin", "application/octet-stream",
-    "bmp", "image/bmp",
-    "class", "application/octet-stream",
-    "css", "text/css",
-    "dll", "application/octet-stream",
-    "doc", "application/msword",
-    "ejs", "text/html",
-    "eps", "application/postscript",
-    "es", "application/x-javascript",
-    "exe", "application/octet-stream",
-    "gif", "image/gif",
-    "gz", "application/x-gzip",
-    "htm", "text/html",
-    "html", "text/html",
-    "ico", "image/x-icon",
-    "jar", "application/octet-stream",
-    "jpeg", "image/jpeg",
-    "jpg", "image/jpeg",
-    "js", "application/javascript",
-    "mp3", "audio/mpeg",
-    "pdf", "application/pdf",
-    "png", "image/png",
-    "ppt", "application/vnd.ms-powerpoint",
-    "ps", "application/postscript",
-    "ra", "audio/x-realaudio",
-    "ram", "audio/x-pn-realaudio",
-    "rmm", "audio/x-pn-realaudio",
-    "rtf", "text/rtf",
-    "rv", "video/vnd.rn-realvideo",
-    "so", "application/octet-stream",
-    "swf", "application/x-shockwave-flash",
-    "tar", "application/x-tar",
-    "tgz", "application/x-gzip",
-    "tiff", "image/tiff",
-    "txt", "text/plain",
-    "wav", "audio/x-wav",
-    "xls", "application/vnd.ms-excel",
-    "zip", "application/zip",
-    "php", "application/x-appweb-php",
-    "pl", "application/x-appweb-perl",
-    "py", "application/x-appweb-python",
-    NULL, NULL,
+typedef struct MimeType {
+    char    *ext;
+    char    *type;
+} MimeType;
+
+/*
+ *  Perfect hash table generated by makehash from mimeTypes.txt. Do not edit.
+ *  Lookup with mprLookupPerfectHash(mimeTypesSeeds, MIME_TYPES_SIZE, key).
+ */
+#define MIME_TYPES_SIZE 45
+
+static const short mimeTypesSeeds[MIME_TYPES_SIZE] = {
+    2, 1, 1, 1, 1, -5, -7, -10, -13, 0, -14, -17,
+    0, -19, -22, 1, 0, -26, 0, -29, 0, -30, -31, 0,
+    0, 1, -35, -36, 0, 0, 0, -38, -39, 0, 0, 0,
+    0, 2, 0, -40, 2, 0, 0, 1, -43,
+};
+
+static MimeType mimeTypes[] = {
+    { "es", "application/x-javascript" },
+    { "jpg", "image/jpeg" },
+    { "js", "application/javascript" },
+    { "asc", "text/plain" },
+    { "tiff", "image/tiff" },
+    { "txt", "text/plain" },
+    { "rmm", "audio/x-pn-realaudio" },
+    { "au", "audio/basic" },
+    { "exe", "application/octet-stream" },
+    { "css", "text/css" },
+    { "png", "image/png" },
+    { "tgz", "application/x-gzip" },
+    { "ai", "application/postscript" },
+    { "tar", "application/x-tar" },
+    { "pdf", "application/pdf" },
+    { "avi", "video/x-msvideo" },
+    { "py", "application/x-appweb-python" },
+    { "xls", "application/vnd.ms-excel" },
+    { "so", "application/octet-stream" },
+    { "ram", "audio/x-pn-realaudio" },
+    { "rtf", "text/rtf" },
+    { "ps", "application/postscript" },
+    { "ico", "image/x-icon" },
+    { "class", "application/octet-stream" },
+    { "ra", "audio/x-realaudio" },
+    { "mp3", "audio/mpeg" },
+    { "bin", "application/octet-stream" },
+    { "ejs", "text/html" },
+    { "gif", "image/gif" },
+    { "html", "text/html" },
+    { "jpeg", "image/jpeg" },
+    { "eps", "application/postscript" },
+    { "pl", "application/x-appweb-perl" },
+    { "jar", "application/octet-stream" },
+    { "dll", "application/octet-stream" },
+    { "wav", "audio/x-wav" },
+    { "swf", "application/x-shockwave-flash" },
+    { "php", "application/x-appweb-php" },
+    { "bmp", "image/bmp" },
+    { "gz", "application/x-gzip" },
+    { "ppt", "application/vnd.ms-powerpoint" },
+    { "htm", "text/html" },
+    { "rv", "video/vnd.rn-realvideo" },
+    { "doc", "application/msword" },
+    { "zip", "application/zip" },
 };
 
 /*
@@ -213,71 +230,39 @@ MprUri *mprParseUri(MprCtx ctx, cchar *uri)
  */
 char *mprFormatUri(MprCtx ctx, cchar *scheme, cchar *host, int port, cchar *path, cchar *query)
 {
-    char    portBuf[16], *uri;
-    cchar   *portDelim, *pathDelim, *queryDelim;
-    int     defaultPort, len;
-
-    len = 0;
+    MprStrBuilder   sb;
+    int             defaultPort;
 
     if (scheme == 0 || *scheme == '\0') {
         scheme = "http";
     }
-    len += (int) strlen(scheme) + 3;                            /* Add 3 for "://" */
-
     defaultPort = (strcmp(scheme, "http") == 0) ? 80 : 443;
 
     if (host == 0 || *host == '\0') {
         host = "localhost";
     }
+    mprInitStrBuilder(ctx, &sb, -1);
+    mprPutStringToBuilder(&sb, scheme);
+    mprPutStringToBuilder(&sb, "://");
+    mprPutStringToBuilder(&sb, host);
 
     /*
      *  Hosts with integral port specifiers override
      */
-    if (strchr(host, ':')) {
-        portDelim = 0;
-    } else {
-        if (port != defaultPort) {
-            mprItoa(portBuf, sizeof(portBuf), port, 10);
-            portDelim = ":";
-        } else {
-            portBuf[0] = '\0';
-            portDelim = "";
-        }
-        len += (int) strlen(portBuf) + (int) strlen(portDelim);
+    if (strchr(host, ':') == 0 && port != defaultPort) {
+        mprPutCharToBuilder(&sb, ':');
+        mprPutIntToBuilder(&sb, port);
     }
-    len += (int) strlen(host);
-
-    if (path) {
-        pathDelim = (*path == '/') ? "" :  "/";
-    } else {
-        pathDelim = "/";
-        path = "";
+    if (path == 0 || *path != '/') {
+        mprPutCharToBuilder(&sb, '/');
     }
-    len += (int) strlen(path) + (int) strlen(pathDelim);
+    mprPutStringToBuilder(&sb, path);
 
     if (query && *query) {
-        queryDelim = "?";
-    } else {
-        queryDelim = query = "";
-    }
-    len += (int) strlen(query) + (int) strlen(queryDelim);
-    len += 1;                                               /* Add one for the null */
-
-    uri = mprAlloc(ctx, len);
-    if (uri == 0) {
-        return 0;
-    }
-
-    if (portDelim) {
-        uri = mprAsprintf(ctx, len, "%s://%s%s%s%s%s%s%s", scheme, host, portDelim, portBuf, pathDelim, 
-            path, queryDelim, query);
-    } else {
-        uri = mprAsprintf(ctx, len, "%s://%s%s%s%s%s", scheme, host, pathDelim, path, queryDelim, query);
-    }
-    if (uri == 0) {
-        return 0;
+        mprPutCharToBuilder(&sb, '?');
+        mprPutStringToBuilder(&sb, query);
     }
-    return uri;
+    return mprStealBuilder(&sb);
 }
 
 
@@ -599,27 +584,19 @@ char *mprValidateUrl(MprCtx ctx, char *url)
 
 cchar *mprLookupMimeType(MprCtx ctx, cchar *ext)
 {
-    Mpr     *mpr;
-    char    **cp;
-    cchar   *ep, *mtype;
+    MimeType    *mt;
+    cchar       *ep;
 
     mprAssert(ext);
 
-    mpr = mprGetMpr(ctx);
-    if (mpr->mimeTypes == 0) {
-        mpr->mimeTypes = mprCreateHash(mpr, 67);
-        for (cp = mimeTypes; cp[0]; cp += 2) {
-            mprAddHash(mpr->mimeTypes, cp[0], cp[1]);
-        }
-    }
     if ((ep = strrchr(ext, '.')) != 0) {
         ext = &ep[1];
     }
-    mtype = (cchar*) mprLookupHash(mpr->mimeTypes, ext);
-    if (mtype == 0) {
+    mt = &mimeTypes[mprLookupPerfectHash(mimeTypesSeeds, MIME_TYPES_SIZE, ext)];
+    if (strcmp(mt->ext, ext) != 0) {
         return "application/octet-stream";
     }
-    return mtype;
+    return mt->type;
 }
 
 
@@ -32,7 +32,7 @@ MprWaitService *mprCreateWaitService(Mpr *mpr)
     ws->flags = 0;
     ws->maskGeneration = 0;
     ws->lastMaskGeneration = -1;
-    ws->handlers = mprCreateList(ws);
+    mprInitLinkList(&ws->handlers);
 
 #if BLD_WIN_LIKE && !WINCE
     ws->socketMessage = MPR_SOCKET_MESSAGE;
@@ -57,7 +57,7 @@ MprWaitHandler *mprCreateWaitHandler(MprCtx ctx, int fd, int mask, MprWaitProc p
 
     ws = mprGetMpr(ctx)->waitService;
 
-    if (mprGetListCount(ws->handlers) == FD_SETSIZE) {
+    if (mprGetLinkCount(&ws->handlers) == FD_SETSIZE) {
         mprError(ws, "io: Too many io handlers: %d\n", FD_SETSIZE);
         return 0;
     }
@@ -87,11 +87,7 @@ MprWaitHandler *mprCreateWaitHandler(MprCtx ctx, int fd, int mask, MprWaitProc p
 #endif
 
     mprLock(ws->mutex);
-    if (mprAddItem(ws->handlers, wp) < 0) {
-        mprUnlock(ws->mutex);
-        mprFree(wp);
-        return 0;
-    }
+    mprAppendLink(&ws->handlers, &wp->link);
     mprUnlock(ws->mutex);
     mprUpdateWaitHandler(wp, 1);
     return wp;
@@ -121,7 +117,10 @@ void mprDisconnectWaitHandler(MprWaitHandler *wp)
      *  Lock the service to stabilize the list, then lock the handler to prevent callbacks. 
      */
     mprLock(ws->mutex);
-    mprRemoveItem(ws->handlers, wp);
+    if (wp->link.next) {
+        mprRemoveLink(&ws->handlers, &wp->link);
+        ws->removals++;
+    }
 
 #if BLD_FEATURE_MULTITHREAD
     /*
@@ -254,7 +253,7 @@ void mprInvokeWaitCallback(MprWaitHandler *wp)
         mprActivateWorker(wp->requiredWorker, (MprWorkerProc) waitCallback, (void*) wp, MPR_REQUEST_PRIORITY);
         return;
     } else {
-        if (mprStartWorker(wp, (MprWorkerProc) waitCallback, (void*) wp, MPR_REQUEST_PRIORITY) == 0) {
+        if (mprTryStartWorker(wp, (MprWorkerProc) waitCallback, (void*) wp, MPR_REQUEST_PRIORITY) == 0) {
             return;
         }
     }
@@ -10,21 +10,45 @@
 
 /********************************** Locals ************************************/
 
+#define CORPUS_SIZE     (1024 * 1024)   /* Size of the text for the unicode benchmarks */
+#define MAX_HASH_BLOCKS 2048            /* Cap on 64K blocks for the parallel benchmarks (128MB) */
+
 static int      iterations = 1;         /* Benchmark iterations */
 static int      workers = 0;            /* Number of worker threads */
 
 static MprCond  *complete;              /* Condition set when benchmark complete */
 static int      markCount;              /* Flag set when benchmark complete */
 
+/*
+ *  Typical response header block for the string benchmarks
+ */
+static char     response[] = 
+    "HTTP/1.1 200 OK\r\n"
+    "Date: Tue, 01 Mar 2011 10:12:21 GMT\r\n"
+    "Server: Embedthis-Appweb/3.2.3\r\n"
+    "Last-Modified: Mon, 28 Feb 2011 18:03:44 GMT\r\n"
+    "ETag: \"2c3d9-76-4d6be3a0\"\r\n"
+    "Cache-Control: max-age=3600, must-revalidate\r\n"
+    "Content-Type: text/html; charset=utf-8\r\n"
+    "Content-Length: 118\r\n"
+    "Keep-Alive: timeout=60, max=199\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+
 #if BLD_FEATURE_MULTITHREAD
 static MprMutex *mutex;                 /* Test synchronization */
 #endif
 
 /***************************** Forward Declarations ***************************/
 
+static int      compareItems(cvoid *arg1, cvoid *arg2);
 static void     doBenchmark(Mpr *mpr, void *thread);
 static void     endMark(MprCtx ctx, MprTime start, int count, char *msg);
+static void     endThroughput(MprCtx ctx, MprTime start, int count, int64 bytes, char *msg);
 static void     eventCallback(void *data, MprEvent *ep);
+static int      fillCorpus(char *buf, int size, cchar *text);
+static void     fillList(MprList *list, int count);
+static void     hashBlocks(void *data, int start, int end);
 static MprTime  startMark(MprCtx ctx);
 static void     timerCallback(void *data, MprEvent *ep);
 
@@ -124,8 +148,11 @@ static void doBenchmark(Mpr *mpr, void *thread)
     MprEvent    *event;
     MprTime     start;
     MprList     *list;
+    MprFormat   *format;
     void        *mp;
-    int         count, i;
+    char        buf[64], text[256], *cp, *tok, *corpus;
+    uni         *us;
+    int         count, i, len, units;
 #if BLD_FEATURE_MULTITHREAD
     MprMutex    *lock;
 #endif
@@ -175,6 +202,23 @@ static void doBenchmark(Mpr *mpr, void *thread)
         mprWaitForCond(complete, -1);
     }
     endMark(mpr, start, count, "Cond signal|wait");
+
+    /*
+     *  Parallel loops. Hash 64K blocks serially and over the worker pool.
+     */
+    mprPrintf(mpr, "Parallel Benchmarks\n");
+    count = (int) min((int64) 256 * iterations, MAX_HASH_BLOCKS);
+    if ((mp = mprAllocZeroed(mpr, count * 65536)) == 0) {
+        mprPrintf(mpr, "\tCan't allocate %d 64K blocks, skipping\n", count);
+    } else {
+        start = startMark(mpr);
+        hashBlocks(mp, 0, count);
+        endMark(mpr, start, count, "Hash 64K (serial)");
+        start = startMark(mpr);
+        mprParallelFor(mpr, 0, count, 4, hashBlocks, mp);
+        endMark(mpr, start, count, "Hash 64K (mprParallelFor)");
+        mprFree(mp);
+    }
 #endif
 
     /*
@@ -191,6 +235,176 @@ static void doBenchmark(Mpr *mpr, void *thread)
     endMark(mpr, start, count, "Link insert|remove");
     mprFree(list);;
 
+    count = 1000000 * iterations;
+    list = mprCreateList(mpr);
+    mprSetListLimits(list, count, MAXINT);
+    fillList(list, count);
+    start = startMark(mpr);
+    mprSortList(list, compareItems);
+    endMark(mpr, start, count, "Sort (serial)");
+    mprClearList(list);
+    fillList(list, count);
+    start = startMark(mpr);
+    mprParallelSortList(list, compareItems);
+    endMark(mpr, start, count, "Sort (mprParallelSortList)");
+    mprFree(list);
+
+    /*
+     *  Printf. Format integers over a range of magnitudes.
+     */
+    mprPrintf(mpr, "Printf Benchmarks\n");
+    count = 2000000 * iterations;
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprSprintf(buf, sizeof(buf), "%d", i * 7919);
+    }
+    endMark(mpr, start, count, "Printf %d");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprSprintf(buf, sizeof(buf), "%Ld", (int64) i * INT64(2654435761));
+    }
+    endMark(mpr, start, count, "Printf %Ld");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprSprintf(buf, sizeof(buf), "%x", (uint) i * 2654435761U);
+    }
+    endMark(mpr, start, count, "Printf %x");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprSprintf(buf, sizeof(buf), "Content-Length: %d\r\n", i);
+    }
+    endMark(mpr, start, count, "Printf header");
+    format = mprCompileFormat(mpr, "Content-Length: %d\r\n");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprSprintfFormat(buf, sizeof(buf), format, i);
+    }
+    endMark(mpr, start, count, "Printf header (compiled)");
+    mprFree(format);
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprSprintf(buf, sizeof(buf), "%s %s HTTP/1.1\r\nHost: %s:%d\r\n", "GET", "/index.html", "example.com", 80);
+    }
+    endMark(mpr, start, count, "Printf request");
+    format = mprCompileFormat(mpr, "%s %s HTTP/1.1\r\nHost: %s:%d\r\n");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprSprintfFormat(buf, sizeof(buf), format, "GET", "/index.html", "example.com", 80);
+    }
+    endMark(mpr, start, count, "Printf request (compiled)");
+    mprFree(format);
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprItoa(buf, sizeof(buf), (int64) i * INT64(2654435761), 10);
+    }
+    endMark(mpr, start, count, "Itoa");
+#if BLD_FEATURE_FLOATING_POINT
+    count = 1000000 * iterations;
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprFree(mprDtoa(mpr, i * 0.0137, 0, MPR_DTOA_ALL_DIGITS, 0));
+    }
+    endMark(mpr, start, count, "Dtoa (shortest)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprFree(mprDtoa(mpr, i * 1.7e-3 + 1e9, 6, MPR_DTOA_N_DIGITS, 0));
+    }
+    endMark(mpr, start, count, "Dtoa (6 digits)");
+#endif
+
+    /*
+     *  Strings. Header sized comparisons, searches and tokenizing.
+     */
+    mprPrintf(mpr, "String Benchmarks\n");
+    count = 2000000 * iterations;
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprStrcmpAnyCase("Content-Type", (i & 1) ? "content-type" : "CONTENT-TYPE");
+    }
+    endMark(mpr, start, count, "StrcmpAnyCase (12 chars)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprStrcmpAnyCase("/usr/local/lib/appweb/modules/mod_ejs.so", 
+            (i & 1) ? "/USR/local/lib/appweb/modules/mod_ejs.so" : "/usr/local/lib/appweb/modules/MOD_EJS.so");
+    }
+    endMark(mpr, start, count, "StrcmpAnyCase (40 chars)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprStrnstr(response, "\r\n\r\n", (int) sizeof(response));
+    }
+    endMark(mpr, start, count, "Strnstr (header end)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        strcpy(text, response);
+        for (cp = mprStrTok(text, "\r\n", &tok); cp; cp = mprStrTok(0, "\r\n", &tok)) ;
+    }
+    endMark(mpr, start, count, "StrTok (header lines)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        strcpy(text, response);
+        mprStrLower(text);
+    }
+    endMark(mpr, start, count, "StrLower (header)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprFree(mprStrcat(mpr, -1, "/usr/local", "/lib", "/appweb", "/modules", "/mod_ejs.so", NULL));
+    }
+    endMark(mpr, start, count, "Strcat (5 strings)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprFree(mprFormatUri(mpr, "http", "example.com", 8080, "/index.html", "a=b&c=d"));
+    }
+    endMark(mpr, start, count, "FormatUri");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprFree(mprJoinPath(mpr, "/usr/local/lib", "appweb/modules"));
+    }
+    endMark(mpr, start, count, "JoinPath");
+
+    /*
+     *  Unicode. Throughput over a 1MB corpus of ASCII text and of text mixing one to four byte sequences.
+     */
+    mprPrintf(mpr, "Unicode Benchmarks\n");
+    count = 100 * iterations;
+    corpus = (char*) mprAlloc(mpr, CORPUS_SIZE + 1);
+    us = (uni*) mprAlloc(mpr, (CORPUS_SIZE + 1) * (int) sizeof(uni));
+    len = fillCorpus(corpus, CORPUS_SIZE, "The quick brown fox jumps over the lazy dog. ");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprIsUtf8(corpus, len);
+    }
+    endThroughput(mpr, start, count, len, "IsUtf8 (ASCII)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        units = mprUtf8ToUni(us, CORPUS_SIZE + 1, corpus, len);
+    }
+    endThroughput(mpr, start, count, len, "Utf8ToUni (ASCII)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprUniToUtf8(corpus, CORPUS_SIZE + 1, us, units);
+    }
+    endThroughput(mpr, start, count, len, "UniToUtf8 (ASCII)");
+
+    len = fillCorpus(corpus, CORPUS_SIZE, 
+        "Gr\xC3\xB6\xC3\x9F" "e na\xC3\xAFve caf\xC3\xA9 \xE2\x80\x94 \xE6\x9D\xB1\xE4\xBA\xAC \xF0\x9F\x98\x80 and plain words. ");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprIsUtf8(corpus, len);
+    }
+    endThroughput(mpr, start, count, len, "IsUtf8 (mixed)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        units = mprUtf8ToUni(us, CORPUS_SIZE + 1, corpus, len);
+    }
+    endThroughput(mpr, start, count, len, "Utf8ToUni (mixed)");
+    start = startMark(mpr);
+    for (i = 0; i < count; i++) {
+        mprUniToUtf8(corpus, CORPUS_SIZE + 1, us, units);
+    }
+    endThroughput(mpr, start, count, len, "UniToUtf8 (mixed)");
+    mprFree(us);
+    mprFree(corpus);
+
     /*
      *  Events
      */
@@ -226,6 +440,60 @@ static void doBenchmark(Mpr *mpr, void *thread)
 }
 
 
+/*
+ *  Parallel loop callback. Hash a range of 64K blocks.
+ */
+static void hashBlocks(void *data, int start, int end)
+{
+    char    *buf;
+    int     i;
+
+    buf = (char*) data;
+    for (i = start; i < end; i++) {
+        mprFree(mprGetMD5Hash(buf, &buf[i * 65536], 65536, NULL));
+    }
+}
+
+
+/*
+ *  Fill a buffer with whole copies of text. Return the length used.
+ */
+static int fillCorpus(char *buf, int size, cchar *text)
+{
+    int     len, used;
+
+    len = (int) strlen(text);
+    for (used = 0; (used + len) <= size; used += len) {
+        memcpy(&buf[used], text, len);
+    }
+    buf[used] = '\0';
+    return used;
+}
+
+
+/*
+ *  Fill a list with scrambled integers for sorting
+ */
+static void fillList(MprList *list, int count)
+{
+    int     i;
+
+    for (i = 0; i < count; i++) {
+        mprAddItem(list, LTOP((i * 2654435761U) & 0x7fffffff));
+    }
+}
+
+
+static int compareItems(cvoid *arg1, cvoid *arg2)
+{
+    long    a, b;
+
+    a = (long) PTOL(*(void**) arg1);
+    b = (long) PTOL(*(void**) arg2);
+    return (a < b) ? -1 : ((a > b) ? 1 : 0);
+}
+
+
 /*
  *  Event callback 
  */
@@ -272,6 +540,22 @@ static void endMark(MprCtx ctx, MprTime start, int count, char *msg)
         msg, elapsed * 1000.0 / count, elapsed / 1000.0);
 }
 
+
+/*
+ *  As for endMark but also report the throughput in GB/sec for benchmarks over a block of data
+ */
+static void endThroughput(MprCtx ctx, MprTime start, int count, int64 bytes, char *msg)
+{
+    MprTime     elapsed;
+
+    elapsed = mprGetElapsedTime(ctx, start);
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    mprPrintf(ctx, "\t%-30s\t%13.2f\t%12.2f\t%8.2f GB/sec\n", 
+        msg, elapsed * 1000.0 / count, elapsed / 1000.0, (double) bytes * count / (elapsed * 1000000.0));
+}
+
 /*
  *  @copy   default
  *  
@@ -81,7 +81,7 @@ static void testFlushBuf(MprTestGroup *gp)
     for (i = 0; i < 100; i++) {
         rc = mprPutStringToBuf(bp, "Hello World");
         assert(rc == 11);
-        assert(mprGetBufLength(bp) == 11);
+    assert(mprGetBufLength(bp) == 11);
 
         mprFlushBuf(bp);
         assert(mprGetBufLength(bp) == 0);
@@ -251,6 +251,305 @@ static void testBufLoad(MprTestGroup *gp)
 }
 
 
+static void testRingBuf(MprTestGroup *gp)
+{
+    MprBuf      *bp;
+    MprIOVec    iovec[2];
+    char        ibuf[256], obuf[256], *origin;
+    int         i, j, rc, count, next, total;
+
+    for (i = 0; i < (int) sizeof(ibuf); i++) {
+        ibuf[i] = 'A' + (i % 26);
+    }
+
+    /*
+     *  A fixed size ring holds one less than its size and never moves its data
+     */
+    bp = mprCreateBuf(gp, 64, 64);
+    assert(mprSetBufRing(bp, 1) == 0);
+    origin = mprGetBufOrigin(bp);
+    assert(mprPutBlockToBuf(bp, ibuf, 100) == 63);
+    assert(mprGetBufLength(bp) == 63);
+    assert(mprGetBlockFromBuf(bp, obuf, 100) == 63);
+    assert(memcmp(obuf, ibuf, 63) == 0);
+
+    for (next = j = 0; j < 200; j++) {
+        count = (j % 40) + 1;
+        rc = mprPutBlockToBuf(bp, &ibuf[next % 26], count);
+        assert(rc == count);
+        assert(mprGetBufLength(bp) == count);
+        assert(mprLookAtNextCharInBuf(bp) == ibuf[next % 26]);
+        assert(mprLookAtLastCharInBuf(bp) == ibuf[(next % 26) + count - 1]);
+
+        total = 0;
+        for (i = mprGetBufVector(bp, iovec) - 1; i >= 0; i--) {
+            total += (int) iovec[i].len;
+        }
+        assert(total == count);
+
+        rc = mprGetBlockFromBuf(bp, obuf, count);
+        assert(rc == count);
+        assert(memcmp(obuf, &ibuf[next % 26], count) == 0);
+        assert(mprGetBufOrigin(bp) == origin);
+        next += count;
+    }
+
+    /*
+     *  Wrap the data and check the two segment vector
+     */
+    mprFlushBuf(bp);
+    mprPutBlockToBuf(bp, ibuf, 50);
+    mprAdjustBufStart(bp, 40);
+    mprPutBlockToBuf(bp, &ibuf[50], 30);
+    assert(mprGetBufLength(bp) == 40);
+    assert(mprGetBufVector(bp, iovec) == 2);
+    assert(iovec[0].len == 24 && iovec[1].len == 16);
+    assert(memcmp(iovec[0].start, &ibuf[40], 24) == 0);
+    assert(memcmp(iovec[1].start, &ibuf[64], 16) == 0);
+    assert(mprGetCharFromBuf(bp) == ibuf[40]);
+    assert(mprInsertCharToBuf(bp, ibuf[40]) == 0);
+
+    /*
+     *  Fill free space via the space vector
+     */
+    mprFlushBuf(bp);
+    mprPutBlockToBuf(bp, ibuf, 60);
+    mprAdjustBufStart(bp, 50);
+    count = mprGetBufSpaceVector(bp, iovec);
+    assert(count == 2);
+    for (total = i = 0; i < count; i++) {
+        memcpy(iovec[i].start, &ibuf[60 + total], iovec[i].len);
+        total += (int) iovec[i].len;
+    }
+    assert(total == 53);
+    mprAdjustBufEnd(bp, total);
+    assert(mprGetBufLength(bp) == 63);
+    assert(mprGetBlockFromBuf(bp, obuf, sizeof(obuf)) == 63);
+    assert(memcmp(obuf, &ibuf[50], 63) == 0);
+    mprFree(bp);
+
+    /*
+     *  Growing a wrapped ring keeps the data in order. Leaving ring mode makes it contiguous.
+     */
+    bp = mprCreateBuf(gp, 64, -1);
+    mprSetBufRing(bp, 1);
+    mprPutBlockToBuf(bp, ibuf, 50);
+    mprAdjustBufStart(bp, 40);
+    mprPutBlockToBuf(bp, &ibuf[50], 200);
+    assert(mprGetBufLength(bp) == 210);
+    mprSetBufRing(bp, 0);
+    assert(memcmp(mprGetBufStart(bp), &ibuf[40], 210) == 0);
+
+    mprFlushBuf(bp);
+    mprPutBlockToBuf(bp, ibuf, 10);
+    mprSetBufRing(bp, 1);
+    mprAdjustBufStart(bp, 5);
+    mprPutBlockToBuf(bp, &ibuf[10], mprGetBufSize(bp) - 6);
+    mprSetBufRing(bp, 0);
+    assert(mprGetBufStart(bp) == mprGetBufOrigin(bp));
+    assert(mprGetBufLength(bp) == mprGetBufSize(bp) - 1);
+    assert(memcmp(mprGetBufStart(bp), &ibuf[5], mprGetBufLength(bp)) == 0);
+    mprFree(bp);
+}
+
+
+static void testBufPool(MprTestGroup *gp)
+{
+    MprBufPoolStats before, after;
+    MprBuf          *bp;
+    char            ibuf[256], *str;
+    int             i;
+
+    /*
+     *  Pooled sizes are rounded up to a power of two. Small buffers are not pooled.
+     */
+    bp = mprCreateBuf(gp, 3000, -1);
+    assert(mprGetBufSize(bp) == 4096);
+    mprFree(bp);
+    bp = mprCreateBuf(gp, 100, -1);
+    assert(mprGetBufSize(bp) == 100);
+    mprFree(bp);
+
+    /*
+     *  Storage released by one buffer is reused by the next. Other test threads may use the pool concurrently.
+     */
+    mprGetBufPoolStats(gp, &before);
+    for (i = 0; i < 10; i++) {
+        bp = mprCreateBuf(gp, MPR_BUF_POOL_MIN, -1);
+        mprFree(bp);
+    }
+    mprGetBufPoolStats(gp, &after);
+    assert(after.hits >= before.hits + 9);
+    assert(after.releases >= before.releases + 10);
+    assert(after.retained >= 0);
+
+    /*
+     *  Growing keeps the data and moves through the size classes
+     */
+    for (i = 0; i < (int) sizeof(ibuf); i++) {
+        ibuf[i] = 'A' + (i % 26);
+    }
+    bp = mprCreateBuf(gp, MPR_BUF_POOL_MIN, -1);
+    for (i = 0; i < 100; i++) {
+        assert(mprPutBlockToBuf(bp, ibuf, sizeof(ibuf)) == sizeof(ibuf));
+    }
+    assert(mprGetBufLength(bp) == 100 * (int) sizeof(ibuf));
+    assert((mprGetBufSize(bp) & (mprGetBufSize(bp) - 1)) == 0);
+    for (i = 0; i < 100; i++) {
+        assert(memcmp(&mprGetBufStart(bp)[i * sizeof(ibuf)], ibuf, sizeof(ibuf)) == 0);
+    }
+    mprFree(bp);
+
+    /*
+     *  Stolen storage no longer belongs to the pool
+     */
+    bp = mprCreateBuf(gp, MPR_BUF_POOL_MIN, -1);
+    mprPutStringToBuf(bp, "stolen");
+    mprAddNullToBuf(bp);
+    str = mprStealBuf(gp, bp);
+    mprFree(bp);
+    assert(strcmp(str, "stolen") == 0);
+    mprFree(str);
+}
+
+
+static void testPutFmtToBuf(MprTestGroup *gp)
+{
+    MprBuf      *bp;
+    char        *str;
+    int         i, rc, count;
+
+    /*
+     *  Format into a small buffer so the output must grow the buffer in place
+     */
+    bp = mprCreateBuf(gp, 16, -1);
+    assert(bp != 0);
+    rc = mprPutFmtToBuf(bp, "%s-%d-%x", "abc", 1234, 255);
+    assert(rc == 11);
+    assert(strcmp(mprGetBufStart(bp), "abc-1234-ff") == 0);
+
+    count = rc;
+    for (i = 0; i < 500; i++) {
+        count += mprPutFmtToBuf(bp, "Header-%d: %s\r\n", i, "value");
+    }
+    assert(mprGetBufLength(bp) == count);
+    str = mprGetBufStart(bp);
+    assert(strncmp(str, "abc-1234-ffHeader-0: value\r\nHeader-1: value\r\n", 45) == 0);
+    assert(strstr(str, "Header-499: value\r\n") != 0);
+    assert(str[count] == '\0');
+
+    assert(mprPutFmtToBuf(bp, "") == 0);
+    assert(mprGetBufLength(bp) == count);
+    mprFree(bp);
+
+    /*
+     *  Output is truncated at the buffer maximum
+     */
+    bp = mprCreateBuf(gp, 8, 16);
+    rc = mprPutFmtToBuf(bp, "%s", "0123456789abcdefghijkl");
+    assert(rc > 0 && rc < 16);
+    assert(mprGetBufLength(bp) == rc);
+    assert(strncmp(mprGetBufStart(bp), "0123456789abcdefghijkl", rc) == 0);
+    mprFree(bp);
+
+    /*
+     *  Rings are formatted via a temporary string
+     */
+    bp = mprCreateBuf(gp, 16, 16);
+    mprSetBufRing(bp, 1);
+    mprPutStringToBuf(bp, "0123456789");
+    mprAdjustBufStart(bp, 8);
+    rc = mprPutFmtToBuf(bp, "%d", 123456789);
+    assert(rc == 9);
+    assert(mprGetBufLength(bp) == 11);
+    mprFree(bp);
+}
+
+
+static void testBufChain(MprTestGroup *gp)
+{
+    MprBufChain     *chain;
+    MprIOVec        iovec[8];
+    char            ibuf[1000], obuf[1000], *str, *end;
+    int             i, j, rc, count, total, space;
+
+    for (i = 0; i < (int) sizeof(ibuf); i++) {
+        ibuf[i] = 'A' + (i % 26);
+    }
+
+    /*
+     *  Small odd sized segments so blocks straddle segment boundaries
+     */
+    chain = mprCreateBufChain(gp, 97, -1);
+    assert(chain != 0);
+    assert(mprGetBufChainLength(chain) == 0);
+    assert(mprGetBufChainVector(chain, iovec, 8) == 0);
+
+    for (j = 0; j < 100; j++) {
+        rc = mprPutBlockToBufChain(chain, ibuf, sizeof(ibuf));
+        assert(rc == sizeof(ibuf));
+        assert(mprGetBufChainLength(chain) == sizeof(ibuf));
+
+        assert(mprPeekBufChain(chain, obuf, 10) == 10);
+        assert(memcmp(obuf, ibuf, 10) == 0);
+        assert(mprGetBufChainLength(chain) == sizeof(ibuf));
+
+        for (count = 0; mprGetBufChainLength(chain) > 0; count += rc) {
+            rc = mprGetBlockFromBufChain(chain, &obuf[count], (j % 50) + 1);
+            assert(rc > 0);
+        }
+        assert(count == sizeof(ibuf));
+        assert(memcmp(obuf, ibuf, sizeof(ibuf)) == 0);
+    }
+
+    /*
+     *  Export as a vector and consume part way through a segment
+     */
+    mprPutBlockToBufChain(chain, ibuf, 300);
+    count = mprGetBufChainVector(chain, iovec, 8);
+    assert(count == 4);
+    for (total = i = 0; i < count; i++) {
+        assert(memcmp(iovec[i].start, &ibuf[total], iovec[i].len) == 0);
+        total += (int) iovec[i].len;
+    }
+    assert(total == 300);
+    mprAdjustBufChainStart(chain, 150);
+    count = mprGetBufChainVector(chain, iovec, 8);
+    assert(iovec[0].start[0] == ibuf[150]);
+    assert(mprGetBufChainLength(chain) == 150);
+
+    str = mprGetBufChainString(gp, chain);
+    assert((int) strlen(str) == 150);
+    assert(memcmp(str, &ibuf[150], 150) == 0);
+    mprFree(str);
+
+    mprFlushBufChain(chain);
+    assert(mprGetBufChainLength(chain) == 0);
+
+    /*
+     *  Read directly into reserved space
+     */
+    space = mprReserveBufChain(chain, &end);
+    assert(space > 0 && space <= 97);
+    memcpy(end, "Hello", 5);
+    mprAdjustBufChainEnd(chain, 5);
+    mprPutStringToBufChain(chain, " World");
+    str = mprGetBufChainString(gp, chain);
+    assert(strcmp(str, "Hello World") == 0);
+    mprFree(str);
+    mprFree(chain);
+
+    /*
+     *  Limited chains accept only up to the maximum
+     */
+    chain = mprCreateBufChain(gp, 64, 100);
+    assert(mprPutBlockToBufChain(chain, ibuf, sizeof(ibuf)) == 100);
+    assert(mprGetBufChainLength(chain) == 100);
+    assert(mprReserveBufChain(chain, &end) < 0);
+    mprFree(chain);
+}
+
+
 MprTestDef testBuf = {
     "buf", 0, 0, 0,
     {
@@ -261,6 +560,10 @@ MprTestDef testBuf = {
         MPR_TEST(0, testGrowBuf),
         MPR_TEST(0, testMiscBuf),
         MPR_TEST(0, testBufLoad),
+        MPR_TEST(0, testRingBuf),
+        MPR_TEST(0, testBufPool),
+        MPR_TEST(0, testPutFmtToBuf),
+        MPR_TEST(0, testBufChain),
         MPR_TEST(0, 0),
     },
 };
@@ -0,0 +1,268 @@
+/**
+ *  testFiber.c - Unit tests for fibers
+ *
+ *  Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mprTest.h"
+
+#if BLD_FEATURE_FIBERS
+/*********************************** Locals ***********************************/
+
+typedef struct FiberTest {
+    MprCond     *cond;
+    int         fds[2];
+    int         count;
+    int         order[8];
+    int         events;
+    int         rc;
+} FiberTest;
+
+/************************************ Code ************************************/
+
+static void yieldProc(void *data)
+{
+    FiberTest   *ft;
+    int         i;
+
+    ft = (FiberTest*) data;
+    for (i = 0; i < 3; i++) {
+        ft->order[ft->count++] = (mprGetCurrentFiber(ft->cond) != 0);
+        mprYieldFiber(ft->cond);
+    }
+}
+
+
+static void testYield(MprTestGroup *gp)
+{
+    MprFiberService     *fs;
+    FiberTest           ft;
+    int                 rc;
+
+    memset(&ft, 0, sizeof(ft));
+    ft.cond = mprCreateCond(gp);
+    fs = mprCreateFiberService(gp);
+    assert(fs != 0);
+
+    assert(mprCreateFiber(fs, yieldProc, &ft, 0) != 0);
+    assert(mprCreateFiber(fs, yieldProc, &ft, 0) != 0);
+    assert(mprGetCurrentFiber(gp) == 0);
+
+    rc = mprRunFibers(fs, MPR_TEST_TIMEOUT);
+    assert(rc == 0);
+    assert(ft.count == 6);
+    assert(ft.order[0] && ft.order[5]);
+    assert(mprGetCurrentFiber(gp) == 0);
+    mprFree(fs);
+    mprFree(ft.cond);
+}
+
+
+static void readerProc(void *data)
+{
+    FiberTest   *ft;
+
+    ft = (FiberTest*) data;
+    ft->events = mprWaitForSingleIO(ft->cond, ft->fds[0], MPR_READABLE, MPR_TEST_TIMEOUT);
+}
+
+
+static void writerProc(void *data)
+{
+    FiberTest   *ft;
+
+    ft = (FiberTest*) data;
+    mprYieldFiber(ft->cond);
+    ft->rc = (int) write(ft->fds[1], "x", 1);
+}
+
+
+static void testWaitForIO(MprTestGroup *gp)
+{
+    MprFiberService     *fs;
+    FiberTest           ft;
+    int                 rc;
+
+    memset(&ft, 0, sizeof(ft));
+    ft.cond = mprCreateCond(gp);
+    rc = pipe(ft.fds);
+    assert(rc == 0);
+    fs = mprCreateFiberService(gp);
+
+    /*
+     *  The reader suspends on the pipe while the writer runs on the same thread
+     */
+    mprCreateFiber(fs, readerProc, &ft, 0);
+    mprCreateFiber(fs, writerProc, &ft, 0);
+    rc = mprRunFibers(fs, MPR_TEST_TIMEOUT);
+    assert(rc == 0);
+    assert(ft.rc == 1);
+    assert(ft.events == MPR_READABLE);
+
+    mprFree(fs);
+    mprFree(ft.cond);
+    close(ft.fds[0]);
+    close(ft.fds[1]);
+}
+
+
+static void waiterProc(void *data)
+{
+    FiberTest   *ft;
+
+    ft = (FiberTest*) data;
+    ft->rc = mprWaitForCondWithService(ft->cond, MPR_TEST_TIMEOUT);
+    ft->count++;
+}
+
+
+static void timeoutProc(void *data)
+{
+    FiberTest   *ft;
+
+    ft = (FiberTest*) data;
+    ft->rc = mprWaitForCondWithService(ft->cond, 20);
+    ft->count++;
+}
+
+
+static void signalCallback(void *data, MprEvent *event)
+{
+    mprSignalCond((MprCond*) data);
+}
+
+
+static void testWaitForCond(MprTestGroup *gp)
+{
+    MprFiberService     *fs;
+    MprEvent            *event;
+    FiberTest           ft;
+    int                 rc;
+
+    memset(&ft, 0, sizeof(ft));
+    ft.cond = mprCreateCond(gp);
+    fs = mprCreateFiberService(gp);
+
+    /*
+     *  Signalled by an event. The event may be run by this thread or by the service thread.
+     */
+    mprCreateFiber(fs, waiterProc, &ft, 0);
+    event = mprCreateEvent(mprGetDispatcher(gp), signalCallback, 10, 0, ft.cond, 0);
+    rc = mprRunFibers(fs, MPR_TEST_TIMEOUT);
+    assert(rc == 0);
+    assert(ft.count == 1);
+    assert(ft.rc == 0);
+    mprFree(event);
+
+    /*
+     *  Timeout
+     */
+    ft.rc = 0;
+    mprCreateFiber(fs, timeoutProc, &ft, 0);
+    rc = mprRunFibers(fs, MPR_TEST_TIMEOUT);
+    assert(rc == 0);
+    assert(ft.count == 2);
+    assert(ft.rc == MPR_ERR_TIMEOUT);
+
+    mprFree(fs);
+    mprFree(ft.cond);
+}
+
+
+static void sleeperProc(void *data)
+{
+    FiberTest   *ft;
+
+    ft = (FiberTest*) data;
+    mprSleepFiber(mprGetCurrentFiber(ft->cond), 50);
+    ft->order[ft->count++] = 1;
+}
+
+
+static void counterProc(void *data)
+{
+    FiberTest   *ft;
+
+    ft = (FiberTest*) data;
+    ft->order[ft->count++] = 2;
+}
+
+
+static void testSleep(MprTestGroup *gp)
+{
+    MprFiberService     *fs;
+    FiberTest           ft;
+    int                 rc;
+
+    memset(&ft, 0, sizeof(ft));
+    ft.cond = mprCreateCond(gp);
+    fs = mprCreateFiberService(gp);
+
+    /*
+     *  A sleeping fiber must not stop other fibers on the thread from running
+     */
+    mprCreateFiber(fs, sleeperProc, &ft, 0);
+    mprCreateFiber(fs, counterProc, &ft, 0);
+    rc = mprRunFibers(fs, MPR_TEST_TIMEOUT);
+    assert(rc == 0);
+    assert(ft.count == 2);
+    assert(ft.order[0] == 2);
+    assert(ft.order[1] == 1);
+
+    mprFree(fs);
+    mprFree(ft.cond);
+}
+
+
+MprTestDef testFiber = {
+    "fiber", 0, 0, 0,
+    {
+        MPR_TEST(0, testYield),
+        MPR_TEST(0, testWaitForIO),
+        MPR_TEST(0, testWaitForCond),
+        MPR_TEST(0, testSleep),
+        MPR_TEST(0, 0),
+    },
+};
+
+#else
+void dummyTestFiber() {}
+#endif /* BLD_FEATURE_FIBERS */
+
+/*
+ *  @copy   default
+ *  
+ *  Copyright (c) Embedthis Software LLC, 2003-2011. All Rights Reserved.
+ *  Copyright (c) Michael O'Brien, 1993-2011. All Rights Reserved.
+ *  
+ *  This software is distributed under commercial and open source licenses.
+ *  You may use the GPL open source license described below or you may acquire 
+ *  a commercial license from Embedthis Software. You agree to be fully bound 
+ *  by the terms of either license. Consult the LICENSE.TXT distributed with 
+ *  this software for full details.
+ *  
+ *  This software is open source; you can redistribute it and/or modify it 
+ *  under the terms of the GNU General Public License as published by the 
+ *  Free Software Foundation; either version 2 of the License, or (at your 
+ *  option) any later version. See the GNU General Public License for more 
+ *  details at: http://www.embedthis.com/downloads/gplLicense.html
+ *  
+ *  This program is distributed WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
+ *  
+ *  This GPL license does NOT permit incorporating this software into 
+ *  proprietary programs. If you are unable to comply with the GPL, you must
+ *  acquire a commercial license to use this software. Commercial licenses 
+ *  for this software and support services are available from Embedthis 
+ *  Software at http://www.embedthis.com 
+ *  
+ *  Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
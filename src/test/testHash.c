@@ -181,6 +181,392 @@ static void testIterateHash(MprTestGroup *gp)
 }
 
 
+/*
+ *  Grow the table while walking it and check the walk still returns each original entry exactly once
+ */
+static void testResizeHash(MprTestGroup *gp)
+{
+    MprHashTable    *table;
+    MprHash         *sp;
+    char            name[80];
+    int             count, i, initialSize, check[HASH_COUNT];
+
+    table = mprCreateHash(gp, 0);
+    initialSize = table->hashSize;
+    memset(check, 0, sizeof(check));
+
+    for (i = 0; i < HASH_COUNT; i++) {
+        mprSprintf(name, sizeof(name), "name.%d", i);
+        sp = mprAddHash(table, name, (void*) (size_t) (i + 1));
+        assert(sp != 0);
+    }
+    assert(table->hashSize > initialSize);
+    assert(table->count * 100 <= table->hashSize * MPR_HASH_MAX_LOAD);
+
+    /*
+     *  Half way through the walk, add enough entries to force the table to grow twice
+     */
+    count = 0;
+    for (sp = mprGetFirstHash(table); sp; sp = mprGetNextHash(table, sp)) {
+        i = (int) (size_t) sp->data;
+        if (i <= HASH_COUNT) {
+            check[i - 1]++;
+        }
+        if (++count == HASH_COUNT / 2) {
+            initialSize = table->hashSize;
+            for (i = 0; i < HASH_COUNT * 4; i++) {
+                mprSprintf(name, sizeof(name), "extra.%d", i);
+                mprAddHash(table, name, (void*) (size_t) (HASH_COUNT + i + 1));
+            }
+            assert(table->hashSize > initialSize);
+        }
+    }
+    for (i = 0; i < HASH_COUNT; i++) {
+        assert(check[i] == 1);
+    }
+    assert(mprGetHashCount(table) == HASH_COUNT * 5);
+
+    for (i = 0; i < HASH_COUNT * 4; i++) {
+        mprSprintf(name, sizeof(name), "extra.%d", i);
+        assert(mprRemoveHash(table, name) == 0);
+    }
+    for (i = 10; i < HASH_COUNT; i++) {
+        mprSprintf(name, sizeof(name), "name.%d", i);
+        assert(mprRemoveHash(table, name) == 0);
+    }
+    assert(mprGetHashCount(table) == 10);
+    assert(table->hashSize == table->minSize);
+    for (i = 0; i < 10; i++) {
+        mprSprintf(name, sizeof(name), "name.%d", i);
+        assert(mprLookupHash(table, name) == (void*) (size_t) (i + 1));
+    }
+    mprFree(table);
+}
+
+
+static void testSeedAndCaseless(MprTestGroup *gp)
+{
+    MprHashTable    *table;
+    MprHash         *sp;
+    char            name[80];
+    int             i;
+
+    /*
+     *  Every byte of short keys must contribute to the hash with the default zero seed
+     */
+    table = mprCreateHash(gp, 0);
+    assert(mprHashKey(table, "a") != mprHashKey(table, "b"));
+    assert(mprHashKey(table, "ab") != mprHashKey(table, "ba"));
+    assert(mprHashKey(table, "ab") != mprHashKey(table, "ac"));
+    assert(mprHashKey(table, "12345678") != mprHashKey(table, "12345679"));
+    assert(mprHashKey(table, "x") != mprHashKey(table, "y"));
+
+    for (i = 0; i < 100; i++) {
+        mprSprintf(name, sizeof(name), "Content-Header-Number-%d", i);
+        mprAddHash(table, name, (void*) (size_t) (i + 1));
+    }
+
+    /*
+     *  Changing the seed rehashes existing entries
+     */
+    sp = mprLookupHashEntry(table, "Content-Header-Number-7");
+    assert(sp != 0);
+    i = sp->hash;
+    mprSetHashSeed(table, 0x12345678);
+    assert(sp->hash != (uint) i);
+    assert(mprLookupHash(table, "Content-Header-Number-7") == (void*) 8);
+    assert(mprLookupHash(table, "content-header-number-7") == 0);
+
+    /*
+     *  Caseless lookup must fold case in both the short tail and the whole words of the key
+     */
+    mprSetHashCaseless(table);
+    assert(mprGetHashCount(table) == 100);
+    assert(mprLookupHash(table, "content-header-number-7") == (void*) 8);
+    assert(mprLookupHash(table, "CONTENT-HEADER-NUMBER-99") == (void*) 100);
+    assert(mprLookupHash(table, "Content-Header-Number-100") == 0);
+
+    mprFree(table);
+}
+
+
+/*
+ *  Flat tables must behave like chained tables, including through heavy add/remove churn that leaves tombstones
+ */
+static void testFlatHash(MprTestGroup *gp)
+{
+    MprHashTable    *table, *copy;
+    MprHash         *sp;
+    char            name[80];
+    int             count, i, round, check[HASH_COUNT];
+
+    table = mprCreateFlatHash(gp, 0);
+    assert(table != 0);
+    assert(mprGetHashCount(table) == 0);
+    assert(mprGetFirstHash(table) == 0);
+    assert(mprLookupHash(table, "") == 0);
+
+    for (round = 0; round < 4; round++) {
+        for (i = 0; i < HASH_COUNT; i++) {
+            mprSprintf(name, sizeof(name), "name.%d.%d", round, i);
+            sp = mprAddHash(table, name, (void*) (size_t) (i + 1));
+            assert(sp != 0);
+            assert(strcmp(sp->key, name) == 0);
+        }
+        assert(mprGetHashCount(table) == HASH_COUNT);
+        for (i = 0; i < HASH_COUNT; i++) {
+            mprSprintf(name, sizeof(name), "name.%d.%d", round, i);
+            assert(mprLookupHash(table, name) == (void*) (size_t) (i + 1));
+        }
+        mprSprintf(name, sizeof(name), "name.%d.%d", round + 1, 0);
+        assert(mprLookupHash(table, name) == 0);
+
+        /*
+         *  Update in place
+         */
+        mprSprintf(name, sizeof(name), "name.%d.%d", round, 7);
+        mprAddHash(table, name, (void*) 1);
+        assert(mprLookupHash(table, name) == (void*) 1);
+        mprAddHash(table, name, (void*) 8);
+        assert(mprGetHashCount(table) == HASH_COUNT);
+
+        /*
+         *  Walk and remove each entry as it is visited
+         */
+        memset(check, 0, sizeof(check));
+        count = 0;
+        for (sp = mprGetFirstHash(table); sp; sp = mprGetNextHash(table, sp)) {
+            i = (int) (size_t) sp->data;
+            check[i - 1]++;
+            assert(mprRemoveHash(table, sp->key) == 0);
+            count++;
+        }
+        assert(count == HASH_COUNT);
+        for (i = 0; i < HASH_COUNT; i++) {
+            assert(check[i] == 1);
+        }
+        assert(mprGetHashCount(table) == 0);
+        assert(mprRemoveHash(table, "name.0.0") == MPR_ERR_NOT_FOUND);
+    }
+
+    /*
+     *  Duplicates, case and copy
+     */
+    mprAddHash(table, "Content-Type", "text/html");
+    mprAddDuplicateHash(table, "Set-Cookie", "a=1");
+    mprAddDuplicateHash(table, "Set-Cookie", "b=2");
+    assert(mprGetHashCount(table) == 3);
+    mprSetHashCaseless(table);
+    assert(strcmp(mprLookupHash(table, "content-type"), "text/html") == 0);
+    assert(mprLookupHash(table, "SET-COOKIE") != 0);
+
+    copy = mprCopyHash(gp, table);
+    assert(copy != 0);
+    assert(copy->flags & MPR_HASH_FLAT);
+    assert(mprGetHashCount(copy) == 2);
+    assert(strcmp(mprLookupHash(copy, "CONTENT-TYPE"), "text/html") == 0);
+
+    mprFree(copy);
+    mprFree(table);
+}
+
+
+static void testBorrowedAndInternedKeys(MprTestGroup *gp)
+{
+    MprHashTable    *table, *other;
+    MprHash         *sp;
+    char            key[80];
+    cchar           *interned;
+
+    /*
+     *  Borrowed keys are stored by reference
+     */
+    table = mprCreateFlatHash(gp, 0);
+    mprSetHashBorrowedKeys(table);
+    mprStrcpy(key, sizeof(key), "Content-Length");
+    sp = mprAddHash(table, key, "42");
+    assert(sp != 0);
+    assert(sp->key == key);
+    assert(strcmp(mprLookupHash(table, "Content-Length"), "42") == 0);
+    mprFree(table);
+
+    table = mprCreateHash(gp, 0);
+    mprSetHashBorrowedKeys(table);
+    sp = mprAddHash(table, key, "42");
+    assert(sp->key == key);
+    assert(mprRemoveHash(table, key) == 0);
+    mprFree(table);
+
+    /*
+     *  Interned strings compare by pointer and are shared across tables
+     */
+    interned = mprIntern(gp, "Content-Length");
+    assert(interned != 0);
+    assert(interned != key);
+    assert(mprIntern(gp, key) == interned);
+    assert(strcmp(interned, key) == 0);
+
+    table = mprCreateHash(gp, 0);
+    other = mprCreateFlatHash(gp, 0);
+    mprSetHashInternedKeys(table);
+    mprSetHashInternedKeys(other);
+    assert(mprAddHash(table, key, "1")->key == interned);
+    assert(mprAddHash(other, key, "2")->key == interned);
+    assert(strcmp(mprLookupHash(table, interned), "1") == 0);
+    assert(strcmp(mprLookupHash(other, "Content-Length"), "2") == 0);
+    mprFree(table);
+    mprFree(other);
+}
+
+
+static void casProc(void *data, int start, int end)
+{
+    MprConcurrentHash   *ch;
+    cvoid               *value;
+    char                key[32];
+    int                 i;
+
+    ch = (MprConcurrentHash*) data;
+    for (i = start; i < end; i++) {
+        mprSprintf(key, sizeof(key), "counter.%d", i % 8);
+        do {
+            value = mprLookupConcurrentHash(ch, key);
+        } while (!mprCasConcurrentHash(ch, key, value, (cvoid*) ((size_t) value + 1)));
+    }
+}
+
+
+static bool sumProc(void *data, cchar *key, cvoid *value)
+{
+    *(int*) data += (int) (size_t) value;
+    return key[strlen(key) - 1] & 0x1;
+}
+
+
+static void testConcurrentHash(MprTestGroup *gp)
+{
+    MprConcurrentHash   *ch;
+    int                 total;
+
+    ch = mprCreateConcurrentHash(gp, 0, MPR_HASH_CASELESS);
+    assert(ch != 0);
+
+    assert(mprAddConcurrentHash(ch, "Session", "abc") == 0);
+    assert(strcmp(mprLookupConcurrentHash(ch, "SESSION"), "abc") == 0);
+    assert(!mprCasConcurrentHash(ch, "session", "xyz", "def"));
+    assert(!mprCasConcurrentHash(ch, "session", 0, "def"));
+    assert(mprCasConcurrentHash(ch, "session", mprLookupConcurrentHash(ch, "session"), "def"));
+    assert(strcmp(mprLookupConcurrentHash(ch, "Session"), "def") == 0);
+    assert(mprRemoveConcurrentHash(ch, "session") == 0);
+    assert(mprRemoveConcurrentHash(ch, "session") == MPR_ERR_NOT_FOUND);
+    assert(mprGetConcurrentHashCount(ch) == 0);
+
+    /*
+     *  Increment shared counters from many threads using compare and swap. No increment may be lost.
+     */
+    assert(mprParallelFor(gp, 0, 4000, 50, casProc, ch) == 0);
+    assert(mprGetConcurrentHashCount(ch) == 8);
+
+    total = 0;
+    mprWalkConcurrentHash(ch, sumProc, &total);
+    assert(total == 4000);
+    assert(mprGetConcurrentHashCount(ch) == 4);
+    assert(mprLookupConcurrentHash(ch, "counter.1") == 0);
+    assert(mprLookupConcurrentHash(ch, "counter.2") == (cvoid*) 500);
+
+    mprFree(ch);
+}
+
+
+static void testOrderedHash(MprTestGroup *gp)
+{
+    MprHashTable    *table, *copy;
+    MprHash         *sp;
+    char            name[80];
+    int             flat, i, next;
+
+    for (flat = 0; flat < 2; flat++) {
+        table = (flat) ? mprCreateFlatHash(gp, 0) : mprCreateHash(gp, 0);
+        mprSetHashOrdered(table);
+
+        /*
+         *  Enough entries to force several resizes
+         */
+        for (i = 0; i < HASH_COUNT; i++) {
+            mprSprintf(name, sizeof(name), "name.%d", i);
+            mprAddHash(table, name, (void*) (size_t) i);
+        }
+        mprAddHash(table, "name.0", (void*) 0);
+
+        /*
+         *  Remove every third entry, including while walking
+         */
+        for (i = 0; i < HASH_COUNT; i += 3) {
+            mprSprintf(name, sizeof(name), "name.%d", i);
+            assert(mprRemoveHash(table, name) == 0);
+        }
+        if (flat) {
+            for (sp = mprGetFirstHash(table); sp; sp = mprGetNextHash(table, sp)) {
+                if (((int) (size_t) sp->data % 3) == 1) {
+                    mprRemoveHash(table, sp->key);
+                }
+            }
+        } else {
+            for (i = 1; i < HASH_COUNT; i += 3) {
+                mprSprintf(name, sizeof(name), "name.%d", i);
+                assert(mprRemoveHash(table, name) == 0);
+            }
+        }
+        copy = mprCopyHash(gp, table);
+
+        next = 2;
+        for (sp = mprGetFirstHash(table); sp; sp = mprGetNextHash(table, sp)) {
+            assert((int) (size_t) sp->data == next);
+            next += 3;
+        }
+        assert(next > HASH_COUNT);
+
+        next = 2;
+        for (sp = mprGetFirstHash(copy); sp; sp = mprGetNextHash(copy, sp)) {
+            assert((int) (size_t) sp->data == next);
+            next += 3;
+        }
+        assert(next > HASH_COUNT);
+        mprFree(copy);
+        mprFree(table);
+    }
+}
+
+
+/*
+ *  Static lookup tables generated by makehash
+ */
+static void testPerfectHash(MprTestGroup *gp)
+{
+    static const short  seeds[] = { -1 };
+
+    /*
+     *  Short keys must hash by content with the default seed
+     */
+    assert(mprHashString("a", 0) != mprHashString("b", 0));
+    assert(mprHashString("a", 0) != mprHashString("a", 1));
+    assert(mprLookupPerfectHash(seeds, 1, "anything") == 0);
+
+    assert(strcmp(mprLookupMimeType(gp, "html"), "text/html") == 0);
+    assert(strcmp(mprLookupMimeType(gp, "index.jpg"), "image/jpeg") == 0);
+    assert(strcmp(mprLookupMimeType(gp, "zip"), "application/zip") == 0);
+    assert(strcmp(mprLookupMimeType(gp, "unknown"), "application/octet-stream") == 0);
+    assert(strcmp(mprLookupMimeType(gp, ""), "application/octet-stream") == 0);
+
+#if BLD_FEATURE_HTTP
+    assert(strcmp(mprGetHttpCodeString(gp, 200), "OK") == 0);
+    assert(strcmp(mprGetHttpCodeString(gp, 404), "Not Found") == 0);
+    assert(strcmp(mprGetHttpCodeString(gp, 551), "General Client Error") == 0);
+    assert(strcmp(mprGetHttpCodeString(gp, 999), "Custom error") == 0);
+#endif
+}
+
+
 MprTestDef testHash = {
     "symbol", 0, 0, 0,
     {
@@ -189,6 +575,13 @@ MprTestDef testHash = {
         MPR_TEST(0, testInsertAndRemoveHash),
         MPR_TEST(0, testHashScale),
         MPR_TEST(0, testIterateHash),
+        MPR_TEST(0, testResizeHash),
+        MPR_TEST(0, testSeedAndCaseless),
+        MPR_TEST(0, testFlatHash),
+        MPR_TEST(0, testBorrowedAndInternedKeys),
+        MPR_TEST(0, testConcurrentHash),
+        MPR_TEST(0, testOrderedHash),
+        MPR_TEST(0, testPerfectHash),
         MPR_TEST(0, 0),
     },
 };
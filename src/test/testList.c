@@ -154,6 +154,198 @@ static void testOrderedInserts(MprTestGroup *gp)
 }
 
 
+typedef struct LinkItem {
+    int         value;
+    MprLink     link;
+} LinkItem;
+
+
+static void testLinkList(MprTestGroup *gp)
+{
+    MprLinkList     list;
+    MprLink         *lp, *next;
+    LinkItem        items[LIST_MAX_ITEMS];
+    int             i;
+
+    mprInitLinkList(&list);
+    assert(mprGetLinkCount(&list) == 0);
+    assert(mprGetFirstLink(&list) == 0);
+    assert(mprGetLastLink(&list) == 0);
+
+    memset(items, 0, sizeof(items));
+    for (i = 0; i < LIST_MAX_ITEMS; i++) {
+        items[i].value = i;
+        if (i & 1) {
+            mprAppendLink(&list, &items[i].link);
+        } else {
+            mprPrependLink(&list, &items[i].link);
+        }
+        assert(mprIsLinked(&items[i].link));
+    }
+    assert(mprGetLinkCount(&list) == LIST_MAX_ITEMS);
+    assert(mprGetLinkItem(mprGetFirstLink(&list), LinkItem, link)->value == LIST_MAX_ITEMS - 2);
+    assert(mprGetLinkItem(mprGetLastLink(&list), LinkItem, link)->value == LIST_MAX_ITEMS - 1);
+
+    /*
+     *  Remove the even items while walking. Removing an unlinked item is a no-op.
+     */
+    for (lp = mprGetFirstLink(&list); lp; lp = next) {
+        next = mprGetNextLink(&list, lp);
+        if ((mprGetLinkItem(lp, LinkItem, link)->value & 1) == 0) {
+            mprRemoveLink(&list, lp);
+        }
+    }
+    mprRemoveLink(&list, &items[0].link);
+    assert(!mprIsLinked(&items[0].link));
+    assert(mprGetLinkCount(&list) == LIST_MAX_ITEMS / 2);
+
+    /*
+     *  The odd items remain in ascending order
+     */
+    for (i = 1, lp = mprGetFirstLink(&list); lp; lp = mprGetNextLink(&list, lp), i += 2) {
+        assert(mprGetLinkItem(lp, LinkItem, link)->value == i);
+    }
+    for (i -= 2, lp = mprGetLastLink(&list); lp; lp = mprGetPrevLink(&list, lp), i -= 2) {
+        assert(mprGetLinkItem(lp, LinkItem, link)->value == i);
+    }
+    assert(i == -1);
+}
+
+
+typedef struct SortItem {
+    int         key;
+    int         seq;
+} SortItem;
+
+
+static int compareSortItems(cvoid *arg1, cvoid *arg2)
+{
+    SortItem    *a, *b;
+
+    a = *(SortItem**) arg1;
+    b = *(SortItem**) arg2;
+    return (a->key < b->key) ? -1 : ((a->key > b->key) ? 1 : 0);
+}
+
+
+/*
+ *  Fill a list with items in sequence order. Keys are scattered over the given number of distinct values.
+ */
+static SortItem *fillSortList(MprList *lp, int count, int keys)
+{
+    SortItem    *items;
+    int         i;
+
+    items = (SortItem*) mprAlloc(lp, count * sizeof(SortItem));
+    for (i = 0; i < count; i++) {
+        items[i].key = (int) ((i * 2654435761U) % keys);
+        items[i].seq = i;
+        mprAddItem(lp, &items[i]);
+    }
+    return items;
+}
+
+
+/*
+ *  Return false if the list is out of order or equal keys have been reordered
+ */
+static int isStablySorted(MprList *lp, int count)
+{
+    SortItem    *prev, *item;
+    int         i;
+
+    if (mprGetListCount(lp) != count) {
+        return 0;
+    }
+    prev = (SortItem*) mprGetItem(lp, 0);
+    for (i = 1; i < count; i++) {
+        item = (SortItem*) mprGetItem(lp, i);
+        if (item->key < prev->key || (item->key == prev->key && item->seq < prev->seq)) {
+            return 0;
+        }
+        prev = item;
+    }
+    return 1;
+}
+
+
+static void testSortList(MprTestGroup *gp)
+{
+    MprList     *lp;
+    char        *words[] = { "pear", "apple", "fig", "banana", "apple", "cherry", 0 };
+    int         i, sizes[] = { 0, 1, 15, 16, 17, 100, LIST_MAX_ITEMS, 12345 };
+
+    for (i = 0; i < (int) (sizeof(sizes) / sizeof(int)); i++) {
+        lp = mprCreateList(gp);
+        fillSortList(lp, sizes[i], 37);
+        assert(mprSortList(lp, compareSortItems) == 0);
+        assert(sizes[i] == 0 || isStablySorted(lp, sizes[i]));
+
+        /*
+         *  Sorting a sorted list must not move anything
+         */
+        assert(mprSortList(lp, compareSortItems) == 0);
+        assert(sizes[i] == 0 || isStablySorted(lp, sizes[i]));
+        mprFree(lp);
+    }
+
+    /*
+     *  A null compare function sorts strings
+     */
+    lp = mprCreateList(gp);
+    for (i = 0; words[i]; i++) {
+        mprAddItem(lp, words[i]);
+    }
+    assert(mprSortList(lp, 0) == 0);
+    assert(strcmp((char*) mprGetItem(lp, 0), "apple") == 0);
+    assert(strcmp((char*) mprGetItem(lp, 1), "apple") == 0);
+    assert(strcmp((char*) mprGetItem(lp, 2), "banana") == 0);
+    assert(strcmp((char*) mprGetItem(lp, 5), "pear") == 0);
+    mprFree(lp);
+}
+
+
+static void testParallelSortList(MprTestGroup *gp)
+{
+    MprList     *lp;
+    int         i, count, numCpu, sizes[] = { 100, MPR_SORT_PARALLEL_MIN, MPR_SORT_PARALLEL_MIN * 3 + 7 };
+
+    /*
+     *  Claim several CPUs so the parallel merge is exercised on single CPU systems too
+     */
+    numCpu = max(mprGetCpuCount(gp), 6);
+
+    for (i = 0; i < (int) (sizeof(sizes) / sizeof(int)); i++) {
+        count = sizes[i];
+        lp = mprCreateList(gp);
+        mprSetListLimits(lp, count, MAXINT);
+        fillSortList(lp, count, 1000);
+        assert(mprSortListInParallel(lp, compareSortItems, MPR_SORT_PARALLEL_MIN, numCpu) == 0);
+        assert(isStablySorted(lp, count));
+        mprFree(lp);
+    }
+
+    /*
+     *  Few distinct keys puts long runs of equal items across the merge slice boundaries
+     */
+    count = MPR_SORT_PARALLEL_MIN * 2;
+    lp = mprCreateList(gp);
+    fillSortList(lp, count, 3);
+    assert(mprSortListInParallel(lp, compareSortItems, MPR_SORT_PARALLEL_MIN, numCpu) == 0);
+    assert(isStablySorted(lp, count));
+    mprFree(lp);
+
+    /*
+     *  The public entry point sorts with the real CPU count
+     */
+    lp = mprCreateList(gp);
+    fillSortList(lp, count, 1000);
+    assert(mprParallelSortList(lp, compareSortItems) == 0);
+    assert(isStablySorted(lp, count));
+    mprFree(lp);
+}
+
+
 MprTestDef testList = {
     "list", 0, 0, 0,
     {
@@ -163,6 +355,9 @@ MprTestDef testList = {
         MPR_TEST(0, testLotsOfInserts),
         MPR_TEST(0, testListIterate),
         MPR_TEST(0, testOrderedInserts),
+        MPR_TEST(0, testLinkList),
+        MPR_TEST(0, testSortList),
+        MPR_TEST(0, testParallelSortList),
         MPR_TEST(0, 0),
     },
 };
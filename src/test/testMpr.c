@@ -13,6 +13,9 @@
 extern MprTestDef testAlloc;
 extern MprTestDef testBuf;
 extern MprTestDef testEvent;
+#if BLD_FEATURE_FIBERS
+extern MprTestDef testFiber;
+#endif
 #if BLD_FEATURE_CMD
 extern MprTestDef testCmd;
 #endif
@@ -23,9 +26,11 @@ extern MprTestDef testHttp;
 #endif
 extern MprTestDef testList;
 extern MprTestDef testPath;
+extern MprTestDef testQueue;
 extern MprTestDef testSocket;
 extern MprTestDef testSprintf;
 extern MprTestDef testTime;
+extern MprTestDef testUnicode;
 #if BLD_FEATURE_MULTITHREAD
 extern MprTestDef testCond;
 extern MprTestDef testLock;
@@ -43,6 +48,9 @@ static MprTestDef *testGroups[] =
     &testCmd,
 #endif
     &testEvent,
+#if BLD_FEATURE_FIBERS
+    &testFiber,
+#endif
     &testFile,
     &testPath,
     &testHash,
@@ -50,6 +58,7 @@ static MprTestDef *testGroups[] =
     &testHttp,
 #endif
     &testList,
+    &testQueue,
 #if BLD_FEATURE_MULTITHREAD
     &testLock,
     &testWorker,
@@ -57,6 +66,7 @@ static MprTestDef *testGroups[] =
     &testSocket,
     &testSprintf,
     &testTime,
+    &testUnicode,
     0
 };
  
@@ -0,0 +1,242 @@
+/**
+ *  testQueue.c - Unit tests for the lock-free queues
+ *
+ *  Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mprTest.h"
+
+/*********************************** Locals ***********************************/
+
+#define QUEUE_COUNT     20000           /* Count of items to pass through the queues */
+
+typedef struct QueueItem {
+    int             value;
+    MprQueueLink    link;
+} QueueItem;
+
+typedef struct QueueTest {
+    MprQueue        *q;
+    QueueItem       *items;
+    volatile int    sum;
+    volatile int    received;
+    volatile int    done;
+} QueueTest;
+
+/************************************ Code ************************************/
+
+static void testBoundedQueue(MprTestGroup *gp)
+{
+    MprQueue    *q;
+    int         i, lap;
+
+    assert(mprCreateQueue(gp, MAXINT) == 0);
+
+    q = mprCreateQueue(gp, 5);
+    assert(q != 0);
+    assert(mprGetQueueCount(q) == 0);
+    assert(mprDequeue(q) == 0);
+
+    /*
+     *  Size is rounded up to 8. Go round the ring several times to exercise wrapping.
+     */
+    for (lap = 0; lap < 10; lap++) {
+        for (i = 1; i <= 8; i++) {
+            assert(mprEnqueue(q, (void*) (size_t) (lap * 8 + i)) == 0);
+        }
+        assert(mprEnqueue(q, (void*) 1) == MPR_ERR_WONT_FIT);
+        assert(mprGetQueueCount(q) == 8);
+        for (i = 1; i <= 8; i++) {
+            assert(mprDequeue(q) == (void*) (size_t) (lap * 8 + i));
+        }
+        assert(mprDequeue(q) == 0);
+    }
+    mprFree(q);
+}
+
+
+static void testUnboundedQueue(MprTestGroup *gp)
+{
+    MprQueue        *q;
+    MprQueueLink    *link;
+    QueueItem       items[100];
+    int             i;
+
+    q = mprCreateQueue(gp, 0);
+    assert(q != 0);
+    assert(mprDequeueLink(q) == 0);
+
+    for (i = 0; i < 100; i++) {
+        items[i].value = i;
+        mprEnqueueLink(q, &items[i].link);
+    }
+    for (i = 0; i < 100; i++) {
+        link = mprDequeueLink(q);
+        assert(link != 0);
+        assert(mprGetLinkItem(link, QueueItem, link)->value == i);
+        if (i == 50) {
+            /*
+             *  Refill after partially draining
+             */
+            mprEnqueueLink(q, &items[0].link);
+        }
+    }
+    link = mprDequeueLink(q);
+    assert(link == &items[0].link);
+    assert(mprDequeueLink(q) == 0);
+    mprFree(q);
+}
+
+
+#if BLD_FEATURE_MULTITHREAD
+/*
+ *  Each index is enqueued once. When the queue is full or after each enqueue, dequeue and total an item.
+ */
+static void boundedProc(void *data, int start, int end)
+{
+    QueueTest   *qt;
+    void        *item;
+    int         i;
+
+    qt = (QueueTest*) data;
+    for (i = start + 1; i <= end; i++) {
+        while (mprEnqueue(qt->q, (void*) (size_t) i) < 0) {
+            if ((item = mprDequeue(qt->q)) != 0) {
+                mprAtomicAdd(&qt->sum, (int) (size_t) item);
+            }
+        }
+        if ((item = mprDequeue(qt->q)) != 0) {
+            mprAtomicAdd(&qt->sum, (int) (size_t) item);
+        }
+    }
+}
+
+
+static void testBoundedQueueThreads(MprTestGroup *gp)
+{
+    QueueTest   qt;
+    void        *item;
+
+    memset(&qt, 0, sizeof(qt));
+    qt.q = mprCreateQueue(gp, 64);
+    assert(qt.q != 0);
+
+    assert(mprParallelFor(gp, 0, QUEUE_COUNT, 100, boundedProc, &qt) == 0);
+    while ((item = mprDequeue(qt.q)) != 0) {
+        qt.sum += (int) (size_t) item;
+    }
+    assert(qt.sum == QUEUE_COUNT * (QUEUE_COUNT + 1) / 2);
+    mprFree(qt.q);
+}
+
+
+static void produceProc(void *data, int start, int end)
+{
+    QueueTest   *qt;
+    int         i;
+
+    qt = (QueueTest*) data;
+    for (i = start; i < end; i++) {
+        mprEnqueueLink(qt->q, &qt->items[i].link);
+    }
+}
+
+
+static void consumeProc(QueueTest *qt, MprThread *tp)
+{
+    MprQueueLink    *link;
+
+    while (qt->received < QUEUE_COUNT) {
+        if ((link = mprDequeueLink(qt->q)) != 0) {
+            qt->sum += mprGetLinkItem(link, QueueItem, link)->value;
+            qt->received++;
+        } else {
+            mprSleep(tp, 1);
+        }
+    }
+    mprAtomicBarrier();
+    qt->done = 1;
+}
+
+
+static void testUnboundedQueueThreads(MprTestGroup *gp)
+{
+    QueueTest   qt;
+    MprThread   *tp;
+    int         i, timeout;
+
+    memset(&qt, 0, sizeof(qt));
+    qt.q = mprCreateQueue(gp, 0);
+    qt.items = (QueueItem*) mprAllocZeroed(gp, QUEUE_COUNT * (int) sizeof(QueueItem));
+    assert(qt.q != 0 && qt.items != 0);
+    for (i = 0; i < QUEUE_COUNT; i++) {
+        qt.items[i].value = i + 1;
+    }
+    tp = mprCreateThread(gp, "consumer", (MprThreadProc) consumeProc, &qt, MPR_NORMAL_PRIORITY, 0);
+    assert(tp != 0);
+    assert(mprStartThread(tp) == 0);
+
+    assert(mprParallelFor(gp, 0, QUEUE_COUNT, 100, produceProc, &qt) == 0);
+    for (timeout = MPR_TEST_TIMEOUT; !qt.done && timeout > 0; timeout -= 10) {
+        mprSleep(gp, 10);
+    }
+    assert(qt.done);
+    mprAtomicBarrier();
+    assert(qt.received == QUEUE_COUNT);
+    assert(qt.sum == QUEUE_COUNT * (QUEUE_COUNT + 1) / 2);
+    mprFree(qt.items);
+    mprFree(qt.q);
+}
+#endif
+
+
+MprTestDef testQueue = {
+    "queue", 0, 0, 0,
+    {
+        MPR_TEST(0, testBoundedQueue),
+        MPR_TEST(0, testUnboundedQueue),
+#if BLD_FEATURE_MULTITHREAD
+        MPR_TEST(0, testBoundedQueueThreads),
+        MPR_TEST(0, testUnboundedQueueThreads),
+#endif
+        MPR_TEST(0, 0),
+    },
+};
+
+/*
+ *  @copy   default
+ *  
+ *  Copyright (c) Embedthis Software LLC, 2003-2011. All Rights Reserved.
+ *  Copyright (c) Michael O'Brien, 1993-2011. All Rights Reserved.
+ *  
+ *  This software is distributed under commercial and open source licenses.
+ *  You may use the GPL open source license described below or you may acquire 
+ *  a commercial license from Embedthis Software. You agree to be fully bound 
+ *  by the terms of either license. Consult the LICENSE.TXT distributed with 
+ *  this software for full details.
+ *  
+ *  This software is open source; you can redistribute it and/or modify it 
+ *  under the terms of the GNU General Public License as published by the 
+ *  Free Software Foundation; either version 2 of the License, or (at your 
+ *  option) any later version. See the GNU General Public License for more 
+ *  details at: http://www.embedthis.com/downloads/gplLicense.html
+ *  
+ *  This program is distributed WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
+ *  
+ *  This GPL license does NOT permit incorporating this software into 
+ *  proprietary programs. If you are unable to comply with the GPL, you must
+ *  acquire a commercial license to use this software. Commercial licenses 
+ *  for this software and support services are available from Embedthis 
+ *  Software at http://www.embedthis.com 
+ *  
+ *  Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
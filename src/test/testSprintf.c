@@ -57,6 +57,268 @@ static void testItoa(MprTestGroup *gp)
 
     mprItoa(buf, sizeof(buf), 0x1234, 16);
     assert(strcmp(buf, "1234") == 0);
+
+    mprItoa(buf, sizeof(buf), 0xABCDEF, 16);
+    assert(strcmp(buf, "ABCDEF") == 0);
+
+    mprItoa(buf, sizeof(buf), INT64(9223372036854775807), 10);
+    assert(strcmp(buf, "9223372036854775807") == 0);
+
+    mprItoa(buf, sizeof(buf), -INT64(9223372036854775807) - 1, 10);
+    assert(strcmp(buf, "-9223372036854775808") == 0);
+
+    /*
+     *  Truncate to fit the buffer
+     */
+    mprItoa(buf, 4, 12345678, 10);
+    assert(strcmp(buf, "123") == 0);
+}
+
+
+/*
+ *  Compare the integer conversions with the system printf over a range of magnitudes
+ */
+static void testIntegerFormats(MprTestGroup *gp)
+{
+    char        buf[256], expected[256];
+    uint64      value;
+    int64       svalue;
+    int         i, j;
+
+    value = 1;
+    for (i = 0; i < 64; i++) {
+        for (j = -1; j <= 1; j++) {
+            svalue = (int64) (value + j);
+
+            mprSprintf(buf, sizeof(buf), "%Ld", svalue);
+            sprintf(expected, "%lld", (long long) svalue);
+            assert(strcmp(buf, expected) == 0);
+
+            svalue = (int64) (0 - (uint64) svalue);
+            mprSprintf(buf, sizeof(buf), "%Ld", svalue);
+            sprintf(expected, "%lld", (long long) svalue);
+            assert(strcmp(buf, expected) == 0);
+
+            mprSprintf(buf, sizeof(buf), "%Lx", value + j);
+            sprintf(expected, "%llx", (unsigned long long) (value + j));
+            assert(strcmp(buf, expected) == 0);
+
+            mprSprintf(buf, sizeof(buf), "%Lo", value + j);
+            sprintf(expected, "%llo", (unsigned long long) (value + j));
+            assert(strcmp(buf, expected) == 0);
+
+            mprSprintf(buf, sizeof(buf), "%d", (int) svalue);
+            sprintf(expected, "%d", (int) svalue);
+            assert(strcmp(buf, expected) == 0);
+
+            mprSprintf(buf, sizeof(buf), "%u", (uint) svalue);
+            sprintf(expected, "%u", (uint) svalue);
+            assert(strcmp(buf, expected) == 0);
+
+            mprSprintf(buf, sizeof(buf), "[%08x|%-6d|%+.3d]", (uint) svalue, (int) svalue & 0xFFFF, (int) svalue & 0xFF);
+            sprintf(expected, "[%08x|%-6d|%+.3d]", (uint) svalue, (int) svalue & 0xFFFF, (int) svalue & 0xFF);
+            assert(strcmp(buf, expected) == 0);
+        }
+        value *= 2;
+    }
+    mprSprintf(buf, sizeof(buf), "%Ld", -INT64(9223372036854775807) - 1);
+    assert(strcmp(buf, "-9223372036854775808") == 0);
+
+    mprSprintf(buf, sizeof(buf), "%Lu", (uint64) -1);
+    assert(strcmp(buf, "18446744073709551615") == 0);
+
+    mprSprintf(buf, sizeof(buf), "%,d", 1234567);
+    assert(strcmp(buf, "1,234,567") == 0);
+}
+
+
+/*
+ *  Reference implementation for the string tests
+ */
+static cchar *findPattern(cchar *str, cchar *pattern, int len)
+{
+    int     i, plen;
+
+    plen = (int) strlen(pattern);
+    for (i = 0; i + plen <= len && str[i]; i++) {
+        if (strncmp(&str[i], pattern, plen) == 0) {
+            return &str[i];
+        }
+    }
+    return 0;
+}
+
+
+static int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+
+static void testStrings(MprTestGroup *gp)
+{
+    char        buf[256], copy[256], other[256], *tok, *last, *refLast, *ref;
+    cchar       *alphabet;
+    uint        seed;
+    int         i, j, len, offset, count;
+
+    assert(mprStrcmpAnyCase("Content-Length", "content-length") == 0);
+    assert(mprStrcmpAnyCase("abc", "ABD") < 0);
+    assert(mprStrcmpAnyCase("abc", "ab") > 0);
+    assert(mprStrcmpAnyCase("Transfer-Encoding-And-More", "TRANSFER-ENCODING-AND-MORE") == 0);
+    assert(mprStrcmpAnyCaseCount("Keep-Alive: 10", "keep-alive", 10) == 0);
+    assert(mprStrcmpAnyCaseCount("abcdefghijklmnopqrstuvwxyz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ!", 26) == 0);
+    assert(mprStrcmpAnyCaseCount("abcdefghijklmnopqrstuvwxyz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ!", 27) != 0);
+
+    strcpy(buf, "Mixed Case @[`{ String With Enough Characters To Span Blocks");
+    assert(strcmp(mprStrLower(buf), "mixed case @[`{ string with enough characters to span blocks") == 0);
+    assert(strcmp(mprStrUpper(buf), "MIXED CASE @[`{ STRING WITH ENOUGH CHARACTERS TO SPAN BLOCKS") == 0);
+
+    assert(mprStrnstr("HTTP/1.1 200 OK\r\nHost: a\r\n\r\nbody", "\r\n\r\n", 28) != 0);
+    assert(mprStrnstr("HTTP/1.1 200 OK\r\nHost: a\r\n\r\nbody", "\r\n\r\n", 27) == 0);
+    assert(mprStrnstr("abc", "", 3) == 0);
+    assert(mprStrnstr("abc", "c", 0) == 0);
+
+    strcpy(buf, "  one two\tthree  ");
+    assert(strcmp(mprStrTok(buf, " \t", &last), "one") == 0);
+    assert(strcmp(mprStrTok(0, " \t", &last), "two") == 0);
+    assert(strcmp(mprStrTok(0, " \t", &last), "three") == 0);
+    assert(mprStrTok(0, " \t", &last) == 0);
+
+    /*
+     *  Compare with the reference implementations over random strings at all alignments and lengths
+     */
+    alphabet = "aAbBzZ@[`{-: \t\r\n";
+    seed = 2463534242U;
+    for (i = 0; i < 5000; i++) {
+        len = i % 100;
+        offset = (i / 100) % 16;
+        for (j = 0; j < len; j++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            buf[offset + j] = alphabet[seed % 16];
+        }
+        buf[offset + len] = '\0';
+        strcpy(other, &buf[offset]);
+        if (len > 0 && (i & 1)) {
+            other[seed % len] = alphabet[(seed >> 8) % 16];
+        }
+        assert(sign(mprStrcmpAnyCase(&buf[offset], other)) == sign(strcasecmp(&buf[offset], other)));
+        count = (int) (seed % 120);
+        assert(sign(mprStrcmpAnyCaseCount(&buf[offset], other, count)) == 
+            sign(strncasecmp(&buf[offset], other, count)));
+
+        strcpy(copy, &buf[offset]);
+        mprStrLower(&buf[offset]);
+        for (j = 0; j < len; j++) {
+            assert(buf[offset + j] == tolower((int) copy[j]));
+        }
+        mprStrUpper(&buf[offset]);
+        for (j = 0; j < len; j++) {
+            assert(buf[offset + j] == toupper((int) copy[j]));
+        }
+        memcpy(&buf[offset], copy, len + 1);
+
+        count = (int) (seed % (len + 2));
+        assert(mprStrnstr(&buf[offset], "a\r", count) == findPattern(&buf[offset], "a\r", count));
+        assert(mprStrnstr(&buf[offset], "A", count) == findPattern(&buf[offset], "A", count));
+        assert(mprStrnstr(&buf[offset], "Zz@", count) == findPattern(&buf[offset], "Zz@", count));
+
+        strcpy(copy, &buf[offset]);
+        tok = mprStrTok(&buf[offset], " \t\r\n", &last);
+        ref = strtok_r(copy, " \t\r\n", &refLast);
+        while (tok && ref) {
+            assert(strcmp(tok, ref) == 0);
+            tok = mprStrTok(0, " \t\r\n", &last);
+            ref = strtok_r(0, " \t\r\n", &refLast);
+        }
+        assert(tok == 0 && ref == 0);
+    }
+}
+
+
+static void testStrBuilder(MprTestGroup *gp)
+{
+    MprStrBuilder   sb;
+    cchar           *buf;
+    char            *str;
+    int             i;
+
+    /*
+     *  Short strings are built in local storage and copied once when stolen
+     */
+    mprInitStrBuilder(gp, &sb, -1);
+    assert(strcmp(mprGetBuilderString(&sb), "") == 0);
+    assert(mprPutStringToBuilder(&sb, "Hello") == 5);
+    assert(mprPutCharToBuilder(&sb, ' ') == 1);
+    assert(mprPutBlockToBuilder(&sb, "World!!", 5) == 5);
+    assert(mprPutIntToBuilder(&sb, -42) == 3);
+    assert(mprPutFmtToBuilder(&sb, " %s=%d", "x", 7) == 4);
+    assert(sb.buf == sb.local);
+    assert(strcmp(mprGetBuilderString(&sb), "Hello World-42 x=7") == 0);
+    str = mprStealBuilder(&sb);
+    assert(str && strcmp(str, "Hello World-42 x=7") == 0);
+    assert(sb.length == 0 && sb.buf == sb.local);
+    mprFree(str);
+
+    /*
+     *  Long strings move to an allocated block which is stolen without copying
+     */
+    for (i = 0; i < 1000; i++) {
+        assert(mprPutFmtToBuilder(&sb, "%04d,", i) == 5);
+    }
+    assert(sb.length == 5000);
+    assert(sb.buf != sb.local);
+    buf = mprGetBuilderString(&sb);
+    assert(strncmp(buf, "0000,0001,", 10) == 0);
+    assert(strcmp(&buf[4995], "0999,") == 0);
+    str = mprStealBuilder(&sb);
+    assert(str == buf);
+    mprFree(str);
+
+    mprInitStrBuilder(gp, &sb, -1);
+    for (i = 0; i < 300; i++) {
+        mprPutCharToBuilder(&sb, 'a' + (i % 26));
+    }
+    mprPutIntToBuilder(&sb, INT64(-9223372036854775807) - 1);
+    assert(sb.length == 320);
+    assert(strcmp(&mprGetBuilderString(&sb)[300], "-9223372036854775808") == 0);
+    mprFreeBuilder(&sb);
+    assert(sb.length == 0 && sb.buf == sb.local);
+
+    /*
+     *  Exceeding the maximum size fails the builder
+     */
+    mprInitStrBuilder(gp, &sb, 8);
+    assert(mprPutStringToBuilder(&sb, "1234567") == 7);
+    assert(mprPutCharToBuilder(&sb, '8') < 0);
+    assert(mprStealBuilder(&sb) == 0);
+
+    mprInitStrBuilder(gp, &sb, 300);
+    for (i = 0; i < 200; i++) {
+        mprPutFmtToBuilder(&sb, "%d", i);
+    }
+    assert(sb.error);
+    assert(mprStealBuilder(&sb) == 0);
+
+    /*
+     *  Routines built on the builder
+     */
+    str = mprStrcat(gp, -1, "a", "bc", "", "def", NULL);
+    assert(strcmp(str, "abcdef") == 0);
+    mprFree(str);
+    assert(mprStrcat(gp, 4, "abc", "d", NULL) == 0);
+
+    str = mprFormatUri(gp, "http", "example.com", 8080, "index.html", "a=b");
+    assert(strcmp(str, "http://example.com:8080/index.html?a=b") == 0);
+    mprFree(str);
+    str = mprFormatUri(gp, 0, 0, 80, 0, 0);
+    assert(strcmp(str, "http://localhost/") == 0);
+    mprFree(str);
+    str = mprFormatUri(gp, "https", "example.com:4443", 443, "/", "");
+    assert(strcmp(str, "https://example.com:4443/") == 0);
+    mprFree(str);
 }
 
 
@@ -153,6 +415,12 @@ static void testModifierOptions(MprTestGroup *gp)
 
     mprSprintf(buf, sizeof(buf), "%,d", 12345678);
     assert(strcmp(buf, "12,345,678") == 0);
+
+    mprSprintf(buf, sizeof(buf), "%,o", 01234567);
+    assert(strcmp(buf, "1,234,567") == 0);
+
+    mprSprintf(buf, sizeof(buf), "%,x", 0x1234567);
+    assert(strcmp(buf, "1234567") == 0);
 }
 
 
@@ -239,10 +507,163 @@ static void testSprintf64(MprTestGroup *gp)
 }
 
 
+static void testCompileFormat(MprTestGroup *gp)
+{
+    static MprFormat    *cache;
+    MprFormat           *format, *cached, *slot;
+    MprBuf              *bp;
+    char                buf[256], expected[256], *str;
+    cchar               *spec;
+    int                 i;
+
+    spec = "%s=%d [%5x] %-4s|%%|%*d|%.*s";
+    format = mprCompileFormat(gp, spec);
+    assert(format != 0);
+
+    mprSprintf(expected, sizeof(expected), spec, "name", -42, 255, "ab", 6, 77, 3, "abcdef");
+    assert(strcmp(expected, "name=-42 [   ff] ab  |%|    77|abc") == 0);
+
+    str = mprSprintfFormat(buf, sizeof(buf), format, "name", -42, 255, "ab", 6, 77, 3, "abcdef");
+    assert(str == buf);
+    assert(strcmp(buf, expected) == 0);
+
+    str = mprAsprintfFormat(gp, -1, format, "name", -42, 255, "ab", 6, 77, 3, "abcdef");
+    assert(str && strcmp(str, expected) == 0);
+    mprFree(str);
+
+    /*
+     *  Truncation must match the uncompiled form
+     */
+    mprSprintfFormat(buf, 8, format, "name", -42, 255, "ab", 6, 77, 3, "abcdef");
+    mprSprintf(expected, 8, spec, "name", -42, 255, "ab", 6, 77, 3, "abcdef");
+    assert(strcmp(buf, expected) == 0);
+    mprFree(format);
+
+    /*
+     *  Formats without conversions and with only conversions
+     */
+    format = mprCompileFormat(gp, "plain text");
+    mprSprintfFormat(buf, sizeof(buf), format);
+    assert(strcmp(buf, "plain text") == 0);
+    mprFree(format);
+
+    format = mprCompileFormat(gp, "");
+    mprSprintfFormat(buf, sizeof(buf), format);
+    assert(buf[0] == '\0');
+    mprFree(format);
+
+    /*
+     *  The cache slot is compiled once and reused
+     */
+    cached = mprGetFormat(gp, &cache, "%s: %d\r\n");
+    assert(cached != 0);
+    assert(mprGetFormat(gp, &cache, "%s: %d\r\n") == cached);
+
+    bp = mprCreateBuf(gp, 16, -1);
+    for (i = 0; i < 50; i++) {
+        assert(mprPutFormatToBuf(bp, cached, "Header", i) > 0);
+    }
+    mprAddNullToBuf(bp);
+    assert(strncmp(mprGetBufStart(bp), "Header: 0\r\nHeader: 1\r\n", 22) == 0);
+    assert(strstr(mprGetBufStart(bp), "Header: 49\r\n") != 0);
+    mprFree(bp);
+
+    /*
+     *  Freeing a cached format resets its slot so it is compiled again (as when the Mpr is recreated)
+     */
+    slot = 0;
+    format = mprGetFormat(gp, &slot, "%d");
+    assert(format != 0 && slot == format);
+    mprFree(format);
+    assert(slot == 0);
+    assert(mprGetFormat(gp, &slot, "%d") != 0);
+    mprFree(slot);
+
+    /*
+     *  Logging with a compiled format. Level 9 is normally not emitted.
+     */
+    mprLogFormat(gp, 9, mprGetFormat(gp, &cache, "%s: %d\r\n"), "Header", 1);
+    mprLogFormat(gp, 9, 0);
+}
+
+
 #if BLD_FEATURE_FLOATING_POINT
 static void testFloatingSprintf(MprTestGroup *gp)
 {
 }
+
+
+static int checkDtoa(MprTestGroup *gp, double value, int ndigits, int mode, int flags, cchar *expected)
+{
+    char    *str;
+    int     rc;
+
+    str = mprDtoa(gp, value, ndigits, mode, flags);
+    rc = (str && strcmp(str, expected) == 0);
+    if (!rc) {
+        mprLog(gp, 0, "mprDtoa(%.17g) gave \"%s\" expected \"%s\"", value, str, expected);
+    }
+    mprFree(str);
+    return rc;
+}
+
+
+static void testDtoa(MprTestGroup *gp)
+{
+    char        buf[MPR_GRISU_BUFSIZE], *str, *digits;
+    double      value;
+    uint64      bits, seed;
+    int         i, period, dtoaPeriod, sign, len;
+
+    assert(checkDtoa(gp, 0.0, 0, MPR_DTOA_ALL_DIGITS, 0, "0"));
+    assert(checkDtoa(gp, 0.1, 0, MPR_DTOA_ALL_DIGITS, 0, "0.1"));
+    assert(checkDtoa(gp, -123.456, 0, MPR_DTOA_ALL_DIGITS, 0, "-123.456"));
+    assert(checkDtoa(gp, 100, 0, MPR_DTOA_ALL_DIGITS, 0, "100"));
+    assert(checkDtoa(gp, 1e21, 0, MPR_DTOA_ALL_DIGITS, 0, "1e+21"));
+    assert(checkDtoa(gp, 1.5e-7, 0, MPR_DTOA_ALL_DIGITS, 0, "1.5e-7"));
+    assert(checkDtoa(gp, 0.000001, 0, MPR_DTOA_ALL_DIGITS, 0, "0.000001"));
+    assert(checkDtoa(gp, 5e-324, 0, MPR_DTOA_ALL_DIGITS, 0, "5e-324"));
+    assert(checkDtoa(gp, 1.7976931348623157e308, 0, MPR_DTOA_ALL_DIGITS, 0, "1.7976931348623157e+308"));
+    assert(checkDtoa(gp, 0.5, 0, MPR_DTOA_ALL_DIGITS, MPR_DTOA_EXPONENT_FORM, "5e-1"));
+    assert(checkDtoa(gp, 1234.5, 0, MPR_DTOA_ALL_DIGITS, MPR_DTOA_EXPONENT_FORM, "1.2345e+3"));
+    assert(checkDtoa(gp, 3.14159, 3, MPR_DTOA_N_DIGITS, 0, "3.14"));
+    assert(checkDtoa(gp, 2.5e-9, 4, MPR_DTOA_N_DIGITS, 0, "2.5e-9"));
+    assert(checkDtoa(gp, 1.5, 2, MPR_DTOA_N_FRACTION_DIGITS, MPR_DTOA_FIXED_FORM, "1.50"));
+    assert(checkDtoa(gp, 0.015, 4, MPR_DTOA_N_FRACTION_DIGITS, MPR_DTOA_FIXED_FORM, "0.0150"));
+    assert(checkDtoa(gp, 12345.678, 2, MPR_DTOA_N_FRACTION_DIGITS, MPR_DTOA_FIXED_FORM, "12345.68"));
+
+    /*
+     *  The fast conversion must agree with dtoa when it succeeds and the shortest form must round trip
+     */
+    seed = UINT64(88172645463325252);
+    for (i = 0; i < 20000; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        bits = seed & ~(UINT64(1) << 63);
+        memcpy(&value, &bits, sizeof(value));
+        if (mprIsNan(value) || mprIsInfinite(value) || value == 0) {
+            continue;
+        }
+        if ((len = mprGrisuDtoa(value, MPR_DTOA_ALL_DIGITS, 0, buf, &period)) > 0) {
+            mprGlobalLock(gp);
+            digits = dtoa(value, MPR_DTOA_ALL_DIGITS, 0, &dtoaPeriod, &sign, NULL);
+            assert(strcmp(buf, digits) == 0 && period == dtoaPeriod);
+            freedtoa(digits);
+            mprGlobalUnlock(gp);
+        }
+        if ((len = mprGrisuDtoa(value, MPR_DTOA_N_DIGITS, (i % 17) + 1, buf, &period)) > 0) {
+            mprGlobalLock(gp);
+            digits = dtoa(value, MPR_DTOA_N_DIGITS, (i % 17) + 1, &dtoaPeriod, &sign, NULL);
+            assert(strcmp(buf, digits) == 0 && period == dtoaPeriod);
+            freedtoa(digits);
+            mprGlobalUnlock(gp);
+        }
+        str = mprDtoa(gp, value, 0, MPR_DTOA_ALL_DIGITS, 0);
+        assert(strtod(str, NULL) == value);
+        mprFree(str);
+    }
+}
 #endif
 
 
@@ -251,14 +672,19 @@ MprTestDef testSprintf = {
     {
         MPR_TEST(0, testBasicSprintf),
         MPR_TEST(0, testItoa),
+        MPR_TEST(0, testIntegerFormats),
+        MPR_TEST(0, testStrings),
+        MPR_TEST(0, testStrBuilder),
         MPR_TEST(0, testTypeOptions),
         MPR_TEST(0, testModifierOptions),
         MPR_TEST(0, testWidthOptions),
         MPR_TEST(0, testPrecisionOptions),
         MPR_TEST(0, testBitOptions),
         MPR_TEST(0, testSprintf64),
+        MPR_TEST(0, testCompileFormat),
 #if BLD_FEATURE_FLOATING_POINT
         MPR_TEST(0, testFloatingSprintf),
+        MPR_TEST(0, testDtoa),
 #endif
         MPR_TEST(0, 0),
     },
@@ -33,10 +33,345 @@ static void testStartWorker(MprTestGroup *gp)
 }
 
 
+static void testCpuSet(MprTestGroup *gp)
+{
+    MprCpuSet   cpus, all;
+    int         node, cpu, count;
+
+    mprInitCpuSet(&cpus);
+    assert(mprGetCpuSetCount(&cpus) == 0);
+
+    mprAddCpuToSet(&cpus, 0);
+    mprAddCpuToSet(&cpus, 65);
+    assert(mprIsCpuInSet(&cpus, 0));
+    assert(mprIsCpuInSet(&cpus, 65));
+    assert(!mprIsCpuInSet(&cpus, 1));
+    assert(mprGetCpuSetCount(&cpus) == 2);
+
+    mprRemoveCpuFromSet(&cpus, 65);
+    assert(!mprIsCpuInSet(&cpus, 65));
+    assert(mprGetCpuSetCount(&cpus) == 1);
+
+    /*
+     *  Every CPU must belong to exactly one NUMA node
+     */
+    mprInitCpuSet(&all);
+    for (node = 0; node < mprGetNumaNodeCount(gp); node++) {
+        assert(mprGetNumaCpuSet(gp, node, &cpus) == 0);
+        for (cpu = 0; cpu < MPR_MAX_CPUS; cpu++) {
+            if (mprIsCpuInSet(&cpus, cpu)) {
+                assert(!mprIsCpuInSet(&all, cpu));
+                mprAddCpuToSet(&all, cpu);
+            }
+        }
+    }
+    count = mprGetCpuSetCount(&all);
+    assert(count >= 1);
+    assert(count >= mprGetCpuCount(gp));
+    assert(mprGetNumaCpuSet(gp, -1, &cpus) == MPR_ERR_BAD_ARGS);
+}
+
+
+static void affinityProc(void *data, MprWorker *worker)
+{
+    MprTestGroup    *gp;
+
+    gp = (MprTestGroup*) data;
+    gp->data = (void*) (long) (worker->thread->pinned && mprIsCpuInSet(&worker->thread->affinity, 0));
+    mprSignalTestComplete(gp);
+}
+
+
+static void testWorkerAffinity(MprTestGroup *gp)
+{
+    MprCpuSet   cpus;
+    int         rc;
+
+    mprInitCpuSet(&cpus);
+    mprAddCpuToSet(&cpus, 0);
+    assert(mprSetWorkerAffinity(gp, &cpus, MPR_AFFINITY_CPU) == 0);
+
+    if (mprGetMaxWorkers(gp) > gp->service->numThreads) {
+        gp->data = 0;
+        rc = mprStartWorker(gp, affinityProc, (void*) gp, MPR_NORMAL_PRIORITY);
+        assert(rc == 0);
+        assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+        /*
+         *  Worker affinity is process wide. Other test threads running this test may reset it at any time.
+         */
+        if (gp->service->numThreads == 1) {
+            assert(gp->data != 0);
+        }
+    }
+    assert(mprSetWorkerAffinity(gp, NULL, 0) == 0);
+
+    mprInitCpuSet(&cpus);
+    assert(mprSetWorkerAffinity(gp, &cpus, MPR_AFFINITY_SHARED) == MPR_ERR_BAD_ARGS);
+}
+
+
+static void *squareProc(void *data, void *arg)
+{
+    return (void*) ((long) data * (long) data);
+}
+
+
+static void *addProc(void *data, void *arg)
+{
+    return (void*) ((long) data + (long) arg);
+}
+
+
+static void testFuture(MprTestGroup *gp)
+{
+    MprFuture   *fp, *then;
+
+    fp = mprSubmitFuture(gp, squareProc, (void*) 7L);
+    assert(fp != 0);
+    then = mprThenFuture(fp, addProc, (void*) 1L);
+    assert(then != 0);
+
+    assert(mprWaitForFuture(then, MPR_TEST_SLEEP) == 0);
+    assert(mprIsFutureComplete(then));
+    assert(mprIsFutureComplete(fp));
+    assert((long) mprGetFutureResult(fp) == 49);
+    assert((long) mprGetFutureResult(then) == 50);
+
+    /*
+     *  Continuation of an already completed future
+     */
+    mprFree(then);
+    then = mprThenFuture(fp, addProc, (void*) 2L);
+    assert(mprWaitForFuture(then, MPR_TEST_SLEEP) == 0);
+    assert((long) mprGetFutureResult(then) == 51);
+    mprFree(then);
+    mprFree(fp);
+}
+
+
+static void sumProc(void *data, int start, int end)
+{
+    int     *counts, i;
+
+    counts = (int*) data;
+    for (i = start; i < end; i++) {
+        counts[i]++;
+    }
+}
+
+
+static void testParallelFor(MprTestGroup *gp)
+{
+    int     *counts, i, count;
+
+    count = 10000;
+    counts = (int*) mprAllocZeroed(gp, count * sizeof(int));
+    assert(counts != 0);
+
+    assert(mprParallelFor(gp, 0, count, 0, sumProc, counts) == 0);
+    assert(mprParallelFor(gp, 0, count, 7, sumProc, counts) == 0);
+    assert(mprParallelFor(gp, 100, 100, 0, sumProc, counts) == 0);
+    for (i = 0; i < count; i++) {
+        assert(counts[i] == 2);
+    }
+    mprFree(counts);
+}
+
+
+static void *orderProc(void *data, void *arg)
+{
+    return data;
+}
+
+
+/*
+ *  Queue futures while holding the worker service lock so no worker can take them, then dequeue them in policy order.
+ *  Return the dequeue position of the background future.
+ */
+static int queueOrder(MprTestGroup *gp, int policy, int count)
+{
+    MprWorkerService    *ws;
+    MprFuture           *fp, **futures, **others;
+    int                 i, pos, position, nothers;
+
+    ws = mprGetMpr(gp)->workerService;
+    futures = (MprFuture**) mprAllocZeroed(gp, (count + 1) * sizeof(MprFuture*));
+    others = (MprFuture**) mprAllocZeroed(gp, 64 * sizeof(MprFuture*));
+    position = -1;
+    nothers = 0;
+
+    mprLock(ws->mutex);
+    mprSetWorkerQueuePolicy(gp, policy);
+    futures[0] = mprSubmitPriorityFuture(gp, orderProc, 0, MPR_BACKGROUND_PRIORITY);
+    for (i = 1; i <= count; i++) {
+        futures[i] = mprSubmitPriorityFuture(gp, orderProc, 0, MPR_CRITICAL_PRIORITY);
+    }
+    for (pos = 0; (fp = mprGetNextFuture(ws)) != 0; ) {
+        for (i = 0; i <= count; i++) {
+            if (fp == futures[i]) {
+                break;
+            }
+        }
+        if (i > count) {
+            /* Future queued by another test group */
+            if (nothers < 64) {
+                others[nothers++] = fp;
+            }
+            continue;
+        }
+        if (i == 0) {
+            position = pos;
+        }
+        pos++;
+        mprRunFuture(fp);
+    }
+    mprSetWorkerQueuePolicy(gp, MPR_QUEUE_WEIGHTED);
+    mprUnlock(ws->mutex);
+
+    for (i = 0; i < nothers; i++) {
+        mprRunFuture(others[i]);
+    }
+    for (i = 0; i <= count; i++) {
+        mprFree(futures[i]);
+    }
+    mprFree(futures);
+    mprFree(others);
+    return position;
+}
+
+
+static void testFuturePriority(MprTestGroup *gp)
+{
+    assert(mprGetPriorityClass(MPR_BACKGROUND_PRIORITY) == MPR_CLASS_BACKGROUND);
+    assert(mprGetPriorityClass(MPR_NORMAL_PRIORITY) == MPR_CLASS_NORMAL);
+    assert(mprGetPriorityClass(MPR_CRITICAL_PRIORITY) == MPR_CLASS_CRITICAL);
+
+    /*
+     *  Strict order starves the background future until all critical futures have run. Weighted order gives it a
+     *  turn once the critical class has used its 2^4 turns.
+     */
+    assert(queueOrder(gp, MPR_QUEUE_STRICT, 20) == 20);
+    assert(queueOrder(gp, MPR_QUEUE_WEIGHTED, 20) == 16);
+}
+
+
+static void taskProc(void *data, MprWorker *worker)
+{
+    MprTestGroup    *gp;
+
+    gp = (MprTestGroup*) data;
+    if (worker && mprGetCurrentWorker(gp) == worker) {
+        mprSignalTestComplete(gp);
+    }
+}
+
+
+static void testQueueTask(MprTestGroup *gp)
+{
+    MprWorkerService    *ws;
+    MprFuture           *fp;
+    int                 rc, tasks;
+
+    ws = mprGetMpr(gp)->workerService;
+    assert(mprGetCurrentWorker(gp) == 0);
+
+    /*
+     *  Queue a task as mprStartWorker does when the pool is saturated. Only a worker may run it.
+     */
+    tasks = 0;
+    mprLock(ws->mutex);
+    rc = mprQueueWorkerTask(ws, taskProc, (void*) gp, MPR_CRITICAL_PRIORITY);
+    assert(rc == 0);
+    while ((fp = mprGetNextFuture(ws)) != 0) {
+        /* Future queued by another test group */
+        if (fp->task) {
+            tasks++;
+        } else {
+            mprRunFuture(fp);
+        }
+    }
+    mprUnlock(ws->mutex);
+    assert(tasks == 0);
+    assert(mprWaitForTestToComplete(gp, MPR_TEST_SLEEP));
+}
+
+
+static void testTuneWorkers(MprTestGroup *gp)
+{
+    MprWorkerService    *ws;
+    MprWorkerStats      stats;
+    int                 decision, spare, quiet, shrunk, excess, expected, i;
+
+    ws = mprGetMpr(gp)->workerService;
+
+    /*
+     *  Hold the lock so other test groups can't record waits or change the pool while sizing. Save the sizing 
+     *  state so the rest of the run is not affected.
+     */
+    mprLock(ws->mutex);
+    spare = ws->spareThreads;
+    quiet = ws->quietPeriods;
+
+    /*
+     *  Start a fresh sizing period and simulate a task that waited to start
+     */
+    mprTuneWorkers(gp);
+    mprRecordWorkerWait(ws, MPR_WORKER_GROW_WAIT * 10);
+    i = ws->spareThreads;
+    decision = mprTuneWorkers(gp);
+
+    mprGetWorkerServiceStats(ws, &stats);
+    assert(stats.decision == decision);
+    assert(stats.maxWait >= MPR_WORKER_GROW_WAIT * 10);
+    if (decision == MPR_WORKER_GROW) {
+        assert(stats.spareThreads == min(max(i * 2, 1), stats.maxThreads));
+    } else {
+        assert(stats.cpuLoad >= MPR_WORKER_CPU_SATURATED);
+        assert(stats.spareThreads == i);
+    }
+    assert(stats.spareThreads <= stats.maxThreads);
+    assert(stats.numThreads <= stats.maxThreads);
+    mprUnlock(ws->mutex);
+
+    /*
+     *  Let the spare threads go idle, then run quiet periods until the pool shrinks
+     */
+    for (i = 0; i < 20 && ws->starting > 0; i++) {
+        mprSleep(gp, 50);
+    }
+    mprLock(ws->mutex);
+    mprTuneWorkers(gp);
+    ws->quietPeriods = 0;
+    if (!mprGetDebugMode(gp) && ws->starting == 0) {
+        for (i = 1; i < MPR_WORKER_SHRINK_PERIODS && ws->pendingFutures == 0; i++) {
+            assert(mprTuneWorkers(gp) == MPR_WORKER_HOLD);
+        }
+        if (ws->pendingFutures == 0) {
+            excess = min(mprGetLinkCount(&ws->idleThreads) - ws->spareThreads / 2, ws->numThreads - ws->minThreads);
+            expected = (excess > 0) ? (excess + 1) / 2 : 0;
+            shrunk = ws->shrunk;
+            decision = mprTuneWorkers(gp);
+            assert(decision == (expected > 0 ? MPR_WORKER_SHRINK : MPR_WORKER_HOLD));
+            assert(ws->shrunk - shrunk == expected);
+        }
+    }
+    ws->spareThreads = spare;
+    ws->quietPeriods = quiet;
+    mprUnlock(ws->mutex);
+}
+
+
 MprTestDef testWorker = {
     "worker", 0, 0, 0,
     {
         MPR_TEST(0, testStartWorker),
+        MPR_TEST(0, testCpuSet),
+        MPR_TEST(0, testWorkerAffinity),
+        MPR_TEST(0, testFuture),
+        MPR_TEST(0, testParallelFor),
+        MPR_TEST(0, testFuturePriority),
+        MPR_TEST(0, testQueueTask),
+        MPR_TEST(0, testTuneWorkers),
         MPR_TEST(0, 0),
     },
 };
@@ -12,35 +12,265 @@
 
 static void testBasicUnicode(MprTestGroup *gp)
 {
-    char    buf[256];
-    char    *str;
+    uni     buf[64];
+    char    str[64];
+    uni     *us;
+    char    *result;
     int     count;
 
-    mprSprintf(buf, sizeof(buf), "%d", 12345678);
-    assert(strlen(buf) == 8);
-    assert(strcmp(buf, "12345678") == 0);
+    /*
+     *  "aé€😀" is 1, 2, 3 and 4 bytes of UTF-8 and 1, 1, 1 and 2 units of UTF-16
+     */
+    count = mprUtf8ToUni(buf, 64, "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", -1);
+    assert(count == 5);
+    assert(buf[0] == 'a');
+    assert((ushort) buf[1] == 0xE9);
+    assert((ushort) buf[2] == 0x20AC);
+    assert((ushort) buf[3] == 0xD83D);
+    assert((ushort) buf[4] == 0xDE00);
+    assert(buf[5] == 0);
+    assert(mprUtf8ToUni(0, 0, "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", -1) == 5);
+
+    assert(mprUniToUtf8(0, 0, buf, -1) == 10);
+    assert(mprUniToUtf8(str, sizeof(str), buf, count) == 10);
+    assert(strcmp(str, "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80") == 0);
+
+    /*
+     *  Results must fit with the null
+     */
+    assert(mprUtf8ToUni(buf, 5, "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", -1) == MPR_ERR_WONT_FIT);
+    assert(mprUtf8ToUni(buf, 6, "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", -1) == 5);
+    assert(mprUniToUtf8(str, 10, buf, -1) == MPR_ERR_WONT_FIT);
+    assert(mprUtf8ToUni(buf, 16, "0123456789abcdef", -1) == MPR_ERR_WONT_FIT);
+    assert(mprUtf8ToUni(buf, 17, "0123456789abcdef", -1) == 16);
+
+    us = mprStrToUni(gp, "A longer string of ASCII with one \xE2\x82\xAC sign in the middle of it", -1);
+    assert(us != 0);
+    assert(mprUniLen(us) == 60);
+    assert((ushort) us[34] == 0x20AC);
+    result = mprUniToStr(gp, us, -1);
+    assert(strcmp(result, "A longer string of ASCII with one \xE2\x82\xAC sign in the middle of it") == 0);
+    mprFree(result);
+    mprFree(us);
+}
+
+
+static void testValidation(MprTestGroup *gp)
+{
+    uni     buf[16];
+    cchar   **cp;
+    cchar   *invalid[] = {
+        "\x80",                         /* Lone continuation */
+        "\xC0\xAF",                     /* Overlong '/' */
+        "\xC1\xBF",                     /* Overlong */
+        "\xE0\x9F\xBF",                 /* Overlong three byte */
+        "\xF0\x8F\xBF\xBF",             /* Overlong four byte */
+        "\xED\xA0\x80",                 /* Encoded surrogate */
+        "\xF4\x90\x80\x80",             /* Beyond U+10FFFF */
+        "\xF5\x80\x80\x80",
+        "\xFF",
+        "\xC3",                         /* Truncated */
+        "\xE2\x82",
+        "\xF0\x9F\x98",
+        "\xC3\x28",                     /* Bad continuation */
+        0
+    };
 
-    mprSprintf(buf, sizeof(buf), "%d", -12345678);
-    assert(strlen(buf) == 9);
-    assert(strcmp(buf, "-12345678") == 0);
+    assert(mprIsUtf8("", -1));
+    assert(mprIsUtf8("plain ascii text that spans more than one block", -1));
+    assert(mprIsUtf8("\xC2\x80\xDF\xBF\xE0\xA0\x80\xEF\xBF\xBF\xF0\x90\x80\x80\xF4\x8F\xBF\xBF", -1));
+    assert(mprIsUtf8("\xED\x9F\xBF\xEE\x80\x80", -1));
 
-    str = mprAsprintf(gp, 4, "%d", 12345678);
-    count = (int) strlen(str);
-    assert(count == 3);
-    assert(strcmp(str, "123") == 0);
+    for (cp = invalid; *cp; cp++) {
+        assert(!mprIsUtf8(*cp, -1));
+        assert(mprUtf8ToUni(buf, 16, *cp, -1) == MPR_ERR_BAD_FORMAT);
+        assert(mprUtf8ToUni(0, 0, *cp, -1) == MPR_ERR_BAD_FORMAT);
+        assert(mprStrToUni(gp, *cp, -1) == 0);
+    }
+    /*
+     *  Errors after a run of ASCII and sequences truncated by the length
+     */
+    assert(!mprIsUtf8("0123456789abcdefghijklmnopqrstuvwxyz\xC0\xAF", -1));
+    assert(!mprIsUtf8("\xE2\x82\xAC", 2));
+    assert(mprIsUtf8("\xE2\x82\xAC", 3));
+
+    /*
+     *  Unpaired surrogates
+     */
+    buf[0] = 'a'; buf[1] = (uni) 0xD800; buf[2] = 'b'; buf[3] = 0;
+    assert(mprUniToUtf8(0, 0, buf, -1) == MPR_ERR_BAD_FORMAT);
+    buf[1] = (uni) 0xDC00;
+    assert(mprUniToStr(gp, buf, -1) == 0);
+    buf[1] = (uni) 0xD800; buf[2] = (uni) 0xDC00;
+    assert(mprUniToUtf8(0, 0, buf, -1) == 5);
+    assert(mprUniToUtf8(0, 0, buf, 2) == MPR_ERR_BAD_FORMAT);
+}
+
+
+static void testUniStrings(MprTestGroup *gp)
+{
+    uni     *us, *tok, *last, *space, *pattern, *trimmed;
+    char    *str;
+
+    us = mprStrToUni(gp, "  \xE2\x82\xAC one two\tthree  ", -1);
+    space = mprStrToUni(gp, " \t", -1);
+    trimmed = mprUniTrim(us, space);
+    str = mprUniToStr(gp, trimmed, -1);
+    assert(strcmp(str, "\xE2\x82\xAC one two\tthree") == 0);
     mprFree(str);
+
+    tok = mprUniTok(trimmed, space, &last);
+    assert(mprUniLen(tok) == 1 && (ushort) tok[0] == 0x20AC);
+    tok = mprUniTok(0, space, &last);
+    assert(mprUniLen(tok) == 3 && tok[0] == 'o');
+    tok = mprUniTok(0, space, &last);
+    assert(mprUniLen(tok) == 3 && tok[0] == 't' && tok[1] == 'w');
+    tok = mprUniTok(0, space, &last);
+    assert(mprUniLen(tok) == 5 && tok[0] == 't' && tok[1] == 'h');
+    assert(mprUniTok(0, space, &last) == 0);
+    mprFree(us);
+
+    us = mprStrToUni(gp, "The quick brown \xF0\x9F\xA6\x8A jumps over the lazy dog, the quick brown fox", -1);
+    pattern = mprStrToUni(gp, "brown fox", -1);
+    assert(mprUniStr(us, pattern) == &us[54]);
+    mprFree(pattern);
+    pattern = mprStrToUni(gp, "\xF0\x9F\xA6\x8A jumps", -1);
+    assert(mprUniStr(us, pattern) == &us[16]);
+    mprFree(pattern);
+    pattern = mprStrToUni(gp, "T", -1);
+    assert(mprUniStr(us, pattern) == us);
+    mprFree(pattern);
+    pattern = mprStrToUni(gp, "foxes", -1);
+    assert(mprUniStr(us, pattern) == 0);
+    mprFree(pattern);
+    pattern = mprStrToUni(gp, "", -1);
+    assert(mprUniStr(us, pattern) == us);
+    mprFree(pattern);
+    mprFree(space);
+    mprFree(us);
 }
 
 
 /*
+ *  Reference encoders for the random tests
  */
+static int encodeUtf8(char *dest, int code)
+{
+    uchar   *dp;
+
+    dp = (uchar*) dest;
+    if (code < 0x80) {
+        dp[0] = (uchar) code;
+        return 1;
+    } else if (code < 0x800) {
+        dp[0] = (uchar) (0xC0 | (code >> 6));
+        dp[1] = (uchar) (0x80 | (code & 0x3F));
+        return 2;
+    } else if (code < 0x10000) {
+        dp[0] = (uchar) (0xE0 | (code >> 12));
+        dp[1] = (uchar) (0x80 | ((code >> 6) & 0x3F));
+        dp[2] = (uchar) (0x80 | (code & 0x3F));
+        return 3;
+    }
+    dp[0] = (uchar) (0xF0 | (code >> 18));
+    dp[1] = (uchar) (0x80 | ((code >> 12) & 0x3F));
+    dp[2] = (uchar) (0x80 | ((code >> 6) & 0x3F));
+    dp[3] = (uchar) (0x80 | (code & 0x3F));
+    return 4;
+}
+
+
+static int encodeUtf16(uni *dest, int code)
+{
+    if (code < 0x10000) {
+        dest[0] = (uni) code;
+        return 1;
+    }
+    code -= 0x10000;
+    dest[0] = (uni) (0xD800 | (code >> 10));
+    dest[1] = (uni) (0xDC00 | (code & 0x3FF));
+    return 2;
+}
+
+
+/*
+ *  Convert random text at all alignments and lengths. Mostly ASCII so the block paths are exercised.
+ */
+static void testRandomUnicode(MprTestGroup *gp)
+{
+    char        str[512], result[512];
+    uni         expected[256], us[256];
+    uint        seed;
+    int         i, j, len, count, code, offset;
+
+    seed = 88172645U;
+    for (i = 0; i < 3000; i++) {
+        offset = i % 8;
+        len = count = 0;
+        for (j = 0; j < (i % 90); j++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            switch (seed % 16) {
+            case 0:
+                code = 0x80 + (seed >> 8) % 0x780;
+                break;
+            case 1:
+                code = 0x800 + (seed >> 8) % 0xF800;
+                if (code >= 0xD800 && code < 0xE000) {
+                    code -= 0x800;
+                }
+                break;
+            case 2:
+                code = 0x10000 + (seed >> 8) % 0x100000;
+                break;
+            default:
+                code = 1 + (seed >> 8) % 0x7F;
+            }
+            len += encodeUtf8(&str[offset + len], code);
+            count += encodeUtf16(&expected[count], code);
+        }
+        str[offset + len] = '\0';
+        expected[count] = 0;
+
+        assert(mprIsUtf8(&str[offset], len));
+        assert(mprUtf8ToUni(0, 0, &str[offset], len) == count);
+        assert(mprUtf8ToUni(&us[offset], 256 - offset, &str[offset], len) == count);
+        assert(memcmp(&us[offset], expected, (count + 1) * sizeof(uni)) == 0);
+        assert(mprUniLen(&us[offset]) == count);
+
+        assert(mprUniToUtf8(0, 0, &us[offset], count) == len);
+        assert(mprUniToUtf8(result, sizeof(result), &us[offset], -1) == len);
+        assert(strcmp(result, &str[offset]) == 0);
+
+        if (len > 0) {
+            /*
+             *  Corrupt one byte. Either the text stays valid or all routines must agree it is not.
+             */
+            j = offset + (int) ((seed >> 4) % len);
+            str[j] = (char) (0x80 | (seed >> 12));
+            if (mprIsUtf8(&str[offset], len)) {
+                assert(mprUtf8ToUni(us, 256, &str[offset], len) >= 0);
+            } else {
+                assert(mprUtf8ToUni(us, 256, &str[offset], len) == MPR_ERR_BAD_FORMAT);
+                assert(mprUtf8ToUni(0, 0, &str[offset], len) == MPR_ERR_BAD_FORMAT);
+            }
+        }
+    }
+}
+
+
 MprTestDef testUnicode = {
     "unicode", 0, 0, 0,
     {
         MPR_TEST(0, testBasicUnicode),
+        MPR_TEST(0, testValidation),
+        MPR_TEST(0, testUniStrings),
+        MPR_TEST(0, testRandomUnicode),
         MPR_TEST(0, 0),
     },
 };
+
 /*
  *  @copy   default
  *  
@@ -0,0 +1,319 @@
+/**
+ *  makehash.c - Generate minimal perfect hash tables as C code.
+ *
+ *  Usage: makehash --name tableName --type "C type" [--terminator init] keyFile >table.c
+ *
+ *  Each line of the key file is a key followed by the C initializer for its table entry. Keys containing spaces
+ *  are double quoted. Blank lines and lines starting with "#" are ignored. For example:
+ *
+ *      html    { "html", "text/html" }
+ *
+ *  The output is a seed table and the entry table in slot order. Use mprLookupPerfectHash to map a key to its slot
+ *  at runtime, then compare the key stored in the entry. The tables are built using "hash and displace": keys are
+ *  hashed into buckets, then the largest buckets are placed first by searching for a seed that rehashes all the
+ *  bucket keys into free slots. Single key buckets are placed directly into the remaining free slots.
+ *
+ *  Copyright (c) All Rights Reserved. See copyright notice at the bottom of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mpr.h"
+
+/*********************************** Locals ***********************************/
+
+#define MAX_SEED    32767               /* Seeds are stored as shorts */
+
+typedef struct HashKey {
+    char        *key;                   /* Key string */
+    char        *init;                  /* C initializer for the entry */
+    int         bucket;                 /* Bucket for the key */
+} HashKey;
+
+/**************************** Forward Declarations ****************************/
+
+static void printUsage(Mpr *mpr);
+static MprList *readKeys(Mpr *mpr, cchar *path);
+static int generate(Mpr *mpr, MprList *keys, cchar *path, cchar *name, cchar *type, cchar *terminator);
+
+/*********************************** Code *************************************/
+/*
+ *  Main program
+ */ 
+
+int main(int argc, char **argv)
+{
+    Mpr         *mpr;
+    MprList     *keys;
+    char        *argp, *name, *type, *terminator;
+    int         nextArg, err;
+
+    mpr = mprCreate(argc, argv, 0);
+
+    err = 0;
+    name = "hashTable";
+    type = 0;
+    terminator = 0;
+
+    for (nextArg = 1; nextArg < argc; nextArg++) {
+        argp = argv[nextArg];
+        if (*argp != '-') {
+            break;
+        }
+        if (strcmp(argp, "--name") == 0) {
+            if (nextArg + 1 >= argc) {
+                err++;
+            } else {
+                name = argv[++nextArg];
+            }
+
+        } else if (strcmp(argp, "--type") == 0) {
+            if (nextArg + 1 >= argc) {
+                err++;
+            } else {
+                type = argv[++nextArg];
+            }
+
+        } else if (strcmp(argp, "--terminator") == 0) {
+            if (nextArg + 1 >= argc) {
+                err++;
+            } else {
+                terminator = argv[++nextArg];
+            }
+        } else {
+            err++;
+        }
+    }
+    if (nextArg + 1 != argc || type == 0) {
+        err++;
+    }
+    if (err) {
+        printUsage(mpr);
+        exit(2);
+    }   
+    if ((keys = readKeys(mpr, argv[nextArg])) == 0) {
+        return MPR_ERR;
+    }
+    if (generate(mpr, keys, argv[nextArg], name, type, terminator) < 0) {
+        return MPR_ERR;
+    }
+    return 0;
+}
+
+
+static void printUsage(Mpr *mpr)
+{
+    mprPrintfError(mpr, "usage: makehash [options] keyFile >output.c\n");
+    mprPrintfError(mpr, "  Makehash options:\n");
+    mprPrintfError(mpr, "  --name tableName      # Name of the generated C table\n");
+    mprPrintfError(mpr, "  --type type           # C type (with storage class) of the table entries\n");
+    mprPrintfError(mpr, "  --terminator init     # Initializer for an entry to append after the table\n");
+}
+
+
+static MprList *readKeys(Mpr *mpr, cchar *path)
+{
+    MprFile     *file;
+    MprList     *keys;
+    HashKey     *hk;
+    char        buf[MPR_MAX_STRING], *cp, *end;
+    int         next, i;
+
+    if ((file = mprOpen(mpr, path, O_RDONLY | O_TEXT, 0)) == 0) {
+        mprError(mpr, "Can't open %s", path);
+        return 0;
+    }
+    keys = mprCreateList(mpr);
+
+    while (mprGets(file, buf, sizeof(buf)) != 0) {
+        for (cp = buf; isspace((int) *cp); cp++) ;
+        if (*cp == '\0' || *cp == '#') {
+            continue;
+        }
+        if (*cp == '"') {
+            if ((end = strchr(++cp, '"')) == 0) {
+                mprError(mpr, "Unterminated key in %s: %s", path, buf);
+                return 0;
+            }
+        } else {
+            for (end = cp; *end && !isspace((int) *end); end++) ;
+        }
+        hk = mprAllocObjZeroed(keys, HashKey);
+        hk->key = mprMemdup(hk, cp, (int) (end - cp) + 1);
+        hk->key[end - cp] = '\0';
+        for (cp = (*end == '"') ? end + 1 : end; isspace((int) *cp); cp++) ;
+        hk->init = mprStrTrim(mprStrdup(hk, cp), " \t\r");
+        if (*hk->init == '\0') {
+            mprError(mpr, "Missing initializer for \"%s\" in %s", hk->key, path);
+            return 0;
+        }
+        mprAddItem(keys, hk);
+    }
+    mprFree(file);
+
+    if (mprGetListCount(keys) == 0) {
+        mprError(mpr, "No keys in %s", path);
+        return 0;
+    }
+    for (next = 0; (hk = mprGetNextItem(keys, &next)) != 0; ) {
+        for (i = next; i < mprGetListCount(keys); i++) {
+            if (strcmp(hk->key, ((HashKey*) mprGetItem(keys, i))->key) == 0) {
+                mprError(mpr, "Duplicate key \"%s\" in %s", hk->key, path);
+                return 0;
+            }
+        }
+    }
+    return keys;
+}
+
+
+/*
+ *  Sort buckets by descending key count
+ */
+static int *bucketSizes;
+
+static int compareBuckets(cvoid *b1, cvoid *b2)
+{
+    return bucketSizes[*(int*) b2] - bucketSizes[*(int*) b1];
+}
+
+
+static int generate(Mpr *mpr, MprList *keys, cchar *path, cchar *name, cchar *type, cchar *terminator)
+{
+    HashKey     *hk, **slots;
+    short       *seeds;
+    char        define[MPR_MAX_FNAME], *dp;
+    cchar       *cp;
+    int         *order, *placed, size, i, b, next, seed, slot, count, freeSlot;
+
+    size = mprGetListCount(keys);
+    seeds = (short*) mprAllocZeroed(mpr, size * (int) sizeof(short));
+    slots = (HashKey**) mprAllocZeroed(mpr, size * (int) sizeof(HashKey*));
+    order = (int*) mprAllocZeroed(mpr, size * (int) sizeof(int));
+    placed = (int*) mprAllocZeroed(mpr, size * (int) sizeof(int));
+    bucketSizes = (int*) mprAllocZeroed(mpr, size * (int) sizeof(int));
+
+    for (next = 0; (hk = mprGetNextItem(keys, &next)) != 0; ) {
+        hk->bucket = mprHashString(hk->key, 0) % size;
+        bucketSizes[hk->bucket]++;
+    }
+    for (b = 0; b < size; b++) {
+        order[b] = b;
+    }
+    qsort(order, size, sizeof(int), compareBuckets);
+
+    /*
+     *  Place multi-key buckets by searching for a seed that puts every key in the bucket into a free slot
+     */
+    for (i = 0; i < size && bucketSizes[order[i]] > 1; i++) {
+        b = order[i];
+        for (seed = 1; seed <= MAX_SEED; seed++) {
+            count = 0;
+            for (next = 0; (hk = mprGetNextItem(keys, &next)) != 0; ) {
+                if (hk->bucket != b) {
+                    continue;
+                }
+                slot = mprHashString(hk->key, seed) % size;
+                if (slots[slot] || placed[slot] == seed) {
+                    break;
+                }
+                placed[slot] = seed;
+                count++;
+            }
+            if (count == bucketSizes[b]) {
+                break;
+            }
+        }
+        if (seed > MAX_SEED) {
+            mprError(mpr, "Can't find a perfect hash for %s", path);
+            return MPR_ERR;
+        }
+        seeds[b] = (short) seed;
+        for (next = 0; (hk = mprGetNextItem(keys, &next)) != 0; ) {
+            if (hk->bucket == b) {
+                slots[mprHashString(hk->key, seed) % size] = hk;
+            }
+        }
+        memset(placed, 0, size * sizeof(int));
+    }
+
+    /*
+     *  Place single key buckets directly into the remaining slots
+     */
+    freeSlot = 0;
+    for (; i < size && bucketSizes[order[i]] == 1; i++) {
+        b = order[i];
+        for (next = 0; (hk = mprGetNextItem(keys, &next)) != 0 && hk->bucket != b; ) ;
+        while (slots[freeSlot]) {
+            freeSlot++;
+        }
+        slots[freeSlot] = hk;
+        seeds[b] = (short) -(freeSlot + 1);
+    }
+
+    /*
+     *  Derive the size define from the table name: timeTokens => TIME_TOKENS_SIZE
+     */
+    for (cp = name, dp = define; *cp && dp < &define[sizeof(define) - 8]; cp++) {
+        if (isupper((int) *cp) && cp != name) {
+            *dp++ = '_';
+        }
+        *dp++ = toupper((int) *cp);
+    }
+    strcpy(dp, "_SIZE");
+
+    mprPrintf(mpr, "/*\n *  Perfect hash table generated by makehash from %s. Do not edit.\n", mprGetPathBase(mpr, path));
+    mprPrintf(mpr, " *  Lookup with mprLookupPerfectHash(%sSeeds, %s, key).\n */\n", name, define);
+    mprPrintf(mpr, "#define %s %d\n\n", define, size);
+    mprPrintf(mpr, "static const short %sSeeds[%s] = {", name, define);
+    for (i = 0; i < size; i++) {
+        mprPrintf(mpr, "%s%d,", (i % 12) ? " " : "\n    ", seeds[i]);
+    }
+    mprPrintf(mpr, "\n};\n\n");
+
+    mprPrintf(mpr, "%s %s[] = {\n", type, name);
+    for (i = 0; i < size; i++) {
+        mprPrintf(mpr, "    %s,\n", slots[i]->init);
+    }
+    if (terminator) {
+        mprPrintf(mpr, "    %s,\n", terminator);
+    }
+    mprPrintf(mpr, "};\n");
+    return 0;
+}
+
+/*
+ *  @copy   default
+ *  
+ *  Copyright (c) Embedthis Software LLC, 2003-2011. All Rights Reserved.
+ *  Copyright (c) Michael O'Brien, 1993-2011. All Rights Reserved.
+ *  
+ *  This software is distributed under commercial and open source licenses.
+ *  You may use the GPL open source license described below or you may acquire 
+ *  a commercial license from Embedthis Software. You agree to be fully bound 
+ *  by the terms of either license. Consult the LICENSE.TXT distributed with 
+ *  this software for full details.
+ *  
+ *  This software is open source; you can redistribute it and/or modify it 
+ *  under the terms of the GNU General Public License as published by the 
+ *  Free Software Foundation; either version 2 of the License, or (at your 
+ *  option) any later version. See the GNU General Public License for more 
+ *  details at: http://www.embedthis.com/downloads/gplLicense.html
+ *  
+ *  This program is distributed WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
+ *  
+ *  This GPL license does NOT permit incorporating this software into 
+ *  proprietary programs. If you are unable to comply with the GPL, you must
+ *  acquire a commercial license to use this software. Commercial licenses 
+ *  for this software and support services are available from Embedthis 
+ *  Software at http://www.embedthis.com 
+ *  
+ *  Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */